@@ -1,10 +1,82 @@
 #include "vulkan_template/VulkanTemplate.hpp"
 
 #include <cstdlib>
+#include <optional>
+#include <span>
+#include <string_view>
 
 int main(int argc, char** argv)
 {
-    auto const runResult{vkt::run()};
+    // --golden <directory> renders headlessly and compares against the
+    // references in directory, and --update-golden rewrites them instead.
+    // --check-kernels checks compute kernels against the host, without a GPU.
+    // --check-ui-textures checks the UI texture registry headlessly.
+    // --compare-srgb measures each sRGB encoding's error and GPU time.
+    // --characterize <path> writes the device's roofline profile to path.
+    std::optional<std::string_view> goldenDirectory{};
+    bool updateGolden{false};
+    bool checkKernels{false};
+    bool checkUITextures{false};
+    bool compareSRGB{false};
+    std::optional<std::string_view> profilePath{};
+
+    std::span<char* const> const arguments{argv, static_cast<size_t>(argc)};
+    for (size_t index{1}; index < arguments.size(); index++)
+    {
+        std::string_view const argument{arguments[index]};
+        if (argument == "--golden" && index + 1 < arguments.size())
+        {
+            index += 1;
+            goldenDirectory = arguments[index];
+        }
+        else if (argument == "--update-golden")
+        {
+            updateGolden = true;
+        }
+        else if (argument == "--check-kernels")
+        {
+            checkKernels = true;
+        }
+        else if (argument == "--check-ui-textures")
+        {
+            checkUITextures = true;
+        }
+        else if (argument == "--compare-srgb")
+        {
+            compareSRGB = true;
+        }
+        else if (argument == "--characterize" && index + 1 < arguments.size())
+        {
+            index += 1;
+            profilePath = arguments[index];
+        }
+    }
+
+    vkt::RunResult runResult{vkt::RunResult::SUCCESS};
+    if (checkKernels)
+    {
+        runResult = vkt::checkKernelInterfaces();
+    }
+    else if (checkUITextures)
+    {
+        runResult = vkt::checkUITextureRegistry();
+    }
+    else if (compareSRGB)
+    {
+        runResult = vkt::compareSRGBEncodings();
+    }
+    else if (profilePath.has_value())
+    {
+        runResult = vkt::runDeviceCharacterization(profilePath.value());
+    }
+    else if (goldenDirectory.has_value())
+    {
+        runResult = vkt::runGoldenImages(goldenDirectory.value(), updateGolden);
+    }
+    else
+    {
+        runResult = vkt::run();
+    }
 
     if (runResult != vkt::RunResult::SUCCESS)
     {
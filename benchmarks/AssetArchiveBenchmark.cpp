@@ -0,0 +1,123 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/AssetArchive.hpp"
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <vector>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+
+// Many chunks, so that decompression has enough to spread across workers
+size_t constexpr ENTRY_BYTES{16ULL * 1024ULL * 1024ULL};
+
+// Repeats with variation, roughly as compressible as vertex data
+auto writeSourceFile(std::filesystem::path const& path) -> bool
+{
+    std::vector<char> contents(ENTRY_BYTES);
+    uint32_t state{1};
+    for (size_t index{0}; index < contents.size(); index++)
+    {
+        state = state * 1664525U + 1013904223U;
+        bool const noisy{(state >> 28U) == 0};
+        contents[index] = static_cast<char>(
+            noisy ? (state >> 20U) : (index / 16) % 251
+        );
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return file.good();
+}
+} // namespace
+
+namespace vkt
+{
+// Measures cooking and reading an entry, decompressing on the calling thread
+// and then on a job pool, against copying out an entry that was stored.
+void runAssetArchiveBenchmarks()
+{
+    std::filesystem::path const directory{
+        std::filesystem::temp_directory_path()
+    };
+    std::filesystem::path const sourcePath{
+        directory / "vkt_archive_source.bin"
+    };
+    std::filesystem::path const archivePath{directory / "vkt_archive.vkta"};
+    if (!writeSourceFile(sourcePath))
+    {
+        VKT_ERROR("Failed to write archive benchmark source.");
+        return;
+    }
+
+    std::array const sources{
+        AssetArchiveSource{
+            .name = "compressed",
+            .path = sourcePath,
+            .alignment = 256,
+            .compress = true,
+        },
+        AssetArchiveSource{
+            .name = "stored",
+            .path = sourcePath,
+            .alignment = 256,
+            .compress = false,
+        },
+    };
+
+    double const writeSeconds{medianSeconds(3, [&]()
+    { doNotOptimize(AssetArchive::write(archivePath, sources)); })};
+    VKT_INFO(
+        "write: {:8.3f} ms, {:6.2f} GB/s",
+        writeSeconds * 1.0e3,
+        static_cast<double>(2 * ENTRY_BYTES) / writeSeconds / 1.0e9
+    );
+    reportResult("write", writeSeconds * 1.0e9, "ns/call");
+
+    std::optional<AssetArchive> archive{AssetArchive::open(archivePath)};
+    std::optional<JobSystem> jobSystem{
+        JobSystem::create(JobSystem::defaultWorkerCount())
+    };
+    if (!archive.has_value() || !jobSystem.has_value())
+    {
+        VKT_ERROR("Failed to open archive benchmark resources.");
+        return;
+    }
+
+    std::vector<uint8_t> destination(ENTRY_BYTES);
+    auto const report{[&](char const* const name, double const seconds)
+    {
+        VKT_INFO(
+            "{:>20}: {:8.3f} ms, {:6.2f} GB/s",
+            name,
+            seconds * 1.0e3,
+            static_cast<double>(ENTRY_BYTES) / seconds / 1.0e9
+        );
+        reportResult(name, seconds * 1.0e9, "ns/call");
+    }};
+
+    report("read serial", medianSeconds(SAMPLE_COUNT, [&]()
+    {
+        doNotOptimize(archive.value().read("compressed", destination));
+    }));
+    report("read parallel", medianSeconds(SAMPLE_COUNT, [&]()
+    {
+        doNotOptimize(archive.value().read(
+            "compressed", destination, &jobSystem.value()
+        ));
+    }));
+    report("read stored", medianSeconds(SAMPLE_COUNT, [&]()
+    {
+        doNotOptimize(archive.value().read("stored", destination));
+    }));
+
+    archive.reset();
+    std::filesystem::remove(archivePath);
+    std::filesystem::remove(sourcePath);
+}
+} // namespace vkt
\ No newline at end of file
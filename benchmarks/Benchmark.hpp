@@ -0,0 +1,121 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vkt
+{
+struct Benchmark
+{
+    std::string name;
+    std::function<void()> run;
+};
+
+// Median wall time in seconds of one call to body, which is called once to
+// warm up and then sampleCount times. The median ignores outliers from
+// preemption better than the mean does.
+template <typename Body>
+auto medianSeconds(size_t const sampleCount, Body&& body) -> double
+{
+    using Clock = std::chrono::steady_clock;
+
+    body();
+
+    std::vector<double> samples{};
+    samples.reserve(sampleCount);
+    for (size_t sample{0}; sample < std::max<size_t>(sampleCount, 1); sample++)
+    {
+        Clock::time_point const start{Clock::now()};
+        body();
+        std::chrono::duration<double> const elapsed{Clock::now() - start};
+        samples.push_back(elapsed.count());
+    }
+
+    auto const middle{samples.begin() + samples.size() / 2};
+    std::nth_element(samples.begin(), middle, samples.end());
+    return *middle;
+}
+
+// Like medianSeconds, but calls setup before each call of body without timing
+// it, such as to drain a queue that body fills.
+template <typename Setup, typename Body>
+auto medianSeconds(size_t const sampleCount, Setup&& setup, Body&& body)
+    -> double
+{
+    using Clock = std::chrono::steady_clock;
+
+    setup();
+    body();
+
+    std::vector<double> samples{};
+    samples.reserve(sampleCount);
+    for (size_t sample{0}; sample < std::max<size_t>(sampleCount, 1); sample++)
+    {
+        setup();
+        Clock::time_point const start{Clock::now()};
+        body();
+        std::chrono::duration<double> const elapsed{Clock::now() - start};
+        samples.push_back(elapsed.count());
+    }
+
+    auto const middle{samples.begin() + samples.size() / 2};
+    std::nth_element(samples.begin(), middle, samples.end());
+    return *middle;
+}
+
+// Median nanoseconds per call of body, timed over callsPerSample calls at a
+// time so that calls far shorter than the clock's resolution still measure.
+template <typename Body>
+auto medianNanosecondsPerCall(
+    size_t const sampleCount, size_t const callsPerSample, Body&& body
+) -> double
+{
+    double const seconds{medianSeconds(
+        sampleCount,
+        [&]()
+    {
+        for (size_t call{0}; call < callsPerSample; call++)
+        {
+            body();
+        }
+    }
+    )};
+    return seconds * 1.0e9 / static_cast<double>(callsPerSample);
+}
+
+// Stops the optimizer from discarding a result that is otherwise unused.
+template <typename T> void doNotOptimize(T const& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(
+        *static_cast<char const volatile*>(static_cast<void const*>(&value))
+    );
+#endif
+}
+
+// Results are collected for the benchmark that is running, and written as JSON
+// once every benchmark has run, so that costs can be compared across commits.
+void beginReport(std::string const& benchmark);
+// Unit is free-form, such as "ns/call" or "GB/s".
+void reportResult(
+    std::string const& name, double value, std::string const& unit
+);
+auto writeReport(std::filesystem::path const& path) -> bool;
+
+void runAssetArchiveBenchmarks();
+void runDeletionQueueBenchmarks();
+void runDescriptorBenchmarks();
+void runJobSystemBenchmarks();
+void runLogBenchmarks();
+void runSRGBBenchmarks();
+void runShaderBenchmarks();
+void runUIRectangleBenchmarks();
+void runVulkanStructsBenchmarks();
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Result
+{
+    std::string benchmark;
+    std::string name;
+    double value;
+    std::string unit;
+};
+
+struct Report
+{
+    std::string benchmark{};
+    std::vector<Result> results{};
+};
+
+// Benchmarks only run on the main thread, one at a time
+auto report() -> Report&
+{
+    static Report instance{};
+    return instance;
+}
+} // namespace
+
+namespace vkt
+{
+void beginReport(std::string const& benchmark)
+{
+    report().benchmark = benchmark;
+}
+
+void reportResult(
+    std::string const& name, double const value, std::string const& unit
+)
+{
+    report().results.push_back(Result{
+        .benchmark = report().benchmark,
+        .name = name,
+        .value = value,
+        .unit = unit,
+    });
+}
+
+auto writeReport(std::filesystem::path const& path) -> bool
+{
+    std::ofstream file{path, std::ios::trunc};
+    if (!file.is_open())
+    {
+        VKT_ERROR("Unable to write benchmark report to '{}'.", path.string());
+        return false;
+    }
+
+    // Names and units are string literals without quotes or backslashes, so
+    // they are written without escaping. JSON has no infinity or NaN, so
+    // those become null.
+    file << "{\n    \"results\": [";
+    std::vector<Result> const& results{report().results};
+    for (size_t index{0}; index < results.size(); index++)
+    {
+        Result const& result{results[index]};
+        std::string const value{
+            std::isfinite(result.value) ? fmt::format("{}", result.value)
+                                        : "null"
+        };
+        file << fmt::format(
+            "{}\n        {{\"benchmark\": \"{}\", \"name\": \"{}\", "
+            "\"value\": {}, \"unit\": \"{}\"}}",
+            index == 0 ? "" : ",",
+            result.benchmark,
+            result.name,
+            value,
+            result.unit
+        );
+    }
+    file << "\n    ]\n}\n";
+
+    return file.good();
+}
+} // namespace vkt
\ No newline at end of file
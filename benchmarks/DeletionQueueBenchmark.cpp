@@ -0,0 +1,59 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/DeletionQueue.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+size_t constexpr CALLS_PER_SAMPLE{10'000};
+
+// About as many cleanup steps as creating a frame pushes
+size_t constexpr CALLBACKS_PER_QUEUE{8};
+} // namespace
+
+namespace vkt
+{
+// Measures the cost a DeletionQueue adds to creating an object, both when
+// creation succeeds and the callbacks are cleared, and when it fails and they
+// are flushed.
+void runDeletionQueueBenchmarks()
+{
+    std::array<size_t, CALLBACKS_PER_QUEUE> handles{};
+
+    double const clearNanoseconds{
+        medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        DeletionQueue cleanupCallbacks{};
+        for (size_t& handle : handles)
+        {
+            cleanupCallbacks.pushFunction([&handle]() { handle = 0; });
+        }
+        cleanupCallbacks.clear();
+    })
+    };
+
+    double const flushNanoseconds{
+        medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        DeletionQueue cleanupCallbacks{};
+        for (size_t& handle : handles)
+        {
+            cleanupCallbacks.pushFunction([&handle]() { handle += 1; });
+        }
+        cleanupCallbacks.flush();
+        doNotOptimize(handles);
+    })
+    };
+
+    VKT_INFO(
+        "{} callbacks: push and clear {:8.1f} ns, push and flush {:8.1f} ns",
+        CALLBACKS_PER_QUEUE,
+        clearNanoseconds,
+        flushNanoseconds
+    );
+    reportResult("push and clear", clearNanoseconds, "ns/queue");
+    reportResult("push and flush", flushNanoseconds, "ns/queue");
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/app/DescriptorAllocator.hpp"
+#include "vulkan_template/app/GraphicsContext.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+#include <optional>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+size_t constexpr CALLS_PER_SAMPLE{1000};
+
+// Enough that the allocator grows through a few pools every sample
+uint32_t constexpr INITIAL_SETS_PER_POOL{64};
+
+// Resembles a material: a uniform buffer, a few textures, and an output image
+auto materialLayout() -> vkt::DescriptorLayoutBuilder
+{
+    vkt::DescriptorLayoutBuilder builder{};
+    builder
+        .pushBinding(vkt::DescriptorLayoutBuilder::BindingParams{
+            .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .stageMask = VK_SHADER_STAGE_ALL,
+            .bindingFlags = 0,
+        })
+        .pushBinding(
+            vkt::DescriptorLayoutBuilder::BindingParams{
+                .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                .stageMask = VK_SHADER_STAGE_ALL,
+                .bindingFlags = 0,
+            },
+            4
+        )
+        .pushBinding(vkt::DescriptorLayoutBuilder::BindingParams{
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .stageMask = VK_SHADER_STAGE_ALL,
+            .bindingFlags = 0,
+        });
+    return builder;
+}
+} // namespace
+
+namespace vkt
+{
+// Measures building descriptor set layouts, directly and through the cache,
+// and allocating sets as each recording thread does every frame.
+//
+// Needs a device, but no window, so it runs on a software driver such as
+// lavapipe. Validation layers are enabled unless heap allocations are counted,
+// and add to every call that reaches the driver.
+void runDescriptorBenchmarks()
+{
+    std::optional<GraphicsContext> graphicsResult{
+        GraphicsContext::createHeadless()
+    };
+    if (!graphicsResult.has_value())
+    {
+        VKT_ERROR("Failed to create headless graphics context.");
+        return;
+    }
+    GraphicsContext& graphicsContext{graphicsResult.value()};
+    VkDevice const device{graphicsContext.device()};
+
+    DescriptorLayoutBuilder const builder{materialLayout()};
+
+    double const buildNanoseconds{
+        medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        std::optional<VkDescriptorSetLayout> const layout{
+            builder.build(device, 0)
+        };
+        if (layout.has_value())
+        {
+            vkDestroyDescriptorSetLayout(device, layout.value(), nullptr);
+        }
+    })
+    };
+
+    // Every call after the first hits the cache
+    double const cachedBuildNanoseconds{
+        medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        std::optional<VkDescriptorSetLayout> const layout{
+            builder.build(graphicsContext.descriptorLayoutCache(), 0)
+        };
+        doNotOptimize(layout);
+    })
+    };
+
+    std::optional<VkDescriptorSetLayout> const layoutResult{
+        builder.build(graphicsContext.descriptorLayoutCache(), 0)
+    };
+    if (!layoutResult.has_value())
+    {
+        VKT_ERROR("Failed to build descriptor benchmark layout.");
+        return;
+    }
+    VkDescriptorSetLayout const layout{layoutResult.value()};
+
+    std::array<DescriptorAllocator::PoolSizeRatio, 3> const ratios{
+        DescriptorAllocator::PoolSizeRatio{
+            .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .ratio = 1.0F
+        },
+        DescriptorAllocator::PoolSizeRatio{
+            .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .ratio = 4.0F
+        },
+        DescriptorAllocator::PoolSizeRatio{
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .ratio = 1.0F
+        },
+    };
+    DescriptorAllocator allocator{
+        DescriptorAllocator::create(device, INITIAL_SETS_PER_POOL, ratios, 0)
+    };
+
+    // Pools are reset before each sample, as they are when a frame retires
+    double const allocateSeconds{medianSeconds(
+        SAMPLE_COUNT,
+        [&]() { allocator.clearDescriptors(device); },
+        [&]()
+    {
+        for (size_t call{0}; call < CALLS_PER_SAMPLE; call++)
+        {
+            VkDescriptorSet const set{allocator.allocate(device, layout)};
+            doNotOptimize(set);
+        }
+    }
+    )};
+    double const allocateNanoseconds{
+        allocateSeconds * 1.0e9 / static_cast<double>(CALLS_PER_SAMPLE)
+    };
+
+    double const clearSeconds{medianSeconds(
+        SAMPLE_COUNT,
+        [&]()
+    {
+        for (size_t call{0}; call < CALLS_PER_SAMPLE; call++)
+        {
+            allocator.allocate(device, layout);
+        }
+    },
+        [&]() { allocator.clearDescriptors(device); }
+    )};
+
+    VKT_INFO(
+        "build {:8.1f} ns, cached build {:8.1f} ns, allocate {:8.1f} ns",
+        buildNanoseconds,
+        cachedBuildNanoseconds,
+        allocateNanoseconds
+    );
+    VKT_INFO(
+        "clear {:8.1f} us for {} sets in {} pools",
+        clearSeconds * 1.0e6,
+        CALLS_PER_SAMPLE,
+        allocator.readyPoolCount()
+    );
+
+    reportResult("build", buildNanoseconds, "ns/call");
+    reportResult("cached build", cachedBuildNanoseconds, "ns/call");
+    reportResult("allocate", allocateNanoseconds, "ns/call");
+    reportResult("clear", clearSeconds * 1.0e9, "ns/call");
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+
+// Enough elements that each range does real work at the chosen grain
+size_t constexpr PARALLEL_FOR_ELEMENTS{1ULL << 22ULL};
+size_t constexpr PARALLEL_FOR_GRAIN{1ULL << 14ULL};
+
+// Small enough that scheduling overhead dominates
+size_t constexpr TINY_JOB_COUNT{100'000};
+
+// 0, 1, 2, 4, ... up to the hardware thread count, which includes the main
+// thread, so the largest count oversubscribes by one.
+auto workerCounts() -> std::vector<size_t>
+{
+    size_t const hardwareThreads{
+        std::max<size_t>(std::thread::hardware_concurrency(), 1)
+    };
+
+    std::vector<size_t> counts{0};
+    for (size_t count{1}; count < hardwareThreads; count *= 2)
+    {
+        counts.push_back(count);
+    }
+    if (counts.back() != hardwareThreads)
+    {
+        counts.push_back(hardwareThreads);
+    }
+    return counts;
+}
+
+auto parallelForSeconds(
+    vkt::JobSystem& jobSystem, std::vector<float> const& input
+) -> double
+{
+    size_t const rangeCount{
+        (input.size() + PARALLEL_FOR_GRAIN - 1) / PARALLEL_FOR_GRAIN
+    };
+    std::vector<double> rangeSums(rangeCount, 0.0);
+
+    return vkt::medianSeconds(
+        SAMPLE_COUNT,
+        [&]()
+    {
+        jobSystem.parallelFor(
+            input.size(),
+            PARALLEL_FOR_GRAIN,
+            [&](size_t const begin, size_t const end)
+        {
+            double sum{0.0};
+            for (size_t index{begin}; index < end; index++)
+            {
+                sum += std::sqrt(input[index]) * std::sin(input[index]);
+            }
+            rangeSums[begin / PARALLEL_FOR_GRAIN] = sum;
+        }
+        );
+        vkt::doNotOptimize(rangeSums);
+    }
+    );
+}
+
+auto tinyJobSeconds(vkt::JobSystem& jobSystem) -> double
+{
+    return vkt::medianSeconds(
+        SAMPLE_COUNT,
+        [&]()
+    {
+        vkt::JobCounter counter{};
+        for (size_t job{0}; job < TINY_JOB_COUNT; job++)
+        {
+            jobSystem.submit([]() {}, &counter);
+        }
+        jobSystem.wait(counter);
+    }
+    );
+}
+} // namespace
+
+namespace vkt
+{
+// Measures how parallelFor scales with workers, and the per-job overhead of
+// the scheduler with jobs that do nothing.
+void runJobSystemBenchmarks()
+{
+    std::vector<float> input(PARALLEL_FOR_ELEMENTS);
+    for (size_t index{0}; index < input.size(); index++)
+    {
+        input[index] = static_cast<float>(index % 1024);
+    }
+
+    std::optional<double> serialSeconds{};
+    for (size_t const workerCount : workerCounts())
+    {
+        std::optional<JobSystem> jobSystemResult{
+            JobSystem::create(workerCount)
+        };
+        if (!jobSystemResult.has_value())
+        {
+            VKT_ERROR("Failed to create job system.");
+            return;
+        }
+        JobSystem& jobSystem{jobSystemResult.value()};
+
+        double const forSeconds{parallelForSeconds(jobSystem, input)};
+        if (!serialSeconds.has_value())
+        {
+            serialSeconds = forSeconds;
+        }
+
+        double const tinySeconds{tinyJobSeconds(jobSystem)};
+
+        VKT_INFO(
+            "{:>3} workers: parallelFor {:8.3f} ms ({:5.2f}x), "
+            "empty jobs {:7.1f} ns/job",
+            workerCount,
+            forSeconds * 1000.0,
+            serialSeconds.value() / forSeconds,
+            tinySeconds * 1.0e9 / static_cast<double>(TINY_JOB_COUNT)
+        );
+        reportResult(
+            fmt::format("parallelFor {} workers", workerCount),
+            forSeconds * 1000.0,
+            "ms"
+        );
+        reportResult(
+            fmt::format("empty jobs {} workers", workerCount),
+            tinySeconds * 1.0e9 / static_cast<double>(TINY_JOB_COUNT),
+            "ns/job"
+        );
+    }
+}
+} // namespace vkt
\ No newline at end of file
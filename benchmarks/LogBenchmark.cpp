@@ -0,0 +1,97 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+
+// Fits in the async queue, so no messages are dropped
+size_t constexpr MESSAGES_PER_SAMPLE{1000};
+
+char const* const LOG_PATH{"LogBenchmark.log"};
+
+// Nanoseconds per message on the logging thread. The file is written to disk,
+// but not the console, whose speed depends on the terminal.
+auto messageNanoseconds(vkt::LogMode const mode) -> double
+{
+    vkt::Logger::initLogging(vkt::LogOptions{
+        .mode = mode,
+        .console = false,
+        .filePath = LOG_PATH,
+    });
+
+    double const seconds{vkt::medianSeconds(
+        SAMPLE_COUNT,
+        []() { vkt::Logger::flush(); },
+        []()
+    {
+        for (size_t message{0}; message < MESSAGES_PER_SAMPLE; message++)
+        {
+            VKT_INFO("Frame {} took {:.3f} ms.", message, 16.667);
+        }
+    }
+    )};
+
+    vkt::Logger::flush();
+
+    return seconds * 1.0e9 / static_cast<double>(MESSAGES_PER_SAMPLE);
+}
+
+// Nanoseconds per message from a call site that is being rate limited, so
+// almost every message is suppressed.
+auto rateLimitedNanoseconds() -> double
+{
+    vkt::Logger::initLogging(vkt::LogOptions{
+        .console = false,
+        .filePath = LOG_PATH,
+    });
+
+    double const seconds{vkt::medianSeconds(
+        SAMPLE_COUNT,
+        []()
+    {
+        for (size_t message{0}; message < MESSAGES_PER_SAMPLE; message++)
+        {
+            VKT_INFO_RATE_LIMITED("Frame {} took {:.3f} ms.", message, 16.667);
+        }
+    }
+    )};
+
+    vkt::Logger::flush();
+
+    return seconds * 1.0e9 / static_cast<double>(MESSAGES_PER_SAMPLE);
+}
+} // namespace
+
+namespace vkt
+{
+// Measures what a log call costs the thread that makes it. The synchronous
+// mode formats, writes and flushes on the caller, while the asynchronous mode
+// only copies the message into a queue.
+void runLogBenchmarks()
+{
+    struct Result
+    {
+        char const* name;
+        double nanoseconds;
+    };
+    std::array const results{
+        Result{"synchronous", messageNanoseconds(LogMode::SYNCHRONOUS)},
+        Result{"asynchronous", messageNanoseconds(LogMode::ASYNCHRONOUS)},
+        Result{"rate limited", rateLimitedNanoseconds()},
+    };
+
+    // Results are logged once console logging is back
+    Logger::initLogging();
+
+    for (Result const& result : results)
+    {
+        VKT_INFO(
+            "{:>12}: {:8.1f} ns/message", result.name, result.nanoseconds
+        );
+        reportResult(result.name, result.nanoseconds, "ns/message");
+    }
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/CPUFeatures.hpp"
+#include "vulkan_template/core/CPUKernels.hpp"
+#include "vulkan_template/core/ImageCompare.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+#include <vector>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{9};
+
+uint32_t constexpr IMAGE_WIDTH{1920};
+uint32_t constexpr IMAGE_HEIGHT{1080};
+size_t constexpr TEXEL_COUNT{size_t{IMAGE_WIDTH} * IMAGE_HEIGHT};
+
+struct Variant
+{
+    char const* name;
+    vkt::SRGBEncoding encoding;
+    vkt::SIMDLevel level;
+};
+
+// Every encoding once, then the polynomial at each level this CPU supports.
+auto variants() -> std::vector<Variant>
+{
+    std::vector<Variant> result{
+        {"exact", vkt::SRGBEncoding::EXACT, vkt::SIMDLevel::SCALAR},
+        {"LUT", vkt::SRGBEncoding::LUT, vkt::SIMDLevel::SCALAR},
+    };
+    for (vkt::SIMDLevel const level :
+         {vkt::SIMDLevel::SCALAR,
+          vkt::SIMDLevel::SSE4_1,
+          vkt::SIMDLevel::AVX2,
+          vkt::SIMDLevel::NEON})
+    {
+        if (vkt::simdLevelSupported(level))
+        {
+            result.push_back(
+                {"polynomial", vkt::SRGBEncoding::POLYNOMIAL, level}
+            );
+        }
+    }
+    return result;
+}
+} // namespace
+
+namespace vkt
+{
+// Measures the CPU fallback for oetf_srgb.comp on a full HD test pattern, and
+// how far each approximation strays from the pow-based encoding.
+void runSRGBBenchmarks()
+{
+    VKT_INFO("Detected SIMD level: {}", simdLevelName(detectedSIMDLevel()));
+
+    TexelRect const rect{
+        .x = 0,
+        .y = 0,
+        .width = IMAGE_WIDTH,
+        .height = IMAGE_HEIGHT,
+    };
+
+    std::vector<uint16_t> source(TEXEL_COUNT * 4);
+    drawTestPattern(
+        MutableImageRGBA16{
+            .width = IMAGE_WIDTH, .height = IMAGE_HEIGHT, .texels = source
+        },
+        rect
+    );
+
+    std::vector<uint16_t> reference{source};
+    encodeLinearToSRGB(
+        MutableImageRGBA16{
+            .width = IMAGE_WIDTH, .height = IMAGE_HEIGHT, .texels = reference
+        },
+        rect,
+        SRGBEncoding::EXACT
+    );
+
+    std::vector<uint16_t> texels(source.size());
+    MutableImageRGBA16 const image{
+        .width = IMAGE_WIDTH, .height = IMAGE_HEIGHT, .texels = texels
+    };
+
+    for (Variant const& variant : variants())
+    {
+        double const seconds{medianSeconds(
+            SAMPLE_COUNT,
+            [&]() { texels = source; },
+            [&]()
+        {
+            encodeLinearToSRGB(image, rect, variant.encoding, variant.level);
+            doNotOptimize(texels);
+        }
+        )};
+
+        ImageDifference const difference{
+            compareImages(texels, reference, 0)
+        };
+
+        VKT_INFO(
+            "{:>10} {:>6}: {:8.3f} ms, {:6.2f} ns/texel, max error {}",
+            variant.name,
+            simdLevelName(variant.level),
+            seconds * 1000.0,
+            seconds * 1.0e9 / static_cast<double>(TEXEL_COUNT),
+            difference.maxDifference
+        );
+        reportResult(
+            fmt::format(
+                "{} {}", variant.name, simdLevelName(variant.level)
+            ),
+            seconds * 1.0e9 / static_cast<double>(TEXEL_COUNT),
+            "ns/texel"
+        );
+    }
+}
+} // namespace vkt
\ No newline at end of file
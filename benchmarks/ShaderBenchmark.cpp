@@ -0,0 +1,161 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/core/MappedFile.hpp"
+#include "vulkan_template/vulkan/Shader.hpp"
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+size_t constexpr CALLS_PER_SAMPLE{100'000};
+
+struct FileSize
+{
+    char const* name;
+    size_t bytes;
+};
+
+// A typical compute shader's SPIR-V, and a large asset
+std::array<FileSize, 2> constexpr FILE_SIZES{
+    FileSize{.name = "16KiB", .bytes = 16ULL * 1024ULL},
+    FileSize{.name = "16MiB", .bytes = 16ULL * 1024ULL * 1024ULL},
+};
+
+// Shaders are loaded a few at a time while kernels are created
+size_t constexpr BATCH_FILE_COUNT{32};
+
+auto writeTemporaryFile(size_t const bytes, size_t const index = 0)
+    -> std::filesystem::path
+{
+    std::filesystem::path const path{
+        std::filesystem::temp_directory_path()
+        / fmt::format("vkt_shader_benchmark_{}.bin", index)
+    };
+
+    std::vector<char> const contents(bytes, 'x');
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+
+    return path;
+}
+
+// Reads a byte from every page, so that mapped pages are faulted in as they
+// are when a consumer parses the file.
+auto touchPages(std::span<uint8_t const> const bytes) -> uint32_t
+{
+    size_t constexpr PAGE_BYTES{4096};
+
+    uint32_t sum{0};
+    for (size_t offset{0}; offset < bytes.size(); offset += PAGE_BYTES)
+    {
+        sum += bytes[offset];
+    }
+    return sum;
+}
+} // namespace
+
+namespace vkt
+{
+// Measures reading files as shaders are, which after the first read come from
+// the OS's file cache: mapped one at a time, and small ones read as a batch.
+// Also measures the workgroup count math of every compute dispatch.
+void runShaderBenchmarks()
+{
+    for (FileSize const& size : FILE_SIZES)
+    {
+        std::filesystem::path const path{writeTemporaryFile(size.bytes)};
+
+        double const seconds{medianSeconds(SAMPLE_COUNT, [&]()
+        {
+            std::optional<MappedFile> const file{MappedFile::open(path)};
+            doNotOptimize(touchPages(file.value().bytes()));
+        })};
+        double const gigabytesPerSecond{
+            static_cast<double>(size.bytes) / seconds / 1.0e9
+        };
+
+        VKT_INFO(
+            "MappedFile {:>5}: {:10.3f} us, {:6.2f} GB/s",
+            size.name,
+            seconds * 1.0e6,
+            gigabytesPerSecond
+        );
+        reportResult(
+            fmt::format("MappedFile {}", size.name),
+            seconds * 1.0e9,
+            "ns/call"
+        );
+
+        std::filesystem::remove(path);
+    }
+
+    std::vector<std::filesystem::path> batchPaths{};
+    for (size_t index{0}; index < BATCH_FILE_COUNT; index++)
+    {
+        batchPaths.push_back(
+            writeTemporaryFile(FILE_SIZES.front().bytes, index)
+        );
+    }
+
+    double const mappedSeconds{medianSeconds(SAMPLE_COUNT, [&]()
+    {
+        for (std::filesystem::path const& path : batchPaths)
+        {
+            std::optional<MappedFile> const file{MappedFile::open(path)};
+            doNotOptimize(touchPages(file.value().bytes()));
+        }
+    })};
+    double const batchSeconds{medianSeconds(SAMPLE_COUNT, [&]()
+    {
+        FileBatch const batch{FileBatch::read(batchPaths)};
+        for (size_t index{0}; index < batch.count(); index++)
+        {
+            doNotOptimize(touchPages(batch.bytes(index)));
+        }
+    })};
+
+    VKT_INFO(
+        "{} x {} mapped: {:10.3f} us, batched: {:10.3f} us",
+        BATCH_FILE_COUNT,
+        FILE_SIZES.front().name,
+        mappedSeconds * 1.0e6,
+        batchSeconds * 1.0e6
+    );
+    reportResult(
+        fmt::format("MappedFile {} x {}", BATCH_FILE_COUNT, FILE_SIZES[0].name),
+        mappedSeconds * 1.0e9,
+        "ns/call"
+    );
+    reportResult(
+        fmt::format("FileBatch {} x {}", BATCH_FILE_COUNT, FILE_SIZES[0].name),
+        batchSeconds * 1.0e9,
+        "ns/call"
+    );
+
+    for (std::filesystem::path const& path : batchPaths)
+    {
+        std::filesystem::remove(path);
+    }
+
+    // Varying the inputs keeps the division from being hoisted out of the loop
+    uint32_t invocations{1};
+    uint32_t workgroups{0};
+    double const dispatchNanoseconds{
+        medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        invocations = invocations * 1664525U + 1013904223U;
+        workgroups += ::detail::computeDispatchCount(invocations >> 12U, 64);
+        doNotOptimize(workgroups);
+    })
+    };
+
+    VKT_INFO("computeDispatchCount: {:6.2f} ns/call", dispatchNanoseconds);
+    reportResult("computeDispatchCount", dispatchNanoseconds, "ns/call");
+}
+} // namespace vkt
\ No newline at end of file
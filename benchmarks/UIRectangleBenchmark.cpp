@@ -0,0 +1,104 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/core/UIRectangle.hpp"
+#include <array>
+#include <glm/vec2.hpp>
+#include <vector>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+
+// Around the number of widgets a busy UI tests against each frame
+size_t constexpr RECTANGLE_COUNT{4096};
+
+auto rectangles() -> std::vector<vkt::UIRectangle>
+{
+    std::vector<vkt::UIRectangle> result{};
+    result.reserve(RECTANGLE_COUNT);
+    for (size_t index{0}; index < RECTANGLE_COUNT; index++)
+    {
+        auto const offset{static_cast<float>(index % 64)};
+        result.push_back(vkt::UIRectangle::fromPosSize(
+            glm::vec2{offset * 20.0F, offset * 10.0F},
+            glm::vec2{100.0F + offset, 40.0F + offset}
+        ));
+    }
+    return result;
+}
+
+// Nanoseconds per rectangle of calling operation on each rectangle.
+template <typename Operation>
+auto perRectangleNanoseconds(Operation&& operation) -> double
+{
+    double const seconds{vkt::medianSeconds(SAMPLE_COUNT, operation)};
+    return seconds * 1.0e9 / static_cast<double>(RECTANGLE_COUNT);
+}
+} // namespace
+
+namespace vkt
+{
+// Measures the rectangle operations that layout and hit testing run for every
+// widget.
+void runUIRectangleBenchmarks()
+{
+    std::vector<UIRectangle> const inputs{rectangles()};
+    std::vector<UIRectangle> outputs(inputs.size());
+    std::vector<uint8_t> hits(inputs.size());
+
+    UIRectangle const clip{UIRectangle::fromPosSize(
+        glm::vec2{200.0F, 100.0F}, glm::vec2{800.0F, 400.0F}
+    )};
+    glm::vec2 const cursor{640.0F, 320.0F};
+
+    struct Result
+    {
+        char const* name;
+        double nanoseconds;
+    };
+    std::array const results{
+        Result{
+            "contains",
+            perRectangleNanoseconds([&]()
+    {
+        for (size_t index{0}; index < inputs.size(); index++)
+        {
+            hits[index] = inputs[index].contains(cursor) ? 1 : 0;
+        }
+        doNotOptimize(hits);
+    })
+        },
+        Result{
+            "intersect",
+            perRectangleNanoseconds([&]()
+    {
+        for (size_t index{0}; index < inputs.size(); index++)
+        {
+            outputs[index] = inputs[index].intersect(clip);
+        }
+        doNotOptimize(outputs);
+    })
+        },
+        Result{
+            "shrink",
+            perRectangleNanoseconds([&]()
+    {
+        for (size_t index{0}; index < inputs.size(); index++)
+        {
+            outputs[index] = inputs[index].shrink(glm::vec2{4.0F, 2.0F});
+        }
+        doNotOptimize(outputs);
+    })
+        },
+    };
+
+    for (Result const& result : results)
+    {
+        VKT_INFO(
+            "{:>10}: {:6.2f} ns/rectangle", result.name, result.nanoseconds
+        );
+        reportResult(result.name, result.nanoseconds, "ns/rectangle");
+    }
+}
+} // namespace vkt
\ No newline at end of file
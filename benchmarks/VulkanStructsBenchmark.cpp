@@ -0,0 +1,107 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/LinearArena.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <array>
+
+namespace
+{
+size_t constexpr SAMPLE_COUNT{15};
+size_t constexpr CALLS_PER_SAMPLE{100'000};
+} // namespace
+
+namespace vkt
+{
+// Measures the struct helpers that recording and submitting a frame calls
+// several times each. Handles are null, since nothing is passed to Vulkan.
+void runVulkanStructsBenchmarks()
+{
+    std::array<VkCommandBufferSubmitInfo, 1> const cmdInfos{
+        commandBufferSubmitInfo(VK_NULL_HANDLE)
+    };
+    std::array<VkSemaphoreSubmitInfo, 2> const waitInfos{
+        semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_NULL_HANDLE
+        ),
+        semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_NULL_HANDLE
+        ),
+    };
+    std::array<VkSemaphoreSubmitInfo, 1> const signalInfos{
+        semaphoreSubmitInfo(
+            VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, VK_NULL_HANDLE
+        )
+    };
+
+    LinearArena arena{};
+
+    struct Result
+    {
+        char const* name;
+        double nanoseconds;
+    };
+    std::array const results{
+        Result{
+            "submitInfo",
+            medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        VkSubmitInfo2 const submission{
+            submitInfo(cmdInfos, waitInfos, signalInfos)
+        };
+        doNotOptimize(submission);
+    })
+        },
+        // Reset every call, as the arena is each frame
+        Result{
+            "submitInfo arena",
+            medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        VkSubmitInfo2 const submission{submitInfo(
+            arena, {cmdInfos[0]}, {waitInfos[0], waitInfos[1]}, {signalInfos[0]}
+        )};
+        doNotOptimize(submission);
+        arena.reset();
+    })
+        },
+        Result{
+            "commandBufferBeginInfo",
+            medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        VkCommandBufferBeginInfo const beginInfo{
+            commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+        };
+        doNotOptimize(beginInfo);
+    })
+        },
+        Result{
+            "imageSubresourceRange",
+            medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        VkImageSubresourceRange const range{
+            imageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT)
+        };
+        doNotOptimize(range);
+    })
+        },
+        Result{
+            "renderingAttachmentInfo",
+            medianNanosecondsPerCall(SAMPLE_COUNT, CALLS_PER_SAMPLE, [&]()
+    {
+        VkRenderingAttachmentInfo const attachment{renderingAttachmentInfo(
+            VK_NULL_HANDLE,
+            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            VkClearValue{.color = {.float32 = {0.0F, 0.0F, 0.0F, 1.0F}}}
+        )};
+        doNotOptimize(attachment);
+    })
+        },
+    };
+
+    for (Result const& result : results)
+    {
+        VKT_INFO("{:>24}: {:6.2f} ns/call", result.name, result.nanoseconds);
+        reportResult(result.name, result.nanoseconds, "ns/call");
+    }
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "Benchmark.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <array>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <string_view>
+
+// Runs every benchmark, or only those whose name contains the filter argument.
+// --json <path> also writes every result to path.
+int main(int argc, char** argv)
+{
+    vkt::Logger::initLogging();
+
+    std::string_view filter{};
+    std::optional<std::string_view> reportPath{};
+
+    std::span<char* const> const arguments{argv, static_cast<size_t>(argc)};
+    for (size_t index{1}; index < arguments.size(); index++)
+    {
+        std::string_view const argument{arguments[index]};
+        if (argument == "--json" && index + 1 < arguments.size())
+        {
+            index += 1;
+            reportPath = arguments[index];
+        }
+        else
+        {
+            filter = argument;
+        }
+    }
+
+    std::array const benchmarks{
+        vkt::Benchmark{
+            .name = "AssetArchive", .run = vkt::runAssetArchiveBenchmarks
+        },
+        vkt::Benchmark{
+            .name = "DeletionQueue", .run = vkt::runDeletionQueueBenchmarks
+        },
+        vkt::Benchmark{
+            .name = "Descriptor", .run = vkt::runDescriptorBenchmarks
+        },
+        vkt::Benchmark{.name = "JobSystem", .run = vkt::runJobSystemBenchmarks},
+        vkt::Benchmark{.name = "Log", .run = vkt::runLogBenchmarks},
+        vkt::Benchmark{.name = "SRGB", .run = vkt::runSRGBBenchmarks},
+        vkt::Benchmark{.name = "Shader", .run = vkt::runShaderBenchmarks},
+        vkt::Benchmark{
+            .name = "UIRectangle", .run = vkt::runUIRectangleBenchmarks
+        },
+        vkt::Benchmark{
+            .name = "VulkanStructs", .run = vkt::runVulkanStructsBenchmarks
+        },
+    };
+
+    bool anyRan{false};
+    for (vkt::Benchmark const& benchmark : benchmarks)
+    {
+        if (benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        VKT_INFO("Running benchmark '{}'", benchmark.name);
+        vkt::beginReport(benchmark.name);
+        benchmark.run();
+        anyRan = true;
+    }
+
+    if (!anyRan)
+    {
+        VKT_ERROR("No benchmarks match '{}'.", filter);
+        return EXIT_FAILURE;
+    }
+
+    if (reportPath.has_value() && !vkt::writeReport(reportPath.value()))
+    {
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
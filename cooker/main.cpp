@@ -0,0 +1,81 @@
+#include "vulkan_template/core/AssetArchive.hpp"
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    vkt::Logger::initLogging({.mode = vkt::LogMode::SYNCHRONOUS});
+
+    // <archive> <root> [options] <files...>, where files are named by their
+    // path relative to root. Options apply to the files after them:
+    // --align <bytes> aligns entries, and --store and --compress choose whether
+    // their chunks are compressed.
+    std::span<char* const> const arguments{argv, static_cast<size_t>(argc)};
+    if (arguments.size() < 3)
+    {
+        VKT_ERROR(
+            "Usage: VulkanTemplateCooker <archive> <root directory> "
+            "[--align <bytes>] [--store] [--compress] <files...>"
+        );
+        return EXIT_FAILURE;
+    }
+
+    std::filesystem::path const archivePath{arguments[1]};
+    std::filesystem::path const root{arguments[2]};
+
+    std::vector<vkt::AssetArchiveSource> sources{};
+    uint32_t alignment{vkt::AssetArchiveSource{}.alignment};
+    bool compress{true};
+    for (size_t index{3}; index < arguments.size(); index++)
+    {
+        std::string_view const argument{arguments[index]};
+        if (argument == "--align" && index + 1 < arguments.size())
+        {
+            index += 1;
+            std::string_view const value{arguments[index]};
+            auto const [end, error]{std::from_chars(
+                value.data(), value.data() + value.size(), alignment
+            )};
+            if (error != std::errc{} || end != value.data() + value.size())
+            {
+                VKT_ERROR("Alignment '{}' is not a number.", value);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (argument == "--store")
+        {
+            compress = false;
+        }
+        else if (argument == "--compress")
+        {
+            compress = true;
+        }
+        else
+        {
+            std::filesystem::path const name{argument};
+            sources.push_back(vkt::AssetArchiveSource{
+                .name = name.generic_string(),
+                .path = root / name,
+                .alignment = alignment,
+                .compress = compress,
+            });
+        }
+    }
+
+    if (!vkt::AssetArchive::write(archivePath, sources))
+    {
+        VKT_ERROR("Failed to cook '{}'.", archivePath.string());
+        return EXIT_FAILURE;
+    }
+
+    VKT_INFO(
+        "Cooked {} files into '{}'.", sources.size(), archivePath.string()
+    );
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
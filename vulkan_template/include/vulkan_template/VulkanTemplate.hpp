@@ -1,5 +1,7 @@
 #pragma once
 
+#include <filesystem>
+
 namespace vkt
 {
 enum class RunResult
@@ -9,4 +11,31 @@ enum class RunResult
 };
 
 auto run() -> RunResult;
+
+// Renders the golden image cases headlessly and compares them against the
+// references in referenceDirectory, failing if any case does not match. Then
+// draws UI frames on headless UI layers of several sizes, and compares them and
+// the scene viewport in them the same way.
+// Needs no window, so it runs on software drivers such as lavapipe.
+auto runGoldenImages(
+    std::filesystem::path const& referenceDirectory, bool updateReferences
+) -> RunResult;
+
+// Checks packing, eviction, and deferred release in the UI texture registry on
+// a headless device.
+auto checkUITextureRegistry() -> RunResult;
+
+// Reflects the SPIR-V of every compute kernel and checks it against the
+// host-side push constants, bindings, and specialization constants. Needs no
+// device, so it catches mismatches on machines without a GPU.
+auto checkKernelInterfaces() -> RunResult;
+
+// Encodes a test pattern headlessly with each sRGB encoding, and logs each
+// one's GPU time and largest error against the exact encoding on the CPU.
+auto compareSRGBEncodings() -> RunResult;
+
+// Runs compute microbenchmarks headlessly and writes the device's bandwidth,
+// arithmetic throughput, and dispatch overhead to profilePath as JSON.
+auto runDeviceCharacterization(std::filesystem::path const& profilePath)
+    -> RunResult;
 } // namespace vkt
\ No newline at end of file
@@ -1,32 +1,86 @@
 #include "vulkan_template/VulkanTemplate.hpp"
 
+#include "vulkan_template/app/DeviceCharacterization.hpp"
 #include "vulkan_template/app/FrameBuffer.hpp"
+#include "vulkan_template/app/GoldenImage.hpp"
 #include "vulkan_template/app/GraphicsContext.hpp"
+#include "vulkan_template/app/ParallelRecorder.hpp"
 #include "vulkan_template/app/PlatformWindow.hpp"
 #include "vulkan_template/app/PostProcess.hpp"
+#include "vulkan_template/app/RenderTarget.hpp"
 #include "vulkan_template/app/Renderer.hpp"
 #include "vulkan_template/app/Swapchain.hpp"
 #include "vulkan_template/app/UILayer.hpp"
+#include "vulkan_template/core/AssetArchive.hpp"
+#include "vulkan_template/core/CPUKernels.hpp"
+#include "vulkan_template/core/HeapAllocationCounter.hpp"
+#include "vulkan_template/core/ImageFile.hpp"
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/JobSystem.hpp"
 #include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/core/SPSCQueue.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
+#include "vulkan_template/vulkan/ReadbackService.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include "vulkan_template/vulkan/WorkgroupAutotuner.hpp"
 #include <GLFW/glfw3.h>
-#include <chrono>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
 #include <functional>
 #include <glm/vec2.hpp>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
 #include <thread>
 #include <utility>
+#include <vector>
 
-namespace vkt
+namespace detail
 {
-struct RenderTarget;
-} // namespace vkt
+// Caches are rebuilt when missing, so they are kept apart from the sources in
+// the directory named by CACHE_DIRECTORY_VARIABLE, or DEFAULT_CACHE_DIRECTORY
+// under the working directory when it is unset.
+char const* const CACHE_DIRECTORY_VARIABLE{"VKT_CACHE_DIR"};
+char const* const DEFAULT_CACHE_DIRECTORY{"cache"};
 
-namespace detail
+char const* const FONT_ATLAS_CACHE_NAME{"font_atlas_cache.bin"};
+char const* const WORKGROUP_CACHE_NAME{"workgroup_cache.txt"};
+
+// Creates the cache directory if needed. On failure the path is still
+// returned, and the cache fails to write and is rebuilt on the next run.
+auto cachePath(std::string_view const name) -> std::filesystem::path
 {
+    std::filesystem::path directory{DEFAULT_CACHE_DIRECTORY};
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    if (char const* const variable{std::getenv(CACHE_DIRECTORY_VARIABLE)};
+        variable != nullptr && *variable != '\0')
+    {
+        directory = variable;
+    }
+
+    std::error_code error{};
+    std::filesystem::create_directories(directory, error);
+    if (error)
+    {
+        VKT_WARNING(
+            "Failed to create cache directory '{}': {}",
+            directory.string(),
+            error.message()
+        );
+    }
+
+    return directory / name;
+}
+
 struct Resources
 {
+    // Destroyed last, so jobs may still reference the other resources
+    vkt::JobSystem jobSystem;
     vkt::PlatformWindow window;
     vkt::GraphicsContext graphics;
     vkt::Swapchain swapchain;
@@ -34,19 +88,96 @@ struct Resources
     vkt::UILayer uiLayer;
     vkt::Renderer renderer;
     vkt::PostProcess postProcess;
+    vkt::ReadbackService readback;
 };
 struct Config
 {
     // As a post process step, encode main render target to sRGB
     bool postProcessLinearToSRGB{true};
+
+    // Only draw frames after input arrives, or while the UI or scene is
+    // changing on its own. Otherwise the main loop blocks on window events.
+    bool renderOnDemand{true};
+
+    // Capture every frame drawn, which also keeps frames drawing
+    bool recordSequence{false};
 };
 
+// Failing to tune is not fatal, since the shaders keep their default sizes.
+void autotuneWorkgroups(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::Renderer& renderer,
+    vkt::PostProcess& postProcess
+)
+{
+    std::optional<vkt::WorkgroupAutotuner> autotunerResult{
+        vkt::WorkgroupAutotuner::create(
+            graphicsContext.physicalDevice(),
+            graphicsContext.device(),
+            graphicsContext.universalQueue(),
+            graphicsContext.universalQueueFamily(),
+            cachePath(WORKGROUP_CACHE_NAME)
+        )
+    };
+    if (!autotunerResult.has_value())
+    {
+        VKT_WARNING("Failed to create workgroup autotuner.");
+        return;
+    }
+
+    // Benchmark at a typical full-screen resolution
+    VkExtent2D constexpr BENCHMARK_EXTENT{1920, 1080};
+    std::optional<vkt::RenderTarget> benchmarkTargetResult{
+        vkt::RenderTarget::create(
+            graphicsContext.device(),
+            graphicsContext.allocator(),
+            graphicsContext.bindlessHeap(),
+            vkt::RenderTarget::CreateParameters{
+                .max = BENCHMARK_EXTENT,
+                .color = VK_FORMAT_R16G16B16A16_UNORM,
+                .depth = VK_FORMAT_D32_SFLOAT,
+            }
+        )
+    };
+    if (!benchmarkTargetResult.has_value())
+    {
+        VKT_WARNING("Failed to create workgroup autotuning target.");
+        return;
+    }
+    vkt::RenderTarget& benchmarkTarget{benchmarkTargetResult.value()};
+    benchmarkTarget.setSize(VkRect2D{.extent = BENCHMARK_EXTENT});
+
+    renderer.autotune(
+        autotunerResult.value(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        benchmarkTarget
+    );
+    postProcess.autotune(
+        autotunerResult.value(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        benchmarkTarget
+    );
+}
+
 auto initialize() -> std::optional<Resources>
 {
     VkExtent2D constexpr TEXTURE_MAX{4096, 4096};
 
     VKT_INFO("Initializing Editor resources...");
 
+    VKT_INFO("Creating Job System...");
+
+    std::optional<vkt::JobSystem> jobSystemResult{
+        vkt::JobSystem::create(vkt::JobSystem::defaultWorkerCount())
+    };
+    if (!jobSystemResult.has_value())
+    {
+        VKT_ERROR("Failed to create job system.");
+        return std::nullopt;
+    }
+
     VKT_INFO("Creating window...");
 
     glm::u16vec2 constexpr DEFAULT_WINDOW_EXTENT{1920, 1080};
@@ -89,7 +220,9 @@ auto initialize() -> std::optional<Resources>
     VKT_INFO("Creating Frame Buffer...");
 
     std::optional<vkt::FrameBuffer> frameBufferResult{vkt::FrameBuffer::create(
-        graphicsContext.device(), graphicsContext.universalQueueFamily()
+        graphicsContext.device(),
+        graphicsContext.universalQueueFamily(),
+        vkt::recordingThreadCount(jobSystemResult.value())
     )};
     if (!frameBufferResult.has_value())
     {
@@ -104,11 +237,13 @@ auto initialize() -> std::optional<Resources>
         graphicsContext.physicalDevice(),
         graphicsContext.device(),
         graphicsContext.allocator(),
+        graphicsContext.bindlessHeap(),
         TEXTURE_MAX,
         graphicsContext.universalQueueFamily(),
         graphicsContext.universalQueue(),
-        windowResult.value(),
-        vkt::UIPreferences{}
+        &windowResult.value(),
+        vkt::UIPreferences{},
+        cachePath(FONT_ATLAS_CACHE_NAME)
     )};
     if (!uiLayerResult.has_value())
     {
@@ -119,7 +254,11 @@ auto initialize() -> std::optional<Resources>
     VKT_INFO("Creating Renderer...");
 
     std::optional<vkt::Renderer> rendererResult{
-        vkt::Renderer::create(graphicsContext.device())
+        vkt::Renderer::create(
+            graphicsContext.device(),
+            graphicsContext.bindlessHeap(),
+            graphicsContext.descriptorLayoutCache()
+        )
     };
     if (!rendererResult.has_value())
     {
@@ -130,7 +269,13 @@ auto initialize() -> std::optional<Resources>
     VKT_INFO("Creating Post Processor...");
 
     std::optional<vkt::PostProcess> postProcessResult{
-        vkt::PostProcess::create(graphicsContext.device())
+        vkt::PostProcess::create(
+            graphicsContext.device(),
+            graphicsContext.allocator(),
+            graphicsContext.bindlessHeap(),
+            graphicsContext.descriptorLayoutCache(),
+            vkt::SRGBEncoding::EXACT
+        )
     };
     if (!postProcessResult.has_value())
     {
@@ -138,9 +283,33 @@ auto initialize() -> std::optional<Resources>
         return std::nullopt;
     }
 
+    VKT_INFO("Creating Readback Service...");
+
+    // Enough for consecutive captures while earlier ones are still encoding
+    uint32_t constexpr READBACK_STAGING_BUFFERS{6};
+    std::optional<vkt::ReadbackService> readbackResult{
+        vkt::ReadbackService::create(
+            graphicsContext.allocator(),
+            READBACK_STAGING_BUFFERS,
+            static_cast<uint32_t>(vkt::FrameBuffer::FRAMES_IN_FLIGHT)
+        )
+    };
+    if (!readbackResult.has_value())
+    {
+        VKT_ERROR("Failed to create readback service.");
+        return std::nullopt;
+    }
+
+    VKT_INFO("Autotuning compute workgroup sizes...");
+
+    autotuneWorkgroups(
+        graphicsContext, rendererResult.value(), postProcessResult.value()
+    );
+
     VKT_INFO("Successfully initialized Editor resources.");
 
     return Resources{
+        .jobSystem = std::move(jobSystemResult).value(),
         .window = std::move(windowResult).value(),
         .graphics = std::move(graphicsResult).value(),
         .swapchain = std::move(swapchainResult).value(),
@@ -148,6 +317,7 @@ auto initialize() -> std::optional<Resources>
         .uiLayer = std::move(uiLayerResult).value(),
         .renderer = std::move(rendererResult).value(),
         .postProcess = std::move(postProcessResult).value(),
+        .readback = std::move(readbackResult).value(),
     };
 }
 
@@ -157,45 +327,176 @@ enum class LoopResult
     FATAL_ERROR
 };
 
-auto mainLoop(Resources& resources, Config& config) -> LoopResult
+// Everything the render thread needs to record and present one frame. The main
+// thread builds the next packet while the render thread records this one.
+struct FramePacket
+{
+    // Asks the render thread to exit once every earlier packet is recorded
+    bool stop{false};
+
+    bool postProcessLinearToSRGB{true};
+    bool captureFrame{false};
+
+    // Empty when the scene viewport is hidden
+    std::optional<vkt::SceneViewport> sceneViewport{};
+    vkt::UIFrame ui{};
+};
+
+// A single packet lets the main thread build one frame ahead of the render
+// thread, without adding more than a frame of input latency.
+using FramePacketQueue = vkt::SPSCQueue<FramePacket, 1>;
+
+// Once every per-frame buffer has grown to fit, building and recording a frame
+// should only reuse memory.
+size_t constexpr ALLOCATION_WARMUP_FRAMES{16};
+
+// Runs on the main thread, since ImGui reads input from GLFW.
+auto buildFrame(Resources& resources, Config& config, size_t const frameNumber)
+    -> FramePacket
+{
+    vkt::UILayer& uiLayer{resources.uiLayer};
+
+    FramePacket packet{};
+
+    vkt::DockingLayout const& dockingLayout{uiLayer.begin()};
+
+    // Rebuilding the docking layout or reloading preferences in begin() is
+    // rare and allocates, so the check starts after it.
+    std::optional<vkt::HeapAllocationCheck> allocationCheck{};
+    if (frameNumber >= ALLOCATION_WARMUP_FRAMES)
+    {
+        allocationCheck.emplace("Frame building");
+    }
+
+    uiLayer.HUDMenuToggle(
+        "Display", "Post-Process Linear to sRGB", config.postProcessLinearToSRGB
+    );
+    uiLayer.HUDMenuToggle("Display", "Render On Demand", config.renderOnDemand);
+    bool const captureRequested{uiLayer.HUDMenuItem("Capture", "Save Frame")};
+    uiLayer.HUDMenuToggle("Capture", "Record Sequence", config.recordSequence);
+
+    packet.sceneViewport = uiLayer.sceneViewport();
+
+    packet.ui = uiLayer.end();
+
+    packet.postProcessLinearToSRGB = config.postProcessLinearToSRGB;
+    packet.captureFrame = captureRequested || config.recordSequence;
+
+    return packet;
+}
+
+// Encoded output goes to PNG, while linear output goes to EXR, which expects
+// linear values.
+void recordCapture(
+    vkt::ReadbackService& readback,
+    VkCommandBuffer const cmd,
+    vkt::RenderTarget& output,
+    size_t const frameNumber,
+    bool const encodedSRGB
+)
+{
+    readback.recordCopy(
+        cmd,
+        output.color().image(),
+        output.size(),
+        [frameNumber, encodedSRGB](vkt::ReadbackResult const& result)
+    {
+        if (result.format != VK_FORMAT_R16G16B16A16_UNORM)
+        {
+            VKT_ERROR(
+                "Captures of format {} are not supported.",
+                string_VkFormat(result.format)
+            );
+            return;
+        }
+
+        vkt::ImageRGBA16 const image{
+            .width = result.extent.width,
+            .height = result.extent.height,
+            .texels = std::span<uint16_t const>{
+                reinterpret_cast<uint16_t const*>(result.texels.data()),
+                result.texels.size() / sizeof(uint16_t)
+            },
+        };
+        std::string const path{fmt::format(
+            "capture_{:06}.{}", frameNumber, encodedSRGB ? "png" : "exr"
+        )};
+        if (vkt::writeImageFile(path, image))
+        {
+            VKT_INFO("Saved capture to '{}'.", path);
+        }
+    }
+    );
+}
+
+// Runs on the render thread. Resources touched here must not be touched by
+// buildFrame.
+auto renderFrame(Resources& resources, FramePacket& packet) -> LoopResult
 {
     vkt::GraphicsContext& graphicsContext{resources.graphics};
     vkt::Swapchain& swapchain{resources.swapchain};
+    vkt::JobSystem& jobSystem{resources.jobSystem};
     vkt::FrameBuffer& frameBuffer{resources.frameBuffer};
     vkt::UILayer& uiLayer{resources.uiLayer};
-    vkt::Renderer const& renderer{resources.renderer};
     vkt::PostProcess& postProcess{resources.postProcess};
 
+    // Resizing is rare and rebuilds the swapchain, so it is left out.
+    std::optional<vkt::HeapAllocationCheck> allocationCheck{};
+    if (frameBuffer.frameNumber() >= ALLOCATION_WARMUP_FRAMES)
+    {
+        allocationCheck.emplace("Frame recording");
+    }
+
     if (VkResult const beginFrameResult{frameBuffer.beginNewFrame()};
         beginFrameResult != VK_SUCCESS)
     {
         VKT_LOG_VK(beginFrameResult, "Failed to begin frame.");
         return LoopResult::FATAL_ERROR;
     }
-    VkCommandBuffer const cmd{frameBuffer.currentFrame().mainCommandBuffer};
+    vkt::Frame& frame{frameBuffer.currentFrame()};
+    VkCommandBuffer const cmd{frame.mainCommandBuffer};
+
+    // The frame's fence has been waited on, so slots and ring memory released
+    // that many frames ago can be recycled.
+    vkt::BindlessHeap& bindlessHeap{graphicsContext.bindlessHeap()};
+    bindlessHeap.advanceFrame();
+    graphicsContext.frameDataRing().advanceFrame();
+    resources.readback.advanceFrame(jobSystem);
+    bindlessHeap.bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
 
+    if (packet.sceneViewport.has_value())
     {
-        vkt::DockingLayout const& dockingLayout{uiLayer.begin()};
+        vkt::SceneViewport const& sceneViewport{packet.sceneViewport.value()};
 
-        uiLayer.HUDMenuToggle(
-            "Display",
-            "Post-Process Linear to sRGB",
-            config.postProcessLinearToSRGB
-        );
+        vkt::RenderTarget& sceneTexture{sceneViewport.texture};
+        sceneTexture.setSize(sceneViewport.textureRegion);
 
-        std::optional<vkt::SceneViewport> sceneViewport{uiLayer.sceneViewport()
+        // Each viewport or independent pass can be recorded on its own thread.
+        // Captures are kept to two references so the pass does not allocate.
+        std::array<vkt::RecordingPass, 1> const scenePasses{
+            [&resources, &sceneTexture](
+                VkCommandBuffer const passCmd, vkt::DescriptorAllocator&
+            )
+        {
+            resources.graphics.bindlessHeap().bind(
+                passCmd, VK_PIPELINE_BIND_POINT_COMPUTE
+            );
+            resources.renderer.recordDraw(passCmd, sceneTexture);
+        }
         };
 
-        if (sceneViewport.has_value())
+        if (VkResult const recordResult{vkt::recordParallel(
+                jobSystem, graphicsContext.device(), frame, cmd, scenePasses
+            )};
+            recordResult != VK_SUCCESS)
         {
-            renderer.recordDraw(cmd, sceneViewport.value().texture);
+            VKT_LOG_VK(recordResult, "Failed to record scene passes.");
+            return LoopResult::FATAL_ERROR;
         }
-
-        uiLayer.end();
     }
 
     std::optional<std::reference_wrapper<vkt::RenderTarget>> uiOutput{
-        uiLayer.recordDraw(cmd)
+        uiLayer.recordDraw(cmd, packet.ui)
     };
 
     if (!uiOutput.has_value())
@@ -206,16 +507,31 @@ auto mainLoop(Resources& resources, Config& config) -> LoopResult
         return LoopResult::FATAL_ERROR;
     }
 
-    if (config.postProcessLinearToSRGB)
+    if (packet.postProcessLinearToSRGB)
     {
         postProcess.recordLinearToSRGB(cmd, uiOutput.value());
     }
 
+    if (packet.captureFrame)
+    {
+        // Staging buffers are allocated on first use
+        allocationCheck.reset();
+        recordCapture(
+            resources.readback,
+            cmd,
+            uiOutput.value(),
+            frameBuffer.frameNumber(),
+            packet.postProcessLinearToSRGB
+        );
+    }
+
     if (VkResult const endFrameResult{frameBuffer.finishFrameWithPresent(
             swapchain, graphicsContext.universalQueue(), uiOutput.value()
         )};
         endFrameResult != VK_SUCCESS)
     {
+        allocationCheck.reset();
+
         if (endFrameResult != VK_ERROR_OUT_OF_DATE_KHR)
         {
             VKT_LOG_VK(
@@ -238,11 +554,43 @@ auto mainLoop(Resources& resources, Config& config) -> LoopResult
     return LoopResult::CONTINUE;
 }
 
-auto runApp() -> vkt::RunResult
+// Records and presents packets until one asks to stop. After a fatal error,
+// packets are still taken so the main thread never blocks on a full queue, but
+// they are dropped.
+void renderLoop(
+    Resources& resources, FramePacketQueue& packets, std::atomic<bool>& failed
+)
+{
+    while (true)
+    {
+        FramePacket packet{packets.pop()};
+        if (packet.stop)
+        {
+            return;
+        }
+
+        if (failed.load())
+        {
+            continue;
+        }
+
+        if (renderFrame(resources, packet) == LoopResult::FATAL_ERROR)
+        {
+            failed.store(true);
+        }
+    }
+}
+
+// Whether a frame should be drawn even if no events arrive.
+auto continuousRedraw(Resources const& resources, Config const& config) -> bool
 {
-    // For usage of time suffixes i.e. 1ms
-    using namespace std::chrono_literals;
+    return !config.renderOnDemand || config.recordSequence
+        || resources.renderer.animating()
+        || resources.uiLayer.wantsRedraw();
+}
 
+auto runApp() -> vkt::RunResult
+{
     std::optional<Resources> resourcesResult{detail::initialize()};
     if (!resourcesResult.has_value())
     {
@@ -257,33 +605,156 @@ auto runApp() -> vkt::RunResult
 
     vkt::RunResult runResult{vkt::RunResult::SUCCESS};
 
+    // The UI settles over a few frames after an event, such as hover
+    // highlights catching up to the cursor or popups opening.
+    uint32_t constexpr REDRAW_FRAMES_AFTER_EVENTS{3};
+    // Wake up this often while idle, in case something started animating
+    // without an event.
+    double constexpr IDLE_WAIT_SECONDS{0.25};
+
+    uint32_t redrawFrames{REDRAW_FRAMES_AFTER_EVENTS};
+    size_t builtFrames{0};
+
+    // Recording and presenting happen on their own thread, so the main thread
+    // can handle input and build the next frame's UI in the meantime.
+    FramePacketQueue packets{};
+    std::atomic<bool> renderFailed{false};
+    std::thread renderThread{
+        [&]() { renderLoop(resources, packets, renderFailed); }
+    };
+
     while (glfwWindowShouldClose(resources.window.handle()) == GLFW_FALSE)
     {
-        glfwPollEvents();
+        if (renderFailed.load())
+        {
+            runResult = vkt::RunResult::FAILURE;
+            break;
+        }
 
         if (glfwGetWindowAttrib(resources.window.handle(), GLFW_ICONIFIED)
             == GLFW_TRUE)
         {
-            std::this_thread::sleep_for(1ms);
+            // Nothing is visible, so block until the window is restored
+            glfwWaitEvents();
             continue;
         }
 
-        LoopResult const loopResult{mainLoop(resourcesResult.value(), config)};
-        switch (loopResult)
+        bool const continuous{continuousRedraw(resources, config)};
+        if (continuous || redrawFrames > 0)
+        {
+            glfwPollEvents();
+        }
+        else
+        {
+            glfwWaitEventsTimeout(IDLE_WAIT_SECONDS);
+        }
+
+        // Such as jobs from workers that need to call GLFW or ImGui
+        resources.jobSystem.runMainThreadJobs();
+
+        if (resources.window.takeEventActivity())
+        {
+            redrawFrames = REDRAW_FRAMES_AFTER_EVENTS;
+        }
+
+        if (!continuous && redrawFrames == 0)
         {
-        case LoopResult::CONTINUE:
             continue;
-        case LoopResult::FATAL_ERROR:
-            runResult = vkt::RunResult::FAILURE;
-            break;
         }
+        if (redrawFrames > 0)
+        {
+            redrawFrames--;
+        }
+
+        // Blocks while the render thread is still a full frame behind
+        packets.push(buildFrame(resources, config, builtFrames));
+        builtFrames++;
     }
 
+    packets.push(FramePacket{.stop = true});
+    renderThread.join();
+
     vkDeviceWaitIdle(resources.graphics.device());
 
+    // Captures from the last frames only retire here
+    resources.readback.flush(resources.jobSystem);
+
     return runResult;
 }
 
+struct HeadlessResources
+{
+    // Destroyed last, so jobs may still reference the other resources
+    vkt::JobSystem jobSystem;
+    vkt::GraphicsContext graphics;
+    vkt::Renderer renderer;
+};
+
+auto initializeHeadless() -> std::optional<HeadlessResources>
+{
+    std::optional<vkt::GraphicsContext> graphicsResult{
+        vkt::GraphicsContext::createHeadless()
+    };
+    if (!graphicsResult.has_value())
+    {
+        VKT_ERROR("Failed to create headless graphics context.");
+        return std::nullopt;
+    }
+    vkt::GraphicsContext& graphicsContext{graphicsResult.value()};
+
+    // Jobs only run on this thread, so readback callbacks run in order
+    std::optional<vkt::JobSystem> jobSystemResult{vkt::JobSystem::create(0)};
+    if (!jobSystemResult.has_value())
+    {
+        VKT_ERROR("Failed to create job system.");
+        return std::nullopt;
+    }
+
+    // Left untuned, so outputs do not depend on the workgroup cache
+    std::optional<vkt::Renderer> rendererResult{vkt::Renderer::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache()
+    )};
+    if (!rendererResult.has_value())
+    {
+        VKT_ERROR("Failed to create renderer.");
+        return std::nullopt;
+    }
+
+    return HeadlessResources{
+        .jobSystem = std::move(jobSystemResult).value(),
+        .graphics = std::move(graphicsResult).value(),
+        .renderer = std::move(rendererResult).value(),
+    };
+}
+
+// Written by the cooked_assets build target. Until it exists, assets are loaded
+// from loose files instead.
+char const* const COOKED_ASSETS_PATH{"cooked/assets.vkta"};
+
+void mountCookedAssets()
+{
+    if (!std::filesystem::exists(COOKED_ASSETS_PATH))
+    {
+        VKT_INFO(
+            "No cooked assets at '{}', loading loose files.", COOKED_ASSETS_PATH
+        );
+        return;
+    }
+
+    std::optional<vkt::AssetArchive> archive{
+        vkt::AssetArchive::open(COOKED_ASSETS_PATH)
+    };
+    if (!archive.has_value())
+    {
+        VKT_WARNING("Failed to open cooked assets, loading loose files.");
+        return;
+    }
+
+    vkt::mountAssetArchive(std::move(archive));
+    VKT_INFO("Mounted cooked assets at '{}'.", COOKED_ASSETS_PATH);
+}
 } // namespace detail
 
 namespace vkt
@@ -293,6 +764,8 @@ auto run() -> RunResult
     vkt::Logger::initLogging();
     VKT_INFO("Logging initialized.");
 
+    detail::mountCookedAssets();
+
     if (glfwInit() != GLFW_TRUE)
     {
         VKT_ERROR("Failed to initialize GLFW.");
@@ -305,4 +778,322 @@ auto run() -> RunResult
 
     return result;
 }
+
+auto runGoldenImages(
+    std::filesystem::path const& referenceDirectory,
+    bool const updateReferences
+) -> RunResult
+{
+    vkt::Logger::initLogging();
+    VKT_INFO("Logging initialized.");
+
+    detail::mountCookedAssets();
+
+    std::optional<detail::HeadlessResources> resourcesResult{
+        detail::initializeHeadless()
+    };
+    if (!resourcesResult.has_value())
+    {
+        return RunResult::FAILURE;
+    }
+    detail::HeadlessResources& resources{resourcesResult.value()};
+    vkt::GraphicsContext& graphicsContext{resources.graphics};
+
+    std::optional<vkt::PostProcess> postProcessResult{vkt::PostProcess::create(
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        vkt::SRGBEncoding::EXACT
+    )};
+    if (!postProcessResult.has_value())
+    {
+        VKT_ERROR("Failed to create post process instance.");
+        return RunResult::FAILURE;
+    }
+
+    // About one step of an 8-bit value, enough to absorb differences in
+    // rounding between drivers
+    uint16_t constexpr TOLERANCE{256};
+
+    std::vector<vkt::GoldenImageCase> const cases{
+        vkt::defaultGoldenImageCases()
+    };
+    std::vector<vkt::GoldenImageResult> results{vkt::runGoldenImageCases(
+        graphicsContext,
+        resources.jobSystem,
+        resources.renderer,
+        postProcessResult.value(),
+        cases,
+        vkt::GoldenImageOptions{
+            .referenceDirectory = referenceDirectory,
+            .updateReferences = updateReferences,
+            .tolerance = TOLERANCE,
+        }
+    )};
+
+    // A typical window, a smaller 4:3 one, and an odd size, so the docked
+    // layout places the scene viewport at several sizes and offsets
+    std::array<VkExtent2D, 3> constexpr UI_EXTENTS{{
+        {1280, 720},
+        {800, 600},
+        {1031, 577},
+    }};
+    // Text uses ImGui's built-in font, but its rasterizer may still move
+    // antialiased edges between ImGui versions
+    double constexpr UI_EXCEEDING_FRACTION{0.005};
+    for (VkExtent2D const uiExtent : UI_EXTENTS)
+    {
+        std::optional<vkt::UILayer> uiLayerResult{vkt::UILayer::create(
+            graphicsContext.instance(),
+            graphicsContext.physicalDevice(),
+            graphicsContext.device(),
+            graphicsContext.allocator(),
+            graphicsContext.bindlessHeap(),
+            uiExtent,
+            graphicsContext.universalQueueFamily(),
+            graphicsContext.universalQueue(),
+            nullptr,
+            vkt::UIPreferences{},
+            detail::cachePath(detail::FONT_ATLAS_CACHE_NAME)
+        )};
+        if (!uiLayerResult.has_value())
+        {
+            VKT_ERROR("Failed to create headless UI Layer.");
+            return RunResult::FAILURE;
+        }
+        results.push_back(vkt::runUIFrameCase(
+            graphicsContext,
+            resources.jobSystem,
+            resources.renderer,
+            uiLayerResult.value(),
+            vkt::GoldenImageOptions{
+                .referenceDirectory = referenceDirectory,
+                .updateReferences = updateReferences,
+                .tolerance = TOLERANCE,
+                .exceedingFraction = UI_EXCEEDING_FRACTION,
+            }
+        ));
+    }
+
+    vkDeviceWaitIdle(graphicsContext.device());
+
+    size_t failures{0};
+    for (vkt::GoldenImageResult const& result : results)
+    {
+        if (result.passed)
+        {
+            VKT_INFO(
+                "PASS {:<24} gpu {:8.3f} ms  cpu {:8.3f} ms  max diff {}",
+                result.name,
+                result.gpuMilliseconds,
+                result.cpuMilliseconds,
+                result.difference.maxDifference
+            );
+            continue;
+        }
+
+        failures += 1;
+        VKT_ERROR(
+            "FAIL {:<24} gpu {:8.3f} ms  cpu {:8.3f} ms  max diff {}, {} "
+            "values over tolerance",
+            result.name,
+            result.gpuMilliseconds,
+            result.cpuMilliseconds,
+            result.difference.maxDifference,
+            result.difference.exceedingCount
+        );
+    }
+
+    VKT_INFO(
+        "{} of {} golden images passed.",
+        results.size() - failures,
+        results.size()
+    );
+
+    return failures == 0 ? RunResult::SUCCESS : RunResult::FAILURE;
+}
+
+auto checkUITextureRegistry() -> RunResult
+{
+    vkt::Logger::initLogging();
+    VKT_INFO("Logging initialized.");
+
+    detail::mountCookedAssets();
+
+    std::optional<detail::HeadlessResources> resourcesResult{
+        detail::initializeHeadless()
+    };
+    if (!resourcesResult.has_value())
+    {
+        return RunResult::FAILURE;
+    }
+    vkt::GraphicsContext& graphicsContext{resourcesResult.value().graphics};
+
+    // Only initializes the UI backend that the registry allocates sets with
+    VkExtent2D constexpr UI_EXTENT{64, 64};
+    std::optional<vkt::UILayer> uiLayerResult{vkt::UILayer::create(
+        graphicsContext.instance(),
+        graphicsContext.physicalDevice(),
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        graphicsContext.bindlessHeap(),
+        UI_EXTENT,
+        graphicsContext.universalQueueFamily(),
+        graphicsContext.universalQueue(),
+        nullptr,
+        vkt::UIPreferences{},
+        detail::cachePath(detail::FONT_ATLAS_CACHE_NAME)
+    )};
+    if (!uiLayerResult.has_value())
+    {
+        VKT_ERROR("Failed to create headless UI Layer.");
+        return RunResult::FAILURE;
+    }
+
+    vkt::GoldenImageResult const result{
+        vkt::runUITextureRegistryCase(graphicsContext)
+    };
+
+    vkDeviceWaitIdle(graphicsContext.device());
+
+    if (!result.passed)
+    {
+        VKT_ERROR("FAIL {}", result.name);
+        return RunResult::FAILURE;
+    }
+    VKT_INFO("PASS {}", result.name);
+
+    return RunResult::SUCCESS;
+}
+
+auto checkKernelInterfaces() -> RunResult
+{
+    vkt::Logger::initLogging();
+    VKT_INFO("Logging initialized.");
+
+    detail::mountCookedAssets();
+
+    bool passed{true};
+    passed &= vkt::Renderer::checkKernelInterfaces();
+    passed &= vkt::PostProcess::checkKernelInterfaces();
+    passed &= vkt::checkCharacterizationKernelInterfaces();
+
+    if (!passed)
+    {
+        VKT_ERROR("Compute kernel interfaces do not match the host.");
+        return RunResult::FAILURE;
+    }
+    VKT_INFO("Compute kernel interfaces match the host.");
+
+    return RunResult::SUCCESS;
+}
+
+auto compareSRGBEncodings() -> RunResult
+{
+    vkt::Logger::initLogging();
+    VKT_INFO("Logging initialized.");
+
+    detail::mountCookedAssets();
+
+    std::optional<detail::HeadlessResources> resourcesResult{
+        detail::initializeHeadless()
+    };
+    if (!resourcesResult.has_value())
+    {
+        return RunResult::FAILURE;
+    }
+    detail::HeadlessResources& resources{resourcesResult.value()};
+
+    // A typical full-screen resolution, where the red and green channels
+    // together cover most of the 16-bit range
+    VkExtent2D constexpr EXTENT{1920, 1080};
+    size_t constexpr SAMPLE_COUNT{15};
+
+    std::vector<vkt::SRGBEncodingResult> const results{
+        vkt::compareSRGBEncodings(
+            resources.graphics,
+            resources.jobSystem,
+            resources.renderer,
+            EXTENT,
+            SAMPLE_COUNT
+        )
+    };
+
+    vkDeviceWaitIdle(resources.graphics.device());
+
+    for (vkt::SRGBEncodingResult const& result : results)
+    {
+        VKT_INFO(
+            "{:>10}: gpu {:8.4f} ms  max error {:>5} ({} values differ)",
+            vkt::srgbEncodingName(result.encoding),
+            result.gpuMilliseconds,
+            result.difference.maxDifference,
+            result.difference.exceedingCount
+        );
+    }
+
+    return results.empty() ? RunResult::FAILURE : RunResult::SUCCESS;
+}
+
+auto runDeviceCharacterization(std::filesystem::path const& profilePath)
+    -> RunResult
+{
+    vkt::Logger::initLogging();
+    VKT_INFO("Logging initialized.");
+
+    detail::mountCookedAssets();
+
+    std::optional<detail::HeadlessResources> resourcesResult{
+        detail::initializeHeadless()
+    };
+    if (!resourcesResult.has_value())
+    {
+        return RunResult::FAILURE;
+    }
+    detail::HeadlessResources& resources{resourcesResult.value()};
+
+    std::optional<vkt::DeviceProfile> const profile{
+        vkt::characterizeDevice(resources.graphics)
+    };
+
+    vkDeviceWaitIdle(resources.graphics.device());
+
+    if (!profile.has_value())
+    {
+        return RunResult::FAILURE;
+    }
+
+    VKT_INFO(
+        "'{}': buffer read {:.1f} GB/s, write {:.1f} GB/s, copy {:.1f} GB/s",
+        profile->deviceName,
+        profile->bufferReadGBps,
+        profile->bufferWriteGBps,
+        profile->bufferCopyGBps
+    );
+    VKT_INFO(
+        "image read {:.1f} GB/s, write {:.1f} GB/s, copy {:.1f} GB/s, shared "
+        "{:.1f} GB/s",
+        profile->imageReadGBps,
+        profile->imageWriteGBps,
+        profile->imageCopyGBps,
+        profile->sharedMemoryGBps
+    );
+    VKT_INFO(
+        "ALU {:.1f} GFLOP/s, ridge {:.2f} FLOP/byte, dispatch {:.2f} us, "
+        "barrier {:.2f} us",
+        profile->aluGFlops,
+        profile->ridgeFlopsPerByte(),
+        profile->dispatchMicroseconds,
+        profile->barrierMicroseconds
+    );
+
+    if (!vkt::writeDeviceProfile(profilePath, profile.value()))
+    {
+        return RunResult::FAILURE;
+    }
+    VKT_INFO("Wrote device profile to '{}'.", profilePath.string());
+
+    return RunResult::SUCCESS;
+}
 } // namespace vkt
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "vulkan_template/core/Log.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <algorithm>
 #include <cmath>
 #include <glm/common.hpp>
 #include <utility>
@@ -102,6 +103,35 @@ auto DescriptorLayoutBuilder::build(
     return set;
 }
 
+auto DescriptorLayoutBuilder::build(
+    DescriptorLayoutCache& cache,
+    VkDescriptorSetLayoutCreateFlags const layoutFlags
+) const -> std::optional<VkDescriptorSetLayout>
+{
+    return cache.getSetLayout(describe(layoutFlags));
+}
+
+auto DescriptorLayoutBuilder::describe(
+    VkDescriptorSetLayoutCreateFlags const layoutFlags
+) const -> DescriptorSetLayoutDescription
+{
+    DescriptorSetLayoutDescription description{.flags = layoutFlags};
+
+    for (Binding const& inBinding : m_bindings)
+    {
+        description.bindings.push_back({
+            .binding = inBinding.binding.binding,
+            .type = inBinding.binding.descriptorType,
+            .count = inBinding.binding.descriptorCount,
+            .stageMask = inBinding.binding.stageFlags,
+            .bindingFlags = inBinding.flags,
+            .immutableSamplers = inBinding.immutableSamplers,
+        });
+    }
+
+    return description;
+}
+
 DescriptorAllocator::DescriptorAllocator(DescriptorAllocator&& other) noexcept
 {
     *this = std::move(other);
@@ -113,7 +143,14 @@ auto DescriptorAllocator::operator=(DescriptorAllocator&& other) noexcept
     destroy();
 
     m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
-    m_pool = std::exchange(other.m_pool, VK_NULL_HANDLE);
+    m_flags = std::exchange(other.m_flags, 0);
+    m_ratios = std::move(other.m_ratios);
+    m_setsPerPool = std::exchange(other.m_setsPerPool, 0);
+    m_readyPools = std::move(other.m_readyPools);
+    m_fullPools = std::move(other.m_fullPools);
+
+    other.m_readyPools.clear();
+    other.m_fullPools.clear();
 
     return *this;
 }
@@ -122,65 +159,158 @@ DescriptorAllocator::~DescriptorAllocator() { destroy(); }
 
 auto DescriptorAllocator::create(
     VkDevice device,
-    uint32_t maxSets,
+    uint32_t initialSetsPerPool,
     std::span<PoolSizeRatio const> poolRatios,
     VkDescriptorPoolCreateFlags flags
 ) -> DescriptorAllocator
 {
-    std::vector<VkDescriptorPoolSize> poolSizes{};
-    for (PoolSizeRatio const& ratio : poolRatios)
-    {
-        auto const descriptorCount{static_cast<uint32_t>(
-            glm::ceil(ratio.ratio * static_cast<float>(maxSets))
-        )};
-
-        poolSizes.push_back(VkDescriptorPoolSize{
-            .type = ratio.type,
-            .descriptorCount = descriptorCount,
-        });
-    }
-
-    VkDescriptorPoolCreateInfo const poolInfo{
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .flags = flags,
-        .maxSets = maxSets,
-        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
-        .pPoolSizes = poolSizes.data(),
+    DescriptorAllocator allocator{
+        device, initialSetsPerPool, poolRatios, flags
     };
 
-    VkDescriptorPool pool{VK_NULL_HANDLE};
-    VKT_CHECK_VK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool));
+    // Create the first pool eagerly, so the common case never allocates a pool
+    // mid-frame.
+    if (!allocator.getReadyPool().has_value())
+    {
+        VKT_ERROR("Failed to create initial descriptor pool.");
+    }
 
-    return DescriptorAllocator{device, pool};
+    return allocator;
 }
 
 void DescriptorAllocator::clearDescriptors(VkDevice const device)
 {
-    VKT_CHECK_VK(vkResetDescriptorPool(device, m_pool, 0));
+    for (VkDescriptorPool const pool : m_readyPools)
+    {
+        VKT_CHECK_VK(vkResetDescriptorPool(device, pool, 0));
+    }
+    for (VkDescriptorPool const pool : m_fullPools)
+    {
+        VKT_CHECK_VK(vkResetDescriptorPool(device, pool, 0));
+        m_readyPools.push_back(pool);
+    }
+    m_fullPools.clear();
 }
 
 auto DescriptorAllocator::allocate(
     VkDevice const device, VkDescriptorSetLayout const layout
 ) -> VkDescriptorSet
 {
-    if (m_pool == VK_NULL_HANDLE)
+    if (m_device == VK_NULL_HANDLE)
     {
-        VKT_ERROR("Descriptor Allocator pool is null.");
+        VKT_ERROR("Descriptor Allocator device is null.");
         return VK_NULL_HANDLE;
     }
 
-    VkDescriptorSetAllocateInfo const allocInfo{
-        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .pNext = nullptr,
-        .descriptorPool = m_pool,
-        .descriptorSetCount = 1,
-        .pSetLayouts = &layout,
+    // Retry once with a fresh pool if the current one runs out. A brand new
+    // pool failing means the layout can never fit, so give up after that.
+    for (size_t attempt{0}; attempt < 2; attempt++)
+    {
+        std::optional<VkDescriptorPool> const poolResult{getReadyPool()};
+        if (!poolResult.has_value())
+        {
+            VKT_ERROR("Descriptor Allocator failed to get a ready pool.");
+            return VK_NULL_HANDLE;
+        }
+
+        VkDescriptorSetAllocateInfo const allocInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .descriptorPool = poolResult.value(),
+            .descriptorSetCount = 1,
+            .pSetLayouts = &layout,
+        };
+
+        VkDescriptorSet set{VK_NULL_HANDLE};
+        VkResult const result{vkAllocateDescriptorSets(device, &allocInfo, &set)
+        };
+
+        if (result == VK_SUCCESS)
+        {
+            return set;
+        }
+
+        if (result != VK_ERROR_OUT_OF_POOL_MEMORY
+            && result != VK_ERROR_FRAGMENTED_POOL)
+        {
+            VKT_LOG_VK(result, "Failed to allocate descriptor set.");
+            return VK_NULL_HANDLE;
+        }
+
+        m_readyPools.pop_back();
+        m_fullPools.push_back(poolResult.value());
+    }
+
+    VKT_ERROR("Descriptor set did not fit in a freshly created pool.");
+    return VK_NULL_HANDLE;
+}
+
+auto DescriptorAllocator::readyPoolCount() const -> size_t
+{
+    return m_readyPools.size();
+}
+
+auto DescriptorAllocator::fullPoolCount() const -> size_t
+{
+    return m_fullPools.size();
+}
+
+auto DescriptorAllocator::getReadyPool() -> std::optional<VkDescriptorPool>
+{
+    if (!m_readyPools.empty())
+    {
+        return m_readyPools.back();
+    }
+
+    std::optional<VkDescriptorPool> const poolResult{createPool(m_setsPerPool)
     };
+    if (!poolResult.has_value())
+    {
+        return std::nullopt;
+    }
 
-    VkDescriptorSet set;
-    VKT_CHECK_VK(vkAllocateDescriptorSets(device, &allocInfo, &set));
+    // Grow, so that allocators that churn through many sets settle on a small
+    // number of large pools.
+    m_setsPerPool = std::min(
+        MAX_SETS_PER_POOL, m_setsPerPool + std::max(m_setsPerPool / 2U, 1U)
+    );
 
-    return set;
+    m_readyPools.push_back(poolResult.value());
+    return poolResult;
+}
+
+auto DescriptorAllocator::createPool(uint32_t const setCount)
+    -> std::optional<VkDescriptorPool>
+{
+    std::vector<VkDescriptorPoolSize> poolSizes{};
+    for (PoolSizeRatio const& ratio : m_ratios)
+    {
+        auto const descriptorCount{static_cast<uint32_t>(
+            glm::ceil(ratio.ratio * static_cast<float>(setCount))
+        )};
+
+        poolSizes.push_back(VkDescriptorPoolSize{
+            .type = ratio.type,
+            .descriptorCount = descriptorCount,
+        });
+    }
+
+    VkDescriptorPoolCreateInfo const poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = m_flags,
+        .maxSets = setCount,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data(),
+    };
+
+    VkDescriptorPool pool{VK_NULL_HANDLE};
+    VKT_TRY_VK(
+        vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &pool),
+        "Failed to create descriptor pool.",
+        std::nullopt
+    );
+
+    return pool;
 }
 
 void DescriptorAllocator::destroy() noexcept
@@ -190,9 +320,17 @@ void DescriptorAllocator::destroy() noexcept
         return;
     }
 
-    vkDestroyDescriptorPool(m_device, m_pool, VK_NULL_HANDLE);
+    for (VkDescriptorPool const pool : m_readyPools)
+    {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+    for (VkDescriptorPool const pool : m_fullPools)
+    {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
 
     m_device = VK_NULL_HANDLE;
-    m_pool = VK_NULL_HANDLE;
+    m_readyPools.clear();
+    m_fullPools.clear();
 }
 } // namespace vkt
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
 #include <optional>
 #include <span>
@@ -30,6 +31,16 @@ struct DescriptorLayoutBuilder
     build(VkDevice device, VkDescriptorSetLayoutCreateFlags layoutFlags) const
         -> std::optional<VkDescriptorSetLayout>;
 
+    // Returns a layout shared through the cache. The cache retains ownership,
+    // so do not destroy the returned layout.
+    auto build(
+        DescriptorLayoutCache& cache,
+        VkDescriptorSetLayoutCreateFlags layoutFlags
+    ) const -> std::optional<VkDescriptorSetLayout>;
+
+    [[nodiscard]] auto describe(VkDescriptorSetLayoutCreateFlags layoutFlags
+    ) const -> DescriptorSetLayoutDescription;
+
 private:
     struct Binding
     {
@@ -41,7 +52,12 @@ private:
     std::vector<Binding> m_bindings{};
 };
 
-// Holds a descriptor pool and allows allocating from it.
+// Allocates descriptor sets from a chain of descriptor pools. When a pool runs
+// out of space it is marked as full, and a new larger pool is created to
+// continue allocating from.
+//
+// This is not thread safe. Each recording thread should own its own instance,
+// so that allocation never needs to take a lock.
 struct DescriptorAllocator
 {
 public:
@@ -51,6 +67,9 @@ public:
         float ratio{0.0F};
     };
 
+    // Newly created pools grow geometrically up to this many sets.
+    static uint32_t constexpr MAX_SETS_PER_POOL{4096U};
+
     DescriptorAllocator() = delete;
 
     DescriptorAllocator(DescriptorAllocator const&) = delete;
@@ -63,25 +82,53 @@ public:
 
     static auto create(
         VkDevice device,
-        uint32_t maxSets,
+        uint32_t initialSetsPerPool,
         std::span<PoolSizeRatio const> poolRatios,
         VkDescriptorPoolCreateFlags flags
     ) -> DescriptorAllocator;
+
+    // Resets every pool and marks them all as ready. This invalidates all sets
+    // previously allocated from this allocator, so it should only be called
+    // once the GPU is done with them, such as when a frame retires.
     void clearDescriptors(VkDevice device);
 
+    // Returns VK_NULL_HANDLE if a new pool was needed and could not be created.
     auto allocate(VkDevice device, VkDescriptorSetLayout layout)
         -> VkDescriptorSet;
 
+    [[nodiscard]] auto readyPoolCount() const -> size_t;
+    [[nodiscard]] auto fullPoolCount() const -> size_t;
+
 private:
-    DescriptorAllocator(VkDevice device, VkDescriptorPool pool)
+    DescriptorAllocator(
+        VkDevice device,
+        uint32_t setsPerPool,
+        std::span<PoolSizeRatio const> poolRatios,
+        VkDescriptorPoolCreateFlags flags
+    )
         : m_device{device}
-        , m_pool{pool}
+        , m_flags{flags}
+        , m_ratios(poolRatios.begin(), poolRatios.end())
+        , m_setsPerPool{setsPerPool}
     {
     }
 
+    // Gets a pool with space remaining, creating one if necessary.
+    auto getReadyPool() -> std::optional<VkDescriptorPool>;
+    auto createPool(uint32_t setCount) -> std::optional<VkDescriptorPool>;
+
     void destroy() noexcept;
 
     VkDevice m_device{VK_NULL_HANDLE};
-    VkDescriptorPool m_pool{VK_NULL_HANDLE};
+    VkDescriptorPoolCreateFlags m_flags{0};
+    std::vector<PoolSizeRatio> m_ratios{};
+
+    // The set capacity of the next pool to be created.
+    uint32_t m_setsPerPool{0};
+
+    // Pools that may still have space. The back is allocated from first.
+    std::vector<VkDescriptorPool> m_readyPools{};
+    // Pools that have returned out of memory, and will not be used until reset.
+    std::vector<VkDescriptorPool> m_fullPools{};
 };
 } // namespace vkt
\ No newline at end of file
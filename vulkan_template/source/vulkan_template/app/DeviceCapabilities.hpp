@@ -0,0 +1,30 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <optional>
+
+namespace vkt
+{
+// Optional capabilities of the selected device, for systems to choose between
+// a faster path and a fallback. Everything else the engine uses is required,
+// so devices without it are never selected. That includes Vulkan 1.3, shader
+// objects, push descriptors, buffer device addresses, and update-after-bind
+// descriptor indexing.
+struct DeviceCapabilities
+{
+    // A queue family with compute but not graphics, whose work can overlap
+    // the universal queue's
+    std::optional<uint32_t> dedicatedComputeQueueFamily{};
+
+    // VK_EXT_host_image_copy, for uploading images from the host without a
+    // staging buffer
+    bool hostImageCopy{false};
+
+    // VK_EXT_memory_budget, so that allocations are checked against the
+    // budget the OS gives the process instead of the heap sizes
+    bool memoryBudget{false};
+
+    // Line widths other than 1.0
+    bool wideLines{false};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,870 @@
+#include "DeviceCharacterization.hpp"
+
+#include "vulkan_template/app/GraphicsContext.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/ComputeKernel.hpp"
+#include "vulkan_template/vulkan/ImageView.hpp"
+#include "vulkan_template/vulkan/TimedSubmitter.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+char const* const BUFFER_SHADER_PATH{"shaders/characterize_buffer.comp.spv"};
+char const* const IMAGE_SHADER_PATH{"shaders/characterize_image.comp.spv"};
+char const* const ALU_SHADER_PATH{"shaders/characterize_alu.comp.spv"};
+char const* const SHARED_SHADER_PATH{"shaders/characterize_shared.comp.spv"};
+char const* const DISPATCH_SHADER_PATH{
+    "shaders/characterize_dispatch.comp.spv"
+};
+
+// Each sample records its workload this many times between timestamps, to
+// amortize timer granularity. The first sample warms up caches and clocks, and
+// is discarded.
+uint32_t constexpr RUNS_PER_SAMPLE{4};
+size_t constexpr SAMPLE_COUNT{7};
+
+// Elements of 16 bytes, for 128MiB per buffer. That is larger than the last
+// level cache of current GPUs, so traffic reaches device memory.
+uint32_t constexpr BUFFER_ELEMENTS{8 * 1024 * 1024};
+double constexpr BUFFER_BYTES{BUFFER_ELEMENTS * 16.0};
+
+// 8 bytes per texel, for 128MiB per image
+VkExtent2D constexpr IMAGE_EXTENT{4096, 4096};
+double constexpr IMAGE_BYTES{IMAGE_EXTENT.width * 8.0 * IMAGE_EXTENT.height};
+
+// Enough workgroups to fill any device several times over
+uint32_t constexpr COMPUTE_INVOCATIONS{1024 * 1024};
+// Must match ITERATIONS in characterize_alu.comp
+double constexpr ALU_FLOPS_PER_INVOCATION{256.0 * 4 * 4 * 2};
+// Must match ITERATIONS in characterize_shared.comp
+double constexpr SHARED_BYTES_PER_INVOCATION{256.0 * 16};
+
+uint32_t constexpr DISPATCH_COUNT{1000};
+
+vkt::WorkgroupSize constexpr LINEAR_WORKGROUP{.x = 256, .y = 1};
+vkt::WorkgroupSize constexpr IMAGE_WORKGROUP{.x = 16, .y = 16};
+vkt::WorkgroupSize constexpr DISPATCH_WORKGROUP{.x = 64, .y = 1};
+
+// Matches MODE in characterize_buffer.comp and characterize_image.comp
+enum class TrafficMode : uint32_t
+{
+    READ,
+    WRITE,
+    COPY,
+};
+
+// Source values are never negative, so reads never match this and the
+// benchmark writes nothing
+float constexpr READ_SENTINEL{-1.0F};
+
+struct BufferPushConstants
+{
+    uint32_t count;
+    float sentinel;
+};
+
+struct ImagePushConstants
+{
+    float sentinel;
+};
+
+struct ALUPushConstants
+{
+    uint32_t count;
+    float multiplier;
+    float addend;
+};
+
+struct SharedPushConstants
+{
+    uint32_t count;
+};
+
+using BufferKernel = vkt::ComputeKernel<
+    BufferPushConstants,
+    vkt::StorageBufferBinding,
+    vkt::StorageBufferBinding>;
+using ImageKernel = vkt::ComputeKernel<
+    ImagePushConstants,
+    vkt::StorageImageBinding,
+    vkt::StorageImageBinding>;
+using ALUKernel =
+    vkt::ComputeKernel<ALUPushConstants, vkt::StorageBufferBinding>;
+using SharedKernel =
+    vkt::ComputeKernel<SharedPushConstants, vkt::StorageBufferBinding>;
+using DispatchKernel = vkt::ComputeKernel<vkt::NoPushConstants>;
+
+// Device memory the benchmarks read and write, freed once the
+// characterization ends. The first of each is the source, and the second the
+// destination.
+struct ScratchMemory
+{
+    ScratchMemory() = default;
+
+    ScratchMemory(ScratchMemory const&) = delete;
+    auto operator=(ScratchMemory const&) -> ScratchMemory& = delete;
+
+    ScratchMemory(ScratchMemory&&) = delete;
+    auto operator=(ScratchMemory&&) -> ScratchMemory& = delete;
+
+    ~ScratchMemory()
+    {
+        for (size_t index{0}; index < buffers.size(); index++)
+        {
+            if (allocations[index] != VK_NULL_HANDLE)
+            {
+                vmaDestroyBuffer(
+                    allocator, buffers[index], allocations[index]
+                );
+            }
+        }
+    }
+
+    VmaAllocator allocator{VK_NULL_HANDLE};
+    std::array<VkBuffer, 2> buffers{};
+    std::array<VmaAllocation, 2> allocations{};
+
+    std::array<std::unique_ptr<vkt::ImageView>, 2> images{};
+};
+
+auto allocateScratch(
+    vkt::GraphicsContext& graphicsContext, ScratchMemory& scratch
+) -> bool
+{
+    scratch.allocator = graphicsContext.allocator();
+
+    VkBufferCreateInfo const bufferInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+
+        .flags = 0,
+
+        .size = static_cast<VkDeviceSize>(BUFFER_BYTES),
+        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+               | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
+    };
+    VmaAllocationCreateInfo const allocationInfo{
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+
+    for (size_t index{0}; index < scratch.buffers.size(); index++)
+    {
+        VKT_TRY_VK(
+            vmaCreateBuffer(
+                scratch.allocator,
+                &bufferInfo,
+                &allocationInfo,
+                &scratch.buffers[index],
+                &scratch.allocations[index],
+                nullptr
+            ),
+            "Failed to allocate device characterization buffer.",
+            false
+        );
+    }
+
+    for (std::unique_ptr<vkt::ImageView>& image : scratch.images)
+    {
+        std::optional<std::unique_ptr<vkt::ImageView>> imageResult{
+            vkt::ImageView::allocate(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                vkt::ImageAllocationParameters{
+                    .extent = IMAGE_EXTENT,
+                    .format = VK_FORMAT_R16G16B16A16_UNORM,
+                    .usageFlags = VK_IMAGE_USAGE_STORAGE_BIT,
+                },
+                vkt::ImageViewAllocationParameters{}
+            )
+        };
+        if (!imageResult.has_value())
+        {
+            VKT_ERROR("Failed to allocate device characterization image.");
+            return false;
+        }
+        image = std::move(imageResult).value();
+    }
+
+    return true;
+}
+
+// Makes the next commands wait on the memory written by the previous ones, as
+// consecutive passes in a frame do.
+void recordBarrier(
+    VkCommandBuffer const cmd,
+    VkPipelineStageFlags2 const srcStage,
+    VkAccessFlags2 const srcAccess
+)
+{
+    VkMemoryBarrier2 const barrier{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = srcStage,
+        .srcAccessMask = srcAccess,
+        .dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT
+                       | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+    };
+    VkDependencyInfo const dependency{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+        .dependencyFlags = 0,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barrier,
+        .bufferMemoryBarrierCount = 0,
+        .pBufferMemoryBarriers = nullptr,
+        .imageMemoryBarrierCount = 0,
+        .pImageMemoryBarriers = nullptr,
+    };
+    vkCmdPipelineBarrier2(cmd, &dependency);
+}
+
+void recordComputeBarrier(VkCommandBuffer const cmd)
+{
+    recordBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT
+    );
+}
+
+// Zeroes the buffers so that reads see known values, and moves the images to
+// the layout storage images are accessed in. Image contents stay undefined,
+// but UNORM values are never negative so they cannot match READ_SENTINEL.
+auto prepareScratch(vkt::TimedSubmitter& submitter, ScratchMemory& scratch)
+    -> bool
+{
+    std::optional<VkCommandBuffer> const beginResult{submitter.begin()};
+    if (!beginResult.has_value())
+    {
+        return false;
+    }
+    VkCommandBuffer const cmd{beginResult.value()};
+
+    for (VkBuffer const buffer : scratch.buffers)
+    {
+        vkCmdFillBuffer(cmd, buffer, 0, VK_WHOLE_SIZE, 0);
+    }
+    for (std::unique_ptr<vkt::ImageView> const& image : scratch.images)
+    {
+        image->recordTransitionBarriered(cmd, VK_IMAGE_LAYOUT_GENERAL);
+    }
+
+    recordBarrier(
+        cmd,
+        VK_PIPELINE_STAGE_2_CLEAR_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT
+    );
+
+    return submitter.submitAndWait() == VK_SUCCESS;
+}
+
+using Workload = std::function<void(VkCommandBuffer)>;
+
+// Returns the median time of one run of workload, with runsPerSample runs per
+// sample. Runs are separated by barriers so that they do not overlap.
+auto medianRunMilliseconds(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    uint32_t const runsPerSample,
+    Workload const& workload
+) -> std::optional<double>
+{
+    std::vector<double> samples{};
+    for (size_t sample{0}; sample <= SAMPLE_COUNT; sample++)
+    {
+        std::optional<VkCommandBuffer> const beginResult{submitter.begin()};
+        if (!beginResult.has_value())
+        {
+            return std::nullopt;
+        }
+        VkCommandBuffer const cmd{beginResult.value()};
+
+        graphicsContext.bindlessHeap().bind(
+            cmd, VK_PIPELINE_BIND_POINT_COMPUTE
+        );
+
+        submitter.writeTimestamp(0);
+        for (uint32_t run{0}; run < runsPerSample; run++)
+        {
+            workload(cmd);
+            recordComputeBarrier(cmd);
+        }
+        submitter.writeTimestamp(1);
+
+        if (submitter.submitAndWait() != VK_SUCCESS)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<double> const milliseconds{
+            submitter.millisecondsBetween(0, 1)
+        };
+        if (!milliseconds.has_value())
+        {
+            return std::nullopt;
+        }
+
+        if (sample > 0)
+        {
+            samples.push_back(milliseconds.value() / runsPerSample);
+        }
+    }
+
+    auto const middle{samples.begin() + samples.size() / 2};
+    std::nth_element(samples.begin(), middle, samples.end());
+    return *middle;
+}
+
+// Units of work per second, in billions. Runs shorter than the timestamp
+// resolution measure as 0, which is reported as 0 rather than infinity.
+auto gigaPerSecond(double const amount, double const milliseconds) -> double
+{
+    if (milliseconds <= 0.0)
+    {
+        return 0.0;
+    }
+    return amount / (milliseconds * 1.0e6);
+}
+
+auto trafficBytes(TrafficMode const mode, double const bytes) -> double
+{
+    // Copies read and write every byte
+    return mode == TrafficMode::COPY ? bytes * 2.0 : bytes;
+}
+
+auto measureBufferBandwidth(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    ScratchMemory const& scratch,
+    TrafficMode const mode
+) -> std::optional<double>
+{
+    std::array<uint32_t, 1> const constants{static_cast<uint32_t>(mode)};
+    std::optional<BufferKernel> const kernel{BufferKernel::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        BUFFER_SHADER_PATH,
+        LINEAR_WORKGROUP,
+        constants
+    )};
+    if (!kernel.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> const milliseconds{medianRunMilliseconds(
+        graphicsContext,
+        submitter,
+        RUNS_PER_SAMPLE,
+        [&](VkCommandBuffer const cmd)
+    {
+        kernel.value().record(
+            cmd,
+            BufferPushConstants{
+                .count = BUFFER_ELEMENTS,
+                .sentinel = READ_SENTINEL,
+            },
+            VkExtent3D{BUFFER_ELEMENTS, 1, 1},
+            vkt::StorageBufferBinding{.buffer = scratch.buffers[0]},
+            vkt::StorageBufferBinding{.buffer = scratch.buffers[1]}
+        );
+    }
+    )};
+    if (!milliseconds.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return gigaPerSecond(
+        trafficBytes(mode, BUFFER_BYTES), milliseconds.value()
+    );
+}
+
+auto measureImageBandwidth(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    ScratchMemory const& scratch,
+    TrafficMode const mode
+) -> std::optional<double>
+{
+    std::array<uint32_t, 1> const constants{static_cast<uint32_t>(mode)};
+    std::optional<ImageKernel> const kernel{ImageKernel::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        IMAGE_SHADER_PATH,
+        IMAGE_WORKGROUP,
+        constants
+    )};
+    if (!kernel.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> const milliseconds{medianRunMilliseconds(
+        graphicsContext,
+        submitter,
+        RUNS_PER_SAMPLE,
+        [&](VkCommandBuffer const cmd)
+    {
+        kernel.value().record(
+            cmd,
+            ImagePushConstants{.sentinel = READ_SENTINEL},
+            VkExtent3D{IMAGE_EXTENT.width, IMAGE_EXTENT.height, 1},
+            vkt::StorageImageBinding{.view = scratch.images[0]->view()},
+            vkt::StorageImageBinding{.view = scratch.images[1]->view()}
+        );
+    }
+    )};
+    if (!milliseconds.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return gigaPerSecond(trafficBytes(mode, IMAGE_BYTES), milliseconds.value());
+}
+
+auto measureALUThroughput(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    ScratchMemory const& scratch
+) -> std::optional<double>
+{
+    std::optional<ALUKernel> const kernel{ALUKernel::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        ALU_SHADER_PATH,
+        LINEAR_WORKGROUP
+    )};
+    if (!kernel.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> const milliseconds{medianRunMilliseconds(
+        graphicsContext,
+        submitter,
+        RUNS_PER_SAMPLE,
+        [&](VkCommandBuffer const cmd)
+    {
+        // Chains converge towards 1, so values never overflow or become
+        // denormal, which would be slower on some devices
+        kernel.value().record(
+            cmd,
+            ALUPushConstants{
+                .count = COMPUTE_INVOCATIONS,
+                .multiplier = 0.999F,
+                .addend = 0.001F,
+            },
+            VkExtent3D{COMPUTE_INVOCATIONS, 1, 1},
+            vkt::StorageBufferBinding{.buffer = scratch.buffers[1]}
+        );
+    }
+    )};
+    if (!milliseconds.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return gigaPerSecond(
+        COMPUTE_INVOCATIONS * ALU_FLOPS_PER_INVOCATION, milliseconds.value()
+    );
+}
+
+auto measureSharedMemoryBandwidth(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    ScratchMemory const& scratch
+) -> std::optional<double>
+{
+    std::optional<SharedKernel> const kernel{SharedKernel::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        SHARED_SHADER_PATH,
+        LINEAR_WORKGROUP
+    )};
+    if (!kernel.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> const milliseconds{medianRunMilliseconds(
+        graphicsContext,
+        submitter,
+        RUNS_PER_SAMPLE,
+        [&](VkCommandBuffer const cmd)
+    {
+        kernel.value().record(
+            cmd,
+            SharedPushConstants{.count = COMPUTE_INVOCATIONS},
+            VkExtent3D{COMPUTE_INVOCATIONS, 1, 1},
+            vkt::StorageBufferBinding{.buffer = scratch.buffers[1]}
+        );
+    }
+    )};
+    if (!milliseconds.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return gigaPerSecond(
+        COMPUTE_INVOCATIONS * SHARED_BYTES_PER_INVOCATION,
+        milliseconds.value()
+    );
+}
+
+// Microseconds per dispatch of a single empty workgroup, so that the time is
+// all launch overhead, and optionally the barrier that follows it.
+auto measureDispatchOverhead(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::TimedSubmitter& submitter,
+    bool const withBarriers
+) -> std::optional<double>
+{
+    std::optional<DispatchKernel> const kernel{DispatchKernel::create(
+        graphicsContext.device(),
+        graphicsContext.bindlessHeap(),
+        graphicsContext.descriptorLayoutCache(),
+        DISPATCH_SHADER_PATH,
+        DISPATCH_WORKGROUP
+    )};
+    if (!kernel.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> const milliseconds{medianRunMilliseconds(
+        graphicsContext,
+        submitter,
+        1,
+        [&](VkCommandBuffer const cmd)
+    {
+        for (uint32_t dispatch{0}; dispatch < DISPATCH_COUNT; dispatch++)
+        {
+            kernel.value().record(
+                cmd,
+                vkt::NoPushConstants{},
+                VkExtent3D{DISPATCH_WORKGROUP.x, DISPATCH_WORKGROUP.y, 1}
+            );
+            if (withBarriers)
+            {
+                recordComputeBarrier(cmd);
+            }
+        }
+    }
+    )};
+    if (!milliseconds.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return milliseconds.value() * 1000.0 / DISPATCH_COUNT;
+}
+
+auto escapeJSON(std::string const& text) -> std::string
+{
+    std::string result{};
+    for (char const character : text)
+    {
+        switch (character)
+        {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20)
+            {
+                result += fmt::format(
+                    "\\u{:04x}", static_cast<unsigned char>(character)
+                );
+            }
+            else
+            {
+                result += character;
+            }
+            break;
+        }
+    }
+    return result;
+}
+} // namespace
+
+namespace vkt
+{
+auto DeviceProfile::ridgeFlopsPerByte() const -> double
+{
+    double const bandwidthGBps{std::max(
+        {bufferReadGBps,
+         bufferWriteGBps,
+         bufferCopyGBps,
+         imageReadGBps,
+         imageWriteGBps,
+         imageCopyGBps}
+    )};
+    if (bandwidthGBps <= 0.0)
+    {
+        return 0.0;
+    }
+    return aluGFlops / bandwidthGBps;
+}
+
+auto characterizeDevice(GraphicsContext& graphicsContext)
+    -> std::optional<DeviceProfile>
+{
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(
+        graphicsContext.physicalDevice(), &properties
+    );
+
+    DeviceProfile profile{
+        .deviceName = properties.deviceName,
+        .vendorID = properties.vendorID,
+        .deviceID = properties.deviceID,
+        .driverVersion = properties.driverVersion,
+    };
+
+    // Around each sample's runs
+    uint32_t constexpr TIMESTAMP_COUNT{2};
+
+    // A dedicated compute queue runs the benchmarks without graphics work
+    // queued ahead of them, as async compute passes would. Not every compute
+    // family can write timestamps, so it is only used if it can time them.
+    std::optional<TimedSubmitter> submitterResult{};
+    if (std::optional<uint32_t> const computeQueueFamily{
+            graphicsContext.capabilities().dedicatedComputeQueueFamily
+        };
+        computeQueueFamily.has_value())
+    {
+        submitterResult = TimedSubmitter::create(
+            graphicsContext.physicalDevice(),
+            graphicsContext.device(),
+            graphicsContext.dedicatedComputeQueue(),
+            computeQueueFamily.value(),
+            TIMESTAMP_COUNT
+        );
+        if (submitterResult.has_value()
+            && submitterResult.value().timestampsSupported())
+        {
+            profile.dedicatedComputeQueue = true;
+        }
+        else
+        {
+            VKT_INFO(
+                "Dedicated compute queue cannot be timed, characterizing on "
+                "the universal queue instead."
+            );
+            submitterResult.reset();
+        }
+    }
+    if (!submitterResult.has_value())
+    {
+        submitterResult = TimedSubmitter::create(
+            graphicsContext.physicalDevice(),
+            graphicsContext.device(),
+            graphicsContext.universalQueue(),
+            graphicsContext.universalQueueFamily(),
+            TIMESTAMP_COUNT
+        );
+    }
+    if (!submitterResult.has_value())
+    {
+        VKT_ERROR("Failed to create device characterization submitter.");
+        return std::nullopt;
+    }
+    TimedSubmitter& submitter{submitterResult.value()};
+
+    if (!submitter.timestampsSupported())
+    {
+        VKT_ERROR(
+            "Queue does not support timestamps, so '{}' cannot be "
+            "characterized.",
+            profile.deviceName
+        );
+        return std::nullopt;
+    }
+
+    ScratchMemory scratch{};
+    if (!allocateScratch(graphicsContext, scratch)
+        || !prepareScratch(submitter, scratch))
+    {
+        return std::nullopt;
+    }
+
+    struct Measurement
+    {
+        char const* name;
+        double& value;
+        std::function<std::optional<double>()> measure;
+    };
+    std::vector<Measurement> const measurements{
+        {"buffer read bandwidth",
+         profile.bufferReadGBps,
+         [&]()
+    {
+        return measureBufferBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::READ
+        );
+    }},
+        {"buffer write bandwidth",
+         profile.bufferWriteGBps,
+         [&]()
+    {
+        return measureBufferBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::WRITE
+        );
+    }},
+        {"buffer copy bandwidth",
+         profile.bufferCopyGBps,
+         [&]()
+    {
+        return measureBufferBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::COPY
+        );
+    }},
+        {"image read bandwidth",
+         profile.imageReadGBps,
+         [&]()
+    {
+        return measureImageBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::READ
+        );
+    }},
+        {"image write bandwidth",
+         profile.imageWriteGBps,
+         [&]()
+    {
+        return measureImageBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::WRITE
+        );
+    }},
+        {"image copy bandwidth",
+         profile.imageCopyGBps,
+         [&]()
+    {
+        return measureImageBandwidth(
+            graphicsContext, submitter, scratch, TrafficMode::COPY
+        );
+    }},
+        {"shared memory bandwidth",
+         profile.sharedMemoryGBps,
+         [&]()
+    {
+        return measureSharedMemoryBandwidth(
+            graphicsContext, submitter, scratch
+        );
+    }},
+        {"ALU throughput",
+         profile.aluGFlops,
+         [&]()
+    { return measureALUThroughput(graphicsContext, submitter, scratch); }},
+        {"dispatch overhead",
+         profile.dispatchMicroseconds,
+         [&]()
+    { return measureDispatchOverhead(graphicsContext, submitter, false); }},
+        {"barrier overhead",
+         profile.barrierMicroseconds,
+         [&]()
+    { return measureDispatchOverhead(graphicsContext, submitter, true); }},
+    };
+
+    for (Measurement const& measurement : measurements)
+    {
+        VKT_INFO("Measuring {}...", measurement.name);
+
+        std::optional<double> const value{measurement.measure()};
+        if (!value.has_value())
+        {
+            VKT_ERROR("Failed to measure {}.", measurement.name);
+            return std::nullopt;
+        }
+        measurement.value = value.value();
+    }
+
+    return profile;
+}
+
+auto checkCharacterizationKernelInterfaces() -> bool
+{
+    std::array<uint32_t, 1> const constants{
+        static_cast<uint32_t>(TrafficMode::READ)
+    };
+
+    bool passed{true};
+    passed &= BufferKernel::checkInterface(BUFFER_SHADER_PATH, constants);
+    passed &= ImageKernel::checkInterface(IMAGE_SHADER_PATH, constants);
+    passed &= ALUKernel::checkInterface(ALU_SHADER_PATH);
+    passed &= SharedKernel::checkInterface(SHARED_SHADER_PATH);
+    passed &= DispatchKernel::checkInterface(DISPATCH_SHADER_PATH);
+    return passed;
+}
+
+auto writeDeviceProfile(
+    std::filesystem::path const& path, DeviceProfile const& profile
+) -> bool
+{
+    std::ofstream file{path, std::ios::trunc};
+    if (!file.is_open())
+    {
+        VKT_ERROR("Unable to write device profile to '{}'.", path.string());
+        return false;
+    }
+
+    file << fmt::format(
+        "{{\n"
+        "    \"deviceName\": \"{}\",\n"
+        "    \"vendorID\": {},\n"
+        "    \"deviceID\": {},\n"
+        "    \"driverVersion\": {},\n"
+        "    \"dedicatedComputeQueue\": {},\n"
+        "    \"bufferReadGBps\": {:.3f},\n"
+        "    \"bufferWriteGBps\": {:.3f},\n"
+        "    \"bufferCopyGBps\": {:.3f},\n"
+        "    \"imageReadGBps\": {:.3f},\n"
+        "    \"imageWriteGBps\": {:.3f},\n"
+        "    \"imageCopyGBps\": {:.3f},\n"
+        "    \"sharedMemoryGBps\": {:.3f},\n"
+        "    \"aluGFlops\": {:.3f},\n"
+        "    \"dispatchMicroseconds\": {:.3f},\n"
+        "    \"barrierMicroseconds\": {:.3f},\n"
+        "    \"ridgeFlopsPerByte\": {:.3f}\n"
+        "}}\n",
+        escapeJSON(profile.deviceName),
+        profile.vendorID,
+        profile.deviceID,
+        profile.driverVersion,
+        profile.dedicatedComputeQueue,
+        profile.bufferReadGBps,
+        profile.bufferWriteGBps,
+        profile.bufferCopyGBps,
+        profile.imageReadGBps,
+        profile.imageWriteGBps,
+        profile.imageCopyGBps,
+        profile.sharedMemoryGBps,
+        profile.aluGFlops,
+        profile.dispatchMicroseconds,
+        profile.barrierMicroseconds,
+        profile.ridgeFlopsPerByte()
+    );
+
+    return file.good();
+}
+} // namespace vkt
\ No newline at end of file
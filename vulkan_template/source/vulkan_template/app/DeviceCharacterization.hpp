@@ -0,0 +1,73 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace vkt
+{
+struct GraphicsContext;
+} // namespace vkt
+
+namespace vkt
+{
+// Measured limits of one device, in the terms of a roofline model: a pass whose
+// arithmetic intensity in FLOPs per byte is below the ridge point is bound by
+// bandwidth, and above it by arithmetic. Bandwidths are in gigabytes (10^9
+// bytes) per second, and count bytes both read and written.
+struct DeviceProfile
+{
+    std::string deviceName{};
+    uint32_t vendorID{0};
+    uint32_t deviceID{0};
+    uint32_t driverVersion{0};
+
+    // Whether the benchmarks ran on a dedicated compute queue rather than the
+    // universal queue
+    bool dedicatedComputeQueue{false};
+
+    // Storage buffers of vec4, each much larger than any device's caches
+    double bufferReadGBps{0.0};
+    double bufferWriteGBps{0.0};
+    double bufferCopyGBps{0.0};
+
+    // Storage images of R16G16B16A16_UNORM, as the render target uses
+    double imageReadGBps{0.0};
+    double imageWriteGBps{0.0};
+    double imageCopyGBps{0.0};
+
+    // Reads of workgroup shared memory
+    double sharedMemoryGBps{0.0};
+
+    // Fused multiply-adds, counted as two FLOPs each
+    double aluGFlops{0.0};
+
+    // Per dispatch of a single workgroup that does nothing, back to back and
+    // then with a compute to compute barrier after each
+    double dispatchMicroseconds{0.0};
+    double barrierMicroseconds{0.0};
+
+    // FLOPs per byte of device memory traffic where a pass stops being bound
+    // by bandwidth, using the fastest bandwidth that was measured.
+    [[nodiscard]] auto ridgeFlopsPerByte() const -> double;
+};
+
+// Times a set of compute microbenchmarks, taking the median of several samples
+// of each. They run on the device's dedicated compute queue if it has one that
+// supports timestamps, and on the universal queue otherwise. Fails if neither
+// supports timestamps, since the host cannot time dispatches precisely enough.
+//
+// Submits and waits on the queue, so frames must not be in flight.
+// Allocates around 512MiB of device memory for the duration of the call.
+auto characterizeDevice(GraphicsContext&) -> std::optional<DeviceProfile>;
+
+// Checks each microbenchmark's SPIR-V against its host-side interface, without
+// a device.
+auto checkCharacterizationKernelInterfaces() -> bool;
+
+// Writes the profile as a flat JSON object, replacing any existing file.
+auto writeDeviceProfile(
+    std::filesystem::path const& path, DeviceProfile const& profile
+) -> bool;
+} // namespace vkt
\ No newline at end of file
@@ -2,68 +2,38 @@
 
 #include "vulkan_template/app/RenderTarget.hpp"
 #include "vulkan_template/app/Swapchain.hpp"
+#include "vulkan_template/core/DeletionQueue.hpp"
 #include "vulkan_template/core/Log.hpp"
 #include "vulkan_template/vulkan/Image.hpp"
 #include "vulkan_template/vulkan/ImageOperations.hpp"
 #include "vulkan_template/vulkan/ImageView.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
 #include "vulkan_template/vulkan/VulkanStructs.hpp"
-#include <deque>
-#include <functional>
+#include <array>
 #include <limits>
 #include <span>
 #include <utility>
 
 namespace
 {
-struct DeletionQueue
-{
-public:
-    void pushFunction(std::function<void()>&& function)
-    {
-        m_cleanupCallbacks.push_front(function);
-    }
-
-    void flush()
-    {
-        for (std::function<void()> const& function : m_cleanupCallbacks)
-        {
-            function();
-        }
-
-        m_cleanupCallbacks.clear();
-    }
-    void clear() { m_cleanupCallbacks.clear(); }
-
-    ~DeletionQueue() noexcept
-    {
-        if (!m_cleanupCallbacks.empty())
-        {
-            VKT_WARNING(
-                "Cleanup callbacks was flushed, potentially indicating "
-                "that dealing with a DeletionQueue instance was forgotten."
-            );
-            flush();
-        }
-    }
-
-private:
-    std::deque<std::function<void()>> m_cleanupCallbacks{};
-};
-
-auto createFrame(VkDevice const device, uint32_t const queueFamilyIndex)
-    -> std::optional<vkt::Frame>
+auto createFrame(
+    VkDevice const device,
+    uint32_t const queueFamilyIndex,
+    size_t const recordingThreads
+) -> std::optional<vkt::Frame>
 {
     std::optional<vkt::Frame> frameResult{std::in_place};
     vkt::Frame& frame{frameResult.value()};
 
-    DeletionQueue cleanupCallbacks{};
+    vkt::DeletionQueue cleanupCallbacks{};
     cleanupCallbacks.pushFunction([&]() { frame.destroy(device); });
 
+    // Buffers are rerecorded every frame, and only ever reset along with their
+    // whole pool.
     VkCommandPoolCreateInfo const commandPoolInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
         .pNext = nullptr,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
         .queueFamilyIndex = queueFamilyIndex,
     };
 
@@ -95,6 +65,29 @@ auto createFrame(VkDevice const device, uint32_t const queueFamilyIndex)
         return std::nullopt;
     }
 
+    frame.threadCommandPools.resize(recordingThreads);
+    for (vkt::ThreadCommandPool& threadPool : frame.threadCommandPools)
+    {
+        if (VkResult const result{vkCreateCommandPool(
+                device, &commandPoolInfo, nullptr, &threadPool.commandPool
+            )};
+            result != VK_SUCCESS)
+        {
+            VKT_LOG_VK(result, "Failed to allocate thread command pool.");
+            cleanupCallbacks.flush();
+            return std::nullopt;
+        }
+
+        // Allocated up front, so that a thread recording for the first time
+        // does not allocate in the middle of the frame loop.
+        if (!threadPool.nextSecondary(device).has_value())
+        {
+            cleanupCallbacks.flush();
+            return std::nullopt;
+        }
+        threadPool.secondariesUsed = 0;
+    }
+
     // Frames start signaled so they can be initially used
     VkFenceCreateInfo const fenceCreateInfo{
         vkt::fenceCreateInfo(VK_FENCE_CREATE_SIGNALED_BIT)
@@ -112,6 +105,25 @@ auto createFrame(VkDevice const device, uint32_t const queueFamilyIndex)
 
     VkSemaphoreCreateInfo const semaphoreCreateInfo{vkt::semaphoreCreateInfo()};
 
+    std::array<vkt::DescriptorAllocator::PoolSizeRatio, 4> const poolRatios{{
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0F},
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 1.0F},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0F},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0F},
+    }};
+    // Pools grow as a thread needs more, so each thread starts small
+    uint32_t constexpr TRANSIENT_SETS_PER_POOL{16U};
+
+    frame.threadDescriptorAllocators.reserve(recordingThreads);
+    for (size_t thread{0}; thread < recordingThreads; thread++)
+    {
+        frame.threadDescriptorAllocators.push_back(
+            vkt::DescriptorAllocator::create(
+                device, TRANSIENT_SETS_PER_POOL, poolRatios, 0
+            )
+        );
+    }
+
     if (VkResult const result{vkCreateSemaphore(
             device, &semaphoreCreateInfo, nullptr, &frame.swapchainSemaphore
         )};
@@ -139,9 +151,40 @@ auto createFrame(VkDevice const device, uint32_t const queueFamilyIndex)
 
 namespace vkt
 {
+auto ThreadCommandPool::nextSecondary(VkDevice const device)
+    -> std::optional<VkCommandBuffer>
+{
+    if (secondariesUsed == secondaries.size())
+    {
+        VkCommandBufferAllocateInfo const cmdAllocInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .pNext = nullptr,
+            .commandPool = commandPool,
+            .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1,
+        };
+
+        VkCommandBuffer cmd{VK_NULL_HANDLE};
+        VKT_TRY_VK(
+            vkAllocateCommandBuffers(device, &cmdAllocInfo, &cmd),
+            "Failed to allocate secondary command buffer.",
+            std::nullopt
+        );
+        secondaries.push_back(cmd);
+    }
+
+    return secondaries[secondariesUsed++];
+}
+
 void Frame::destroy(VkDevice const device)
 {
     vkDestroyCommandPool(device, commandPool, nullptr);
+    for (ThreadCommandPool const& threadPool : threadCommandPools)
+    {
+        vkDestroyCommandPool(device, threadPool.commandPool, nullptr);
+    }
+
+    threadDescriptorAllocators.clear();
 
     vkDestroyFence(device, renderFence, nullptr);
     vkDestroySemaphore(device, renderSemaphore, nullptr);
@@ -159,8 +202,11 @@ FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
 
 FrameBuffer::~FrameBuffer() { destroy(); }
 
-auto FrameBuffer::create(VkDevice const device, uint32_t const queueFamilyIndex)
-    -> std::optional<FrameBuffer>
+auto FrameBuffer::create(
+    VkDevice const device,
+    uint32_t const queueFamilyIndex,
+    size_t const recordingThreads
+) -> std::optional<FrameBuffer>
 {
     if (device == VK_NULL_HANDLE)
     {
@@ -172,19 +218,18 @@ auto FrameBuffer::create(VkDevice const device, uint32_t const queueFamilyIndex)
     FrameBuffer& frameBuffer{frameBufferResult.value()};
     frameBuffer.m_device = device;
 
-    size_t constexpr FRAMES_IN_FLIGHT{2};
 
     for (size_t i{0}; i < FRAMES_IN_FLIGHT; i++)
     {
-        std::optional<Frame> const frameResult{
-            createFrame(device, queueFamilyIndex)
+        std::optional<Frame> frameResult{
+            createFrame(device, queueFamilyIndex, recordingThreads)
         };
         if (!frameResult.has_value())
         {
             VKT_ERROR("Failed to allocate frame for framebuffer.");
             return std::nullopt;
         }
-        frameBuffer.m_frames.push_back(frameResult.value());
+        frameBuffer.m_frames.push_back(std::move(frameResult).value());
     }
 
     return frameBufferResult;
@@ -193,7 +238,7 @@ auto FrameBuffer::create(VkDevice const device, uint32_t const queueFamilyIndex)
 auto FrameBuffer::beginNewFrame() -> VkResult
 {
     m_frameNumber++;
-    Frame const& frame{currentFrame()};
+    Frame& frame{currentFrame()};
 
     uint64_t constexpr FRAME_WAIT_TIMEOUT_NANOSECONDS = 1'000'000'000;
     if (VkResult const waitResult{vkWaitForFences(
@@ -218,13 +263,35 @@ auto FrameBuffer::beginNewFrame() -> VkResult
         return resetResult;
     }
 
-    if (VkResult const resetCmdResult{
-            vkResetCommandBuffer(frame.mainCommandBuffer, 0)
+    // The fence guarantees the GPU is done with any sets from this frame's last
+    // use, so they can all be recycled at once.
+    for (DescriptorAllocator& allocator : frame.threadDescriptorAllocators)
+    {
+        allocator.clearDescriptors(m_device);
+    }
+    frame.arena.reset();
+
+    // Resetting whole pools is cheaper than resetting each buffer, and keeps
+    // the buffers allocated for reuse.
+    if (VkResult const resetPoolResult{
+            vkResetCommandPool(m_device, frame.commandPool, 0)
         };
-        resetCmdResult != VK_SUCCESS)
+        resetPoolResult != VK_SUCCESS)
     {
-        VKT_LOG_VK(resetCmdResult, "Failed to reset frame command buffer.");
-        return resetCmdResult;
+        VKT_LOG_VK(resetPoolResult, "Failed to reset frame command pool.");
+        return resetPoolResult;
+    }
+    for (ThreadCommandPool& threadPool : frame.threadCommandPools)
+    {
+        if (VkResult const resetPoolResult{
+                vkResetCommandPool(m_device, threadPool.commandPool, 0)
+            };
+            resetPoolResult != VK_SUCCESS)
+        {
+            VKT_LOG_VK(resetPoolResult, "Failed to reset thread command pool.");
+            return resetPoolResult;
+        }
+        threadPool.secondariesUsed = 0;
     }
 
     VkCommandBufferBeginInfo const cmdBeginInfo{
@@ -248,6 +315,12 @@ auto FrameBuffer::currentFrame() const -> Frame const&
     return m_frames[index];
 }
 
+auto FrameBuffer::currentFrame() -> Frame&
+{
+    size_t const index{m_frameNumber % m_frames.size()};
+    return m_frames[index];
+}
+
 auto FrameBuffer::finishFrameWithPresent(
     Swapchain& swapchain,
     VkQueue const submissionQueue,
@@ -259,7 +332,7 @@ auto FrameBuffer::finishFrameWithPresent(
 
     uint32_t swapchainImageIndex{std::numeric_limits<uint32_t>::max()};
 
-    Frame const& frame{currentFrame()};
+    Frame& frame{currentFrame()};
     VkCommandBuffer const cmd{frame.mainCommandBuffer};
 
     if (VkResult const acquireResult{vkAcquireNextImageKHR(
@@ -325,13 +398,10 @@ auto FrameBuffer::finishFrameWithPresent(
         VK_PIPELINE_STAGE_2_TRANSFER_BIT, frame.renderSemaphore
     )};
 
-    std::vector<VkCommandBufferSubmitInfo> const cmdSubmitInfos{cmdSubmitInfo};
-    std::vector<VkSemaphoreSubmitInfo> const waitInfos{waitInfo};
-    std::vector<VkSemaphoreSubmitInfo> const signalInfos{signalInfo};
-
     // TODO: transferring to the swapchain should have its own command buffer
-    VkSubmitInfo2 const submission =
-        submitInfo(cmdSubmitInfos, waitInfos, signalInfos);
+    VkSubmitInfo2 const submission{
+        submitInfo(frame.arena, {cmdSubmitInfo}, {waitInfo}, {signalInfo})
+    };
 
     VKT_PROPAGATE_VK(
         vkQueueSubmit2(submissionQueue, 1, &submission, frame.renderFence),
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "vulkan_template/app/DescriptorAllocator.hpp"
 #include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/LinearArena.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
 #include <optional>
 #include <vector>
@@ -13,11 +15,29 @@ struct RenderTarget;
 
 namespace vkt
 {
+// Secondary command buffers for one recording thread. Command pools may only
+// be used by one thread at a time, so each thread gets its own. Buffers are
+// recycled by resetting the whole pool when the frame retires.
+struct ThreadCommandPool
+{
+    VkCommandPool commandPool{VK_NULL_HANDLE};
+    std::vector<VkCommandBuffer> secondaries{};
+    // Secondaries handed out since the pool was last reset
+    size_t secondariesUsed{0};
+
+    // Returns a secondary command buffer that is ready to begin, allocating
+    // one if every existing buffer was used this frame.
+    auto nextSecondary(VkDevice) -> std::optional<VkCommandBuffer>;
+};
+
 struct Frame
 {
     VkCommandPool commandPool{VK_NULL_HANDLE};
     VkCommandBuffer mainCommandBuffer{VK_NULL_HANDLE};
 
+    // One per recording thread, indexed by the thread's index in the recorder
+    std::vector<ThreadCommandPool> threadCommandPools{};
+
     // The semaphore that the swapchain signals when its
     // image is ready to be written to.
     VkSemaphore swapchainSemaphore{VK_NULL_HANDLE};
@@ -28,6 +48,15 @@ struct Frame
     // The fence that the CPU waits on to ensure the frame is not in use.
     VkFence renderFence{VK_NULL_HANDLE};
 
+    // Transient descriptor sets that only need to live for this frame. Like the
+    // command pools there is one per recording thread, so threads never share
+    // an allocator. Each is reset at once when the frame retires.
+    std::vector<DescriptorAllocator> threadDescriptorAllocators{};
+
+    // Transient CPU memory for recording this frame, such as arrays that
+    // Vulkan structs point to. Reset when the frame begins.
+    LinearArena arena{};
+
     void destroy(VkDevice);
 };
 
@@ -46,18 +75,27 @@ private:
     void destroy();
 
 public:
+    // The number of frames that may be recorded or executing at once.
+    static size_t constexpr FRAMES_IN_FLIGHT{2};
+
     // QueueFamilyIndex should be capable of graphics/compute/transfer/present.
-    static auto create(VkDevice, uint32_t queueFamilyIndex)
-        -> std::optional<FrameBuffer>;
+    // Each frame gets a command pool and a descriptor allocator for each of
+    // recordingThreads.
+    static auto create(
+        VkDevice, uint32_t queueFamilyIndex, size_t recordingThreads
+    ) -> std::optional<FrameBuffer>;
 
     [[nodiscard]] auto frameNumber() const -> size_t;
 
     // Prepares the frame for command recording. A return value of VK_RESULT
     // means that you may proceed to call currentFrame and record commands into
-    // its command buffer.
+    // its command buffer. Descriptor sets allocated from the frame's transient
+    // allocators, its arena, and command buffers recorded the last time it was
+    // used are invalidated.
     auto beginNewFrame() -> VkResult;
 
     [[nodiscard]] auto currentFrame() const -> Frame const&;
+    auto currentFrame() -> Frame&;
 
     // Ends the frame and presents it to the given swapchain
     [[nodiscard]] auto finishFrameWithPresent(
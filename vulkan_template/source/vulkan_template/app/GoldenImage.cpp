@@ -0,0 +1,956 @@
+#include "GoldenImage.hpp"
+
+#include "vulkan_template/app/GraphicsContext.hpp"
+#include "vulkan_template/app/PostProcess.hpp"
+#include "vulkan_template/app/RenderTarget.hpp"
+#include "vulkan_template/app/Renderer.hpp"
+#include "vulkan_template/app/UILayer.hpp"
+#include "vulkan_template/app/UITextureRegistry.hpp"
+#include "vulkan_template/core/CPUKernels.hpp"
+#include "vulkan_template/core/ImageFile.hpp"
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/ImageView.hpp"
+#include "vulkan_template/vulkan/ReadbackService.hpp"
+#include "vulkan_template/vulkan/TimedSubmitter.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <glm/common.hpp>
+#include <glm/vec2.hpp>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+auto createSubmitter(vkt::GraphicsContext& graphicsContext)
+    -> std::optional<vkt::TimedSubmitter>
+{
+    // Around the recorded passes
+    uint32_t constexpr TIMESTAMP_COUNT{2};
+    std::optional<vkt::TimedSubmitter> submitterResult{
+        vkt::TimedSubmitter::create(
+            graphicsContext.physicalDevice(),
+            graphicsContext.device(),
+            graphicsContext.universalQueue(),
+            graphicsContext.universalQueueFamily(),
+            TIMESTAMP_COUNT
+        )
+    };
+    if (!submitterResult.has_value())
+    {
+        VKT_ERROR("Failed to create golden image submitter.");
+        return std::nullopt;
+    }
+
+    if (!submitterResult.value().timestampsSupported())
+    {
+        VKT_WARNING("Queue does not support timestamps, golden image GPU "
+                    "times will not be recorded.");
+    }
+
+    return submitterResult;
+}
+
+// Records the case's passes and a readback of its viewport, and returns the
+// texels once the device has finished.
+auto renderCase(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::JobSystem& jobSystem,
+    vkt::Renderer& renderer,
+    vkt::PostProcess& postProcess,
+    vkt::TimedSubmitter& submitter,
+    vkt::ReadbackService& readback,
+    vkt::RenderTarget& target,
+    vkt::GoldenImageCase const& goldenCase,
+    vkt::GoldenImageResult& result
+) -> std::optional<std::vector<uint16_t>>
+{
+    std::optional<VkCommandBuffer> const beginResult{submitter.begin()};
+    if (!beginResult.has_value())
+    {
+        return std::nullopt;
+    }
+    VkCommandBuffer const cmd{beginResult.value()};
+
+    submitter.writeTimestamp(0);
+
+    graphicsContext.bindlessHeap().bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+    target.setSize(goldenCase.viewport);
+    renderer.recordDraw(cmd, target);
+    if (goldenCase.encodeSRGB)
+    {
+        postProcess.recordLinearToSRGB(cmd, target);
+    }
+
+    submitter.writeTimestamp(1);
+
+    std::vector<uint16_t> texels{};
+    if (!readback.recordCopy(
+            cmd,
+            target.color().image(),
+            goldenCase.viewport,
+            [&texels](vkt::ReadbackResult const& readbackResult)
+    {
+        std::span<uint16_t const> const values{
+            reinterpret_cast<uint16_t const*>(readbackResult.texels.data()),
+            readbackResult.texels.size() / sizeof(uint16_t)
+        };
+        texels.assign(values.begin(), values.end());
+    }
+        ))
+    {
+        VKT_ERROR("Failed to record golden image readback.");
+        return std::nullopt;
+    }
+
+    if (submitter.submitAndWait() != VK_SUCCESS)
+    {
+        return std::nullopt;
+    }
+
+    // The device is idle, so this runs the copy's callback right away
+    readback.flush(jobSystem);
+
+    result.gpuMilliseconds = submitter.millisecondsBetween(0, 1).value_or(0.0);
+
+    return texels;
+}
+
+void compareWithReference(
+    std::string const& name,
+    vkt::GoldenImageOptions const& options,
+    vkt::ImageRGBA16 const& output,
+    vkt::GoldenImageResult& result
+)
+{
+    std::filesystem::path const referencePath{
+        options.referenceDirectory / (name + ".png")
+    };
+
+    if (options.updateReferences)
+    {
+        result.passed = vkt::writePNG(referencePath, output);
+        return;
+    }
+
+    if (!std::filesystem::exists(referencePath))
+    {
+        VKT_ERROR(
+            "Golden image '{}' has no reference, writing it to '{}'.",
+            name,
+            referencePath.string()
+        );
+        vkt::writePNG(referencePath, output);
+        return;
+    }
+
+    std::optional<vkt::LoadedImageRGBA16> const reference{
+        vkt::readPNG(referencePath)
+    };
+    if (!reference.has_value())
+    {
+        return;
+    }
+
+    if (reference->width != output.width || reference->height != output.height)
+    {
+        VKT_ERROR(
+            "Golden image '{}' is {}x{}, but its reference is {}x{}.",
+            name,
+            output.width,
+            output.height,
+            reference->width,
+            reference->height
+        );
+        result.difference = vkt::ImageDifference{
+            .maxDifference = UINT16_MAX,
+            .exceedingCount = output.texels.size(),
+        };
+    }
+    else
+    {
+        result.difference = vkt::compareImages(
+            output.texels, reference->texels, options.tolerance
+        );
+    }
+
+    size_t const allowedCount{static_cast<size_t>(
+        options.exceedingFraction * static_cast<double>(output.texels.size())
+    )};
+    result.passed = result.difference.exceedingCount <= allowedCount;
+    if (!result.passed)
+    {
+        std::filesystem::path actualPath{referencePath};
+        actualPath.replace_extension(".actual.png");
+        vkt::writePNG(actualPath, output);
+    }
+}
+
+// Renders goldenCase sampleCount times, and returns the last output along with
+// the median GPU time.
+auto renderSamples(
+    vkt::GraphicsContext& graphicsContext,
+    vkt::JobSystem& jobSystem,
+    vkt::Renderer& renderer,
+    vkt::PostProcess& postProcess,
+    vkt::TimedSubmitter& submitter,
+    vkt::ReadbackService& readback,
+    vkt::RenderTarget& target,
+    vkt::GoldenImageCase const& goldenCase,
+    size_t const sampleCount,
+    double& gpuMilliseconds
+) -> std::optional<std::vector<uint16_t>>
+{
+    std::vector<double> samples{};
+    std::optional<std::vector<uint16_t>> texels{};
+    for (size_t sample{0}; sample < std::max<size_t>(sampleCount, 1); sample++)
+    {
+        vkt::GoldenImageResult result{};
+        texels = renderCase(
+            graphicsContext,
+            jobSystem,
+            renderer,
+            postProcess,
+            submitter,
+            readback,
+            target,
+            goldenCase,
+            result
+        );
+        if (!texels.has_value())
+        {
+            return std::nullopt;
+        }
+        samples.push_back(result.gpuMilliseconds);
+    }
+
+    auto const middle{samples.begin() + samples.size() / 2};
+    std::nth_element(samples.begin(), middle, samples.end());
+    gpuMilliseconds = *middle;
+
+    return texels;
+}
+} // namespace
+
+namespace vkt
+{
+auto defaultGoldenImageCases() -> std::vector<GoldenImageCase>
+{
+    // Odd sizes and offsets leave partial workgroups along the edges
+    return std::vector<GoldenImageCase>{
+        GoldenImageCase{
+            .name = "testpattern_full",
+            .viewport = VkRect2D{.offset = {0, 0}, .extent = {256, 256}},
+            .encodeSRGB = false,
+        },
+        GoldenImageCase{
+            .name = "testpattern_offset",
+            .viewport = VkRect2D{.offset = {37, 21}, .extent = {160, 90}},
+            .encodeSRGB = false,
+        },
+        GoldenImageCase{
+            .name = "testpattern_odd",
+            .viewport = VkRect2D{.offset = {0, 0}, .extent = {33, 17}},
+            .encodeSRGB = false,
+        },
+        GoldenImageCase{
+            .name = "srgb_full",
+            .viewport = VkRect2D{.offset = {0, 0}, .extent = {256, 256}},
+            .encodeSRGB = true,
+        },
+        GoldenImageCase{
+            .name = "srgb_offset",
+            .viewport = VkRect2D{.offset = {64, 48}, .extent = {127, 63}},
+            .encodeSRGB = true,
+        },
+        GoldenImageCase{
+            .name = "srgb_row",
+            .viewport = VkRect2D{.offset = {5, 200}, .extent = {250, 1}},
+            .encodeSRGB = true,
+        },
+    };
+}
+
+auto runGoldenImageCases(
+    GraphicsContext& graphicsContext,
+    JobSystem& jobSystem,
+    Renderer& renderer,
+    PostProcess& postProcess,
+    std::span<GoldenImageCase const> const cases,
+    GoldenImageOptions const& options
+) -> std::vector<GoldenImageResult>
+{
+    std::vector<GoldenImageResult> results{};
+    for (GoldenImageCase const& goldenCase : cases)
+    {
+        results.push_back(GoldenImageResult{.name = goldenCase.name});
+    }
+
+    VkExtent2D targetExtent{1, 1};
+    for (GoldenImageCase const& goldenCase : cases)
+    {
+        VkRect2D const& viewport{goldenCase.viewport};
+        targetExtent.width = std::max(
+            targetExtent.width,
+            static_cast<uint32_t>(viewport.offset.x) + viewport.extent.width
+        );
+        targetExtent.height = std::max(
+            targetExtent.height,
+            static_cast<uint32_t>(viewport.offset.y) + viewport.extent.height
+        );
+    }
+
+    std::optional<TimedSubmitter> submitterResult{
+        createSubmitter(graphicsContext)
+    };
+    if (!submitterResult.has_value())
+    {
+        return results;
+    }
+
+    std::optional<ReadbackService> readbackResult{ReadbackService::create(
+        graphicsContext.allocator(), 1, 1
+    )};
+    if (!readbackResult.has_value())
+    {
+        VKT_ERROR("Failed to create golden image readback.");
+        return results;
+    }
+
+    std::optional<RenderTarget> targetResult{RenderTarget::create(
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        graphicsContext.bindlessHeap(),
+        RenderTarget::CreateParameters{
+            .max = targetExtent,
+            .color = VK_FORMAT_R16G16B16A16_UNORM,
+            .depth = VK_FORMAT_D32_SFLOAT,
+        }
+    )};
+    if (!targetResult.has_value())
+    {
+        VKT_ERROR("Failed to create golden image render target.");
+        return results;
+    }
+
+    std::filesystem::create_directories(options.referenceDirectory);
+
+    for (size_t index{0}; index < cases.size(); index++)
+    {
+        GoldenImageCase const& goldenCase{cases[index]};
+        GoldenImageResult& result{results[index]};
+
+        auto const cpuStart{std::chrono::steady_clock::now()};
+        std::optional<std::vector<uint16_t>> const texels{renderCase(
+            graphicsContext,
+            jobSystem,
+            renderer,
+            postProcess,
+            submitterResult.value(),
+            readbackResult.value(),
+            targetResult.value(),
+            goldenCase,
+            result
+        )};
+        auto const cpuEnd{std::chrono::steady_clock::now()};
+        result.cpuMilliseconds =
+            std::chrono::duration<double, std::milli>(cpuEnd - cpuStart)
+                .count();
+
+        if (!texels.has_value())
+        {
+            VKT_ERROR("Failed to render golden image '{}'.", goldenCase.name);
+            continue;
+        }
+
+        compareWithReference(
+            goldenCase.name,
+            options,
+            ImageRGBA16{
+                .width = goldenCase.viewport.extent.width,
+                .height = goldenCase.viewport.extent.height,
+                .texels = texels.value(),
+            },
+            result
+        );
+    }
+
+    return results;
+}
+
+auto runUIFrameCase(
+    GraphicsContext& graphicsContext,
+    JobSystem& jobSystem,
+    Renderer& renderer,
+    UILayer& uiLayer,
+    GoldenImageOptions const& options
+) -> GoldenImageResult
+{
+    // Named after the output's size once it has been drawn
+    GoldenImageResult result{.name = "ui_frame"};
+
+    std::optional<TimedSubmitter> submitterResult{
+        createSubmitter(graphicsContext)
+    };
+    if (!submitterResult.has_value())
+    {
+        return result;
+    }
+    TimedSubmitter& submitter{submitterResult.value()};
+
+    std::optional<ReadbackService> readbackResult{ReadbackService::create(
+        graphicsContext.allocator(), 1, 1
+    )};
+    if (!readbackResult.has_value())
+    {
+        VKT_ERROR("Failed to create UI frame readback.");
+        return result;
+    }
+    ReadbackService& readback{readbackResult.value()};
+
+    // The first frame builds the docking layout and the next settles window
+    // sizes, so the last frames draw identical UI
+    size_t constexpr FRAME_COUNT{4};
+
+    std::optional<SceneViewport> viewport{};
+    VkExtent2D outputExtent{};
+    std::vector<uint16_t> texels{};
+    auto const cpuStart{std::chrono::steady_clock::now()};
+    for (size_t frameIndex{0}; frameIndex < FRAME_COUNT; frameIndex++)
+    {
+        bool const lastFrame{frameIndex + 1 == FRAME_COUNT};
+
+        uiLayer.begin();
+        viewport = uiLayer.sceneViewport(true);
+        UIFrame frame{uiLayer.end()};
+
+        std::optional<VkCommandBuffer> const beginResult{submitter.begin()};
+        if (!beginResult.has_value())
+        {
+            return result;
+        }
+        VkCommandBuffer const cmd{beginResult.value()};
+
+        submitter.writeTimestamp(0);
+
+        graphicsContext.bindlessHeap().bind(
+            cmd, VK_PIPELINE_BIND_POINT_COMPUTE
+        );
+
+        if (viewport.has_value())
+        {
+            RenderTarget& sceneTexture{viewport.value().texture};
+            sceneTexture.setSize(viewport.value().textureRegion);
+            renderer.recordDraw(cmd, sceneTexture);
+        }
+
+        std::optional<std::reference_wrapper<RenderTarget>> const output{
+            uiLayer.recordDraw(cmd, frame)
+        };
+        if (!output.has_value())
+        {
+            VKT_ERROR("UI layer did not draw the UI frame.");
+            return result;
+        }
+
+        submitter.writeTimestamp(1);
+
+        if (lastFrame)
+        {
+            RenderTarget& outputTarget{output.value().get()};
+            outputExtent = outputTarget.size().extent;
+            if (!readback.recordCopy(
+                    cmd,
+                    outputTarget.color().image(),
+                    outputTarget.size(),
+                    [&texels](ReadbackResult const& readbackResult)
+            {
+                std::span<uint16_t const> const values{
+                    reinterpret_cast<uint16_t const*>(
+                        readbackResult.texels.data()
+                    ),
+                    readbackResult.texels.size() / sizeof(uint16_t)
+                };
+                texels.assign(values.begin(), values.end());
+            }
+                ))
+            {
+                VKT_ERROR("Failed to record UI frame readback.");
+                return result;
+            }
+        }
+
+        if (submitter.submitAndWait() != VK_SUCCESS)
+        {
+            return result;
+        }
+
+        // The device is idle, so this runs the copy's callback right away
+        readback.flush(jobSystem);
+    }
+    auto const cpuEnd{std::chrono::steady_clock::now()};
+    result.cpuMilliseconds =
+        std::chrono::duration<double, std::milli>(cpuEnd - cpuStart).count()
+        / static_cast<double>(FRAME_COUNT);
+    result.gpuMilliseconds = submitter.millisecondsBetween(0, 1).value_or(0.0);
+
+    result.name =
+        fmt::format("ui_{}x{}", outputExtent.width, outputExtent.height);
+
+    if (!viewport.has_value())
+    {
+        VKT_ERROR(
+            "UI frame '{}' did not show the scene viewport.", result.name
+        );
+        return result;
+    }
+
+    size_t constexpr CHANNELS{4};
+    if (texels.size()
+        != static_cast<size_t>(outputExtent.width) * outputExtent.height
+               * CHANNELS)
+    {
+        VKT_ERROR("Failed to read back UI frame '{}'.", result.name);
+        return result;
+    }
+
+    // Where the scene was copied over the rasterized UI
+    glm::vec2 const destination{glm::round(viewport.value().windowExtent.min)};
+    VkRect2D const sceneRegion{
+        .offset{
+            .x = static_cast<int32_t>(destination.x),
+            .y = static_cast<int32_t>(destination.y),
+        },
+        .extent = viewport.value().textureRegion.extent,
+    };
+    if (sceneRegion.offset.x < 0 || sceneRegion.offset.y < 0
+        || static_cast<uint32_t>(sceneRegion.offset.x)
+                   + sceneRegion.extent.width
+               > outputExtent.width
+        || static_cast<uint32_t>(sceneRegion.offset.y)
+                   + sceneRegion.extent.height
+               > outputExtent.height)
+    {
+        VKT_ERROR(
+            "UI frame '{}' placed the scene viewport outside of the output.",
+            result.name
+        );
+        return result;
+    }
+
+    VkExtent2D const sceneExtent{sceneRegion.extent};
+    size_t const sceneRowValues{
+        static_cast<size_t>(sceneExtent.width) * CHANNELS
+    };
+    std::vector<uint16_t> scene(sceneRowValues * sceneExtent.height);
+    for (uint32_t row{0}; row < sceneExtent.height; row++)
+    {
+        size_t const sourceOffset{
+            ((static_cast<size_t>(sceneRegion.offset.y) + row)
+                 * outputExtent.width
+             + static_cast<size_t>(sceneRegion.offset.x))
+            * CHANNELS
+        };
+        std::copy_n(
+            texels.begin() + static_cast<ptrdiff_t>(sourceOffset),
+            sceneRowValues,
+            scene.begin() + static_cast<ptrdiff_t>(row * sceneRowValues)
+        );
+    }
+
+    std::vector<uint16_t> expected(scene.size(), 0);
+    drawTestPattern(
+        MutableImageRGBA16{
+            .width = sceneExtent.width,
+            .height = sceneExtent.height,
+            .texels = expected,
+        },
+        TexelRect{
+            .x = 0,
+            .y = 0,
+            .width = sceneExtent.width,
+            .height = sceneExtent.height,
+        }
+    );
+
+    // The scene is copied rather than rasterized, so it must match exactly
+    // even where the UI around it may not
+    ImageDifference const sceneDifference{
+        compareImages(scene, expected, options.tolerance)
+    };
+    if (sceneDifference.exceedingCount > 0)
+    {
+        VKT_ERROR(
+            "UI frame '{}' has {} values over tolerance in the scene viewport "
+            "at ({}, {}) of {}x{}.",
+            result.name,
+            sceneDifference.exceedingCount,
+            sceneRegion.offset.x,
+            sceneRegion.offset.y,
+            sceneExtent.width,
+            sceneExtent.height
+        );
+    }
+
+    compareWithReference(
+        result.name,
+        options,
+        ImageRGBA16{
+            .width = outputExtent.width,
+            .height = outputExtent.height,
+            .texels = texels,
+        },
+        result
+    );
+    result.difference.maxDifference = std::max(
+        result.difference.maxDifference, sceneDifference.maxDifference
+    );
+    result.difference.exceedingCount += sceneDifference.exceedingCount;
+    result.passed = result.passed && sceneDifference.exceedingCount == 0;
+
+    return result;
+}
+
+auto runUITextureRegistryCase(GraphicsContext& graphicsContext)
+    -> GoldenImageResult
+{
+    GoldenImageResult result{.name = "ui_texture_registry"};
+
+    // A single page of four slots, so the fifth small image must evict
+    uint32_t constexpr SLOT_EXTENT{32};
+    std::optional<UITextureRegistry> registryResult{UITextureRegistry::create(
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        UITextureRegistry::CreateParameters{
+            .pageExtent = SLOT_EXTENT * 2,
+            .minSlotExtent = SLOT_EXTENT,
+            .maxSlotExtent = SLOT_EXTENT,
+            .maxPages = 1,
+        }
+    )};
+    if (!registryResult.has_value())
+    {
+        VKT_ERROR("Failed to create UI texture registry.");
+        return result;
+    }
+    UITextureRegistry& registry{registryResult.value()};
+
+    std::optional<TimedSubmitter> submitterResult{
+        createSubmitter(graphicsContext)
+    };
+    if (!submitterResult.has_value())
+    {
+        return result;
+    }
+    TimedSubmitter& submitter{submitterResult.value()};
+
+    // Six that fit a slot, and two that get dedicated descriptor sets
+    size_t constexpr SMALL_IMAGE_COUNT{6};
+    size_t constexpr LARGE_IMAGE_COUNT{2};
+    std::vector<std::unique_ptr<ImageView>> images{};
+    for (size_t index{0}; index < SMALL_IMAGE_COUNT + LARGE_IMAGE_COUNT;
+         index++)
+    {
+        uint32_t const extent{
+            index < SMALL_IMAGE_COUNT ? SLOT_EXTENT : SLOT_EXTENT * 2
+        };
+        std::optional<std::unique_ptr<ImageView>> imageResult{
+            ImageView::allocate(
+                graphicsContext.device(),
+                graphicsContext.allocator(),
+                ImageAllocationParameters{
+                    .extent = VkExtent2D{.width = extent, .height = extent},
+                    .format = VK_FORMAT_R8G8B8A8_SRGB,
+                    .usageFlags = VK_IMAGE_USAGE_SAMPLED_BIT
+                                | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                },
+                ImageViewAllocationParameters{}
+            )
+        };
+        if (!imageResult.has_value() || imageResult.value() == nullptr)
+        {
+            VKT_ERROR("Failed to allocate UI texture registry source image.");
+            return result;
+        }
+        images.push_back(std::move(imageResult).value());
+    }
+
+    // Collected from each batch, like UILayer does before freeing them
+    std::vector<ImTextureID> released{};
+    auto const endFrame{[&]()
+    {
+        UITextureRegistry::UploadBatch const batch{registry.takeUploads()};
+        released.insert(
+            released.end(),
+            batch.releasedTextures.begin(),
+            batch.releasedTextures.end()
+        );
+
+        std::optional<VkCommandBuffer> const cmd{submitter.begin()};
+        if (!cmd.has_value())
+        {
+            return false;
+        }
+        UITextureRegistry::recordUploads(cmd.value(), batch);
+        return submitter.submitAndWait() == VK_SUCCESS;
+    }};
+
+    bool passed{true};
+    auto const expect{[&](bool const condition, char const* const description)
+    {
+        if (!condition)
+        {
+            VKT_ERROR("UI texture registry check failed: {}.", description);
+            passed = false;
+        }
+    }};
+
+    std::vector<UITexture> packed{};
+    for (UITextureRegistry::Key key{0}; key < 4; key++)
+    {
+        std::optional<UITexture> const texture{registry.add(key, *images[key])};
+        expect(texture.has_value(), "a small image fits a free slot");
+        if (texture.has_value())
+        {
+            packed.push_back(texture.value());
+        }
+    }
+    for (size_t lhs{0}; lhs < packed.size(); lhs++)
+    {
+        expect(
+            packed[lhs].id == packed.front().id,
+            "small images share the page's descriptor set"
+        );
+        for (size_t rhs{lhs + 1}; rhs < packed.size(); rhs++)
+        {
+            expect(
+                packed[lhs].uv0.x != packed[rhs].uv0.x
+                    || packed[lhs].uv0.y != packed[rhs].uv0.y,
+                "small images are packed into distinct slots"
+            );
+        }
+    }
+    if (!endFrame())
+    {
+        return result;
+    }
+
+    // Key 0 is drawn this frame, so key 1 is the least recently used
+    expect(registry.find(0).has_value(), "a packed image is found");
+    expect(registry.add(4, *images[4]).has_value(), "a full page evicts");
+    expect(!registry.find(1).has_value(), "the least recent image is evicted");
+    expect(
+        registry.find(2).has_value() && registry.find(3).has_value(),
+        "more recent images are kept"
+    );
+    // Every slot now holds an image drawn this frame
+    expect(
+        !registry.add(5, *images[5]).has_value(),
+        "images drawn this frame are not evicted"
+    );
+    if (!endFrame())
+    {
+        return result;
+    }
+
+    std::optional<UITexture> const large{registry.add(6, *images[6])};
+    expect(
+        large.has_value() && !packed.empty() && large->id != packed.front().id,
+        "a large image gets a dedicated descriptor set"
+    );
+    if (!endFrame())
+    {
+        return result;
+    }
+
+    std::optional<UITexture> const replacement{registry.add(6, *images[7])};
+    std::optional<UITexture> const found{registry.find(6)};
+    expect(
+        replacement.has_value() && found.has_value()
+            && found->id == replacement->id,
+        "replacing an image updates its key"
+    );
+    expect(
+        released.empty(),
+        "a replaced descriptor set is kept until the frame's uploads are taken"
+    );
+    if (!endFrame())
+    {
+        return result;
+    }
+    expect(
+        large.has_value() && released.size() == 1
+            && released.back() == large->id,
+        "a replaced descriptor set is released with the frame's uploads"
+    );
+
+    registry.remove(6);
+    if (!endFrame())
+    {
+        return result;
+    }
+    expect(
+        replacement.has_value() && released.size() == 2
+            && released.back() == replacement->id,
+        "a removed descriptor set is released with the frame's uploads"
+    );
+
+    // Every frame has been waited on
+    UITextureRegistry::freeReleasedTextures(released);
+
+    result.passed = passed;
+    return result;
+}
+
+auto compareSRGBEncodings(
+    GraphicsContext& graphicsContext,
+    JobSystem& jobSystem,
+    Renderer& renderer,
+    VkExtent2D const extent,
+    size_t const sampleCount
+) -> std::vector<SRGBEncodingResult>
+{
+    std::vector<SRGBEncodingResult> results{};
+
+    std::optional<TimedSubmitter> submitterResult{
+        createSubmitter(graphicsContext)
+    };
+    if (!submitterResult.has_value())
+    {
+        return results;
+    }
+
+    std::optional<ReadbackService> readbackResult{ReadbackService::create(
+        graphicsContext.allocator(), 1, 1
+    )};
+    if (!readbackResult.has_value())
+    {
+        VKT_ERROR("Failed to create sRGB comparison readback.");
+        return results;
+    }
+
+    std::optional<RenderTarget> targetResult{RenderTarget::create(
+        graphicsContext.device(),
+        graphicsContext.allocator(),
+        graphicsContext.bindlessHeap(),
+        RenderTarget::CreateParameters{
+            .max = extent,
+            .color = VK_FORMAT_R16G16B16A16_UNORM,
+            .depth = VK_FORMAT_D32_SFLOAT,
+        }
+    )};
+    if (!targetResult.has_value())
+    {
+        VKT_ERROR("Failed to create sRGB comparison render target.");
+        return results;
+    }
+
+    std::array const encodings{
+        SRGBEncoding::EXACT, SRGBEncoding::POLYNOMIAL, SRGBEncoding::LUT
+    };
+
+    std::vector<PostProcess> postProcesses{};
+    for (SRGBEncoding const encoding : encodings)
+    {
+        std::optional<PostProcess> postProcessResult{PostProcess::create(
+            graphicsContext.device(),
+            graphicsContext.allocator(),
+            graphicsContext.bindlessHeap(),
+            graphicsContext.descriptorLayoutCache(),
+            encoding
+        )};
+        if (!postProcessResult.has_value())
+        {
+            VKT_ERROR(
+                "Failed to create post process with {} sRGB encoding.",
+                srgbEncodingName(encoding)
+            );
+            return results;
+        }
+        postProcesses.push_back(std::move(postProcessResult).value());
+    }
+
+    GoldenImageCase const linearCase{
+        .name = "srgb_comparison",
+        .viewport = VkRect2D{.offset = {0, 0}, .extent = extent},
+        .encodeSRGB = false,
+    };
+
+    double drawMilliseconds{0.0};
+    std::optional<std::vector<uint16_t>> reference{renderSamples(
+        graphicsContext,
+        jobSystem,
+        renderer,
+        postProcesses.front(),
+        submitterResult.value(),
+        readbackResult.value(),
+        targetResult.value(),
+        linearCase,
+        sampleCount,
+        drawMilliseconds
+    )};
+    if (!reference.has_value())
+    {
+        VKT_ERROR("Failed to render linear sRGB comparison image.");
+        return results;
+    }
+    encodeLinearToSRGB(
+        MutableImageRGBA16{
+            .width = extent.width,
+            .height = extent.height,
+            .texels = reference.value(),
+        },
+        TexelRect{
+            .x = 0,
+            .y = 0,
+            .width = extent.width,
+            .height = extent.height,
+        },
+        SRGBEncoding::EXACT
+    );
+
+    GoldenImageCase encodedCase{linearCase};
+    encodedCase.encodeSRGB = true;
+
+    for (PostProcess& postProcess : postProcesses)
+    {
+        SRGBEncodingResult result{.encoding = postProcess.encoding()};
+
+        double totalMilliseconds{0.0};
+        std::optional<std::vector<uint16_t>> const texels{renderSamples(
+            graphicsContext,
+            jobSystem,
+            renderer,
+            postProcess,
+            submitterResult.value(),
+            readbackResult.value(),
+            targetResult.value(),
+            encodedCase,
+            sampleCount,
+            totalMilliseconds
+        )};
+        if (!texels.has_value())
+        {
+            VKT_ERROR(
+                "Failed to render with {} sRGB encoding.",
+                srgbEncodingName(result.encoding)
+            );
+            continue;
+        }
+
+        result.difference = compareImages(texels.value(), reference.value(), 0);
+        result.gpuMilliseconds =
+            std::max(totalMilliseconds - drawMilliseconds, 0.0);
+        results.push_back(result);
+    }
+
+    return results;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "vulkan_template/core/CPUKernels.hpp"
+#include "vulkan_template/core/ImageCompare.hpp"
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vkt
+{
+struct GraphicsContext;
+struct JobSystem;
+struct PostProcess;
+struct Renderer;
+struct UILayer;
+} // namespace vkt
+
+namespace vkt
+{
+struct GoldenImageCase
+{
+    // Names the reference image, so it must be unique within a run
+    std::string name{};
+    // Sub-rectangle of the render target that is drawn into and compared
+    VkRect2D viewport{};
+    // Whether the sRGB post-process runs after the scene is drawn
+    bool encodeSRGB{false};
+};
+
+struct GoldenImageOptions
+{
+    // Holds one PNG per case, named after the case
+    std::filesystem::path referenceDirectory{};
+    // Writes each output as the new reference instead of comparing
+    bool updateReferences{false};
+    // Largest difference allowed per 16-bit channel value
+    uint16_t tolerance{0};
+    // Fraction of channel values allowed past the tolerance, for outputs such
+    // as UI text whose antialiased edges may move between ImGui versions
+    double exceedingFraction{0.0};
+};
+
+struct GoldenImageResult
+{
+    std::string name{};
+    bool passed{false};
+    ImageDifference difference{};
+
+    // Between timestamps around the recorded passes, or 0 if the queue does
+    // not support timestamps
+    double gpuMilliseconds{0.0};
+    // Recording, submitting, waiting, and reading back the output
+    double cpuMilliseconds{0.0};
+};
+
+// Viewports of several sizes and offsets, both with and without encoding.
+auto defaultGoldenImageCases() -> std::vector<GoldenImageCase>;
+
+// Draws each case into an offscreen target and compares the output against its
+// reference. Missing references are written and fail the case, so that a new
+// case is never silently accepted. Outputs that fail are written next to their
+// reference with an .actual.png suffix.
+//
+// Submits and waits on the universal queue, so frames must not be in flight.
+// Meant for a headless context on a deterministic driver such as lavapipe.
+auto runGoldenImageCases(
+    GraphicsContext&,
+    JobSystem&,
+    Renderer&,
+    PostProcess&,
+    std::span<GoldenImageCase const>,
+    GoldenImageOptions const&
+) -> std::vector<GoldenImageResult>;
+
+// Builds UI frames that show the scene viewport on a headless UILayer, and
+// records them through UILayer::recordDraw with the test pattern drawn into the
+// scene. The first frames rasterize the UI and sample the scene, and the last
+// reuses the rasterized UI and copies the scene over it, so both paths are
+// drawn but only the last is compared.
+//
+// The viewport in the output must match drawTestPattern exactly, within the
+// tolerance. The whole output is compared against the reference named after
+// its size, such as ui_1280x720.png, as golden image cases are, so the
+// options' exceedingFraction allows for changes in how text is rasterized.
+//
+// Submits and waits on the universal queue, so frames must not be in flight.
+auto runUIFrameCase(
+    GraphicsContext&,
+    JobSystem&,
+    Renderer&,
+    UILayer&,
+    GoldenImageOptions const&
+) -> GoldenImageResult;
+
+// Fills a one page UITextureRegistry and checks that images pack into distinct
+// slots, that the least recently used image is evicted, that images drawn this
+// frame are not, and that replaced or removed dedicated descriptor sets are
+// only released with the next upload batch. Each frame's uploads are recorded
+// and submitted. Passes or fails without comparing images.
+//
+// The UI backend must be initialized, such as by a headless UILayer.
+auto runUITextureRegistryCase(GraphicsContext&) -> GoldenImageResult;
+
+struct SRGBEncodingResult
+{
+    SRGBEncoding encoding{SRGBEncoding::EXACT};
+    // Against the exact encoding of the same linear texels on the CPU
+    ImageDifference difference{};
+    // Median time of drawing and encoding, less the median time of drawing
+    // alone, or 0 if the queue does not support timestamps
+    double gpuMilliseconds{0.0};
+};
+
+// Draws the test pattern at extent, then encodes it with each encoding and
+// compares the output against encodeLinearToSRGB's EXACT output, so the GPU's
+// pow is measured too. Timings are medians of sampleCount runs.
+//
+// Submits and waits on the universal queue, so frames must not be in flight.
+auto compareSRGBEncodings(
+    GraphicsContext&,
+    JobSystem&,
+    Renderer&,
+    VkExtent2D extent,
+    size_t sampleCount
+) -> std::vector<SRGBEncodingResult>;
+} // namespace vkt
\ No newline at end of file
@@ -1,20 +1,38 @@
 #include "GraphicsContext.hpp"
 
+#include "vulkan_template/app/DeviceCapabilities.hpp"
+#include "vulkan_template/app/FrameBuffer.hpp"
 #include "vulkan_template/app/PlatformWindow.hpp"
+#include "vulkan_template/core/HeapAllocationCounter.hpp"
 #include "vulkan_template/core/Log.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
 #include <GLFW/glfw3.h>
 #include <VkBootstrap.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
 #include <optional>
 #include <span>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 namespace
 {
-auto selectPhysicalDevice(
+// Names a device to use instead of the highest scoring one, either by its
+// index among the suitable devices or by a substring of its name
+char const* const DEVICE_OVERRIDE_VARIABLE{"VKT_PHYSICAL_DEVICE"};
+
+// Implements VK_EXT_shader_object on drivers without it, and passes calls
+// through on drivers that have it
+char const* const SHADER_OBJECT_LAYER{"VK_LAYER_KHRONOS_shader_object"};
+
+// Surface may be null for headless instances, which need no presentation.
+// Returns every device that meets the engine's requirements.
+auto suitablePhysicalDevices(
     vkb::Instance const& instance, VkSurfaceKHR const surface
-) -> vkb::Result<vkb::PhysicalDevice>
+) -> vkb::Result<std::vector<vkb::PhysicalDevice>>
 {
     VkPhysicalDeviceVulkan13Features const features13{
         .synchronization2 = VK_TRUE,
@@ -24,16 +42,18 @@ auto selectPhysicalDevice(
     VkPhysicalDeviceVulkan12Features const features12{
         .descriptorIndexing = VK_TRUE,
 
+        // Required by the bindless heap, which is written while bound
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingStorageImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
         .descriptorBindingPartiallyBound = VK_TRUE,
         .runtimeDescriptorArray = VK_TRUE,
 
+        // Required by the frame data ring, whose blocks shaders read through
+        // their addresses
         .bufferDeviceAddress = VK_TRUE,
     };
 
-    VkPhysicalDeviceFeatures const features{
-        .wideLines = VK_TRUE,
-    };
-
     VkPhysicalDeviceShaderObjectFeaturesEXT const shaderObjectFeature{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
         .pNext = nullptr,
@@ -41,26 +61,248 @@ auto selectPhysicalDevice(
         .shaderObject = VK_TRUE,
     };
 
-    return vkb::PhysicalDeviceSelector{instance}
-        .set_minimum_version(1, 3)
+    vkb::PhysicalDeviceSelector selector{instance};
+    selector.set_minimum_version(1, 3)
         .set_required_features_13(features13)
         .set_required_features_12(features12)
-        .set_required_features(features)
         .add_required_extension_features(shaderObjectFeature)
         .add_required_extension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME)
-        .set_surface(surface)
-        .select();
+        // Every compute kernel binds its per-pass inputs with push descriptors
+        .add_required_extension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    if (surface != VK_NULL_HANDLE)
+    {
+        selector.set_surface(surface);
+    }
+
+    return selector.select_devices();
+}
+
+// Enables what the device supports of the optional capabilities, which must
+// happen before the logical device is built. The dedicated compute queue
+// family is left for the logical device to resolve.
+auto enableCapabilities(vkb::PhysicalDevice& physicalDevice)
+    -> vkt::DeviceCapabilities
+{
+    vkt::DeviceCapabilities capabilities{};
+
+    VkPhysicalDeviceHostImageCopyFeaturesEXT const hostImageCopyFeature{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_HOST_IMAGE_COPY_FEATURES_EXT,
+        .pNext = nullptr,
+
+        .hostImageCopy = VK_TRUE,
+    };
+    capabilities.hostImageCopy =
+        physicalDevice.enable_extension_if_present(
+            VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME
+        )
+        && physicalDevice.enable_extension_features_if_present(
+            hostImageCopyFeature
+        );
+
+    capabilities.memoryBudget = physicalDevice.enable_extension_if_present(
+        VK_EXT_MEMORY_BUDGET_EXTENSION_NAME
+    );
+
+    capabilities.wideLines = physicalDevice.enable_features_if_present(
+        VkPhysicalDeviceFeatures{.wideLines = VK_TRUE}
+    );
+
+    return capabilities;
+}
+
+auto deviceLocalBytes(vkb::PhysicalDevice const& physicalDevice)
+    -> VkDeviceSize
+{
+    VkPhysicalDeviceMemoryProperties const& memory{
+        physicalDevice.memory_properties
+    };
+
+    VkDeviceSize largestHeap{0};
+    for (uint32_t index{0}; index < memory.memoryHeapCount; index++)
+    {
+        VkMemoryHeap const& heap{memory.memoryHeaps[index]};
+        if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0)
+        {
+            largestHeap = std::max(largestHeap, heap.size);
+        }
+    }
+    return largestHeap;
+}
+
+// Higher is better. The device type outweighs everything else, since a
+// discrete GPU is faster than an integrated one with any amount of memory.
+// Within a type, whole GiB of device local memory stand in for the device's
+// class, and optional capabilities break ties.
+auto scoreDevice(vkb::PhysicalDevice const& physicalDevice) -> int64_t
+{
+    int64_t typeRank{0};
+    switch (physicalDevice.properties.deviceType)
+    {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        typeRank = 4;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        typeRank = 3;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        typeRank = 2;
+        break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        typeRank = 1;
+        break;
+    default:
+        typeRank = 0;
+        break;
+    }
+
+    VkDeviceSize constexpr GIBIBYTE{1024ULL * 1024ULL * 1024ULL};
+    auto const memoryGiB{
+        static_cast<int64_t>(deviceLocalBytes(physicalDevice) / GIBIBYTE)
+    };
+
+    int64_t capabilityCount{
+        physicalDevice.has_separate_compute_queue() ? 1 : 0
+    };
+    for (char const* const extension :
+         {VK_EXT_HOST_IMAGE_COPY_EXTENSION_NAME,
+          VK_EXT_MEMORY_BUDGET_EXTENSION_NAME})
+    {
+        if (physicalDevice.is_extension_present(extension))
+        {
+            capabilityCount += 1;
+        }
+    }
+
+    return typeRank * 1'000'000 + memoryGiB * 100 + capabilityCount;
+}
+
+// The index of the device named by DEVICE_OVERRIDE_VARIABLE, if it is set and
+// names one.
+auto overriddenDevice(std::span<vkb::PhysicalDevice const> const devices)
+    -> std::optional<size_t>
+{
+    // NOLINTNEXTLINE(concurrency-mt-unsafe)
+    char const* const variable{std::getenv(DEVICE_OVERRIDE_VARIABLE)};
+    if (variable == nullptr || *variable == '\0')
+    {
+        return std::nullopt;
+    }
+    std::string_view const value{variable};
+
+    size_t index{0};
+    auto const [end, error]{
+        std::from_chars(value.data(), value.data() + value.size(), index)
+    };
+    if (error == std::errc{} && end == value.data() + value.size())
+    {
+        if (index < devices.size())
+        {
+            return index;
+        }
+    }
+    else
+    {
+        auto const match{std::find_if(
+            devices.begin(),
+            devices.end(),
+            [&](vkb::PhysicalDevice const& device)
+        { return device.name.find(value) != std::string::npos; }
+        )};
+        if (match != devices.end())
+        {
+            return static_cast<size_t>(match - devices.begin());
+        }
+    }
+
+    VKT_WARNING(
+        "{}='{}' does not name a suitable device, ignoring it.",
+        DEVICE_OVERRIDE_VARIABLE,
+        value
+    );
+    return std::nullopt;
+}
+
+struct SelectedDevice
+{
+    vkb::PhysicalDevice physicalDevice;
+    vkt::DeviceCapabilities capabilities;
+};
+
+// Picks the highest scoring suitable device, unless one is named through
+// DEVICE_OVERRIDE_VARIABLE, and enables its optional capabilities.
+auto selectPhysicalDevice(
+    vkb::Instance const& instance, VkSurfaceKHR const surface
+) -> std::optional<SelectedDevice>
+{
+    vkb::Result<std::vector<vkb::PhysicalDevice>> const devicesResult{
+        suitablePhysicalDevices(instance, surface)
+    };
+    if (!devicesResult.has_value())
+    {
+        VKT_LOG_VKB(devicesResult, "No physical device is suitable.");
+        return std::nullopt;
+    }
+    std::vector<vkb::PhysicalDevice> const& devices{devicesResult.value()};
+    if (devices.empty())
+    {
+        VKT_ERROR("No physical device is suitable.");
+        return std::nullopt;
+    }
+
+    size_t bestIndex{0};
+    std::vector<int64_t> scores{};
+    for (size_t index{0}; index < devices.size(); index++)
+    {
+        scores.push_back(scoreDevice(devices[index]));
+        if (scores[index] > scores[bestIndex])
+        {
+            bestIndex = index;
+        }
+
+        VKT_INFO(
+            "Suitable device {}: '{}' ({}), score {}",
+            index,
+            devices[index].name,
+            string_VkPhysicalDeviceType(devices[index].properties.deviceType),
+            scores[index]
+        );
+    }
+
+    size_t const selectedIndex{overriddenDevice(devices).value_or(bestIndex)};
+
+    SelectedDevice selected{
+        .physicalDevice = devices[selectedIndex],
+        .capabilities = {},
+    };
+    selected.capabilities = enableCapabilities(selected.physicalDevice);
+
+    VKT_INFO(
+        "Selected device {}: '{}'. Dedicated compute queue: {}, host image "
+        "copy: {}, memory budget: {}, wide lines: {}",
+        selectedIndex,
+        selected.physicalDevice.name,
+        selected.physicalDevice.has_separate_compute_queue(),
+        selected.capabilities.hostImageCopy,
+        selected.capabilities.memoryBudget,
+        selected.capabilities.wideLines
+    );
+
+    return selected;
 }
 
 auto createAllocator(
     VkPhysicalDevice const physicalDevice,
     VkDevice const device,
-    VkInstance const instance
+    VkInstance const instance,
+    vkt::DeviceCapabilities const& capabilities
 ) -> std::optional<VmaAllocator>
 {
     std::optional<VmaAllocator> allocatorResult{std::in_place};
     VmaAllocatorCreateInfo const allocatorInfo{
-        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT
+               | (capabilities.memoryBudget
+                      ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT
+                      : 0U),
         .physicalDevice = physicalDevice,
         .device = device,
         .instance = instance,
@@ -91,15 +333,32 @@ GraphicsContext::GraphicsContext(GraphicsContext&& other) noexcept
 
     m_universalQueue = std::exchange(other.m_universalQueue, VK_NULL_HANDLE);
     m_universalQueueFamily = std::exchange(other.m_universalQueueFamily, 0);
+    m_dedicatedComputeQueue =
+        std::exchange(other.m_dedicatedComputeQueue, VK_NULL_HANDLE);
+    m_capabilities = std::exchange(other.m_capabilities, {});
 
     m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
     m_descriptorAllocator = std::move(other.m_descriptorAllocator);
+    m_descriptorLayoutCache = std::move(other.m_descriptorLayoutCache);
+    m_bindlessHeap = std::move(other.m_bindlessHeap);
+    m_frameDataRing = std::move(other.m_frameDataRing);
 }
 
 GraphicsContext::~GraphicsContext() { destroy(); }
 
 auto GraphicsContext::create(PlatformWindow const& window)
     -> std::optional<GraphicsContext>
+{
+    return create(&window);
+}
+
+auto GraphicsContext::createHeadless() -> std::optional<GraphicsContext>
+{
+    return create(nullptr);
+}
+
+auto GraphicsContext::create(PlatformWindow const* const window)
+    -> std::optional<GraphicsContext>
 {
     std::optional<GraphicsContext> graphicsResult{
         std::in_place, GraphicsContext{}
@@ -112,13 +371,28 @@ auto GraphicsContext::create(PlatformWindow const& window)
         return std::nullopt;
     }
 
+    vkb::InstanceBuilder instanceBuilder{};
+    instanceBuilder.set_app_name("vulkan_template")
+        // Layers allocate on nearly every call, which would swamp any
+        // allocations the application makes.
+        .request_validation_layers(!heapAllocationsCounted())
+        .set_headless(window == nullptr)
+        .use_default_debug_messenger()
+        .require_api_version(1, 3, 0);
+
+    // Lets devices whose drivers lack shader objects still be selected, since
+    // every pass is recorded with them
+    if (vkb::Result<vkb::SystemInfo> const systemInfoResult{
+            vkb::SystemInfo::get_system_info()
+        };
+        systemInfoResult.has_value()
+        && systemInfoResult.value().is_layer_available(SHADER_OBJECT_LAYER))
+    {
+        instanceBuilder.enable_layer(SHADER_OBJECT_LAYER);
+    }
+
     vkb::Result<vkb::Instance> const instanceBuildResult{
-        vkb::InstanceBuilder{}
-            .set_app_name("vulkan_template")
-            .request_validation_layers()
-            .use_default_debug_messenger()
-            .require_api_version(1, 3, 0)
-            .build()
+        instanceBuilder.build()
     };
     if (!instanceBuildResult.has_value())
     {
@@ -134,25 +408,34 @@ auto GraphicsContext::create(PlatformWindow const& window)
     graphics.m_debugMessenger = instance.debug_messenger;
     graphics.m_instance = instance.instance;
 
-    if (VkResult const surfaceResult{glfwCreateWindowSurface(
-            instance.instance, window.handle(), nullptr, &graphics.m_surface
-        )};
+    if (VkResult const surfaceResult{
+            window == nullptr ? VK_SUCCESS
+                              : glfwCreateWindowSurface(
+                                    instance.instance,
+                                    window->handle(),
+                                    nullptr,
+                                    &graphics.m_surface
+                                )
+        };
         surfaceResult != VK_SUCCESS)
     {
         VKT_LOG_VK(surfaceResult, "Failed to create surface via GLFW.");
         return std::nullopt;
     }
 
-    vkb::Result<vkb::PhysicalDevice> physicalDeviceResult{
+    std::optional<SelectedDevice> const selectedResult{
         selectPhysicalDevice(instance, graphics.m_surface)
     };
-    if (!physicalDeviceResult.has_value())
+    if (!selectedResult.has_value())
     {
-        VKT_LOG_VKB(physicalDeviceResult, "Failed to select physical device.");
+        VKT_ERROR("Failed to select physical device.");
         return std::nullopt;
     }
-    vkb::PhysicalDevice const& physicalDevice{physicalDeviceResult.value()};
+    vkb::PhysicalDevice const& physicalDevice{
+        selectedResult.value().physicalDevice
+    };
     graphics.m_physicalDevice = physicalDevice.physical_device;
+    graphics.m_capabilities = selectedResult.value().capabilities;
 
     vkb::Result<vkb::Device> const deviceBuildResult{
         vkb::DeviceBuilder{physicalDevice}.build()
@@ -195,8 +478,29 @@ auto GraphicsContext::create(PlatformWindow const& window)
         return std::nullopt;
     }
 
+    // Every family gets a queue by default, so a separate compute family has
+    // one too
+    if (vkb::Result<uint32_t> const computeQueueFamilyResult{
+            device.get_queue_index(vkb::QueueType::compute)
+        };
+        computeQueueFamilyResult.has_value())
+    {
+        if (vkb::Result<VkQueue> const computeQueueResult{
+                device.get_queue(vkb::QueueType::compute)
+            };
+            computeQueueResult.has_value())
+        {
+            graphics.m_capabilities.dedicatedComputeQueueFamily =
+                computeQueueFamilyResult.value();
+            graphics.m_dedicatedComputeQueue = computeQueueResult.value();
+        }
+    }
+
     if (std::optional<VmaAllocator> const allocatorResult{createAllocator(
-            graphics.m_physicalDevice, graphics.m_device, graphics.m_instance
+            graphics.m_physicalDevice,
+            graphics.m_device,
+            graphics.m_instance,
+            graphics.m_capabilities
         )};
         allocatorResult.has_value())
     {
@@ -215,12 +519,14 @@ auto GraphicsContext::create(PlatformWindow const& window)
         {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0F}
     };
 
-    uint32_t constexpr MAX_SETS{100U};
+    // The allocator chains additional pools as needed, so this is only the
+    // starting capacity.
+    uint32_t constexpr INITIAL_SETS_PER_POOL{100U};
 
     if (std::optional<DescriptorAllocator> descriptorAllocatorResult{
             DescriptorAllocator::create(
                 graphics.m_device,
-                MAX_SETS,
+                INITIAL_SETS_PER_POOL,
                 poolSizes,
                 (VkDescriptorPoolCreateFlags)0
             )
@@ -237,6 +543,61 @@ auto GraphicsContext::create(PlatformWindow const& window)
         return std::nullopt;
     }
 
+    if (std::optional<DescriptorLayoutCache> layoutCacheResult{
+            DescriptorLayoutCache::create(graphics.m_device)
+        };
+        layoutCacheResult.has_value())
+    {
+        graphics.m_descriptorLayoutCache =
+            std::make_unique<DescriptorLayoutCache>(
+                std::move(layoutCacheResult).value()
+            );
+    }
+    else
+    {
+        VKT_ERROR("Failed to create Descriptor Layout Cache.");
+        return std::nullopt;
+    }
+
+    if (std::optional<BindlessHeap> bindlessHeapResult{BindlessHeap::create(
+            graphics.m_device,
+            *graphics.m_descriptorLayoutCache,
+            BindlessHeap::Capacity{},
+            static_cast<uint32_t>(FrameBuffer::FRAMES_IN_FLIGHT)
+        )};
+        bindlessHeapResult.has_value())
+    {
+        graphics.m_bindlessHeap = std::make_unique<BindlessHeap>(
+            std::move(bindlessHeapResult).value()
+        );
+    }
+    else
+    {
+        VKT_ERROR("Failed to create Bindless Heap.");
+        return std::nullopt;
+    }
+
+    // Enough for a few thousand parameter blocks per frame
+    VkDeviceSize constexpr FRAME_DATA_RING_CAPACITY{4ULL * 1024ULL * 1024ULL};
+
+    if (std::optional<GPURingBuffer> frameDataRingResult{GPURingBuffer::create(
+            graphics.m_device,
+            graphics.m_allocator,
+            FRAME_DATA_RING_CAPACITY,
+            static_cast<uint32_t>(FrameBuffer::FRAMES_IN_FLIGHT)
+        )};
+        frameDataRingResult.has_value())
+    {
+        graphics.m_frameDataRing = std::make_unique<GPURingBuffer>(
+            std::move(frameDataRingResult).value()
+        );
+    }
+    else
+    {
+        VKT_ERROR("Failed to create Frame Data Ring.");
+        return std::nullopt;
+    }
+
     return graphicsResult;
 }
 
@@ -263,6 +624,17 @@ auto GraphicsContext::universalQueueFamily() const -> uint32_t
     return m_universalQueueFamily;
 }
 
+// NOLINTNEXTLINE(readability-make-member-function-const)
+auto GraphicsContext::dedicatedComputeQueue() -> VkQueue
+{
+    return m_dedicatedComputeQueue;
+}
+
+auto GraphicsContext::capabilities() const -> DeviceCapabilities const&
+{
+    return m_capabilities;
+}
+
 // NOLINTNEXTLINE(readability-make-member-function-const)
 auto GraphicsContext::allocator() -> VmaAllocator { return m_allocator; }
 
@@ -271,9 +643,28 @@ auto GraphicsContext::descriptorAllocator() -> vkt::DescriptorAllocator&
     return *m_descriptorAllocator;
 }
 
+auto GraphicsContext::descriptorLayoutCache() -> vkt::DescriptorLayoutCache&
+{
+    return *m_descriptorLayoutCache;
+}
+
+auto GraphicsContext::bindlessHeap() -> vkt::BindlessHeap&
+{
+    return *m_bindlessHeap;
+}
+
+auto GraphicsContext::frameDataRing() -> vkt::GPURingBuffer&
+{
+    return *m_frameDataRing;
+}
+
 void GraphicsContext::destroy()
 {
+    // Must be destroyed before the allocator
+    m_frameDataRing.reset();
+    m_bindlessHeap.reset();
     m_descriptorAllocator.reset();
+    m_descriptorLayoutCache.reset();
 
     if (m_allocator != VK_NULL_HANDLE)
     {
@@ -283,6 +674,8 @@ void GraphicsContext::destroy()
 
     m_universalQueue = VK_NULL_HANDLE;
     m_universalQueueFamily = 0;
+    m_dedicatedComputeQueue = VK_NULL_HANDLE;
+    m_capabilities = {};
 
     if (m_device != VK_NULL_HANDLE)
     {
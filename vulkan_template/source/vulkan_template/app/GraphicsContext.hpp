@@ -1,7 +1,11 @@
 #pragma once
 
 #include "vulkan_template/app/DescriptorAllocator.hpp"
+#include "vulkan_template/app/DeviceCapabilities.hpp"
 #include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
+#include "vulkan_template/vulkan/GPURingBuffer.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
 #include <memory>
 #include <optional>
@@ -24,22 +28,42 @@ public:
     GraphicsContext(GraphicsContext&&) noexcept;
     ~GraphicsContext();
 
+    // Selects the suitable device with the highest score by type, memory, and
+    // optional capabilities. Set VKT_PHYSICAL_DEVICE to a device's index or
+    // part of its name, as logged here, to select it instead.
     static auto create(PlatformWindow const&) -> std::optional<GraphicsContext>;
+    // Without a window, surface, or presentation support, such as for
+    // rendering offscreen on a software driver like lavapipe.
+    static auto createHeadless() -> std::optional<GraphicsContext>;
 
     auto instance() -> VkInstance;
+    // Null when headless
     auto surface() -> VkSurfaceKHR;
     auto physicalDevice() -> VkPhysicalDevice;
     auto device() -> VkDevice;
     auto universalQueue() -> VkQueue;
     [[nodiscard]] auto universalQueueFamily() const -> uint32_t;
+    // Null when the device has no dedicated compute family. Its family is in
+    // capabilities().
+    auto dedicatedComputeQueue() -> VkQueue;
+
+    [[nodiscard]] auto capabilities() const -> DeviceCapabilities const&;
 
     auto allocator() -> VmaAllocator;
     auto descriptorAllocator() -> DescriptorAllocator&;
+    auto descriptorLayoutCache() -> DescriptorLayoutCache&;
+    auto bindlessHeap() -> BindlessHeap&;
+    // Per-frame parameter data for shaders, retired with the frames in flight.
+    auto frameDataRing() -> GPURingBuffer&;
 
 private:
     GraphicsContext() = default;
     void destroy();
 
+    // Headless when window is null
+    static auto create(PlatformWindow const* window)
+        -> std::optional<GraphicsContext>;
+
     VkInstance m_instance{VK_NULL_HANDLE};
     VkDebugUtilsMessengerEXT m_debugMessenger{VK_NULL_HANDLE};
     VkSurfaceKHR m_surface{VK_NULL_HANDLE};
@@ -48,8 +72,14 @@ private:
 
     VkQueue m_universalQueue{VK_NULL_HANDLE};
     uint32_t m_universalQueueFamily{};
+    VkQueue m_dedicatedComputeQueue{VK_NULL_HANDLE};
+
+    DeviceCapabilities m_capabilities{};
 
     VmaAllocator m_allocator{VK_NULL_HANDLE};
     std::unique_ptr<DescriptorAllocator> m_descriptorAllocator{};
+    std::unique_ptr<DescriptorLayoutCache> m_descriptorLayoutCache{};
+    std::unique_ptr<BindlessHeap> m_bindlessHeap{};
+    std::unique_ptr<GPURingBuffer> m_frameDataRing{};
 };
 } // namespace vkt
\ No newline at end of file
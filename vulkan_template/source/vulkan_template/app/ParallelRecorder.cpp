@@ -0,0 +1,139 @@
+#include "ParallelRecorder.hpp"
+
+#include "vulkan_template/app/DescriptorAllocator.hpp"
+#include "vulkan_template/app/FrameBuffer.hpp"
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <atomic>
+#include <optional>
+#include <span>
+
+namespace
+{
+auto recordPass(
+    VkDevice const device,
+    vkt::ThreadCommandPool& threadPool,
+    vkt::DescriptorAllocator& descriptorAllocator,
+    vkt::RecordingPass const& pass
+) -> std::optional<VkCommandBuffer>
+{
+    std::optional<VkCommandBuffer> const cmdResult{
+        threadPool.nextSecondary(device)
+    };
+    if (!cmdResult.has_value())
+    {
+        return std::nullopt;
+    }
+    VkCommandBuffer const cmd{cmdResult.value()};
+
+    // Passes run outside of any render pass, so nothing is inherited
+    VkCommandBufferInheritanceInfo const inheritanceInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = nullptr,
+    };
+    VkCommandBufferBeginInfo cmdBeginInfo{
+        vkt::commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+    };
+    cmdBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    VKT_TRY_VK(
+        vkBeginCommandBuffer(cmd, &cmdBeginInfo),
+        "Failed to begin secondary command buffer.",
+        std::nullopt
+    );
+
+    pass(cmd, descriptorAllocator);
+
+    VKT_TRY_VK(
+        vkEndCommandBuffer(cmd),
+        "Failed to end secondary command buffer.",
+        std::nullopt
+    );
+
+    return cmd;
+}
+} // namespace
+
+namespace vkt
+{
+auto recordingThreadCount(JobSystem const& jobSystem) -> size_t
+{
+    // Threads that are not workers share index 0
+    return jobSystem.workerCount() + 1;
+}
+
+auto recordParallel(
+    JobSystem& jobSystem,
+    VkDevice const device,
+    Frame& frame,
+    VkCommandBuffer const primary,
+    std::span<RecordingPass const> const passes
+) -> VkResult
+{
+    if (passes.empty())
+    {
+        return VK_SUCCESS;
+    }
+    if (frame.threadCommandPools.size() < recordingThreadCount(jobSystem)
+        || frame.threadDescriptorAllocators.size()
+               < recordingThreadCount(jobSystem))
+    {
+        VKT_ERROR(
+            "Frame has {} thread command pools and {} thread descriptor "
+            "allocators, but the job system has {} threads.",
+            frame.threadCommandPools.size(),
+            frame.threadDescriptorAllocators.size(),
+            recordingThreadCount(jobSystem)
+        );
+        return VK_ERROR_INITIALIZATION_FAILED;
+    }
+
+    std::span<VkCommandBuffer> const recorded{
+        frame.arena.allocateArray<VkCommandBuffer>(passes.size())
+    };
+    std::atomic<bool> failed{false};
+
+    // One pass per job, since passes vary widely in cost
+    jobSystem.parallelFor(
+        passes.size(),
+        1,
+        [&](size_t const begin, size_t const end)
+    {
+        size_t const threadIndex{JobSystem::threadIndex()};
+        ThreadCommandPool& threadPool{frame.threadCommandPools[threadIndex]};
+        DescriptorAllocator& descriptorAllocator{
+            frame.threadDescriptorAllocators[threadIndex]
+        };
+
+        for (size_t index{begin}; index < end; index++)
+        {
+            std::optional<VkCommandBuffer> const cmd{
+                recordPass(
+                    device, threadPool, descriptorAllocator, passes[index]
+                )
+            };
+            if (!cmd.has_value())
+            {
+                failed.store(true);
+                return;
+            }
+            recorded[index] = cmd.value();
+        }
+    }
+    );
+
+    if (failed.load())
+    {
+        VKT_ERROR("Failed to record passes in parallel.");
+        return VK_ERROR_UNKNOWN;
+    }
+
+    vkCmdExecuteCommands(
+        primary, static_cast<uint32_t>(recorded.size()), recorded.data()
+    );
+
+    return VK_SUCCESS;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <functional>
+#include <span>
+
+namespace vkt
+{
+struct DescriptorAllocator;
+struct Frame;
+struct JobSystem;
+} // namespace vkt
+
+namespace vkt
+{
+// Records commands into a secondary command buffer. Secondaries inherit no
+// state from the primary, so a pass must bind everything it uses, such as the
+// bindless heap. Passes that only capture a couple of references fit within
+// std::function's inline storage, so building them does not allocate.
+//
+// The allocator is the recording thread's transient one in the frame, for
+// descriptor sets that only live as long as the frame.
+using RecordingPass =
+    std::function<void(VkCommandBuffer, DescriptorAllocator&)>;
+
+// The number of recording threads that frames need resources for, to be used
+// with recordParallel.
+auto recordingThreadCount(JobSystem const&) -> size_t;
+
+// Spreads the passes across the job system's threads. Each thread records into
+// secondary command buffers from its own pool in the frame, and allocates from
+// its own descriptor allocator in the frame. The results
+// are executed in the primary in the order the passes were given. Blocks until
+// every pass is recorded. Nothing is executed if any pass fails to record.
+//
+// Threads that are not workers share a pool and an allocator, so only one of
+// them, such as the render thread, may record into a frame.
+//
+// Passes may run concurrently, so they must not record transitions for the
+// same images, since layouts are tracked on the CPU while recording.
+auto recordParallel(
+    JobSystem&,
+    VkDevice,
+    Frame&,
+    VkCommandBuffer primary,
+    std::span<RecordingPass const> passes
+) -> VkResult;
+} // namespace vkt
\ No newline at end of file
@@ -4,6 +4,80 @@
 #include <GLFW/glfw3.h>
 #include <utility>
 
+namespace
+{
+void markEventActivity(GLFWwindow* const window)
+{
+    auto* const activity{static_cast<bool*>(glfwGetWindowUserPointer(window))};
+    if (activity != nullptr)
+    {
+        *activity = true;
+    }
+}
+
+void installActivityCallbacks(GLFWwindow* const handle)
+{
+    glfwSetKeyCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t, int32_t, int32_t, int32_t)
+    { markEventActivity(window); }
+    );
+    glfwSetCharCallback(
+        handle,
+        [](GLFWwindow* const window, uint32_t) { markEventActivity(window); }
+    );
+    glfwSetMouseButtonCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t, int32_t, int32_t)
+    { markEventActivity(window); }
+    );
+    glfwSetCursorPosCallback(
+        handle,
+        [](GLFWwindow* const window, double, double)
+    { markEventActivity(window); }
+    );
+    glfwSetCursorEnterCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t) { markEventActivity(window); }
+    );
+    glfwSetScrollCallback(
+        handle,
+        [](GLFWwindow* const window, double, double)
+    { markEventActivity(window); }
+    );
+    glfwSetDropCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t, char const**)
+    { markEventActivity(window); }
+    );
+    glfwSetWindowFocusCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t) { markEventActivity(window); }
+    );
+    glfwSetWindowIconifyCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t) { markEventActivity(window); }
+    );
+    glfwSetWindowMaximizeCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t) { markEventActivity(window); }
+    );
+    glfwSetFramebufferSizeCallback(
+        handle,
+        [](GLFWwindow* const window, int32_t, int32_t)
+    { markEventActivity(window); }
+    );
+    glfwSetWindowContentScaleCallback(
+        handle,
+        [](GLFWwindow* const window, float, float)
+    { markEventActivity(window); }
+    );
+    glfwSetWindowRefreshCallback(
+        handle, [](GLFWwindow* const window) { markEventActivity(window); }
+    );
+}
+} // namespace
+
 namespace vkt
 {
 auto PlatformWindow::extent() const -> glm::u16vec2
@@ -21,6 +95,7 @@ auto PlatformWindow::extent() const -> glm::u16vec2
 PlatformWindow::PlatformWindow(PlatformWindow&& other) noexcept
 {
     m_handle = std::exchange(other.m_handle, nullptr);
+    m_eventActivity = std::move(other.m_eventActivity);
 }
 
 PlatformWindow::~PlatformWindow() { destroy(); }
@@ -54,6 +129,10 @@ auto PlatformWindow::create(glm::u16vec2 const extent)
 
     window.m_handle = handle;
 
+    window.m_eventActivity = std::make_unique<bool>(true);
+    glfwSetWindowUserPointer(handle, window.m_eventActivity.get());
+    installActivityCallbacks(handle);
+
     return windowResult;
 }
 
@@ -61,7 +140,18 @@ void PlatformWindow::destroy()
 {
     glfwDestroyWindow(m_handle);
     m_handle = nullptr;
+    m_eventActivity.reset();
 }
 
 auto PlatformWindow::handle() const -> GLFWwindow* { return m_handle; }
+
+auto PlatformWindow::takeEventActivity() -> bool
+{
+    if (m_eventActivity == nullptr)
+    {
+        return false;
+    }
+
+    return std::exchange(*m_eventActivity, false);
+}
 } // namespace vkt
\ No newline at end of file
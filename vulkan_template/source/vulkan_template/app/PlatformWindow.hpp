@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/vec2.hpp>
+#include <memory>
 #include <optional>
 
 struct GLFWwindow;
@@ -22,12 +23,22 @@ private:
     void destroy();
 
 public:
+    // Installs window callbacks that track event activity. The UI backend
+    // chains these, so this must be created before the UILayer.
     static auto create(glm::u16vec2 extent) -> std::optional<PlatformWindow>;
 
     [[nodiscard]] auto extent() const -> glm::u16vec2;
     [[nodiscard]] auto handle() const -> GLFWwindow*;
 
+    // Returns whether any input or window event has arrived since the last
+    // call. Starts out true so the first frame is drawn.
+    auto takeEventActivity() -> bool;
+
 private:
     GLFWwindow* m_handle{nullptr};
+
+    // Set by the callbacks through the GLFW user pointer, so it is heap
+    // allocated to stay put when the window is moved.
+    std::unique_ptr<bool> m_eventActivity{};
 };
 } // namespace vkt
\ No newline at end of file
@@ -1,33 +1,77 @@
 #include "PostProcess.hpp"
 
-#include "vulkan_template/app/DescriptorAllocator.hpp"
 #include "vulkan_template/app/RenderTarget.hpp"
-#include "vulkan_template/core/Integer.hpp"
 #include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
 #include "vulkan_template/vulkan/ImageView.hpp"
-#include "vulkan_template/vulkan/Shader.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
-#include <filesystem>
+#include "vulkan_template/vulkan/WorkgroupAutotuner.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #include <glm/vec2.hpp>
-#include <span>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace detail
 {
-struct PushConstant
+char const* const OETF_SHADER_PATH{"shaders/oetf_srgb.comp.spv"};
+
+// Half floats in [0, 1] have bit patterns from 0 up to that of 1.0, matching
+// TABLE_LAST_INDEX in oetf_srgb.comp
+uint32_t constexpr TABLE_LAST_INDEX{0x3C00};
+uint32_t constexpr TABLE_WORDS{TABLE_LAST_INDEX / 2 + 1};
+
+auto halfToFloat(uint32_t const bits) -> double
 {
-    glm::vec2 offset;
-};
+    uint32_t const exponent{(bits >> 10U) & 0x1FU};
+    double const mantissa{static_cast<double>(bits & 0x3FFU) / 1024.0};
+
+    // Only non-negative finite values are in the table
+    if (exponent == 0)
+    {
+        return std::ldexp(mantissa, -14);
+    }
+    return std::ldexp(1.0 + mantissa, static_cast<int>(exponent) - 15);
+}
+
+// Transfer function as defined in
+// https://www.color.org/chardata/rgb/srgb.xalter
+auto encodeUnorm16(double const linear) -> uint32_t
+{
+    double const nonlinear{
+        linear <= 0.0031308 ? linear * 12.92
+                            : std::pow(linear, 1.0 / 2.4) * 1.055 - 0.055
+    };
+    return static_cast<uint32_t>(
+        std::nearbyint(std::clamp(nonlinear, 0.0, 1.0) * 65535.0)
+    );
+}
+
+auto encodingTable() -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> words(TABLE_WORDS, 0);
+    for (uint32_t index{0}; index <= TABLE_LAST_INDEX; index++)
+    {
+        words[index / 2] |= encodeUnorm16(halfToFloat(index))
+                         << ((index % 2) * 16U);
+    }
+    return words;
+}
 } // namespace detail
 
 auto vkt::PostProcess::operator=(PostProcess&& other) -> PostProcess&
 {
-    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
-    m_oetfSRGB = std::exchange(other.m_oetfSRGB, VK_NULL_HANDLE);
-    m_oetfSRGBLayout = std::exchange(other.m_oetfSRGBLayout, VK_NULL_HANDLE);
-    m_transferSingletonLayout =
-        std::exchange(other.m_transferSingletonLayout, VK_NULL_HANDLE);
+    destroy();
+
+    m_encoding = std::exchange(other.m_encoding, SRGBEncoding::EXACT);
+    m_oetfSRGB = std::exchange(other.m_oetfSRGB, std::nullopt);
+
+    m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+    m_tableAllocation = std::exchange(other.m_tableAllocation, VK_NULL_HANDLE);
+    m_table = std::exchange(other.m_table, VK_NULL_HANDLE);
 
     return *this;
 }
@@ -37,141 +81,181 @@ vkt::PostProcess::PostProcess(PostProcess&& other) noexcept
     *this = std::move(other);
 }
 
-vkt::PostProcess::~PostProcess()
+vkt::PostProcess::~PostProcess() { destroy(); }
+
+void vkt::PostProcess::destroy() noexcept
 {
-    if (m_device != VK_NULL_HANDLE)
+    m_oetfSRGB.reset();
+
+    if (m_allocator != VK_NULL_HANDLE)
     {
-        vkDestroyShaderEXT(m_device, m_oetfSRGB, nullptr);
-        vkDestroyPipelineLayout(m_device, m_oetfSRGBLayout, nullptr);
-        vkDestroyDescriptorSetLayout(
-            m_device, m_transferSingletonLayout, nullptr
-        );
+        vmaDestroyBuffer(m_allocator, m_table, m_tableAllocation);
     }
+
+    m_allocator = VK_NULL_HANDLE;
+    m_tableAllocation = VK_NULL_HANDLE;
+    m_table = VK_NULL_HANDLE;
 }
 
-auto vkt::PostProcess::create(VkDevice const device)
-    -> std::optional<PostProcess>
+auto vkt::PostProcess::create(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    BindlessHeap const& bindlessHeap,
+    DescriptorLayoutCache& layoutCache,
+    SRGBEncoding const encoding
+) -> std::optional<PostProcess>
 {
-    char const* OETF_SHADER_PATH{"shaders/oetf_srgb.comp.spv"};
-
     std::optional<PostProcess> result{std::in_place, PostProcess{}};
     PostProcess& postProcess{result.value()};
 
-    postProcess.m_device = device;
-
-    auto const layoutResult{
-        DescriptorLayoutBuilder{}
-            .pushBinding(DescriptorLayoutBuilder::BindingParams{
-                .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                .stageMask = VK_SHADER_STAGE_COMPUTE_BIT,
-                .bindingFlags = 0,
-            })
-            .build(device, 0)
-    };
-
-    if (!layoutResult.has_value())
-    {
-        VKT_ERROR("Failed to allocate singleton descriptor layout.");
-        return std::nullopt;
-    }
-    postProcess.m_transferSingletonLayout = layoutResult.value();
+    postProcess.m_encoding = encoding;
 
-    std::vector<VkDescriptorSetLayout> const layouts{
-        postProcess.m_transferSingletonLayout
+    // Specialization leaves the table statically used by the shader, so its
+    // binding must be valid for every encoding. Only LUT reads it, so the
+    // other encodings get a placeholder of one word that is never written.
+    bool const readsTable{encoding == SRGBEncoding::LUT};
+    std::vector<uint32_t> const table{
+        readsTable ? detail::encodingTable() : std::vector<uint32_t>(1, 0)
     };
-    std::vector<VkPushConstantRange> const ranges{VkPushConstantRange{
-        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
-        .offset = 0,
-        .size = sizeof(detail::PushConstant)
-    }};
-    VkSpecializationInfo const specialization{};
-
-    std::optional<VkShaderEXT> const shaderResult = loadShaderObject(
-        device,
-        OETF_SHADER_PATH,
-        VK_SHADER_STAGE_COMPUTE_BIT,
-        (VkFlags)0,
-        layouts,
-        ranges,
-        specialization
-    );
-    if (!shaderResult.has_value())
-    {
-        VKT_ERROR("Failed to compile shader.");
-        return std::nullopt;
-    }
-    postProcess.m_oetfSRGB = shaderResult.value();
+    size_t const tableBytes{table.size() * sizeof(uint32_t)};
 
-    VkPipelineLayoutCreateInfo const layoutCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+    VkBufferCreateInfo const bufferInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .pNext = nullptr,
 
         .flags = 0,
 
-        .setLayoutCount = static_cast<uint32_t>(layouts.size()),
-        .pSetLayouts = layouts.data(),
+        .size = tableBytes,
+        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
 
-        .pushConstantRangeCount = static_cast<uint32_t>(ranges.size()),
-        .pPushConstantRanges = ranges.data(),
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
     };
 
-    if (VkResult const pipelineLayoutResult{vkCreatePipelineLayout(
-            device, &layoutCreateInfo, nullptr, &postProcess.m_oetfSRGBLayout
-        )};
-        pipelineLayoutResult != VK_SUCCESS)
+    // Written once before any submission, so no staging copy or barrier is
+    // needed. Devices without host visible device local memory read the table
+    // over the bus, but it is small enough to stay in the GPU's caches.
+    VmaAllocationCreateInfo const allocationInfo{
+        .flags = readsTable
+                   ? VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                         | VMA_ALLOCATION_CREATE_MAPPED_BIT
+                   : VmaAllocationCreateFlags{0},
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+
+    VmaAllocationInfo mappedInfo{};
+    VKT_TRY_VK(
+        vmaCreateBuffer(
+            allocator,
+            &bufferInfo,
+            &allocationInfo,
+            &postProcess.m_table,
+            &postProcess.m_tableAllocation,
+            &mappedInfo
+        ),
+        "Failed to allocate sRGB encoding table.",
+        std::nullopt
+    );
+    postProcess.m_allocator = allocator;
+
+    if (readsTable)
     {
-        VKT_LOG_VK(pipelineLayoutResult, "Failed to create pipeline layout.");
+        std::memcpy(mappedInfo.pMappedData, table.data(), tableBytes);
+        VKT_TRY_VK(
+            vmaFlushAllocation(
+                allocator, postProcess.m_tableAllocation, 0, VK_WHOLE_SIZE
+            ),
+            "Failed to flush sRGB encoding table.",
+            std::nullopt
+        );
+    }
+
+    std::array<uint32_t, 1> const constants{static_cast<uint32_t>(encoding)};
+    postProcess.m_oetfSRGB = OETFKernel::create(
+        device,
+        bindlessHeap,
+        layoutCache,
+        detail::OETF_SHADER_PATH,
+        WorkgroupSize{},
+        constants
+    );
+    if (!postProcess.m_oetfSRGB.has_value())
+    {
+        VKT_ERROR("Failed to compile shader.");
         return std::nullopt;
     }
 
     return result;
 }
 
+auto vkt::PostProcess::checkKernelInterfaces() -> bool
+{
+    std::array<uint32_t, 1> const constants{
+        static_cast<uint32_t>(SRGBEncoding::EXACT)
+    };
+    return OETFKernel::checkInterface(detail::OETF_SHADER_PATH, constants);
+}
+
 void vkt::PostProcess::recordLinearToSRGB(
     VkCommandBuffer const cmd, RenderTarget& texture
 )
 {
-    VkShaderStageFlagBits const stage{VK_SHADER_STAGE_COMPUTE_BIT};
-    std::vector<VkDescriptorSet> descriptors{texture.singletonDescriptor()};
-
-    texture.color().recordTransitionBarriered(cmd, VK_IMAGE_LAYOUT_GENERAL);
+    recordDispatch(cmd, m_oetfSRGB.value().variant(), texture);
+}
 
-    vkCmdBindShadersEXT(cmd, 1, &stage, &m_oetfSRGB);
+auto vkt::PostProcess::encoding() const -> SRGBEncoding { return m_encoding; }
 
-    vkCmdBindDescriptorSets(
-        cmd,
-        VK_PIPELINE_BIND_POINT_COMPUTE,
-        m_oetfSRGBLayout,
-        0,
-        VKR_ARRAY(descriptors),
-        VKR_ARRAY_NONE
+void vkt::PostProcess::autotune(
+    WorkgroupAutotuner& autotuner,
+    BindlessHeap const& bindlessHeap,
+    DescriptorLayoutCache& layoutCache,
+    RenderTarget& benchmarkTarget
+)
+{
+    m_oetfSRGB.value().autotune(
+        autotuner,
+        std::string{"oetf_srgb.comp."} + srgbEncodingName(m_encoding),
+        bindlessHeap,
+        layoutCache,
+        [&](VkCommandBuffer const cmd, OETFKernel::Variant const variant)
+    { recordDispatch(cmd, variant, benchmarkTarget); }
     );
+}
 
-    uint32_t constexpr WORKGROUP_SIZE{16};
+void vkt::PostProcess::recordDispatch(
+    VkCommandBuffer const cmd,
+    OETFKernel::Variant const variant,
+    RenderTarget& texture
+)
+{
+    texture.color().recordTransitionBarriered(cmd, VK_IMAGE_LAYOUT_GENERAL);
 
     VkRect2D const drawRect{texture.size()};
-    detail::PushConstant const pc{
-        .offset =
+    OETFPushConstants const pc{
+        .drawOffset =
             glm::vec2{
                 static_cast<float>(drawRect.offset.x),
                 static_cast<float>(drawRect.offset.y)
-            }
+            },
     };
 
-    vkCmdPushConstants(
-        cmd,
-        m_oetfSRGBLayout,
-        VK_SHADER_STAGE_COMPUTE_BIT,
-        0,
-        sizeof(detail::PushConstant),
-        &pc
-    );
-
-    vkt::computeDispatch(
+    m_oetfSRGB.value().record(
         cmd,
+        variant,
+        pc,
         VkExtent3D{drawRect.extent.width, drawRect.extent.height, 1},
-        WORKGROUP_SIZE
+        StorageImageBinding{
+            .view = texture.color().view(),
+            .layout = VK_IMAGE_LAYOUT_GENERAL,
+        },
+        StorageBufferBinding{
+            .buffer = m_table,
+            .offset = 0,
+            .range = VK_WHOLE_SIZE,
+        }
     );
 
+    VkShaderStageFlagBits const stage{VK_SHADER_STAGE_COMPUTE_BIT};
     vkCmdBindShadersEXT(cmd, 1, &stage, nullptr);
-}
+}
\ No newline at end of file
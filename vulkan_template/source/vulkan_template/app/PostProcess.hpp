@@ -1,11 +1,17 @@
 #pragma once
 
+#include "vulkan_template/core/CPUKernels.hpp"
+#include "vulkan_template/vulkan/ComputeKernel.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <glm/vec2.hpp>
 #include <optional>
 
 namespace vkt
 {
+struct BindlessHeap;
+struct DescriptorLayoutCache;
 struct RenderTarget;
+struct WorkgroupAutotuner;
 } // namespace vkt
 
 namespace vkt
@@ -20,19 +26,65 @@ struct PostProcess
 
     ~PostProcess();
 
-    static auto create(VkDevice) -> std::optional<PostProcess>;
+    // The encoding is baked into the shader through a specialization
+    // constant, so the unused paths cost nothing. EXACT matches the transfer
+    // function within float precision. POLYNOMIAL avoids transcendental
+    // instructions and stays within one 16-bit step of EXACT. LUT reads a
+    // 30KiB table indexed by half float, which rounds the input enough to be
+    // off by about a dozen 16-bit steps, still far below one 8-bit step.
+    static auto create(
+        VkDevice,
+        VmaAllocator,
+        BindlessHeap const&,
+        DescriptorLayoutCache&,
+        SRGBEncoding
+    ) -> std::optional<PostProcess>;
+
+    // Checks the shader's SPIR-V against the host-side interface, without a
+    // device.
+    static auto checkKernelInterfaces() -> bool;
 
     // Assumes the input texture is linearly encoded. Schedules compute work to
-    // in-place convert to nonlinear SRGB encoding.
+    // in-place convert to nonlinear SRGB encoding. The texture is pushed as a
+    // descriptor each call, so any texture may be passed without allocating
+    // sets. A bound bindless heap is left undisturbed.
     void recordLinearToSRGB(VkCommandBuffer, RenderTarget&);
 
+    [[nodiscard]] auto encoding() const -> SRGBEncoding;
+
+    // Picks the fastest workgroup size for this device by converting
+    // benchmarkTarget, and recreates the shader with it. The contents of
+    // benchmarkTarget are overwritten.
+    void autotune(
+        WorkgroupAutotuner&,
+        BindlessHeap const&,
+        DescriptorLayoutCache&,
+        RenderTarget& benchmarkTarget
+    );
+
 private:
     PostProcess() = default;
+    void destroy() noexcept;
+
+    // Matches the push constant block in oetf_srgb.comp
+    struct OETFPushConstants
+    {
+        glm::vec2 drawOffset{};
+    };
+    using OETFKernel = ComputeKernel<
+        OETFPushConstants,
+        StorageImageBinding,
+        StorageBufferBinding>;
+
+    void recordDispatch(VkCommandBuffer, OETFKernel::Variant, RenderTarget&);
 
-    VkDevice m_device{VK_NULL_HANDLE};
+    SRGBEncoding m_encoding{SRGBEncoding::EXACT};
+    std::optional<OETFKernel> m_oetfSRGB{};
 
-    VkDescriptorSetLayout m_transferSingletonLayout{};
-    VkShaderEXT m_oetfSRGB{VK_NULL_HANDLE};
-    VkPipelineLayout m_oetfSRGBLayout{VK_NULL_HANDLE};
+    // Read by the LUT encoding. The shader's binding must still be valid for
+    // the other encodings, which get a one word placeholder instead.
+    VmaAllocator m_allocator{VK_NULL_HANDLE};
+    VmaAllocation m_tableAllocation{VK_NULL_HANDLE};
+    VkBuffer m_table{VK_NULL_HANDLE};
 };
 } // namespace vkt
\ No newline at end of file
@@ -1,15 +1,10 @@
 #include "RenderTarget.hpp"
 
-#include "vulkan_template/app/DescriptorAllocator.hpp"
 #include "vulkan_template/core/Log.hpp"
 #include "vulkan_template/vulkan/Image.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
 #include "vulkan_template/vulkan/VulkanStructs.hpp"
-#include <array>
-#include <imgui.h>
-#include <span>
 #include <utility>
-#include <vector>
 
 namespace vkt
 {
@@ -24,7 +19,7 @@ auto RenderTarget::operator=(RenderTarget&& other) noexcept -> RenderTarget&
 
     m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
 
-    m_descriptorPool = std::move(other.m_descriptorPool);
+    m_bindlessHeap = std::exchange(other.m_bindlessHeap, nullptr);
 
     m_colorSampler = std::exchange(other.m_colorSampler, VK_NULL_HANDLE);
     m_color = std::move(other.m_color);
@@ -32,15 +27,7 @@ auto RenderTarget::operator=(RenderTarget&& other) noexcept -> RenderTarget&
     m_depthSampler = std::exchange(other.m_depthSampler, VK_NULL_HANDLE);
     m_depth = std::move(other.m_depth);
 
-    m_singletonDescriptorLayout =
-        std::exchange(other.m_singletonDescriptorLayout, VK_NULL_HANDLE);
-    m_singletonDescriptor =
-        std::exchange(other.m_singletonDescriptor, VK_NULL_HANDLE);
-
-    m_combinedDescriptorLayout =
-        std::exchange(other.m_combinedDescriptorLayout, VK_NULL_HANDLE);
-    m_combinedDescriptor =
-        std::exchange(other.m_combinedDescriptor, VK_NULL_HANDLE);
+    m_bindless = std::exchange(other.m_bindless, {});
 
     return *this;
 }
@@ -50,29 +37,14 @@ RenderTarget::~RenderTarget() { destroy(); }
 auto RenderTarget::create(
     VkDevice const device,
     VmaAllocator const allocator,
+    BindlessHeap& bindlessHeap,
     CreateParameters const parameters
 ) -> std::optional<RenderTarget>
 {
-    if (ImGui::GetIO().BackendRendererUserData == nullptr)
-    {
-        VKT_ERROR("ImGui backend not initialized.");
-        return std::nullopt;
-    }
-
     std::optional<RenderTarget> result{RenderTarget{}};
     RenderTarget& renderTarget{result.value()};
     renderTarget.m_device = device;
-
-    std::array<DescriptorAllocator::PoolSizeRatio, 2> poolRatios{
-        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        1.0F,
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-        1.0F,
-    };
-    renderTarget.m_descriptorPool =
-        std::make_unique<DescriptorAllocator>(DescriptorAllocator::create(
-            device, 4, poolRatios, static_cast<VkFlags>(0)
-        ));
+    renderTarget.m_bindlessHeap = &bindlessHeap;
 
     VkImageUsageFlags const colorUsage{
         VK_IMAGE_USAGE_TRANSFER_SRC_BIT
@@ -164,150 +136,48 @@ auto RenderTarget::create(
         return std::nullopt;
     }
 
-    if (auto const singletonResult{allocateSingletonLayout(device)};
-        singletonResult.has_value())
-    {
-        renderTarget.m_singletonDescriptorLayout = singletonResult.value();
-        renderTarget.m_singletonDescriptor =
-            renderTarget.m_descriptorPool->allocate(
-                device, renderTarget.m_singletonDescriptorLayout
-            );
-    }
-    else
-    {
-        VKT_ERROR("Failed to allocate singleton descriptor layout.");
-        return std::nullopt;
-    }
-
-    if (auto const combinedResult{allocateCombinedLayout(device)};
-        combinedResult.has_value())
-    {
-        renderTarget.m_combinedDescriptorLayout = combinedResult.value();
-        renderTarget.m_combinedDescriptor =
-            renderTarget.m_descriptorPool->allocate(
-                device, renderTarget.m_combinedDescriptorLayout
-            );
-    }
-    else
-    {
-        VKT_ERROR("Failed to allocate combined descriptor layout.");
-        return std::nullopt;
-    }
+    BindlessHandles& handles{renderTarget.m_bindless};
 
-    {
-        VkDescriptorImageInfo const colorInfo{
-            .sampler = VK_NULL_HANDLE,
-            .imageView = renderTarget.m_color->view(),
-            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
-        };
-        VkDescriptorImageInfo const depthInfo{
-            .sampler = renderTarget.m_depthSampler,
-            .imageView = renderTarget.m_depth->view(),
-            .imageLayout = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
-        };
-
-        VkWriteDescriptorSet const singletonColorWrite{
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .pNext = nullptr,
-
-            .dstSet = renderTarget.m_singletonDescriptor,
-            .dstBinding = 0,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-
-            .pImageInfo = &colorInfo,
-            .pBufferInfo = nullptr,
-            .pTexelBufferView = nullptr,
-        };
-
-        VkWriteDescriptorSet const combinedColorWrite{
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .pNext = nullptr,
-
-            .dstSet = renderTarget.m_combinedDescriptor,
-            .dstBinding = 0,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-
-            .pImageInfo = &colorInfo,
-            .pBufferInfo = nullptr,
-            .pTexelBufferView = nullptr,
-        };
-
-        VkWriteDescriptorSet const combinedDepthWrite{
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .pNext = nullptr,
-
-            .dstSet = renderTarget.m_combinedDescriptor,
-            .dstBinding = 1,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-
-            .pImageInfo = &depthInfo,
-            .pBufferInfo = nullptr,
-            .pTexelBufferView = nullptr,
-        };
-
-        std::vector<VkWriteDescriptorSet> const writes{
-            singletonColorWrite, combinedColorWrite, combinedDepthWrite
-        };
-
-        vkUpdateDescriptorSets(device, VKR_ARRAY(writes), VKR_ARRAY_NONE);
-    }
-
-    return result;
-}
-
-auto RenderTarget::allocateSingletonLayout(VkDevice const device)
-    -> std::optional<VkDescriptorSetLayout>
-{
-    auto const layoutResult{
-        DescriptorLayoutBuilder{}
-            .pushBinding(DescriptorLayoutBuilder::BindingParams{
-                .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                .stageMask = VK_SHADER_STAGE_COMPUTE_BIT,
-                .bindingFlags = 0,
-            })
-            .build(device, 0)
+    std::optional<StorageImageHandle> const colorStorageResult{
+        bindlessHeap.registerStorageImage(
+            renderTarget.m_color->view(), VK_IMAGE_LAYOUT_GENERAL
+        )
     };
-
-    if (!layoutResult.has_value())
-    {
-        VKT_ERROR("Failed to allocate singleton descriptor layout.");
-        return std::nullopt;
-    }
-
-    return layoutResult.value();
-}
-
-auto RenderTarget::allocateCombinedLayout(VkDevice const device)
-    -> std::optional<VkDescriptorSetLayout>
-{
-    auto const layoutResult{
-        DescriptorLayoutBuilder{}
-            .pushBinding(DescriptorLayoutBuilder::BindingParams{
-                .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-                .stageMask = VK_SHADER_STAGE_COMPUTE_BIT,
-                .bindingFlags = 0,
-            })
-            .pushBinding(DescriptorLayoutBuilder::BindingParams{
-                .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-                .stageMask = VK_SHADER_STAGE_COMPUTE_BIT,
-                .bindingFlags = 0,
-            })
-            .build(device, 0)
+    std::optional<SampledImageHandle> const colorSampledResult{
+        bindlessHeap.registerSampledImage(
+            renderTarget.m_color->view(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        )
+    };
+    std::optional<SampledImageHandle> const depthSampledResult{
+        bindlessHeap.registerSampledImage(
+            renderTarget.m_depth->view(),
+            VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL
+        )
+    };
+    std::optional<SamplerHandle> const colorSamplerResult{
+        bindlessHeap.registerSampler(renderTarget.m_colorSampler)
+    };
+    std::optional<SamplerHandle> const depthSamplerResult{
+        bindlessHeap.registerSampler(renderTarget.m_depthSampler)
     };
 
-    if (!layoutResult.has_value())
-    {
+    // Store whatever succeeded, so destroy() releases it on failure.
+    handles.colorStorage = colorStorageResult.value_or(StorageImageHandle{});
+    handles.colorSampled = colorSampledResult.value_or(SampledImageHandle{});
+    handles.depthSampled = depthSampledResult.value_or(SampledImageHandle{});
+    handles.colorSampler = colorSamplerResult.value_or(SamplerHandle{});
+    handles.depthSampler = depthSamplerResult.value_or(SamplerHandle{});
 
-        VKT_ERROR("Failed to allocate combined descriptor layout.");
+    if (!handles.colorStorage.valid() || !handles.colorSampled.valid()
+        || !handles.depthSampled.valid() || !handles.colorSampler.valid()
+        || !handles.depthSampler.valid())
+    {
+        VKT_ERROR("Failed to register render target in bindless heap.");
         return std::nullopt;
     }
-    return layoutResult.value();
+
+    return result;
 }
 
 auto RenderTarget::colorSampler() const -> VkSampler { return m_colorSampler; }
@@ -320,24 +190,9 @@ auto RenderTarget::depth() -> ImageView& { return *m_depth; }
 
 auto RenderTarget::depth() const -> ImageView const& { return *m_depth; }
 
-auto RenderTarget::singletonDescriptor() const -> VkDescriptorSet
-{
-    return m_singletonDescriptor;
-}
-
-auto RenderTarget::singletonLayout() const -> VkDescriptorSetLayout
-{
-    return m_singletonDescriptorLayout;
-}
-
-auto RenderTarget::combinedDescriptor() const -> VkDescriptorSet
-{
-    return m_combinedDescriptor;
-}
-
-auto RenderTarget::combinedDescriptorLayout() const -> VkDescriptorSetLayout
+auto RenderTarget::bindless() const -> BindlessHandles const&
 {
-    return m_combinedDescriptorLayout;
+    return m_bindless;
 }
 
 void RenderTarget::setSize(VkRect2D const size) { m_size = size; }
@@ -346,26 +201,39 @@ auto RenderTarget::size() const -> VkRect2D { return m_size; }
 
 void RenderTarget::destroy() noexcept
 {
+    if (m_bindlessHeap != nullptr)
+    {
+        if (m_bindless.colorStorage.valid())
+        {
+            m_bindlessHeap->release(m_bindless.colorStorage);
+        }
+        if (m_bindless.colorSampled.valid())
+        {
+            m_bindlessHeap->release(m_bindless.colorSampled);
+        }
+        if (m_bindless.depthSampled.valid())
+        {
+            m_bindlessHeap->release(m_bindless.depthSampled);
+        }
+        if (m_bindless.colorSampler.valid())
+        {
+            m_bindlessHeap->release(m_bindless.colorSampler);
+        }
+        if (m_bindless.depthSampler.valid())
+        {
+            m_bindlessHeap->release(m_bindless.depthSampler);
+        }
+    }
+
+    m_bindlessHeap = nullptr;
+    m_bindless = {};
+
     if (m_device != VK_NULL_HANDLE)
     {
-        vkDestroyDescriptorSetLayout(
-            m_device, m_singletonDescriptorLayout, nullptr
-        );
-        vkDestroyDescriptorSetLayout(
-            m_device, m_combinedDescriptorLayout, nullptr
-        );
         vkDestroySampler(m_device, m_colorSampler, nullptr);
         vkDestroySampler(m_device, m_depthSampler, nullptr);
     }
 
-    m_descriptorPool.reset();
-
-    m_singletonDescriptorLayout = VK_NULL_HANDLE;
-    m_singletonDescriptor = VK_NULL_HANDLE;
-
-    m_combinedDescriptorLayout = VK_NULL_HANDLE;
-    m_combinedDescriptor = VK_NULL_HANDLE;
-
     m_color.reset();
 
     m_colorSampler = VK_NULL_HANDLE;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "vulkan_template/app/DescriptorAllocator.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
 #include "vulkan_template/vulkan/ImageView.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
 #include <memory>
@@ -29,8 +29,11 @@ struct RenderTarget
     // it, so windows can be resized without reallocation.
     // Thus the texture should be large enough to handle as large as the window
     // is expected to get.
-    static auto create(VkDevice, VmaAllocator, CreateParameters)
-        -> std::optional<RenderTarget>;
+    // The images and samplers are registered in the heap for the lifetime of
+    // the render target.
+    static auto create(
+        VkDevice, VmaAllocator, BindlessHeap&, CreateParameters
+    ) -> std::optional<RenderTarget>;
 
     [[nodiscard]] auto colorSampler() const -> VkSampler;
 
@@ -39,21 +42,21 @@ struct RenderTarget
     auto depth() -> ImageView&;
     [[nodiscard]] auto depth() const -> ImageView const&;
 
-    // layout(binding = 0) uniform image2D image;
-
-    [[nodiscard]] auto singletonDescriptor() const -> VkDescriptorSet;
-    [[nodiscard]] auto singletonLayout() const -> VkDescriptorSetLayout;
-    static auto allocateSingletonLayout(VkDevice)
-        -> std::optional<VkDescriptorSetLayout>;
-
-    // layout(binding = 0) uniform image2D image;
-    // layout(binding = 1) uniform sampler2D fragmentDepth;
-
-    [[nodiscard]] auto combinedDescriptor() const -> VkDescriptorSet;
-    [[nodiscard]] auto combinedDescriptorLayout() const
-        -> VkDescriptorSetLayout;
-    static auto allocateCombinedLayout(VkDevice)
-        -> std::optional<VkDescriptorSetLayout>;
+    // Indices into the bindless heap, to be passed to shaders through push
+    // constants.
+    struct BindlessHandles
+    {
+        // Expects VK_IMAGE_LAYOUT_GENERAL
+        StorageImageHandle colorStorage{};
+        // Expects VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        SampledImageHandle colorSampled{};
+        // Expects VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL
+        SampledImageHandle depthSampled{};
+
+        SamplerHandle colorSampler{};
+        SamplerHandle depthSampler{};
+    };
+    [[nodiscard]] auto bindless() const -> BindlessHandles const&;
 
     void setSize(VkRect2D);
     [[nodiscard]] auto size() const -> VkRect2D;
@@ -69,17 +72,14 @@ private:
     // The device used to create this.
     VkDevice m_device{VK_NULL_HANDLE};
 
-    std::unique_ptr<DescriptorAllocator> m_descriptorPool{};
+    // Not owned, must outlive this render target.
+    BindlessHeap* m_bindlessHeap{nullptr};
 
     VkSampler m_colorSampler{VK_NULL_HANDLE};
     VkSampler m_depthSampler{VK_NULL_HANDLE};
     std::unique_ptr<ImageView> m_color{};
     std::unique_ptr<ImageView> m_depth{};
 
-    VkDescriptorSetLayout m_singletonDescriptorLayout{VK_NULL_HANDLE};
-    VkDescriptorSet m_singletonDescriptor{VK_NULL_HANDLE};
-
-    VkDescriptorSetLayout m_combinedDescriptorLayout{VK_NULL_HANDLE};
-    VkDescriptorSet m_combinedDescriptor{VK_NULL_HANDLE};
+    BindlessHandles m_bindless{};
 };
 } // namespace vkt
\ No newline at end of file
@@ -1,133 +1,91 @@
 #include "Renderer.hpp"
 
 #include "vulkan_template/app/RenderTarget.hpp"
-#include "vulkan_template/core/Integer.hpp"
 #include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
 #include "vulkan_template/vulkan/ImageView.hpp"
-#include "vulkan_template/vulkan/Shader.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
-#include <filesystem>
+#include "vulkan_template/vulkan/WorkgroupAutotuner.hpp"
 #include <glm/vec2.hpp>
-#include <span>
 #include <utility>
-#include <vector>
+
+namespace
+{
+char const* const SHADER_PATH{"shaders/testpattern.comp.spv"};
+} // namespace
 
 namespace vkt
 {
 Renderer::Renderer(Renderer&& other) noexcept
 {
-    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
-    m_shader = std::exchange(other.m_shader, VK_NULL_HANDLE);
-    m_shaderLayout = std::exchange(other.m_shaderLayout, VK_NULL_HANDLE);
-    m_destinationSingletonLayout =
-        std::exchange(other.m_destinationSingletonLayout, VK_NULL_HANDLE);
-}
-Renderer::~Renderer()
-{
-    if (m_device != VK_NULL_HANDLE)
-    {
-        vkDestroyShaderEXT(m_device, m_shader, nullptr);
-        vkDestroyPipelineLayout(m_device, m_shaderLayout, nullptr);
-        vkDestroyDescriptorSetLayout(
-            m_device, m_destinationSingletonLayout, nullptr
-        );
-    }
+    m_kernel = std::exchange(other.m_kernel, std::nullopt);
 }
-auto Renderer::create(VkDevice const device) -> std::optional<Renderer>
+Renderer::~Renderer() = default;
+auto Renderer::create(
+    VkDevice const device,
+    BindlessHeap const& bindlessHeap,
+    DescriptorLayoutCache& layoutCache
+) -> std::optional<Renderer>
 {
     std::optional<Renderer> result{std::in_place, Renderer{}};
     Renderer& renderer{result.value()};
-    renderer.m_device = device;
 
-    std::filesystem::path const shaderPath{"shaders/testpattern.comp.spv"};
-
-    if (auto const descriptorResult{RenderTarget::allocateSingletonLayout(device
-        )};
-        descriptorResult.has_value())
-    {
-        renderer.m_destinationSingletonLayout = descriptorResult.value();
-    }
-    else
-    {
-        VKT_ERROR("Failed to allocator descriptor set layout for scene texture."
-        );
-        return std::nullopt;
-    }
-
-    std::vector<VkDescriptorSetLayout> const layouts{
-        renderer.m_destinationSingletonLayout
-    };
-    std::vector<VkPushConstantRange> const ranges{VkPushConstantRange{
-        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = 16
-    }};
-
-    std::optional<VkShaderEXT> const shaderResult{vkt::loadShaderObject(
-        device,
-        shaderPath,
-        VK_SHADER_STAGE_COMPUTE_BIT,
-        (VkFlags)0,
-        layouts,
-        ranges,
-        VkSpecializationInfo{}
-    )};
-    if (!shaderResult.has_value())
+    renderer.m_kernel =
+        Kernel::create(device, bindlessHeap, layoutCache, SHADER_PATH);
+    if (!renderer.m_kernel.has_value())
     {
         VKT_ERROR("Failed to compile shaader.");
         return std::nullopt;
     }
 
-    renderer.m_shader = shaderResult.value();
-
-    VkPipelineLayoutCreateInfo const layoutCreateInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .pNext = nullptr,
-
-        .flags = 0,
-
-        .setLayoutCount = static_cast<uint32_t>(layouts.size()),
-        .pSetLayouts = layouts.data(),
-
-        .pushConstantRangeCount = static_cast<uint32_t>(ranges.size()),
-        .pPushConstantRanges = ranges.data(),
-    };
-
-    if (VkResult const pipelineLayoutResult{vkCreatePipelineLayout(
-            device, &layoutCreateInfo, nullptr, &renderer.m_shaderLayout
-        )};
-        pipelineLayoutResult != VK_SUCCESS)
+    return result;
+}
+auto Renderer::checkKernelInterfaces() -> bool
+{
+    return Kernel::checkInterface(SHADER_PATH);
+}
+void Renderer::autotune(
+    WorkgroupAutotuner& autotuner,
+    BindlessHeap const& bindlessHeap,
+    DescriptorLayoutCache& layoutCache,
+    RenderTarget& benchmarkTarget
+)
+{
+    m_kernel.value().autotune(
+        autotuner,
+        "testpattern.comp",
+        bindlessHeap,
+        layoutCache,
+        [&](VkCommandBuffer const cmd, Kernel::Variant const variant)
     {
-        VKT_LOG_VK(pipelineLayoutResult, "Failed to create pipeline layout.");
-        return std::nullopt;
+        bindlessHeap.bind(cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        recordDispatch(cmd, variant, benchmarkTarget);
     }
-
-    return result;
+    );
 }
+
 void Renderer::recordDraw(VkCommandBuffer const cmd, RenderTarget& destination)
     const
 {
-    VkShaderStageFlagBits const stage{VK_SHADER_STAGE_COMPUTE_BIT};
-    VkPipelineBindPoint const bindPoint{VK_PIPELINE_BIND_POINT_COMPUTE};
-    VkShaderEXT const shaderObject{m_shader};
-    VkPipelineLayout const layout{m_shaderLayout};
-
-    destination.color().recordTransitionBarriered(cmd, VK_IMAGE_LAYOUT_GENERAL);
-
-    vkCmdBindShadersEXT(cmd, 1, &stage, &shaderObject);
+    recordDispatch(cmd, m_kernel.value().variant(), destination);
+}
 
-    // Bind the destination image for rendering during compute
-    VkDescriptorSet destinationDescriptor{destination.singletonDescriptor()};
-    vkCmdBindDescriptorSets(
-        cmd, bindPoint, layout, 0, 1, &destinationDescriptor, VKR_ARRAY_NONE
-    );
+auto Renderer::animating() const -> bool
+{
+    // The test pattern only depends on the viewport, which changes with input
+    return false;
+}
 
-    struct PushConstant
-    {
-        glm::vec2 drawOffset{};
-        glm::vec2 drawExtent{};
-    };
+void Renderer::recordDispatch(
+    VkCommandBuffer const cmd,
+    Kernel::Variant const variant,
+    RenderTarget& destination
+) const
+{
+    destination.color().recordTransitionBarriered(cmd, VK_IMAGE_LAYOUT_GENERAL);
 
     VkRect2D const drawRect{destination.size()};
-    PushConstant const pc{
+    PushConstants const pc{
         .drawOffset =
             glm::vec2{
                 static_cast<float>(drawRect.offset.x),
@@ -138,19 +96,14 @@ void Renderer::recordDraw(VkCommandBuffer const cmd, RenderTarget& destination)
                 static_cast<float>(drawRect.extent.width),
                 static_cast<float>(drawRect.extent.height)
             },
+        .destinationImage = destination.bindless().colorStorage.index,
     };
 
-    uint32_t constexpr BYTE_OFFSET{0};
-    vkCmdPushConstants(
-        cmd, layout, stage, BYTE_OFFSET, sizeof(PushConstant), &pc
-    );
-
-    uint32_t constexpr WORKGROUP_SIZE{16};
-
-    vkt::computeDispatch(
+    m_kernel.value().record(
         cmd,
-        VkExtent3D{drawRect.extent.width, drawRect.extent.height, 1},
-        WORKGROUP_SIZE
+        variant,
+        pc,
+        VkExtent3D{drawRect.extent.width, drawRect.extent.height, 1}
     );
 }
 } // namespace vkt
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/ComputeKernel.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <glm/vec2.hpp>
 #include <optional>
 
 namespace vkt
 {
+struct BindlessHeap;
+struct DescriptorLayoutCache;
 struct RenderTarget;
+struct WorkgroupAutotuner;
 } // namespace vkt
 
 namespace vkt
@@ -24,14 +30,41 @@ private:
     Renderer() = default;
 
 public:
-    static auto create(VkDevice) -> std::optional<Renderer>;
+    static auto create(VkDevice, BindlessHeap const&, DescriptorLayoutCache&)
+        -> std::optional<Renderer>;
 
+    // Checks the shader's SPIR-V against the host-side interface, without a
+    // device.
+    static auto checkKernelInterfaces() -> bool;
+
+    // Picks the fastest workgroup size for this device by drawing into
+    // benchmarkTarget, and recreates the shader with it.
+    void autotune(
+        WorkgroupAutotuner&,
+        BindlessHeap const&,
+        DescriptorLayoutCache&,
+        RenderTarget& benchmarkTarget
+    );
+
+    // Expects the bindless heap to be bound to the compute bind point.
     void recordDraw(VkCommandBuffer, RenderTarget&) const;
 
+    // Whether the scene changes over time without input, so on-demand
+    // rendering must keep drawing frames.
+    [[nodiscard]] auto animating() const -> bool;
+
 private:
-    VkDescriptorSetLayout m_destinationSingletonLayout{VK_NULL_HANDLE};
-    VkDevice m_device{VK_NULL_HANDLE};
-    VkShaderEXT m_shader{VK_NULL_HANDLE};
-    VkPipelineLayout m_shaderLayout{VK_NULL_HANDLE};
+    // Matches the push constant block in testpattern.comp
+    struct PushConstants
+    {
+        glm::vec2 drawOffset{};
+        glm::vec2 drawExtent{};
+        uint32_t destinationImage{};
+    };
+    using Kernel = ComputeKernel<PushConstants>;
+
+    void recordDispatch(VkCommandBuffer, Kernel::Variant, RenderTarget&) const;
+
+    std::optional<Kernel> m_kernel{};
 };
 } // namespace vkt
\ No newline at end of file
@@ -0,0 +1,10 @@
+#include "UIBackend.hpp"
+
+namespace vkt
+{
+auto uiBackendMutex() -> std::mutex&
+{
+    static std::mutex mutex{};
+    return mutex;
+}
+} // namespace vkt
\ No newline at end of file
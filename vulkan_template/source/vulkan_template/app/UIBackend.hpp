@@ -0,0 +1,13 @@
+#pragma once
+
+#include <mutex>
+
+namespace vkt
+{
+// The ImGui Vulkan backend keeps global state without any synchronization,
+// such as the descriptor pool that texture sets come from and the buffers that
+// draw data is uploaded into. UI frames are built on the main thread while the
+// render thread records earlier ones, so every ImGui_ImplVulkan_* call that can
+// happen while both threads run must hold this lock.
+auto uiBackendMutex() -> std::mutex&;
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,371 @@
+#include "UIFontAtlas.hpp"
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <imgui.h>
+#include <imgui_internal.h>
+#include <iterator>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+float constexpr FONT_BASE_SIZE{13.0F};
+
+// Bump when the layout of the cache file changes.
+uint32_t constexpr CACHE_FORMAT_VERSION{1};
+std::array<char, 8> constexpr CACHE_MAGIC{'V', 'K', 'T', 'F', 'O', 'N', 'T', 0};
+
+// ImWchar is 16 bits, so no font has more distinct glyphs than this. A larger
+// count means the cache is corrupt.
+uint32_t constexpr MAX_GLYPHS_PER_FONT{0x10000};
+
+// Mouse cursors are drawn by the OS, and skipping them keeps the atlas free of
+// custom rectangles that the cache would need to restore.
+ImFontAtlasFlags constexpr ATLAS_FLAGS{ImFontAtlasFlags_NoMouseCursors};
+
+struct CachedGlyph
+{
+    uint32_t codepoint;
+    float advanceX;
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    float u0;
+    float v0;
+    float u1;
+    float v1;
+};
+
+template <typename T> void writeValue(std::ofstream& file, T const& value)
+{
+    file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T> auto readValue(std::ifstream& file, T& value) -> bool
+{
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+
+// Whether the file holds at least byteCount more bytes past the read position,
+// so that sizes read from a corrupt cache are never allocated.
+auto hasBytes(
+    std::ifstream& file, uintmax_t const fileSize, size_t const byteCount
+) -> bool
+{
+    std::streamoff const position{file.tellg()};
+    return position >= 0 && static_cast<uintmax_t>(position) <= fileSize
+        && fileSize - static_cast<uintmax_t>(position) >= byteCount;
+}
+
+// Everything the cache depends on besides its contents. A mismatch means the
+// cache was written by a different build and must be rebuilt.
+auto readHeader(std::ifstream& file) -> bool
+{
+    std::array<char, CACHE_MAGIC.size()> magic{};
+    uint32_t formatVersion{0};
+    uint32_t imguiVersion{0};
+    float baseSize{0.0F};
+    std::array<float, vkt::UI_FONT_SCALES.size()> scales{};
+
+    return readValue(file, magic) && magic == CACHE_MAGIC
+        && readValue(file, formatVersion)
+        && formatVersion == CACHE_FORMAT_VERSION
+        && readValue(file, imguiVersion) && imguiVersion == IMGUI_VERSION_NUM
+        && readValue(file, baseSize) && baseSize == FONT_BASE_SIZE
+        && readValue(file, scales) && scales == vkt::UI_FONT_SCALES;
+}
+
+void writeHeader(std::ofstream& file)
+{
+    writeValue(file, CACHE_MAGIC);
+    writeValue(file, CACHE_FORMAT_VERSION);
+    writeValue(file, static_cast<uint32_t>(IMGUI_VERSION_NUM));
+    writeValue(file, FONT_BASE_SIZE);
+    writeValue(file, vkt::UI_FONT_SCALES);
+}
+
+auto loadCache(
+    ImFontAtlas& atlas,
+    std::filesystem::path const& path,
+    uint32_t const maxTextureDimension
+) -> bool
+{
+    std::error_code sizeError{};
+    uintmax_t const fileSize{std::filesystem::file_size(path, sizeError)};
+    if (sizeError)
+    {
+        return false;
+    }
+
+    std::ifstream file{path, std::ios::binary};
+    if (!file.is_open() || !readHeader(file))
+    {
+        return false;
+    }
+
+    atlas.Clear();
+    atlas.Flags = ATLAS_FLAGS;
+
+    int32_t width{0};
+    int32_t height{0};
+    if (!readValue(file, width) || !readValue(file, height)
+        || !readValue(file, atlas.TexUvScale)
+        || !readValue(file, atlas.TexUvWhitePixel)
+        || !readValue(file, atlas.TexUvLines))
+    {
+        return false;
+    }
+    if (width <= 0 || height <= 0
+        || static_cast<uint32_t>(width) > maxTextureDimension
+        || static_cast<uint32_t>(height) > maxTextureDimension)
+    {
+        VKT_WARNING(
+            "Font atlas cache '{}' has an invalid texture size of {}x{}.",
+            path.string(),
+            width,
+            height
+        );
+        return false;
+    }
+
+    for (size_t fontIndex{0}; fontIndex < vkt::UI_FONT_SCALES.size();
+         fontIndex++)
+    {
+        float fontSize{0.0F};
+        float ascent{0.0F};
+        float descent{0.0F};
+        uint32_t fallbackChar{0};
+        uint32_t ellipsisChar{0};
+        uint32_t glyphCount{0};
+        if (!readValue(file, fontSize) || !readValue(file, ascent)
+            || !readValue(file, descent) || !readValue(file, fallbackChar)
+            || !readValue(file, ellipsisChar) || !readValue(file, glyphCount))
+        {
+            atlas.Clear();
+            return false;
+        }
+        if (glyphCount > MAX_GLYPHS_PER_FONT
+            || !hasBytes(file, fileSize, glyphCount * sizeof(CachedGlyph)))
+        {
+            VKT_WARNING(
+                "Font atlas cache '{}' has an invalid glyph count of {}.",
+                path.string(),
+                glyphCount
+            );
+            atlas.Clear();
+            return false;
+        }
+
+        std::vector<CachedGlyph> glyphs(glyphCount);
+        file.read(
+            reinterpret_cast<char*>(glyphs.data()),
+            static_cast<std::streamsize>(glyphs.size() * sizeof(CachedGlyph))
+        );
+        if (!file.good())
+        {
+            atlas.Clear();
+            return false;
+        }
+
+        // Owned by the atlas, which frees it on Clear()
+        ImFont* const font{IM_NEW(ImFont)};
+        atlas.Fonts.push_back(font);
+
+        font->ContainerAtlas = &atlas;
+        font->FontSize = fontSize;
+        font->Ascent = ascent;
+        font->Descent = descent;
+        font->FallbackChar = static_cast<ImWchar>(fallbackChar);
+        font->EllipsisChar = static_cast<ImWchar>(ellipsisChar);
+
+        for (CachedGlyph const& glyph : glyphs)
+        {
+            font->AddGlyph(
+                nullptr,
+                static_cast<ImWchar>(glyph.codepoint),
+                glyph.x0,
+                glyph.y0,
+                glyph.x1,
+                glyph.y1,
+                glyph.u0,
+                glyph.v0,
+                glyph.u1,
+                glyph.v1,
+                glyph.advanceX
+            );
+        }
+        font->BuildLookupTable();
+    }
+
+    size_t const pixelBytes{
+        static_cast<size_t>(width) * static_cast<size_t>(height) * 4
+    };
+    if (!hasBytes(file, fileSize, pixelBytes))
+    {
+        atlas.Clear();
+        return false;
+    }
+    // Freed by the atlas along with the rest of its texture data
+    auto* const pixels{static_cast<unsigned int*>(IM_ALLOC(pixelBytes))};
+    file.read(
+        reinterpret_cast<char*>(pixels),
+        static_cast<std::streamsize>(pixelBytes)
+    );
+    atlas.TexPixelsRGBA32 = pixels;
+    if (!file.good())
+    {
+        atlas.Clear();
+        return false;
+    }
+
+    atlas.TexWidth = width;
+    atlas.TexHeight = height;
+    atlas.TexReady = true;
+
+    return true;
+}
+
+auto buildAtlas(ImFontAtlas& atlas) -> bool
+{
+    atlas.Clear();
+    atlas.Flags = ATLAS_FLAGS;
+
+    for (float const scale : vkt::UI_FONT_SCALES)
+    {
+        ImFontConfig fontConfig{};
+        fontConfig.SizePixels = FONT_BASE_SIZE * scale;
+        fontConfig.OversampleH = 1;
+        fontConfig.OversampleV = 1;
+        fontConfig.PixelSnapH = true;
+
+        atlas.AddFontDefault(&fontConfig);
+    }
+
+    unsigned char* pixels{nullptr};
+    int32_t width{0};
+    int32_t height{0};
+    atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    return pixels != nullptr;
+}
+
+void saveCache(ImFontAtlas& atlas, std::filesystem::path const& path)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.is_open())
+    {
+        VKT_WARNING("Failed to write font atlas cache '{}'.", path.string());
+        return;
+    }
+
+    unsigned char* pixels{nullptr};
+    int32_t width{0};
+    int32_t height{0};
+    atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+
+    writeHeader(file);
+
+    writeValue(file, width);
+    writeValue(file, height);
+    writeValue(file, atlas.TexUvScale);
+    writeValue(file, atlas.TexUvWhitePixel);
+    writeValue(file, atlas.TexUvLines);
+
+    for (ImFont const* const font : atlas.Fonts)
+    {
+        writeValue(file, font->FontSize);
+        writeValue(file, font->Ascent);
+        writeValue(file, font->Descent);
+        writeValue(file, static_cast<uint32_t>(font->FallbackChar));
+        writeValue(file, static_cast<uint32_t>(font->EllipsisChar));
+        writeValue(file, static_cast<uint32_t>(font->Glyphs.Size));
+
+        for (ImFontGlyph const& glyph : font->Glyphs)
+        {
+            writeValue(
+                file,
+                CachedGlyph{
+                    .codepoint = glyph.Codepoint,
+                    .advanceX = glyph.AdvanceX,
+                    .x0 = glyph.X0,
+                    .y0 = glyph.Y0,
+                    .x1 = glyph.X1,
+                    .y1 = glyph.Y1,
+                    .u0 = glyph.U0,
+                    .v0 = glyph.V0,
+                    .u1 = glyph.U1,
+                    .v1 = glyph.V1,
+                }
+            );
+        }
+    }
+
+    file.write(
+        reinterpret_cast<char const*>(pixels),
+        static_cast<std::streamsize>(
+            static_cast<size_t>(width) * static_cast<size_t>(height) * 4
+        )
+    );
+
+    if (!file.good())
+    {
+        VKT_WARNING("Failed to write font atlas cache '{}'.", path.string());
+    }
+}
+} // namespace
+
+namespace vkt
+{
+auto loadUIFontAtlas(
+    ImFontAtlas& atlas,
+    std::filesystem::path const& cachePath,
+    uint32_t const maxTextureDimension
+) -> bool
+{
+    if (loadCache(atlas, cachePath, maxTextureDimension))
+    {
+        VKT_INFO("Loaded font atlas from '{}'.", cachePath.string());
+        return true;
+    }
+
+    VKT_INFO("Rasterizing font atlas...");
+
+    if (!buildAtlas(atlas))
+    {
+        VKT_ERROR("Failed to build font atlas.");
+        return false;
+    }
+
+    saveCache(atlas, cachePath);
+
+    return true;
+}
+
+void selectUIFont(ImGuiIO& io, float const dpiScale)
+{
+    if (io.Fonts->Fonts.Size != static_cast<int32_t>(UI_FONT_SCALES.size()))
+    {
+        VKT_WARNING("Font atlas was not loaded with the prebuilt UI fonts.");
+        return;
+    }
+
+    auto const nearest{std::min_element(
+        UI_FONT_SCALES.begin(),
+        UI_FONT_SCALES.end(),
+        [&](float const lhs, float const rhs)
+    { return std::abs(lhs - dpiScale) < std::abs(rhs - dpiScale); }
+    )};
+
+    io.FontDefault = io.Fonts->Fonts[static_cast<int32_t>(
+        std::distance(UI_FONT_SCALES.begin(), nearest)
+    )];
+    io.FontGlobalScale = dpiScale / *nearest;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <array>
+#include <filesystem>
+
+struct ImFontAtlas;
+struct ImGuiIO;
+
+namespace vkt
+{
+// The DPI scales that the UI font is prebuilt at. Other scales use the nearest
+// one, scaled up or down at draw time.
+std::array<float, 11> constexpr UI_FONT_SCALES{
+    0.5F, 0.75F, 1.0F, 1.25F, 1.5F, 1.75F, 2.0F, 2.5F, 3.0F, 3.5F, 4.0F
+};
+
+// Fills the atlas with the default font at every scale in UI_FONT_SCALES.
+// The rasterized atlas and glyph metrics are loaded from cachePath when it
+// matches, otherwise the fonts are rasterized and the cache is rewritten. A
+// cache whose sizes are out of range, such as a texture larger than
+// maxTextureDimension or counts past the end of the file, is rebuilt too.
+//
+// Must be called before the UI backend uploads the font texture. Afterwards,
+// changing scale only selects a different font, so the texture never needs to
+// be rebuilt.
+auto loadUIFontAtlas(
+    ImFontAtlas&,
+    std::filesystem::path const& cachePath,
+    uint32_t maxTextureDimension
+) -> bool;
+
+// Makes the prebuilt font closest to dpiScale the default, with the remainder
+// applied as a global font scale.
+void selectUIFont(ImGuiIO&, float dpiScale);
+} // namespace vkt
\ No newline at end of file
@@ -2,14 +2,22 @@
 
 #include "vulkan_template/app/PlatformWindow.hpp"
 #include "vulkan_template/app/RenderTarget.hpp"
+#include "vulkan_template/app/UIBackend.hpp"
+#include "vulkan_template/app/UIFontAtlas.hpp"
+#include "vulkan_template/app/UITextureRegistry.hpp"
+#include "vulkan_template/core/Integer.hpp"
 #include "vulkan_template/core/Log.hpp"
 #include "vulkan_template/core/UIRectangle.hpp"
 #include "vulkan_template/core/UIWindowScope.hpp"
 #include "vulkan_template/vulkan/Image.hpp"
+#include "vulkan_template/vulkan/ImageOperations.hpp"
 #include "vulkan_template/vulkan/ImageView.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
 #include "vulkan_template/vulkan/VulkanStructs.hpp"
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
 #include <glm/common.hpp>
 #include <glm/exponential.hpp>
 #include <glm/ext/vector_relational.hpp>
@@ -20,6 +28,10 @@
 #include <imgui_impl_vulkan.h>
 #include <imgui_internal.h>
 #include <implot.h>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <span>
 #include <utility>
 #include <vector>
@@ -271,31 +283,254 @@ auto sceneViewportWindow(
         .focused = clicked,
     };
 }
-} // namespace detail
 
-namespace vkt
+// FNV-1a over 64-bit words, since vertex buffers at high DPI are large enough
+// that hashing byte by byte every frame would show up in profiles.
+auto hashBytes(uint64_t hash, std::span<std::byte const> const bytes)
+    -> uint64_t
+{
+    uint64_t constexpr FNV_PRIME{0x100000001B3ULL};
+
+    size_t offset{0};
+    for (; offset + sizeof(uint64_t) <= bytes.size();
+         offset += sizeof(uint64_t))
+    {
+        uint64_t word{};
+        std::memcpy(&word, bytes.data() + offset, sizeof(uint64_t));
+        hash = (hash ^ word) * FNV_PRIME;
+    }
+    for (; offset < bytes.size(); offset++)
+    {
+        hash = (hash ^ static_cast<uint64_t>(bytes[offset])) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+template <typename T>
+auto hashValue(uint64_t const hash, T const& value) -> uint64_t
+{
+    return hashBytes(hash, std::as_bytes(std::span{&value, 1}));
+}
+
+// Hashes everything that affects the rasterized UI. Draw commands are hashed
+// field by field to skip their padding.
+auto hashDrawData(ImDrawData const& drawData) -> uint64_t
+{
+    uint64_t hash{0xCBF29CE484222325ULL};
+
+    hash = hashValue(hash, drawData.DisplayPos);
+    hash = hashValue(hash, drawData.DisplaySize);
+    hash = hashValue(hash, drawData.FramebufferScale);
+
+    for (ImDrawList const* const drawList : drawData.CmdLists)
+    {
+        hash = hashBytes(
+            hash,
+            std::as_bytes(std::span{
+                drawList->VtxBuffer.Data,
+                static_cast<size_t>(drawList->VtxBuffer.Size)
+            })
+        );
+        hash = hashBytes(
+            hash,
+            std::as_bytes(std::span{
+                drawList->IdxBuffer.Data,
+                static_cast<size_t>(drawList->IdxBuffer.Size)
+            })
+        );
+
+        for (ImDrawCmd const& command : drawList->CmdBuffer)
+        {
+            hash = hashValue(hash, command.ClipRect);
+            hash = hashValue(hash, command.TextureId);
+            hash = hashValue(hash, command.VtxOffset);
+            hash = hashValue(hash, command.IdxOffset);
+            hash = hashValue(hash, command.ElemCount);
+            hash = hashValue(hash, command.UserCallback);
+            hash = hashValue(hash, command.UserCallbackData);
+        }
+    }
+
+    return hash;
+}
+
+// The area a command's triangles cover, limited to its clip rectangle.
+auto drawCommandBounds(ImDrawList const& drawList, ImDrawCmd const& command)
+    -> vkt::UIRectangle
+{
+    glm::vec2 min{std::numeric_limits<float>::max()};
+    glm::vec2 max{std::numeric_limits<float>::lowest()};
+
+    for (uint32_t index{command.IdxOffset};
+         index < command.IdxOffset + command.ElemCount;
+         index++)
+    {
+        ImDrawVert const& vertex{drawList.VtxBuffer[static_cast<int32_t>(
+            command.VtxOffset + drawList.IdxBuffer[static_cast<int32_t>(index)]
+        )]};
+        min = glm::min(min, glm::vec2{vertex.pos.x, vertex.pos.y});
+        max = glm::max(max, glm::vec2{vertex.pos.x, vertex.pos.y});
+    }
+
+    vkt::UIRectangle const clip{
+        .min{command.ClipRect.x, command.ClipRect.y},
+        .max{command.ClipRect.z, command.ClipRect.w},
+    };
+
+    return vkt::UIRectangle{.min{min}, .max{max}}.clampToMin().intersect(clip);
+}
+
+auto hasArea(vkt::UIRectangle const& rectangle) -> bool
+{
+    return rectangle.size().x > 0.0F && rectangle.size().y > 0.0F;
+}
+
+// Finds where the scene texture was drawn, and whether anything was drawn on
+// top of it afterwards.
+auto findSceneRegion(ImDrawData const& drawData, ImTextureID const sceneTexture)
+    -> std::optional<vkt::UISceneRegion>
+{
+    std::optional<vkt::UIRectangle> sceneBounds{};
+    std::optional<vkt::UISceneRegion> region{};
+
+    for (ImDrawList const* const drawList : drawData.CmdLists)
+    {
+        for (ImDrawCmd const& command : drawList->CmdBuffer)
+        {
+            if (command.UserCallback != nullptr)
+            {
+                continue;
+            }
+
+            if (sceneBounds.has_value())
+            {
+                if (hasArea(drawCommandBounds(*drawList, command)
+                                .intersect(sceneBounds.value())))
+                {
+                    region.value().obstructed = true;
+                    return region;
+                }
+                continue;
+            }
+
+            if (command.TextureId != sceneTexture)
+            {
+                continue;
+            }
+
+            // The image's first vertex is its top-left corner, where the
+            // scene texture's first texel lands. Clipping may cut this off.
+            ImDrawVert const& topLeft{drawList->VtxBuffer[static_cast<int32_t>(
+                command.VtxOffset
+                + drawList->IdxBuffer[static_cast<int32_t>(command.IdxOffset)]
+            )]};
+            glm::vec2 const imageMin{topLeft.pos.x, topLeft.pos.y};
+
+            vkt::UIRectangle const bounds{drawCommandBounds(*drawList, command)
+            };
+            if (!hasArea(bounds))
+            {
+                return std::nullopt;
+            }
+            sceneBounds = bounds;
+
+            glm::vec2 const displayPos{
+                drawData.DisplayPos.x, drawData.DisplayPos.y
+            };
+            glm::ivec2 const destinationMin{
+                glm::round(bounds.min - displayPos)
+            };
+            glm::ivec2 const sourceMin{glm::round(bounds.min - imageMin)};
+            glm::ivec2 const extent{glm::round(bounds.size())};
+
+            region = vkt::UISceneRegion{
+                .source{
+                    .offset{.x = sourceMin.x, .y = sourceMin.y},
+                    .extent{
+                        .width = static_cast<uint32_t>(extent.x),
+                        .height = static_cast<uint32_t>(extent.y),
+                    },
+                },
+                .destination{
+                    .offset{.x = destinationMin.x, .y = destinationMin.y},
+                    .extent{
+                        .width = static_cast<uint32_t>(extent.x),
+                        .height = static_cast<uint32_t>(extent.y),
+                    },
+                },
+                .obstructed = false,
+            };
+        }
+    }
+
+    return region;
+}
+
+// Unlike ImVector's assignment, keeps the destination's buffer when it is
+// large enough.
+template <typename T>
+void copyImVector(ImVector<T> const& source, ImVector<T>& destination)
 {
-void uiReload(VkDevice const device, UIPreferences const preferences)
+    destination.resize(source.Size);
+    if (source.Size > 0)
+    {
+        std::memcpy(destination.Data, source.Data, source.size_in_bytes());
+    }
+}
+
+// Copies the output of each draw list into the storage's draw lists, which are
+// only cloned when there are not enough of them yet.
+void copyDrawData(ImDrawData const& source, vkt::UIFrameStorage& destination)
 {
-    float constexpr FONT_BASE_SIZE{13.0F};
+    auto const listCount{static_cast<size_t>(source.CmdListsCount)};
+    for (size_t index{0}; index < listCount; index++)
+    {
+        ImDrawList const& sourceList{*source.CmdLists[static_cast<int>(index)]};
+        if (index == destination.drawLists.size())
+        {
+            destination.drawLists.emplace_back(sourceList.CloneOutput());
+            continue;
+        }
 
-    ImFontConfig fontConfig{};
-    fontConfig.SizePixels = FONT_BASE_SIZE * preferences.dpiScale;
-    fontConfig.OversampleH = 1;
-    fontConfig.OversampleV = 1;
-    fontConfig.PixelSnapH = true;
+        ImDrawList& list{*destination.drawLists[index]};
+        copyImVector(sourceList.CmdBuffer, list.CmdBuffer);
+        copyImVector(sourceList.IdxBuffer, list.IdxBuffer);
+        copyImVector(sourceList.VtxBuffer, list.VtxBuffer);
+        list.Flags = sourceList.Flags;
+    }
 
-    ImGui::GetIO().Fonts->Clear();
-    ImGui::GetIO().Fonts->AddFontDefault(&fontConfig);
+    ImDrawData& drawData{destination.drawData};
+    drawData.Valid = source.Valid;
+    drawData.CmdListsCount = source.CmdListsCount;
+    drawData.TotalIdxCount = source.TotalIdxCount;
+    drawData.TotalVtxCount = source.TotalVtxCount;
+    drawData.DisplayPos = source.DisplayPos;
+    drawData.DisplaySize = source.DisplaySize;
+    drawData.FramebufferScale = source.FramebufferScale;
+    drawData.OwnerViewport = source.OwnerViewport;
+
+    drawData.CmdLists.resize(source.CmdListsCount);
+    for (size_t index{0}; index < listCount; index++)
+    {
+        drawData.CmdLists[static_cast<int>(index)] =
+            destination.drawLists[index].get();
+    }
+}
+} // namespace detail
 
-    // Wait for idle since we are modifying backend resources
-    vkDeviceWaitIdle(device);
-    // We destroy this to later force a rebuild when the fonts are needed.
-    ImGui_ImplVulkan_DestroyFontsTexture();
+namespace vkt
+{
+void UIDrawListDeleter::operator()(ImDrawList* const drawList) const
+{
+    IM_DELETE(drawList);
+}
 
-    // TODO: is rebuilding the font with a specific scale good?
-    // ImGui recommends building fonts at various sizes then just
-    // selecting them
+void uiReload(UIPreferences const preferences)
+{
+    // Fonts are prebuilt at fixed scales, so switching only changes which one
+    // is used and the font texture stays valid.
+    selectUIFont(ImGui::GetIO(), preferences.dpiScale);
 
     // Reset style so further scaling works off the base "1.0x" scaling
     // TODO: Resetting is problematic since not all fields are sizes, changes we
@@ -315,6 +550,8 @@ UILayer::UILayer(UILayer&& other) noexcept { *this = std::move(other); }
 auto UILayer::operator=(UILayer&& other) noexcept -> UILayer&
 {
     m_backendInitialized = std::exchange(other.m_backendInitialized, false);
+    m_platformBackendInitialized =
+        std::exchange(other.m_platformBackendInitialized, false);
 
     m_reloadNecessary = std::exchange(other.m_reloadNecessary, false);
     m_currentPreferences =
@@ -332,8 +569,18 @@ auto UILayer::operator=(UILayer&& other) noexcept -> UILayer&
     m_sceneTexture = std::move(other.m_sceneTexture);
     m_imguiSceneTextureHandle =
         std::exchange(other.m_imguiSceneTextureHandle, nullptr);
+    m_textureRegistry = std::move(other.m_textureRegistry);
+    m_releasedTextures = std::move(other.m_releasedTextures);
+    m_recordedFrames = std::exchange(other.m_recordedFrames, 0);
+    m_recycledFrames = std::move(other.m_recycledFrames);
     m_outputTexture = std::move(other.m_outputTexture);
 
+    m_uiCache = std::move(other.m_uiCache);
+    m_uiCacheHash = std::exchange(other.m_uiCacheHash, std::nullopt);
+    m_uiCacheScene = std::exchange(other.m_uiCacheScene, std::nullopt);
+    m_framesSinceRasterization =
+        std::exchange(other.m_framesSinceRasterization, 0);
+
     return *this;
 }
 
@@ -342,15 +589,31 @@ UILayer::UILayer() = default;
 
 void UILayer::destroy()
 {
+    // Frees descriptor sets through the backend, so it goes first. The device
+    // is idle by now, so released sets can be freed right away.
+    for (std::vector<ImTextureID>& textures : m_releasedTextures)
+    {
+        UITextureRegistry::freeReleasedTextures(textures);
+        textures.clear();
+    }
+    m_recordedFrames = 0;
+    // Draw lists are freed through ImGui, so this goes before its context
+    m_recycledFrames.reset();
+    m_textureRegistry.reset();
+
     if (m_backendInitialized)
     {
         ImPlot::DestroyContext();
 
         ImGui_ImplVulkan_Shutdown();
-        ImGui_ImplGlfw_Shutdown();
+        if (m_platformBackendInitialized)
+        {
+            ImGui_ImplGlfw_Shutdown();
+        }
         ImGui::DestroyContext();
 
         m_backendInitialized = false;
+        m_platformBackendInitialized = false;
     }
 
     if (m_device != VK_NULL_HANDLE)
@@ -367,6 +630,11 @@ void UILayer::destroy()
     m_sceneTexture.reset();
     m_outputTexture.reset();
 
+    m_uiCache.reset();
+    m_uiCacheHash.reset();
+    m_uiCacheScene.reset();
+    m_framesSinceRasterization = 0;
+
     m_device = VK_NULL_HANDLE;
 
     m_reloadNecessary = false;
@@ -382,11 +650,13 @@ auto UILayer::create(
     VkPhysicalDevice const physicalDevice,
     VkDevice const device,
     VmaAllocator const allocator,
+    BindlessHeap& bindlessHeap,
     VkExtent2D textureCapacity,
     uint32_t const graphicsQueueFamily,
     VkQueue const graphicsQueue,
-    PlatformWindow& mainWindow,
-    UIPreferences const defaultPreferences
+    PlatformWindow* const mainWindow,
+    UIPreferences const defaultPreferences,
+    std::filesystem::path const& fontAtlasCachePath
 ) -> std::optional<UILayer>
 {
     std::optional<UILayer> layerResult{UILayer{}};
@@ -454,7 +724,17 @@ auto UILayer::create(
     ImVec4 constexpr MODAL_BACKGROUND_DIM{0.0F, 0.0F, 0.0F, 0.8F};
     ImGui::GetStyle().Colors[ImGuiCol_ModalWindowDimBg] = MODAL_BACKGROUND_DIM;
 
-    ImGui_ImplGlfw_InitForVulkan(mainWindow.handle(), true);
+    if (mainWindow != nullptr)
+    {
+        ImGui_ImplGlfw_InitForVulkan(mainWindow->handle(), true);
+        layer.m_platformBackendInitialized = true;
+    }
+    else
+    {
+        // Saved window positions would make headless frames depend on
+        // earlier runs
+        ImGui::GetIO().IniFilename = nullptr;
+    }
 
     // Load functions since we are using volk,
     // and not the built-in vulkan loader
@@ -535,6 +815,7 @@ auto UILayer::create(
     if (std::optional<RenderTarget> outputTextureResult{RenderTarget::create(
             device,
             allocator,
+            bindlessHeap,
             RenderTarget::CreateParameters{
                 .max = textureCapacity,
                 .color = VK_FORMAT_R16G16B16A16_UNORM,
@@ -555,6 +836,7 @@ auto UILayer::create(
     if (std::optional<RenderTarget> sceneTextureResult{RenderTarget::create(
             device,
             allocator,
+            bindlessHeap,
             RenderTarget::CreateParameters{
                 .max = textureCapacity,
                 .color = VK_FORMAT_R16G16B16A16_UNORM,
@@ -580,12 +862,65 @@ auto UILayer::create(
         VKT_ERROR("Failed to allocate UI Layer scene texture.");
         return std::nullopt;
     }
+    if (std::optional<UITextureRegistry> textureRegistryResult{
+            UITextureRegistry::create(
+                device, allocator, UITextureRegistry::CreateParameters{}
+            )
+        };
+        textureRegistryResult.has_value())
+    {
+        layer.m_textureRegistry = std::make_unique<UITextureRegistry>(
+            std::move(textureRegistryResult).value()
+        );
+    }
+    else
+    {
+        VKT_ERROR("Failed to create UI Layer texture registry.");
+        return std::nullopt;
+    }
+    layer.m_recycledFrames = std::make_unique<SPSCQueue<
+        std::unique_ptr<UIFrameStorage>,
+        RECYCLED_FRAME_CAPACITY>>();
+    if (std::optional<std::unique_ptr<ImageView>> uiCacheResult{
+            ImageView::allocate(
+                device,
+                allocator,
+                ImageAllocationParameters{
+                    .extent = textureCapacity,
+                    .format = VK_FORMAT_R16G16B16A16_UNORM,
+                    .usageFlags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+                                | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                },
+                ImageViewAllocationParameters{}
+            )
+        };
+        uiCacheResult.has_value() && uiCacheResult.value() != nullptr)
+    {
+        layer.m_uiCache = std::move(uiCacheResult).value();
+    }
+    else
+    {
+        VKT_ERROR("Failed to allocate UI Layer cache texture.");
+        return std::nullopt;
+    }
 
     layer.m_defaultPreferences = defaultPreferences;
     layer.m_currentPreferences = defaultPreferences;
     layer.m_device = device;
 
-    uiReload(device, layer.m_currentPreferences);
+    VkPhysicalDeviceProperties physicalDeviceProperties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+    if (!loadUIFontAtlas(
+            *ImGui::GetIO().Fonts,
+            fontAtlasCachePath,
+            physicalDeviceProperties.limits.maxImageDimension2D
+        ))
+    {
+        VKT_ERROR("Failed to load UI font atlas.");
+        return std::nullopt;
+    }
+
+    uiReload(layer.m_currentPreferences);
 
     return layerResult;
 }
@@ -593,13 +928,32 @@ auto UILayer::begin() -> DockingLayout const&
 {
     if (m_reloadNecessary)
     {
-        uiReload(m_device, m_currentPreferences);
+        uiReload(m_currentPreferences);
 
         m_reloadNecessary = false;
     }
 
-    ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
+    {
+        // The first call uploads the font texture
+        std::lock_guard const lock{uiBackendMutex()};
+        ImGui_ImplVulkan_NewFrame();
+    }
+    if (m_platformBackendInitialized)
+    {
+        ImGui_ImplGlfw_NewFrame();
+    }
+    else
+    {
+        // A fixed display and frame time keep headless frames reproducible
+        VkExtent2D const displaySize{m_outputTexture->color().image().extent2D()
+        };
+        ImGuiIO& io{ImGui::GetIO()};
+        io.DisplaySize = ImVec2{
+            static_cast<float>(displaySize.width),
+            static_cast<float>(displaySize.height)
+        };
+        io.DeltaTime = 1.0F / 60.0F;
+    }
     ImGui::NewFrame();
 
     m_open = true;
@@ -625,12 +979,14 @@ auto UILayer::begin() -> DockingLayout const&
 }
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-auto UILayer::HUDMenuItem(std::string const& menu, std::string const& item)
-    const -> bool
+auto UILayer::HUDMenuItem(char const* const menu, char const* const item) const
+    -> bool
 {
     if (!m_open)
     {
-        VKT_WARNING("UILayer method called while UI frame is not open.");
+        VKT_WARNING_RATE_LIMITED(
+            "UILayer method called while UI frame is not open."
+        );
         return false;
     }
 
@@ -640,9 +996,9 @@ auto UILayer::HUDMenuItem(std::string const& menu, std::string const& item)
 
     if (ImGui::BeginMenuBar())
     {
-        if (ImGui::BeginMenu(menu.c_str()))
+        if (ImGui::BeginMenu(menu))
         {
-            clicked = ImGui::MenuItem(item.c_str());
+            clicked = ImGui::MenuItem(item);
             ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
@@ -654,12 +1010,14 @@ auto UILayer::HUDMenuItem(std::string const& menu, std::string const& item)
 }
 
 void UILayer::HUDMenuToggle(
-    std::string const& menu, std::string const& item, bool& value
+    char const* const menu, char const* const item, bool& value
 ) const
 {
     if (!m_open)
     {
-        VKT_WARNING("UILayer method called while UI frame is not open.");
+        VKT_WARNING_RATE_LIMITED(
+            "UILayer method called while UI frame is not open."
+        );
         return;
     }
 
@@ -667,9 +1025,9 @@ void UILayer::HUDMenuToggle(
 
     if (ImGui::BeginMenuBar())
     {
-        if (ImGui::BeginMenu(menu.c_str()))
+        if (ImGui::BeginMenu(menu))
         {
-            ImGui::MenuItem(item.c_str(), nullptr, &value);
+            ImGui::MenuItem(item, nullptr, &value);
             ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
@@ -678,22 +1036,12 @@ void UILayer::HUDMenuToggle(
     ImGui::End();
 }
 
-auto UILayer::sceneTextureLayout() const -> std::optional<VkDescriptorSetLayout>
-{
-    if (m_sceneTexture == nullptr)
-    {
-        return std::nullopt;
-    }
-
-    return m_sceneTexture->singletonLayout();
-}
-
 auto UILayer::sceneViewport(bool const forceFocus)
     -> std::optional<SceneViewport>
 {
     if (m_sceneTexture == nullptr)
     {
-        VKT_WARNING("No scene texture to draw into.");
+        VKT_WARNING_RATE_LIMITED("No scene texture to draw into.");
         return std::nullopt;
     }
 
@@ -731,30 +1079,68 @@ auto UILayer::sceneViewport(bool const forceFocus)
                 )
             }
     };
-    m_sceneTexture->setSize(sceneTextureSubregion);
-
     return SceneViewport{
         .focused = windowResult.focused,
         .texture = *m_sceneTexture,
-        .windowExtent = windowResult.screenPixels.value()
+        .windowExtent = windowResult.screenPixels.value(),
+        .textureRegion = sceneTextureSubregion,
     };
 }
 
 auto UILayer::sceneTexture() -> RenderTarget const& { return *m_sceneTexture; }
 
-void UILayer::end()
+auto UILayer::textureRegistry() -> UITextureRegistry&
+{
+    return *m_textureRegistry;
+}
+
+auto UILayer::end() -> UIFrame
 {
     if (!m_open)
     {
         VKT_ERROR("UILayer::end() called without matching UILayer::open().");
-        return;
+        return UIFrame{};
     };
 
     ImGui::Render();
 
     m_open = false;
+
+    UIFrame frame{.rasterizeInterval = m_currentPreferences.rasterizeInterval};
+    if (std::optional<std::unique_ptr<UIFrameStorage>> recycledStorage{
+            m_recycledFrames->tryPop()
+        };
+        recycledStorage.has_value())
+    {
+        frame.storage = std::move(recycledStorage).value();
+    }
+    else
+    {
+        // Popups and tooltips add draw lists as they open, so there is room
+        // for more than the first frames use.
+        size_t constexpr RESERVED_DRAW_LISTS{32};
+
+        frame.storage = std::make_unique<UIFrameStorage>();
+        frame.storage->drawLists.reserve(RESERVED_DRAW_LISTS);
+    }
+
+    m_textureRegistry->takeUploads(frame.storage->textureUploads);
+
+    // ImGui reuses its draw lists next frame, so the vertices are copied out
+    detail::copyDrawData(*ImGui::GetDrawData(), *frame.storage);
+
+    return frame;
 }
-auto UILayer::recordDraw(VkCommandBuffer const cmd)
+auto UILayer::wantsRedraw() const -> bool
+{
+    if (m_reloadNecessary || m_currentHUD.rebuildLayoutRequested)
+    {
+        return true;
+    }
+
+    return m_backendInitialized && ImGui::GetIO().WantTextInput;
+}
+auto UILayer::recordDraw(VkCommandBuffer const cmd, UIFrame& frame)
     -> std::optional<std::reference_wrapper<RenderTarget>>
 {
     if (m_outputTexture == nullptr)
@@ -762,19 +1148,25 @@ auto UILayer::recordDraw(VkCommandBuffer const cmd)
         VKT_ERROR("UI Layer had no texture to render to.");
         return std::nullopt;
     }
-
-    if (m_sceneTexture != nullptr)
+    if (frame.storage == nullptr || !frame.storage->drawData.Valid)
     {
-        m_sceneTexture->color().recordTransitionBarriered(
-            cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-        );
+        VKT_ERROR("UI frame has no draw data.");
+        return std::nullopt;
     }
 
-    m_outputTexture->color().recordTransitionBarriered(
-        cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+    // The frame that last used this slot has retired, so nothing still draws
+    // the sets it released
+    std::vector<ImTextureID>& releasedTextures{
+        m_releasedTextures[m_recordedFrames % m_releasedTextures.size()]
+    };
+    UITextureRegistry::freeReleasedTextures(releasedTextures);
+    releasedTextures.assign(
+        frame.storage->textureUploads.releasedTextures.begin(),
+        frame.storage->textureUploads.releasedTextures.end()
     );
+    m_recordedFrames += 1;
 
-    ImDrawData* const drawData{ImGui::GetDrawData()};
+    ImDrawData* const drawData{&frame.storage->drawData};
 
     // TODO: when is this offset nonzero?
     // TODO: Is this offset synced with what imgui will render into?
@@ -790,24 +1182,108 @@ auto UILayer::recordDraw(VkCommandBuffer const cmd)
     };
     m_outputTexture->setSize(renderedArea);
 
-    VkRenderingAttachmentInfo const colorAttachmentInfo{renderingAttachmentInfo(
-        m_outputTexture->color().view(),
-        VK_IMAGE_LAYOUT_GENERAL,
-        VkClearValue{
-            .color = VkClearColorValue{.float32 = {0.0F, 0.0F, 0.0F, 1.0F}}
-        }
-    )};
-    std::vector<VkRenderingAttachmentInfo> const colorAttachments{
-        colorAttachmentInfo
+    uint64_t const drawDataHash{detail::hashDrawData(*drawData)};
+
+    // Images may be copied into atlas slots that the draw data already uses,
+    // which the hash cannot see.
+    bool const texturesChanged{
+        UITextureRegistry::recordUploads(cmd, frame.storage->textureUploads)
+    };
+
+    m_framesSinceRasterization += 1;
+    bool const rasterizationDue{
+        m_framesSinceRasterization >= std::max(frame.rasterizeInterval, 1U)
+    };
+    // If something covers the scene viewport, the scene cannot be updated
+    // without rasterizing everything.
+    bool const sceneObstructed{
+        m_uiCacheScene.has_value() && m_uiCacheScene.value().obstructed
     };
-    VkRenderingInfo const renderInfo{
-        renderingInfo(renderedArea, colorAttachments, nullptr)
+    bool const rasterize{
+        !m_uiCacheHash.has_value()
+        || (drawDataHash != m_uiCacheHash.value() && rasterizationDue)
+        || sceneObstructed || texturesChanged
     };
-    vkCmdBeginRendering(cmd, &renderInfo);
 
-    ImGui_ImplVulkan_RenderDrawData(drawData, cmd);
+    if (rasterize)
+    {
+        if (m_sceneTexture != nullptr)
+        {
+            m_sceneTexture->color().recordTransitionBarriered(
+                cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            );
+        }
+
+        m_uiCache->recordTransitionBarriered(
+            cmd, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+        );
+
+        VkRenderingAttachmentInfo const colorAttachmentInfo{
+            renderingAttachmentInfo(
+                m_uiCache->view(),
+                VK_IMAGE_LAYOUT_GENERAL,
+                VkClearValue{
+                    .color =
+                        VkClearColorValue{.float32 = {0.0F, 0.0F, 0.0F, 1.0F}}
+                }
+            )
+        };
+        std::array<VkRenderingAttachmentInfo, 1> const colorAttachments{
+            colorAttachmentInfo
+        };
+        VkRenderingInfo const renderInfo{
+            renderingInfo(renderedArea, colorAttachments, nullptr)
+        };
+        vkCmdBeginRendering(cmd, &renderInfo);
+
+        {
+            std::lock_guard const lock{uiBackendMutex()};
+            ImGui_ImplVulkan_RenderDrawData(drawData, cmd);
+        }
+
+        vkCmdEndRendering(cmd);
+
+        m_uiCacheHash = drawDataHash;
+        m_uiCacheScene =
+            detail::findSceneRegion(*drawData, m_imguiSceneTextureHandle);
+        m_framesSinceRasterization = 0;
+    }
+
+    m_uiCache->recordTransitionBarriered(
+        cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+    );
+    m_outputTexture->color().recordTransitionBarriered(
+        cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    );
+
+    recordCopyImageToImage(
+        cmd,
+        m_uiCache->image().image(),
+        m_outputTexture->color().image().image(),
+        renderedArea,
+        renderedArea
+    );
+
+    // Scene contents may have changed under a cached UI, so they are copied
+    // over where the UI drew them.
+    if (!rasterize && m_uiCacheScene.has_value() && m_sceneTexture != nullptr)
+    {
+        m_sceneTexture->color().recordTransitionBarriered(
+            cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+        );
+
+        recordCopyImageToImage(
+            cmd,
+            m_sceneTexture->color().image().image(),
+            m_outputTexture->color().image().image(),
+            m_uiCacheScene.value().source,
+            m_uiCacheScene.value().destination
+        );
+    }
 
-    vkCmdEndRendering(cmd);
+    // The backend copied the vertices into its own buffers, so the storage can
+    // be reused. It is freed with the frame instead if the queue is full.
+    m_recycledFrames->tryPush(frame.storage);
 
     return *m_outputTexture;
 }
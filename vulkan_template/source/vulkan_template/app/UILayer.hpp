@@ -1,16 +1,23 @@
 #pragma once
 
+#include "vulkan_template/app/FrameBuffer.hpp"
+#include "vulkan_template/app/UITextureRegistry.hpp"
 #include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/SPSCQueue.hpp"
 #include "vulkan_template/core/UIRectangle.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <filesystem>
 #include <functional>
+#include <array>
 #include <imgui.h>
 #include <memory>
 #include <optional>
-#include <string>
+#include <vector>
 
 namespace vkt
 {
+struct BindlessHeap;
+struct ImageView;
 struct PlatformWindow;
 struct RenderTarget;
 } // namespace vkt
@@ -26,6 +33,39 @@ struct SceneViewport
     // transforming application window coordinates into scene world coordinates,
     // such as when raycasting in mouse events.
     UIRectangle windowExtent;
+
+    // The texels of texture that the UI shows. The texture may still be in use
+    // by the previous frame, so this must be set as its size only when the
+    // frame's commands are recorded.
+    VkRect2D textureRegion;
+};
+
+struct UIDrawListDeleter
+{
+    void operator()(ImDrawList*) const;
+};
+
+// The copied out draw lists and uploads of a UI frame. Recycled by the layer,
+// so once its buffers have grown to fit, copying a frame reuses their memory.
+struct UIFrameStorage
+{
+    // Its command lists point into drawLists. There may be more draw lists
+    // than command lists, left over from earlier frames.
+    ImDrawData drawData{};
+    std::vector<std::unique_ptr<ImDrawList, UIDrawListDeleter>> drawLists{};
+
+    UITextureRegistry::UploadBatch textureUploads{};
+};
+
+// One frame of UI as ImGui drew it, copied out so that it stays valid while
+// ImGui builds the next frame. This lets the frame be recorded on another
+// thread.
+struct UIFrame
+{
+    // Null if the frame failed to build. Taken back by recordDraw.
+    std::unique_ptr<UIFrameStorage> storage{};
+
+    uint32_t rasterizeInterval{1};
 };
 
 struct UIPreferences
@@ -33,6 +73,10 @@ struct UIPreferences
     static float constexpr DEFAULT_DPI_SCALE{2.0F};
 
     float dpiScale{DEFAULT_DPI_SCALE};
+
+    // Rasterize changed UI at most once every this many frames. The scene
+    // viewport is still updated every frame.
+    uint32_t rasterizeInterval{1};
 };
 
 struct HUDState
@@ -58,6 +102,19 @@ struct DockingLayout
     std::optional<ImGuiID> centerTop{};
 };
 
+// Where the scene viewport's texture was drawn in the rasterized UI.
+struct UISceneRegion
+{
+    // Texels of the scene texture that were drawn
+    VkRect2D source{};
+    // Pixels of the UI output that they were drawn to
+    VkRect2D destination{};
+
+    // Whether UI drawn afterwards overlaps the scene, such as a popup. Then
+    // copying the scene over the rasterized UI would hide that UI.
+    bool obstructed{false};
+};
+
 struct UILayer
 {
 public:
@@ -76,28 +133,29 @@ public:
     // GLFW Detail: the backend installs any callbacks, so this can be called
     // after window callbacks are set (Such as cursor position/key event
     // callbacks).
+    //
+    // Without a main window the layer is headless. It reads no input, and its
+    // display is as large as textureCapacity, so UI can be rendered offscreen
+    // such as in tests.
     static auto create(
         VkInstance,
         VkPhysicalDevice,
         VkDevice,
         VmaAllocator,
+        BindlessHeap&,
         VkExtent2D textureCapacity,
         uint32_t graphicsQueueFamily,
         VkQueue graphicsQueue,
-        PlatformWindow& mainWindow,
-        UIPreferences defaultPreferences
+        PlatformWindow* mainWindow,
+        UIPreferences defaultPreferences,
+        std::filesystem::path const& fontAtlasCachePath
     ) -> std::optional<UILayer>;
 
     auto begin() -> DockingLayout const&;
 
     [[nodiscard]] auto
-    HUDMenuItem(std::string const& menu, std::string const& item) const -> bool;
-    void HUDMenuToggle(
-        std::string const& menu, std::string const& item, bool& value
-    ) const;
-
-    [[nodiscard]] auto sceneTextureLayout() const
-        -> std::optional<VkDescriptorSetLayout>;
+    HUDMenuItem(char const* menu, char const* item) const -> bool;
+    void HUDMenuToggle(char const* menu, char const* item, bool& value) const;
 
     auto sceneViewport(bool forceFocus = false) -> std::optional<SceneViewport>;
 
@@ -105,14 +163,40 @@ public:
     // exposing it until rendering time
     [[nodiscard]] auto sceneTexture() -> RenderTarget const&;
 
-    void end();
-
-    // Returns the final output image that should be presented.
-    auto recordDraw(VkCommandBuffer)
+    // For drawing images in the UI without a descriptor set per image.
+    auto textureRegistry() -> UITextureRegistry&;
+
+    // Finishes the UI frame, and copies out everything recordDraw needs. Once
+    // recorded frames have returned their storage, this reuses it and makes no
+    // heap allocations of its own.
+    auto end() -> UIFrame;
+
+    // Whether the UI needs another frame even without new input, such as to
+    // apply reloaded preferences or blink a text cursor.
+    [[nodiscard]] auto wantsRedraw() const -> bool;
+
+    // Returns the final output image that should be presented. The UI is only
+    // rasterized again when its draw data changes, otherwise the previous
+    // rasterization is reused with the scene viewport copied over it.
+    //
+    // Only touches rendering state, so it may be called on another thread
+    // while the next frame is built, as long as frames are recorded in order.
+    // The only ImGui state it shares with that thread is the Vulkan backend,
+    // which it calls while holding uiBackendMutex. Any other code that calls
+    // ImGui_ImplVulkan_* while frames are recorded must hold it too.
+    //
+    // Call once per frame, after waiting on the frame's fence. Texture sets
+    // that the frame's batch released are freed FRAMES_IN_FLIGHT calls later,
+    // once every frame that may draw them has retired. The frame's storage is
+    // handed back to end() for reuse, so frames must be ended and recorded on
+    // one thread each.
+    auto recordDraw(VkCommandBuffer, UIFrame&)
         -> std::optional<std::reference_wrapper<RenderTarget>>;
 
 private:
     bool m_backendInitialized{false};
+    // False when headless
+    bool m_platformBackendInitialized{false};
 
     bool m_reloadNecessary{false};
     UIPreferences m_currentPreferences{};
@@ -131,8 +215,32 @@ private:
     // An opaque handle from the Vulkan backend that contains the scene texture
     ImTextureID m_imguiSceneTextureHandle{nullptr};
 
+    std::unique_ptr<UITextureRegistry> m_textureRegistry;
+    // Sets released by the registry, indexed by the frame that recorded the
+    // batch they came in
+    std::array<std::vector<ImTextureID>, FrameBuffer::FRAMES_IN_FLIGHT>
+        m_releasedTextures{};
+    size_t m_recordedFrames{0};
+
+    // Frame storage that recordDraw is done with, waiting for end() to reuse
+    // it. At most one frame is built, one queued, and one recorded at a time.
+    // Held by pointer since the queue cannot move.
+    static size_t constexpr RECYCLED_FRAME_CAPACITY{4};
+    std::unique_ptr<SPSCQueue<
+        std::unique_ptr<UIFrameStorage>,
+        RECYCLED_FRAME_CAPACITY>>
+        m_recycledFrames;
+
     // The final output of the application viewport, with all geometry and UI
     // rendered
     std::unique_ptr<RenderTarget> m_outputTexture;
+
+    // The UI as last rasterized. Post processing modifies the output texture
+    // in place, so the cache is kept separately and copied each frame.
+    std::unique_ptr<ImageView> m_uiCache;
+    // Hash of the draw data in m_uiCache, or empty if the cache is invalid.
+    std::optional<uint64_t> m_uiCacheHash{};
+    std::optional<UISceneRegion> m_uiCacheScene{};
+    uint32_t m_framesSinceRasterization{0};
 };
 } // namespace vkt
\ No newline at end of file
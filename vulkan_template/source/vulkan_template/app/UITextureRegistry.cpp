@@ -0,0 +1,501 @@
+#include "UITextureRegistry.hpp"
+
+#include "vulkan_template/app/UIBackend.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/Image.hpp"
+#include "vulkan_template/vulkan/ImageOperations.hpp"
+#include "vulkan_template/vulkan/ImageView.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <algorithm>
+#include <bit>
+#include <imgui_impl_vulkan.h>
+#include <mutex>
+#include <utility>
+
+namespace
+{
+// Shaders sample pages as linear color, and small 8-bit images keep pages
+// compact.
+VkFormat constexpr PAGE_FORMAT{VK_FORMAT_R8G8B8A8_SRGB};
+} // namespace
+
+namespace vkt
+{
+UITextureRegistry::UITextureRegistry(UITextureRegistry&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto UITextureRegistry::operator=(UITextureRegistry&& other) noexcept
+    -> UITextureRegistry&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+    m_parameters = std::exchange(other.m_parameters, CreateParameters{});
+
+    m_sampler = std::exchange(other.m_sampler, VK_NULL_HANDLE);
+
+    m_pages = std::move(other.m_pages);
+    m_sizeClasses = std::move(other.m_sizeClasses);
+
+    m_entries = std::move(other.m_entries);
+    m_pendingUploads = std::move(other.m_pendingUploads);
+    m_releasedTextures = std::move(other.m_releasedTextures);
+
+    m_frame = std::exchange(other.m_frame, 0);
+
+    return *this;
+}
+
+UITextureRegistry::~UITextureRegistry() { destroy(); }
+
+void UITextureRegistry::destroy()
+{
+    for (auto const& [key, entry] : m_entries)
+    {
+        if (!entry.slot.has_value())
+        {
+            release(entry);
+        }
+    }
+    // The registry outlives every frame that draws from it, so nothing can
+    // still be sampling these
+    freeReleasedTextures(m_releasedTextures);
+    for (Page const& page : m_pages)
+    {
+        std::lock_guard const lock{uiBackendMutex()};
+        ImGui_ImplVulkan_RemoveTexture(
+            reinterpret_cast<VkDescriptorSet>(page.id)
+        );
+    }
+
+    if (m_device != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(m_device, m_sampler, nullptr);
+    }
+
+    m_device = VK_NULL_HANDLE;
+    m_allocator = VK_NULL_HANDLE;
+    m_parameters = {};
+
+    m_sampler = VK_NULL_HANDLE;
+
+    m_pages.clear();
+    m_sizeClasses.clear();
+
+    m_entries.clear();
+    m_pendingUploads.clear();
+    m_releasedTextures.clear();
+
+    m_frame = 0;
+}
+
+auto UITextureRegistry::create(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    CreateParameters const parameters
+) -> std::optional<UITextureRegistry>
+{
+    if (ImGui::GetIO().BackendRendererUserData == nullptr)
+    {
+        VKT_ERROR("ImGui backend not initialized.");
+        return std::nullopt;
+    }
+
+    if (!std::has_single_bit(parameters.minSlotExtent)
+        || !std::has_single_bit(parameters.maxSlotExtent)
+        || parameters.minSlotExtent > parameters.maxSlotExtent
+        || parameters.maxSlotExtent > parameters.pageExtent)
+    {
+        VKT_ERROR(
+            "UI texture registry slot extents must be powers of two no larger "
+            "than a page."
+        );
+        return std::nullopt;
+    }
+
+    std::optional<UITextureRegistry> result{
+        std::in_place, UITextureRegistry{}
+    };
+    UITextureRegistry& registry{result.value()};
+
+    registry.m_device = device;
+    registry.m_allocator = allocator;
+    registry.m_parameters = parameters;
+
+    VkSamplerCreateInfo const samplerInfo{samplerCreateInfo(
+        0,
+        VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
+        VK_FILTER_LINEAR,
+        VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE
+    )};
+    VKT_TRY_VK(
+        vkCreateSampler(device, &samplerInfo, nullptr, &registry.m_sampler),
+        "Failed to create UI texture registry sampler.",
+        std::nullopt
+    );
+
+    for (uint32_t slotExtent{parameters.minSlotExtent};
+         slotExtent <= parameters.maxSlotExtent;
+         slotExtent *= 2)
+    {
+        registry.m_sizeClasses.push_back(SizeClass{.slotExtent = slotExtent});
+    }
+
+    return result;
+}
+
+auto UITextureRegistry::find(Key const key) -> std::optional<UITexture>
+{
+    auto const entryIt{m_entries.find(key)};
+    if (entryIt == m_entries.end())
+    {
+        return std::nullopt;
+    }
+
+    Entry& entry{entryIt->second};
+    entry.lastUsedFrame = m_frame;
+
+    if (entry.slot.has_value())
+    {
+        std::list<Key>& recency{m_sizeClasses[entry.sizeClass].recency};
+        recency.splice(recency.begin(), recency, entry.recencyIt);
+    }
+
+    return entry.texture;
+}
+
+auto UITextureRegistry::add(Key const key, ImageView& source)
+    -> std::optional<UITexture>
+{
+    remove(key);
+
+    VkExtent2D const extent{source.image().extent2D()};
+    uint32_t const largestSide{std::max(extent.width, extent.height)};
+
+    Entry entry{.lastUsedFrame = m_frame};
+
+    if (largestSide > m_parameters.maxSlotExtent)
+    {
+        std::lock_guard const lock{uiBackendMutex()};
+        entry.texture = UITexture{
+            .id = ImGui_ImplVulkan_AddTexture(
+                m_sampler,
+                source.view(),
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            ),
+        };
+        if (entry.texture.id == nullptr)
+        {
+            VKT_ERROR("Failed to allocate UI texture descriptor set.");
+            return std::nullopt;
+        }
+    }
+    else
+    {
+        uint32_t const sizeClass{static_cast<uint32_t>(
+            std::countr_zero(std::bit_ceil(
+                std::max(largestSide, m_parameters.minSlotExtent)
+            ))
+            - std::countr_zero(m_parameters.minSlotExtent)
+        )};
+
+        std::optional<Slot> const slot{allocateSlot(sizeClass)};
+        if (!slot.has_value())
+        {
+            return std::nullopt;
+        }
+
+        // Inset by half a texel so filtering never reads neighboring slots
+        VkRect2D const rect{slotRect(slot.value(), extent)};
+        auto const pageExtent{static_cast<float>(m_parameters.pageExtent)};
+
+        entry.texture = UITexture{
+            .id = m_pages[slot.value().page].id,
+            .uv0 =
+                ImVec2{
+                    (static_cast<float>(rect.offset.x) + 0.5F) / pageExtent,
+                    (static_cast<float>(rect.offset.y) + 0.5F) / pageExtent,
+                },
+            .uv1 =
+                ImVec2{
+                    (static_cast<float>(rect.offset.x + rect.extent.width)
+                     - 0.5F)
+                        / pageExtent,
+                    (static_cast<float>(rect.offset.y + rect.extent.height)
+                     - 0.5F)
+                        / pageExtent,
+                },
+        };
+        entry.slot = slot;
+        entry.sizeClass = sizeClass;
+
+        std::list<Key>& recency{m_sizeClasses[sizeClass].recency};
+        recency.push_front(key);
+        entry.recencyIt = recency.begin();
+    }
+
+    m_pendingUploads.push_back(PendingUpload{.key = key, .source = &source});
+
+    return m_entries.insert_or_assign(key, entry).first->second.texture;
+}
+
+void UITextureRegistry::remove(Key const key)
+{
+    auto const entryIt{m_entries.find(key)};
+    if (entryIt == m_entries.end())
+    {
+        return;
+    }
+
+    release(entryIt->second);
+    m_entries.erase(entryIt);
+
+    std::erase_if(
+        m_pendingUploads,
+        [&](PendingUpload const& upload) { return upload.key == key; }
+    );
+}
+
+auto UITextureRegistry::takeUploads() -> UploadBatch
+{
+    UploadBatch batch{};
+    takeUploads(batch);
+    return batch;
+}
+
+void UITextureRegistry::takeUploads(UploadBatch& batch)
+{
+    batch.uploads.clear();
+    batch.pages.clear();
+    batch.releasedTextures.clear();
+
+    // Slots are resolved now, since later frames may evict and reuse them
+    // before this batch is recorded.
+    for (PendingUpload const& pending : m_pendingUploads)
+    {
+        Entry const& entry{m_entries.at(pending.key)};
+
+        Upload upload{.key = pending.key, .source = pending.source};
+        if (entry.slot.has_value())
+        {
+            upload.page = m_pages[entry.slot.value().page].image.get();
+            upload.destination = slotRect(
+                entry.slot.value(), pending.source->image().extent2D()
+            );
+        }
+        batch.uploads.push_back(upload);
+    }
+    m_pendingUploads.clear();
+
+    for (Page const& page : m_pages)
+    {
+        batch.pages.push_back(page.image.get());
+    }
+
+    batch.releasedTextures.assign(
+        m_releasedTextures.begin(), m_releasedTextures.end()
+    );
+    m_releasedTextures.clear();
+
+    m_frame += 1;
+}
+
+auto UITextureRegistry::recordUploads(
+    VkCommandBuffer const cmd, UploadBatch const& batch
+) -> bool
+{
+    // Transition every image once, rather than once per copy
+    for (Upload const& upload : batch.uploads)
+    {
+        VkImageLayout const sourceLayout{
+            upload.page != nullptr ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+                                   : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        };
+        if (upload.source->expectedLayout() != sourceLayout)
+        {
+            upload.source->recordTransitionBarriered(cmd, sourceLayout);
+        }
+
+        if (upload.page != nullptr
+            && upload.page->expectedLayout()
+                   != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+        {
+            upload.page->recordTransitionBarriered(
+                cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+            );
+        }
+    }
+
+    for (Upload const& upload : batch.uploads)
+    {
+        if (upload.page == nullptr)
+        {
+            continue;
+        }
+
+        recordCopyImageToImage(
+            cmd,
+            upload.source->image().image(),
+            upload.page->image().image(),
+            VkRect2D{.extent = upload.source->image().extent2D()},
+            upload.destination
+        );
+    }
+
+    for (ImageView* const page : batch.pages)
+    {
+        if (page->expectedLayout() != VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+        {
+            page->recordTransitionBarriered(
+                cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            );
+        }
+    }
+
+    return !batch.uploads.empty();
+}
+
+void UITextureRegistry::freeReleasedTextures(
+    std::span<ImTextureID const> const textures
+)
+{
+    std::lock_guard const lock{uiBackendMutex()};
+    for (ImTextureID const texture : textures)
+    {
+        ImGui_ImplVulkan_RemoveTexture(
+            reinterpret_cast<VkDescriptorSet>(texture)
+        );
+    }
+}
+
+auto UITextureRegistry::allocateSlot(uint32_t const sizeClass)
+    -> std::optional<Slot>
+{
+    SizeClass& slots{m_sizeClasses[sizeClass]};
+
+    if (slots.freeSlots.empty() && m_pages.size() < m_parameters.maxPages)
+    {
+        // A failed allocation falls through to eviction
+        allocatePage(sizeClass);
+    }
+
+    if (slots.freeSlots.empty() && !slots.recency.empty())
+    {
+        Key const leastRecent{slots.recency.back()};
+        Entry const& evicted{m_entries.at(leastRecent)};
+
+        // Evicting an image drawn this frame would draw the wrong image
+        if (evicted.lastUsedFrame == m_frame)
+        {
+            return std::nullopt;
+        }
+
+        remove(leastRecent);
+    }
+
+    if (slots.freeSlots.empty())
+    {
+        return std::nullopt;
+    }
+
+    Slot const slot{slots.freeSlots.back()};
+    slots.freeSlots.pop_back();
+
+    return slot;
+}
+
+auto UITextureRegistry::allocatePage(uint32_t const sizeClass) -> bool
+{
+    std::optional<std::unique_ptr<ImageView>> imageResult{ImageView::allocate(
+        m_device,
+        m_allocator,
+        ImageAllocationParameters{
+            .extent =
+                VkExtent2D{
+                    .width = m_parameters.pageExtent,
+                    .height = m_parameters.pageExtent,
+                },
+            .format = PAGE_FORMAT,
+            .usageFlags =
+                VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        },
+        ImageViewAllocationParameters{}
+    )};
+    if (!imageResult.has_value() || imageResult.value() == nullptr)
+    {
+        VKT_WARNING("Failed to allocate UI texture atlas page.");
+        return false;
+    }
+
+    Page page{
+        .image = std::move(imageResult).value(),
+        .sizeClass = sizeClass,
+    };
+    {
+        std::lock_guard const lock{uiBackendMutex()};
+        page.id = ImGui_ImplVulkan_AddTexture(
+            m_sampler,
+            page.image->view(),
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        );
+    }
+    if (page.id == nullptr)
+    {
+        VKT_WARNING("Failed to allocate UI texture atlas descriptor set.");
+        return false;
+    }
+
+    auto const pageIndex{static_cast<uint32_t>(m_pages.size())};
+    m_pages.push_back(std::move(page));
+
+    SizeClass& slots{m_sizeClasses[sizeClass]};
+    uint32_t const slotsPerRow{m_parameters.pageExtent / slots.slotExtent};
+
+    // Reversed so slots are handed out from the start of the page
+    for (uint32_t index{slotsPerRow * slotsPerRow}; index > 0; index--)
+    {
+        slots.freeSlots.push_back(Slot{.page = pageIndex, .index = index - 1});
+    }
+
+    return true;
+}
+
+void UITextureRegistry::release(Entry const& entry)
+{
+    if (!entry.slot.has_value())
+    {
+        // Frames that are still being built or recorded may draw the set
+        m_releasedTextures.push_back(entry.texture.id);
+        return;
+    }
+
+    SizeClass& slots{m_sizeClasses[entry.sizeClass]};
+    slots.recency.erase(entry.recencyIt);
+    slots.freeSlots.push_back(entry.slot.value());
+}
+
+auto UITextureRegistry::slotRect(Slot const slot, VkExtent2D const extent) const
+    -> VkRect2D
+{
+    uint32_t const slotExtent{
+        m_sizeClasses[m_pages[slot.page].sizeClass].slotExtent
+    };
+    uint32_t const slotsPerRow{m_parameters.pageExtent / slotExtent};
+
+    uint32_t const column{slot.index % slotsPerRow};
+    uint32_t const row{slot.index / slotsPerRow};
+
+    return VkRect2D{
+        .offset =
+            VkOffset2D{
+                .x = static_cast<int32_t>(column * slotExtent),
+                .y = static_cast<int32_t>(row * slotExtent),
+            },
+        .extent = extent,
+    };
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <imgui.h>
+#include <list>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vkt
+{
+struct ImageView;
+} // namespace vkt
+
+namespace vkt
+{
+// Arguments for ImGui::Image and similar, for a texture from the registry.
+struct UITexture
+{
+    ImTextureID id{nullptr};
+    ImVec2 uv0{0.0F, 0.0F};
+    ImVec2 uv1{1.0F, 1.0F};
+};
+
+// Packs small UI images into shared atlas pages, so that hundreds of images
+// cost a handful of descriptor sets and the UI backend can draw them without
+// rebinding. Each page is split into square slots of a single size, and a
+// full size class evicts its least recently used image.
+//
+// Images larger than the biggest slot are not copied and get a descriptor set
+// of their own. Removing or replacing them hands the set to the next upload
+// batch, to be freed once the frame that batch belongs to retires.
+//
+// Lookups are meant to be repeated every frame in immediate mode UI code.
+// Textures returned in earlier frames may have been evicted since, and then
+// draw a different image.
+//
+// The registry belongs to the thread that builds the UI. Each UI frame's
+// uploads are taken out as a batch that can be recorded on another thread.
+// Descriptor sets come from the UI backend, under uiBackendMutex.
+struct UITextureRegistry
+{
+public:
+    // Chosen by the caller, such as a hash of an asset path.
+    using Key = uint64_t;
+
+    struct Upload
+    {
+        Key key{0};
+        ImageView* source{nullptr};
+
+        // Null when the image has a dedicated descriptor set, and is sampled
+        // without copying.
+        ImageView* page{nullptr};
+        VkRect2D destination{};
+    };
+
+    // The uploads that one UI frame needs before it is drawn.
+    struct UploadBatch
+    {
+        std::vector<Upload> uploads{};
+        // Every page that existed when the batch was taken, since the frame
+        // may sample any of them.
+        std::vector<ImageView*> pages{};
+        // Dedicated descriptor sets of images that were removed or replaced.
+        // This frame and frames still in flight may draw them, so they must
+        // be passed to freeReleasedTextures only once this frame retires.
+        std::vector<ImTextureID> releasedTextures{};
+    };
+
+    struct CreateParameters
+    {
+        uint32_t pageExtent{2048};
+        // Slot sizes are the powers of two between these.
+        uint32_t minSlotExtent{32};
+        uint32_t maxSlotExtent{256};
+        uint32_t maxPages{8};
+    };
+
+    UITextureRegistry(UITextureRegistry const&) = delete;
+    auto operator=(UITextureRegistry const&) -> UITextureRegistry& = delete;
+
+    UITextureRegistry(UITextureRegistry&&) noexcept;
+    auto operator=(UITextureRegistry&&) noexcept -> UITextureRegistry&;
+    ~UITextureRegistry();
+
+private:
+    UITextureRegistry() = default;
+    void destroy();
+
+public:
+    // Must be called after the UI backend is initialized, and destroyed before
+    // it is shut down, since descriptor sets are allocated by the backend.
+    static auto create(VkDevice, VmaAllocator, CreateParameters)
+        -> std::optional<UITextureRegistry>;
+
+    // Marks the image as used this frame. Empty if the key was never added or
+    // was evicted.
+    auto find(Key) -> std::optional<UITexture>;
+
+    // Registers source under key, replacing any previous image. Small images
+    // are copied into the atlas when the batch holding them is recorded, so
+    // source must stay alive and support TRANSFER_SRC until then. Large images
+    // are sampled directly, so source must outlive the registration.
+    //
+    // Fails if every slot that fits source was used this frame and no more
+    // pages can be allocated.
+    auto add(Key, ImageView& source) -> std::optional<UITexture>;
+
+    void remove(Key);
+
+    // Ends the registry's frame, and returns the uploads queued during it.
+    // Call once per UI frame, after the last lookup.
+    auto takeUploads() -> UploadBatch;
+    // Replaces the contents of batch instead, reusing its vectors' memory.
+    void takeUploads(UploadBatch& batch);
+
+    // Records the batch's copies into the atlas and transitions everything the
+    // UI will sample for reading, before drawing the frame the batch was taken
+    // from. Touches no registry state, so it may run on another thread while
+    // the next UI frame is built. Returns whether any image contents changed.
+    static auto recordUploads(VkCommandBuffer, UploadBatch const&) -> bool;
+
+    // Frees descriptor sets from UploadBatch::releasedTextures through the UI
+    // backend. Thread safe.
+    static void freeReleasedTextures(std::span<ImTextureID const>);
+
+private:
+    struct Page
+    {
+        std::unique_ptr<ImageView> image{};
+        ImTextureID id{nullptr};
+        uint32_t sizeClass{0};
+    };
+
+    struct Slot
+    {
+        uint32_t page{0};
+        uint32_t index{0};
+    };
+
+    struct SizeClass
+    {
+        uint32_t slotExtent{0};
+        std::vector<Slot> freeSlots{};
+        // Front is the most recently used
+        std::list<Key> recency{};
+    };
+
+    struct Entry
+    {
+        UITexture texture{};
+        uint64_t lastUsedFrame{0};
+
+        // Empty when the image has a dedicated descriptor set
+        std::optional<Slot> slot{};
+        uint32_t sizeClass{0};
+        std::list<Key>::iterator recencyIt{};
+    };
+
+    struct PendingUpload
+    {
+        Key key{0};
+        ImageView* source{nullptr};
+    };
+
+    auto allocateSlot(uint32_t sizeClass) -> std::optional<Slot>;
+    auto allocatePage(uint32_t sizeClass) -> bool;
+    void release(Entry const&);
+    [[nodiscard]] auto slotRect(Slot, VkExtent2D) const -> VkRect2D;
+
+    VkDevice m_device{VK_NULL_HANDLE};
+    VmaAllocator m_allocator{VK_NULL_HANDLE};
+    CreateParameters m_parameters{};
+
+    VkSampler m_sampler{VK_NULL_HANDLE};
+
+    std::vector<Page> m_pages{};
+    std::vector<SizeClass> m_sizeClasses{};
+
+    std::unordered_map<Key, Entry> m_entries{};
+    // Images added since uploads were last taken
+    std::vector<PendingUpload> m_pendingUploads{};
+    // Dedicated sets released since uploads were last taken
+    std::vector<ImTextureID> m_releasedTextures{};
+
+    uint64_t m_frame{0};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,526 @@
+#include "AssetArchive.hpp"
+
+#include "vulkan_template/core/BlockCompression.hpp"
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace
+{
+// Tables are read and written as they are in memory
+static_assert(std::endian::native == std::endian::little);
+
+std::array<char, 4> constexpr MAGIC{'V', 'K', 'T', 'A'};
+uint32_t constexpr VERSION{1};
+
+// Tables start on this boundary so they could also be read in place
+size_t constexpr TABLE_ALIGNMENT{8};
+
+struct Header
+{
+    std::array<char, 4> magic{};
+    uint32_t version{0};
+    uint32_t entryCount{0};
+    uint32_t chunkCount{0};
+    uint64_t chunkSize{0};
+    uint64_t entriesOffset{0};
+    uint64_t chunksOffset{0};
+    uint64_t namesOffset{0};
+    uint64_t namesSize{0};
+};
+
+// FNV-1a, which is short and spreads file paths well enough for an index
+auto hashName(std::string_view const name) -> uint64_t
+{
+    uint64_t hash{14695981039346656037ULL};
+    for (char const character : name)
+    {
+        hash ^= static_cast<uint8_t>(character);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+auto alignUp(size_t const value, size_t const alignment) -> size_t
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void padTo(std::ofstream& file, size_t const alignment)
+{
+    auto const position{static_cast<size_t>(file.tellp())};
+    size_t const padding{alignUp(position, alignment) - position};
+
+    std::array<char, 256> constexpr ZEROES{};
+    for (size_t written{0}; written < padding; written += ZEROES.size())
+    {
+        file.write(
+            ZEROES.data(),
+            static_cast<std::streamsize>(
+                std::min(ZEROES.size(), padding - written)
+            )
+        );
+    }
+}
+
+template <typename T> void writeTable(std::ofstream& file, std::span<T> table)
+{
+    file.write(
+        reinterpret_cast<char const*>(table.data()),
+        static_cast<std::streamsize>(table.size_bytes())
+    );
+}
+
+// Copies count elements at offset out of the mapping, failing if any of them
+// lie outside of it.
+template <typename T>
+auto readTable(
+    std::span<uint8_t const> const bytes,
+    uint64_t const offset,
+    uint64_t const count,
+    std::vector<T>& table
+) -> bool
+{
+    if (offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T))
+    {
+        return false;
+    }
+
+    table.resize(count);
+    std::memcpy(table.data(), bytes.data() + offset, count * sizeof(T));
+    return true;
+}
+
+auto mountedArchive() -> std::optional<vkt::AssetArchive>&
+{
+    static std::optional<vkt::AssetArchive> archive{};
+    return archive;
+}
+} // namespace
+
+namespace vkt
+{
+auto AssetArchive::write(
+    std::filesystem::path const& path,
+    std::span<AssetArchiveSource const> const sources
+) -> bool
+{
+    struct Source
+    {
+        AssetArchiveSource const* source;
+        uint64_t nameHash;
+    };
+
+    std::vector<Source> sorted{};
+    sorted.reserve(sources.size());
+    for (AssetArchiveSource const& source : sources)
+    {
+        if (!std::has_single_bit(source.alignment))
+        {
+            VKT_ERROR(
+                "Alignment {} of '{}' is not a power of two.",
+                source.alignment,
+                source.name
+            );
+            return false;
+        }
+        sorted.push_back(Source{
+            .source = &source,
+            .nameHash = hashName(source.name),
+        });
+    }
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [](Source const& lhs, Source const& rhs)
+    {
+        return std::pair{lhs.nameHash, std::string_view{lhs.source->name}}
+             < std::pair{rhs.nameHash, std::string_view{rhs.source->name}};
+    }
+    );
+    auto const duplicate{std::adjacent_find(
+        sorted.begin(),
+        sorted.end(),
+        [](Source const& lhs, Source const& rhs)
+    { return lhs.source->name == rhs.source->name; }
+    )};
+    if (duplicate != sorted.end())
+    {
+        VKT_ERROR(
+            "Archive has more than one entry named '{}'.",
+            duplicate->source->name
+        );
+        return false;
+    }
+
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file.is_open())
+    {
+        VKT_ERROR("Unable to open archive for writing at '{}'", path.string());
+        return false;
+    }
+
+    // Written again once the tables' offsets are known
+    Header header{};
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    std::vector<Entry> entries{};
+    std::vector<Chunk> chunks{};
+    std::string names{};
+    std::vector<uint8_t> compressed{};
+    for (Source const& source : sorted)
+    {
+        std::optional<MappedFile> const sourceFile{
+            MappedFile::open(source.source->path)
+        };
+        if (!sourceFile.has_value())
+        {
+            return false;
+        }
+        std::span<uint8_t const> const bytes{sourceFile.value().bytes()};
+
+        padTo(file, source.source->alignment);
+
+        size_t const chunkCount{(bytes.size() + CHUNK_SIZE - 1) / CHUNK_SIZE};
+        Entry const entry{
+            .nameHash = source.nameHash,
+            .size = bytes.size(),
+            .nameOffset = static_cast<uint32_t>(names.size()),
+            .nameSize = static_cast<uint32_t>(source.source->name.size()),
+            .firstChunk = static_cast<uint32_t>(chunks.size()),
+            .chunkCount = static_cast<uint32_t>(chunkCount),
+            .alignment = source.source->alignment,
+            .reserved = 0,
+        };
+        entries.push_back(entry);
+        names += source.source->name;
+
+        for (size_t offset{0}; offset < bytes.size(); offset += CHUNK_SIZE)
+        {
+            std::span<uint8_t const> const chunkBytes{bytes.subspan(
+                offset, std::min(CHUNK_SIZE, bytes.size() - offset)
+            )};
+
+            compressed.clear();
+            if (source.source->compress)
+            {
+                compressBlock(chunkBytes, compressed);
+            }
+            bool const store{
+                compressed.empty() || compressed.size() >= chunkBytes.size()
+            };
+            std::span<uint8_t const> const stored{
+                store ? chunkBytes : std::span<uint8_t const>{compressed}
+            };
+
+            chunks.push_back(Chunk{
+                .offset = static_cast<uint64_t>(file.tellp()),
+                .storedSize = static_cast<uint32_t>(stored.size()),
+                .size = static_cast<uint32_t>(chunkBytes.size()),
+            });
+            writeTable(file, stored);
+        }
+    }
+
+    header = Header{
+        .magic = MAGIC,
+        .version = VERSION,
+        .entryCount = static_cast<uint32_t>(entries.size()),
+        .chunkCount = static_cast<uint32_t>(chunks.size()),
+        .chunkSize = CHUNK_SIZE,
+    };
+
+    padTo(file, TABLE_ALIGNMENT);
+    header.entriesOffset = static_cast<uint64_t>(file.tellp());
+    writeTable(file, std::span<Entry const>{entries});
+
+    padTo(file, TABLE_ALIGNMENT);
+    header.chunksOffset = static_cast<uint64_t>(file.tellp());
+    writeTable(file, std::span<Chunk const>{chunks});
+
+    header.namesOffset = static_cast<uint64_t>(file.tellp());
+    header.namesSize = names.size();
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    if (!file.good())
+    {
+        VKT_ERROR("Failed to write archive at '{}'", path.string());
+        return false;
+    }
+
+    return true;
+}
+
+auto AssetArchive::open(std::filesystem::path const& path)
+    -> std::optional<AssetArchive>
+{
+    std::optional<MappedFile> file{MappedFile::open(path)};
+    if (!file.has_value())
+    {
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const bytes{file.value().bytes()};
+
+    Header header{};
+    if (bytes.size() < sizeof(header))
+    {
+        VKT_ERROR("Archive at '{}' is too small for a header.", path.string());
+        return std::nullopt;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != MAGIC || header.version != VERSION
+        || header.chunkSize != CHUNK_SIZE)
+    {
+        VKT_ERROR(
+            "File at '{}' is not an archive of version {}.",
+            path.string(),
+            VERSION
+        );
+        return std::nullopt;
+    }
+
+    std::optional<AssetArchive> result{std::in_place, AssetArchive{}};
+    AssetArchive& archive{result.value()};
+
+    std::vector<char> names{};
+    if (!readTable(
+            bytes, header.entriesOffset, header.entryCount, archive.m_entries
+        )
+        || !readTable(
+            bytes, header.chunksOffset, header.chunkCount, archive.m_chunks
+        )
+        || !readTable(bytes, header.namesOffset, header.namesSize, names))
+    {
+        VKT_ERROR("Archive at '{}' has a truncated index.", path.string());
+        return std::nullopt;
+    }
+    archive.m_names.assign(names.begin(), names.end());
+
+    // Checked once here so that lookups and reads can trust the index
+    for (Chunk const& chunk : archive.m_chunks)
+    {
+        if (chunk.offset > bytes.size()
+            || chunk.storedSize > bytes.size() - chunk.offset
+            || chunk.size > CHUNK_SIZE)
+        {
+            VKT_ERROR(
+                "Archive at '{}' has a chunk outside of the file.",
+                path.string()
+            );
+            return std::nullopt;
+        }
+    }
+    for (Entry const& entry : archive.m_entries)
+    {
+        bool const namesValid{
+            static_cast<size_t>(entry.nameOffset) + entry.nameSize
+            <= archive.m_names.size()
+        };
+        uint64_t const chunkBytes{
+            static_cast<uint64_t>(entry.chunkCount) * CHUNK_SIZE
+        };
+        bool const chunksValid{
+            static_cast<size_t>(entry.firstChunk) + entry.chunkCount
+                <= archive.m_chunks.size()
+            && entry.size <= chunkBytes
+        };
+        if (!namesValid || !chunksValid)
+        {
+            VKT_ERROR(
+                "Archive at '{}' has an entry outside of its tables.",
+                path.string()
+            );
+            return std::nullopt;
+        }
+    }
+
+    archive.m_file = std::move(file);
+
+    return result;
+}
+
+auto AssetArchive::contains(std::string_view const name) const -> bool
+{
+    return find(name) != nullptr;
+}
+
+auto AssetArchive::size(std::string_view const name) const
+    -> std::optional<size_t>
+{
+    Entry const* const entry{find(name)};
+    if (entry == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<size_t>(entry->size);
+}
+
+auto AssetArchive::view(std::string_view const name) const
+    -> std::span<uint8_t const>
+{
+    Entry const* const entry{find(name)};
+    if (entry == nullptr || entry->chunkCount == 0)
+    {
+        return {};
+    }
+
+    std::span<Chunk const> const chunks{
+        std::span{m_chunks}.subspan(entry->firstChunk, entry->chunkCount)
+    };
+    bool const stored{std::all_of(
+        chunks.begin(),
+        chunks.end(),
+        [](Chunk const& chunk) { return chunk.storedSize == chunk.size; }
+    )};
+    if (!stored)
+    {
+        return {};
+    }
+
+    // Stored chunks of an entry are written back to back
+    return m_file.value().bytes().subspan(
+        chunks.front().offset, static_cast<size_t>(entry->size)
+    );
+}
+
+auto AssetArchive::read(
+    std::string_view const name,
+    std::span<uint8_t> const destination,
+    JobSystem* const jobs
+) const -> bool
+{
+    Entry const* const entry{find(name)};
+    if (entry == nullptr)
+    {
+        VKT_ERROR("Archive has no entry named '{}'.", name);
+        return false;
+    }
+    if (destination.size() != entry->size)
+    {
+        VKT_ERROR(
+            "Destination of {} bytes does not fit '{}' of {} bytes.",
+            destination.size(),
+            name,
+            entry->size
+        );
+        return false;
+    }
+
+    std::span<uint8_t const> const bytes{m_file.value().bytes()};
+    std::atomic<bool> failed{false};
+    auto const readChunks{[&](size_t const begin, size_t const end)
+    {
+        for (size_t index{begin}; index < end; index++)
+        {
+            Chunk const& chunk{m_chunks[entry->firstChunk + index]};
+            size_t const offset{index * CHUNK_SIZE};
+            if (offset > destination.size()
+                || chunk.size > destination.size() - offset)
+            {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            std::span<uint8_t const> const stored{
+                bytes.subspan(chunk.offset, chunk.storedSize)
+            };
+            std::span<uint8_t> const target{
+                destination.subspan(offset, chunk.size)
+            };
+            if (chunk.storedSize == chunk.size)
+            {
+                std::copy(stored.begin(), stored.end(), target.begin());
+            }
+            else if (!decompressBlock(stored, target))
+            {
+                failed.store(true, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }};
+
+    if (jobs != nullptr && entry->chunkCount > 1)
+    {
+        jobs->parallelFor(entry->chunkCount, 1, readChunks);
+    }
+    else
+    {
+        readChunks(0, entry->chunkCount);
+    }
+
+    if (failed.load(std::memory_order_relaxed))
+    {
+        VKT_ERROR("Failed to decompress '{}' from archive.", name);
+        return false;
+    }
+
+    return true;
+}
+
+auto AssetArchive::read(std::string_view const name, JobSystem* const jobs)
+    const -> std::optional<std::vector<uint8_t>>
+{
+    std::optional<size_t> const entrySize{size(name)};
+    if (!entrySize.has_value())
+    {
+        VKT_ERROR("Archive has no entry named '{}'.", name);
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> bytes(entrySize.value());
+    if (!read(name, bytes, jobs))
+    {
+        return std::nullopt;
+    }
+
+    return bytes;
+}
+
+auto AssetArchive::find(std::string_view const name) const -> Entry const*
+{
+    uint64_t const nameHash{hashName(name)};
+    auto entry{std::lower_bound(
+        m_entries.begin(),
+        m_entries.end(),
+        nameHash,
+        [](Entry const& entry, uint64_t const hash)
+    { return entry.nameHash < hash; }
+    )};
+
+    // Names that collide are next to each other
+    for (; entry != m_entries.end() && entry->nameHash == nameHash; entry++)
+    {
+        std::string_view const entryName{
+            std::string_view{m_names}.substr(entry->nameOffset, entry->nameSize)
+        };
+        if (entryName == name)
+        {
+            return &*entry;
+        }
+    }
+
+    return nullptr;
+}
+
+void mountAssetArchive(std::optional<AssetArchive> archive)
+{
+    mountedArchive() = std::move(archive);
+}
+
+auto mountedAssetArchive() -> AssetArchive const*
+{
+    std::optional<AssetArchive> const& archive{mountedArchive()};
+    return archive.has_value() ? &archive.value() : nullptr;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/MappedFile.hpp"
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vkt
+{
+struct JobSystem;
+} // namespace vkt
+
+namespace vkt
+{
+// One file to cook into an archive.
+struct AssetArchiveSource
+{
+    // What the entry is found by, such as "shaders/testpattern.comp.spv"
+    std::string name{};
+    std::filesystem::path path{};
+
+    // Offset of the entry's bytes in the archive, and so in memory once the
+    // archive is mapped. Must be a power of two, such as a device's
+    // optimalBufferCopyOffsetAlignment for data that is uploaded as it is.
+    uint32_t alignment{16};
+
+    // Uncompressed entries can be used in place from the mapping, while
+    // compressed ones take less to read from disk.
+    bool compress{true};
+};
+
+// Many files cooked into one, so that startup maps a single file rather than
+// opening each asset. Entries are found through an index sorted by the hash of
+// their names, and are split into chunks that are compressed independently so
+// that a large entry decompresses in parallel.
+//
+// Chunks that do not shrink when compressed are stored as they are. An entry
+// whose chunks were all stored can be viewed in place without a copy.
+struct AssetArchive
+{
+public:
+    static size_t constexpr CHUNK_SIZE{64ULL * 1024ULL};
+
+    // Writes every source into an archive at path, replacing any existing
+    // file. Fails if a source cannot be read or two share a name.
+    static auto write(
+        std::filesystem::path const& path,
+        std::span<AssetArchiveSource const> sources
+    ) -> bool;
+
+    // Maps the archive and reads its index. Fails if the file is not an
+    // archive of this version, or its index points outside of the file.
+    static auto open(std::filesystem::path const& path)
+        -> std::optional<AssetArchive>;
+
+    [[nodiscard]] auto contains(std::string_view name) const -> bool;
+
+    // Bytes of the entry once decompressed.
+    [[nodiscard]] auto size(std::string_view name) const
+        -> std::optional<size_t>;
+
+    // The entry's bytes in the mapping, aligned as it was cooked. Empty if the
+    // entry is missing or any of its chunks are compressed.
+    [[nodiscard]] auto view(std::string_view name) const
+        -> std::span<uint8_t const>;
+
+    // Decompresses the entry into destination, which must be exactly the
+    // entry's size. Chunks are spread across jobs when it is provided, and
+    // otherwise decompressed on the calling thread.
+    auto read(
+        std::string_view name,
+        std::span<uint8_t> destination,
+        JobSystem* jobs = nullptr
+    ) const -> bool;
+
+    auto read(std::string_view name, JobSystem* jobs = nullptr) const
+        -> std::optional<std::vector<uint8_t>>;
+
+private:
+    // Laid out as in the file
+    struct Entry
+    {
+        uint64_t nameHash{0};
+        uint64_t size{0};
+        uint32_t nameOffset{0};
+        uint32_t nameSize{0};
+        uint32_t firstChunk{0};
+        uint32_t chunkCount{0};
+        uint32_t alignment{0};
+        uint32_t reserved{0};
+    };
+
+    // Laid out as in the file. A chunk is stored uncompressed when its stored
+    // size equals its size.
+    struct Chunk
+    {
+        uint64_t offset{0};
+        uint32_t storedSize{0};
+        uint32_t size{0};
+    };
+
+    AssetArchive() = default;
+
+    [[nodiscard]] auto find(std::string_view name) const -> Entry const*;
+
+    std::optional<MappedFile> m_file{};
+
+    // Sorted by name hash
+    std::vector<Entry> m_entries{};
+    std::vector<Chunk> m_chunks{};
+    std::string m_names{};
+};
+
+// Replaces the archive that asset loading checks before the file system, or
+// removes it when given nothing. Loads read the mounted archive without
+// synchronization, so this must be called before any loading starts.
+void mountAssetArchive(std::optional<AssetArchive> archive);
+
+// Null when no archive is mounted.
+auto mountedAssetArchive() -> AssetArchive const*;
+} // namespace vkt
\ No newline at end of file
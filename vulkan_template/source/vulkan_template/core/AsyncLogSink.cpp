@@ -0,0 +1,165 @@
+#include "AsyncLogSink.hpp"
+
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace vkt
+{
+AsyncLogSink::AsyncLogSink(spdlog::sink_ptr sink)
+    : m_sink{std::move(sink)}
+    , m_queue{std::make_unique<MPSCQueue<Record, QUEUE_CAPACITY>>()}
+{
+    m_writer = std::thread{[this]() { runWriter(); }};
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+    m_stopping.store(true);
+    m_pushWakeups.fetch_add(1);
+    m_pushWakeups.notify_one();
+
+    m_writer.join();
+}
+
+void AsyncLogSink::log(spdlog::details::log_msg const& message)
+{
+    Record record{
+        .loggerName = message.logger_name,
+        .level = message.level,
+        .time = message.time,
+        .threadId = message.thread_id,
+        .source = message.source,
+    };
+    record.payload.append(
+        message.payload.data(), message.payload.data() + message.payload.size()
+    );
+
+    if (!m_queue->tryPush(record))
+    {
+        m_dropped.fetch_add(1);
+        return;
+    }
+
+    m_pushed.fetch_add(1);
+
+    // Only makes a system call if the writer is asleep
+    m_pushWakeups.fetch_add(1);
+    m_pushWakeups.notify_one();
+}
+
+void AsyncLogSink::flush()
+{
+    if (m_stopping.load())
+    {
+        return;
+    }
+
+    uint64_t const target{m_pushed.load()};
+
+    uint64_t flushed{m_flushed.load()};
+    while (flushed < target)
+    {
+        m_flushed.wait(flushed);
+        flushed = m_flushed.load();
+    }
+}
+
+void AsyncLogSink::set_pattern(std::string const& pattern)
+{
+    m_sink->set_pattern(pattern);
+}
+
+void AsyncLogSink::set_formatter(std::unique_ptr<spdlog::formatter> formatter)
+{
+    m_sink->set_formatter(std::move(formatter));
+}
+
+void AsyncLogSink::runWriter()
+{
+    uint64_t written{0};
+    size_t idlePolls{0};
+    while (true)
+    {
+        // Loaded before draining, so a push that lands after the queue looks
+        // empty still changes the value and cuts the wait short.
+        uint32_t const wakeups{m_pushWakeups.load()};
+
+        bool wroteAny{false};
+        for (std::optional<Record> record{m_queue->tryPop()};
+             record.has_value();
+             record = m_queue->tryPop())
+        {
+            write(record.value());
+            written += 1;
+            wroteAny = true;
+        }
+
+        if (uint64_t const dropped{m_dropped.exchange(0)}; dropped > 0)
+        {
+            spdlog::memory_buf_t payload{};
+            fmt::format_to(
+                std::back_inserter(payload),
+                "Dropped {} log messages, since the queue was full.",
+                dropped
+            );
+            write(Record{
+                .level = spdlog::level::warn,
+                .time = spdlog::log_clock::now(),
+                .payload = std::move(payload),
+            });
+            wroteAny = true;
+        }
+
+        // Writing out whole bursts at once keeps flushes rare under load, while
+        // an idle writer leaves nothing sitting in buffers.
+        if (wroteAny)
+        {
+            m_sink->flush();
+        }
+        m_flushed.store(written);
+        m_flushed.notify_all();
+
+        if (wroteAny)
+        {
+            idlePolls = 0;
+            continue;
+        }
+        if (m_stopping.load())
+        {
+            return;
+        }
+
+        // Waking a blocked writer costs the logging thread a system call, so
+        // the writer polls for a while before blocking. Messages that trickle
+        // in, such as a few per frame, then never pay for a wakeup.
+        if (idlePolls < IDLE_POLLS_BEFORE_BLOCKING)
+        {
+            idlePolls += 1;
+            std::this_thread::sleep_for(IDLE_POLL_INTERVAL);
+        }
+        else
+        {
+            m_pushWakeups.wait(wakeups);
+        }
+    }
+}
+
+void AsyncLogSink::write(Record const& record)
+{
+    spdlog::details::log_msg message{
+        record.time,
+        record.source,
+        record.loggerName,
+        record.level,
+        spdlog::string_view_t{record.payload.data(), record.payload.size()}
+    };
+    // The message was built on the logging thread, not this one
+    message.thread_id = record.threadId;
+
+    if (m_sink->should_log(message.level))
+    {
+        m_sink->log(message);
+    }
+}
+} // namespace vkt
\ No newline at end of file
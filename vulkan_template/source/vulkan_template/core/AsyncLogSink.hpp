@@ -0,0 +1,80 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/MPSCQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <spdlog/common.h>
+#include <spdlog/details/log_msg.h>
+#include <spdlog/formatter.h>
+#include <spdlog/sinks/sink.h>
+#include <string>
+#include <thread>
+
+namespace vkt
+{
+// Hands messages to a background thread that formats and writes them to the
+// wrapped sink, so logging threads only pay for a copy into a lock-free queue.
+// Messages are flushed whenever the queue runs dry.
+//
+// When the queue is full, messages are dropped rather than blocking the caller,
+// and the writer reports how many were lost.
+struct AsyncLogSink : public spdlog::sinks::sink
+{
+public:
+    explicit AsyncLogSink(spdlog::sink_ptr sink);
+
+    AsyncLogSink(AsyncLogSink const&) = delete;
+    auto operator=(AsyncLogSink const&) -> AsyncLogSink& = delete;
+    AsyncLogSink(AsyncLogSink&&) = delete;
+    auto operator=(AsyncLogSink&&) -> AsyncLogSink& = delete;
+
+    // Writes out every queued message before returning.
+    ~AsyncLogSink() override;
+
+    void log(spdlog::details::log_msg const& message) override;
+
+    // Blocks until every message queued so far is written and flushed.
+    void flush() override;
+
+    void set_pattern(std::string const& pattern) override;
+    void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override;
+
+private:
+    struct Record
+    {
+        spdlog::string_view_t loggerName{};
+        spdlog::level::level_enum level{spdlog::level::off};
+        spdlog::log_clock::time_point time{};
+        size_t threadId{0};
+        spdlog::source_loc source{};
+
+        // Holds short messages inline, so queueing them does not allocate
+        spdlog::memory_buf_t payload{};
+    };
+
+    void runWriter();
+    void write(Record const& record);
+
+    // Large enough to absorb a burst such as a validation error every frame
+    static size_t constexpr QUEUE_CAPACITY{4096};
+
+    static std::chrono::microseconds constexpr IDLE_POLL_INTERVAL{1000};
+    static size_t constexpr IDLE_POLLS_BEFORE_BLOCKING{100};
+
+    spdlog::sink_ptr m_sink{};
+
+    std::unique_ptr<MPSCQueue<Record, QUEUE_CAPACITY>> m_queue{};
+
+    // Bumped after every push, for the writer to sleep on while idle
+    std::atomic<uint32_t> m_pushWakeups{0};
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_dropped{0};
+    // Pushed messages that have been written and flushed
+    std::atomic<uint64_t> m_flushed{0};
+
+    std::atomic<bool> m_stopping{false};
+    std::thread m_writer{};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,258 @@
+#include "BlockCompression.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Each sequence starts with a token of 4 bits of literal count and 4 bits of
+// match length. A nibble of 15 continues into extra bytes that each add up to
+// 255, ending on the first byte below 255.
+uint32_t constexpr NIBBLE_MAX{15};
+uint32_t constexpr EXTRA_BYTE_MAX{255};
+
+// Matches shorter than this cost more to encode than the literals they replace
+size_t constexpr MIN_MATCH{4};
+size_t constexpr MAX_OFFSET{65535};
+
+// Literals and matches up to this long are copied with a fixed size when
+// there is room, rather than with a call that handles any size.
+size_t constexpr SHORT_COPY{16};
+
+uint32_t constexpr HASH_BITS{14};
+
+auto read32(uint8_t const* const bytes) -> uint32_t
+{
+    uint32_t value{0};
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+auto hash32(uint32_t const value) -> uint32_t
+{
+    // Knuth's multiplicative hash, keeping the well-mixed top bits
+    return (value * 2654435761U) >> (32U - HASH_BITS);
+}
+
+void appendLength(std::vector<uint8_t>& destination, size_t length)
+{
+    while (length >= EXTRA_BYTE_MAX)
+    {
+        destination.push_back(static_cast<uint8_t>(EXTRA_BYTE_MAX));
+        length -= EXTRA_BYTE_MAX;
+    }
+    destination.push_back(static_cast<uint8_t>(length));
+}
+
+void appendSequence(
+    std::vector<uint8_t>& destination,
+    std::span<uint8_t const> const literals,
+    size_t const offset,
+    size_t const matchLength
+)
+{
+    size_t const literalCount{literals.size()};
+    // Only the last sequence has no match, and its length field is unused
+    size_t const matchCode{matchLength == 0 ? 0 : matchLength - MIN_MATCH};
+
+    uint32_t const literalNibble{
+        static_cast<uint32_t>(std::min<size_t>(literalCount, NIBBLE_MAX))
+    };
+    uint32_t const matchNibble{
+        static_cast<uint32_t>(std::min<size_t>(matchCode, NIBBLE_MAX))
+    };
+    destination.push_back(
+        static_cast<uint8_t>((literalNibble << 4U) | matchNibble)
+    );
+
+    if (literalCount >= NIBBLE_MAX)
+    {
+        appendLength(destination, literalCount - NIBBLE_MAX);
+    }
+    destination.insert(destination.end(), literals.begin(), literals.end());
+
+    if (matchLength == 0)
+    {
+        return;
+    }
+
+    destination.push_back(static_cast<uint8_t>(offset & 0xFFU));
+    destination.push_back(static_cast<uint8_t>(offset >> 8U));
+
+    if (matchCode >= NIBBLE_MAX)
+    {
+        appendLength(destination, matchCode - NIBBLE_MAX);
+    }
+}
+
+// Returns false when the length runs past the end of the source.
+auto readLength(
+    std::span<uint8_t const> const source, size_t& position, size_t& length
+) -> bool
+{
+    while (position < source.size())
+    {
+        uint8_t const extra{source[position]};
+        position += 1;
+        length += extra;
+        if (extra < EXTRA_BYTE_MAX)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+namespace vkt
+{
+void compressBlock(
+    std::span<uint8_t const> const source, std::vector<uint8_t>& destination
+)
+{
+    // Positions plus one of the last occurrence of each hashed 4 bytes, so
+    // that zero means empty
+    std::vector<uint32_t> table(size_t{1} << HASH_BITS, 0);
+
+    size_t literalStart{0};
+    size_t position{0};
+    while (source.size() >= MIN_MATCH && position <= source.size() - MIN_MATCH)
+    {
+        uint32_t const sequence{read32(source.data() + position)};
+        uint32_t& slot{table[hash32(sequence)]};
+        size_t const candidate{slot};
+        slot = static_cast<uint32_t>(position + 1);
+
+        if (candidate == 0 || position - (candidate - 1) > MAX_OFFSET
+            || read32(source.data() + candidate - 1) != sequence)
+        {
+            position += 1;
+            continue;
+        }
+
+        size_t const matchStart{candidate - 1};
+        size_t matchLength{MIN_MATCH};
+        while (position + matchLength < source.size()
+               && source[matchStart + matchLength]
+                      == source[position + matchLength])
+        {
+            matchLength += 1;
+        }
+
+        appendSequence(
+            destination,
+            source.subspan(literalStart, position - literalStart),
+            position - matchStart,
+            matchLength
+        );
+
+        position += matchLength;
+        literalStart = position;
+    }
+
+    appendSequence(destination, source.subspan(literalStart), 0, 0);
+}
+
+auto decompressBlock(
+    std::span<uint8_t const> const source, std::span<uint8_t> const destination
+) -> bool
+{
+    size_t input{0};
+    size_t output{0};
+    while (input < source.size())
+    {
+        uint8_t const token{source[input]};
+        input += 1;
+
+        size_t literalCount{static_cast<size_t>(token >> 4U)};
+        if (literalCount == NIBBLE_MAX
+            && !readLength(source, input, literalCount))
+        {
+            return false;
+        }
+        if (literalCount > source.size() - input
+            || literalCount > destination.size() - output)
+        {
+            return false;
+        }
+        if (literalCount <= SHORT_COPY && source.size() - input >= SHORT_COPY
+            && destination.size() - output >= SHORT_COPY)
+        {
+            // Copying a fixed size compiles to a couple of moves, where most
+            // runs of literals are short. The extra bytes are overwritten by
+            // later sequences or are past the end of the data.
+            std::memcpy(
+                destination.data() + output, source.data() + input, SHORT_COPY
+            );
+        }
+        else
+        {
+            std::memcpy(
+                destination.data() + output,
+                source.data() + input,
+                literalCount
+            );
+        }
+        input += literalCount;
+        output += literalCount;
+
+        // The last sequence ends with its literals
+        if (input == source.size())
+        {
+            break;
+        }
+
+        if (source.size() - input < 2)
+        {
+            return false;
+        }
+        size_t const offset{
+            static_cast<size_t>(source[input])
+            | (static_cast<size_t>(source[input + 1]) << 8U)
+        };
+        input += 2;
+
+        size_t matchLength{static_cast<size_t>(token & 0x0FU)};
+        if (matchLength == NIBBLE_MAX
+            && !readLength(source, input, matchLength))
+        {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+
+        if (offset == 0 || offset > output
+            || matchLength > destination.size() - output)
+        {
+            return false;
+        }
+
+        uint8_t const* const from{destination.data() + output - offset};
+        uint8_t* const to{destination.data() + output};
+        if (offset >= SHORT_COPY && matchLength <= SHORT_COPY
+            && destination.size() - output >= SHORT_COPY)
+        {
+            std::memcpy(to, from, SHORT_COPY);
+        }
+        else if (offset == 1)
+        {
+            std::memset(to, *from, matchLength);
+        }
+        else
+        {
+            // A match closer than its length repeats the bytes it writes, so
+            // it is copied a period at a time, none of which overlap.
+            for (size_t copied{0}; copied < matchLength; copied += offset)
+            {
+                std::memcpy(
+                    to + copied,
+                    from + copied,
+                    std::min(offset, matchLength - copied)
+                );
+            }
+        }
+        output += matchLength;
+    }
+
+    return output == destination.size();
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <span>
+#include <vector>
+
+namespace vkt
+{
+// A byte-oriented LZ77 codec in the style of LZ4's block format: runs of
+// literals alternate with copies of up to 64KiB back. Compression is greedy and
+// meant for cooking assets offline, while decompression is a few branches per
+// sequence so that it keeps up with reading from disk.
+
+// Appends the compressed block to destination. The result can be larger than
+// the source when the source does not compress.
+void compressBlock(
+    std::span<uint8_t const> source, std::vector<uint8_t>& destination
+);
+
+// Fails if the block is malformed or does not decompress to exactly the size of
+// destination, so untrusted input cannot write out of bounds.
+auto decompressBlock(
+    std::span<uint8_t const> source, std::span<uint8_t> destination
+) -> bool;
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "CPUFeatures.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace
+{
+auto detectSIMDLevel() -> vkt::SIMDLevel
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    // NEON is mandatory on AArch64
+    return vkt::SIMDLevel::NEON;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int32_t constexpr SSE4_1_BIT{1 << 19};
+    int32_t constexpr FMA_BIT{1 << 12};
+    int32_t constexpr OSXSAVE_BIT{1 << 27};
+    int32_t constexpr AVX2_BIT{1 << 5};
+    // The OS saves both SSE and AVX registers on context switches
+    uint64_t constexpr XCR0_SSE_AVX{0b110};
+
+    int32_t info[4]{};
+    __cpuid(info, 0);
+    int32_t const maxLeaf{info[0]};
+
+    __cpuid(info, 1);
+    int32_t const features{info[2]};
+    if ((features & SSE4_1_BIT) == 0)
+    {
+        return vkt::SIMDLevel::SCALAR;
+    }
+
+    bool const avxEnabled{
+        (features & OSXSAVE_BIT) != 0
+        && (_xgetbv(0) & XCR0_SSE_AVX) == XCR0_SSE_AVX
+    };
+    if (!avxEnabled || (features & FMA_BIT) == 0 || maxLeaf < 7)
+    {
+        return vkt::SIMDLevel::SSE4_1;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & AVX2_BIT) != 0 ? vkt::SIMDLevel::AVX2
+                                      : vkt::SIMDLevel::SSE4_1;
+#elif defined(__x86_64__) || defined(__i386__)
+    // Also checks that the OS saves AVX registers
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return vkt::SIMDLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        return vkt::SIMDLevel::SSE4_1;
+    }
+    return vkt::SIMDLevel::SCALAR;
+#else
+    return vkt::SIMDLevel::SCALAR;
+#endif
+}
+} // namespace
+
+namespace vkt
+{
+auto detectedSIMDLevel() -> SIMDLevel
+{
+    static SIMDLevel const LEVEL{detectSIMDLevel()};
+    return LEVEL;
+}
+
+auto simdLevelSupported(SIMDLevel const level) -> bool
+{
+    SIMDLevel const detected{detectedSIMDLevel()};
+    switch (level)
+    {
+    case SIMDLevel::SCALAR:
+        return true;
+    case SIMDLevel::SSE4_1:
+        return detected == SIMDLevel::SSE4_1 || detected == SIMDLevel::AVX2;
+    case SIMDLevel::AVX2:
+        return detected == SIMDLevel::AVX2;
+    case SIMDLevel::NEON:
+        return detected == SIMDLevel::NEON;
+    }
+    return false;
+}
+
+auto simdLevelName(SIMDLevel const level) -> char const*
+{
+    switch (level)
+    {
+    case SIMDLevel::SCALAR:
+        return "scalar";
+    case SIMDLevel::SSE4_1:
+        return "SSE4.1";
+    case SIMDLevel::AVX2:
+        return "AVX2";
+    case SIMDLevel::NEON:
+        return "NEON";
+    }
+    return "unknown";
+}
+} // namespace vkt
\ No newline at end of file
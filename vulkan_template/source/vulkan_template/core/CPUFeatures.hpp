@@ -0,0 +1,25 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+
+namespace vkt
+{
+// Instruction sets that CPU kernels have paths for, from least to most capable
+// within each architecture.
+enum class SIMDLevel : uint8_t
+{
+    SCALAR,
+    SSE4_1,
+    // Along with FMA, which every AVX2 CPU also supports
+    AVX2,
+    NEON,
+};
+
+// The best level the running CPU and OS support, detected once on first call.
+auto detectedSIMDLevel() -> SIMDLevel;
+
+// Whether code for level can run here, such as SSE4_1 on an AVX2 CPU.
+auto simdLevelSupported(SIMDLevel level) -> bool;
+
+auto simdLevelName(SIMDLevel level) -> char const*;
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,691 @@
+#include "CPUKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)                \
+    || defined(_M_IX86)
+#include <immintrin.h>
+#define VKT_KERNELS_X86
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VKT_KERNELS_NEON
+#endif
+
+// GCC and Clang only emit instructions for sets enabled on the function, while
+// MSVC allows intrinsics anywhere. Either way, these only run once detection
+// says the CPU supports them.
+#if defined(__GNUC__) || defined(__clang__)
+#define VKT_TARGET_SSE4_1 __attribute__((target("sse4.1")))
+#define VKT_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define VKT_TARGET_SSE4_1
+#define VKT_TARGET_AVX2
+#endif
+
+namespace
+{
+size_t constexpr CHANNELS{4};
+size_t constexpr ALPHA_CHANNEL{3};
+
+float constexpr UNORM16_MAX{65535.0F};
+
+// Transfer function as defined in
+// https://www.color.org/chardata/rgb/srgb.xalter
+float constexpr SRGB_CUTOFF{0.0031308F};
+float constexpr SRGB_LINEAR_SLOPE{12.92F};
+float constexpr SRGB_SCALE{1.055F};
+float constexpr SRGB_OFFSET{0.055F};
+float constexpr SRGB_EXPONENT{1.0F / 2.4F};
+
+// Least squares fits at Chebyshev nodes. log2(1 + t) for t in [0, 1) is within
+// 2.2e-6, and exp2(t) for t in [0, 1) within a relative 1.1e-7, which keeps the
+// encoded result within half of a 16-bit step.
+std::array<float, 7> constexpr LOG2_COEFFICIENTS{
+    2.1237462e-06F,
+    1.4424753F,
+    -0.71755787F,
+    0.45552707F,
+    -0.27462322F,
+    0.11929821F,
+    -0.025123193F,
+};
+std::array<float, 6> constexpr EXP2_COEFFICIENTS{
+    0.99999990F,
+    0.69315462F,
+    0.24014077F,
+    0.055863282F,
+    0.0089462153F,
+    0.0018951070F,
+};
+
+int32_t constexpr FLOAT_EXPONENT_BIAS{127};
+int32_t constexpr FLOAT_MANTISSA_BITS{23};
+uint32_t constexpr FLOAT_MANTISSA_MASK{0x007F'FFFFU};
+uint32_t constexpr FLOAT_ONE_BITS{0x3F80'0000U};
+
+auto toUnorm16(float const value) -> uint16_t
+{
+    return static_cast<uint16_t>(
+        std::nearbyint(std::clamp(value, 0.0F, 1.0F) * UNORM16_MAX)
+    );
+}
+
+auto clipRect(vkt::MutableImageRGBA16 const& image, vkt::TexelRect const rect)
+    -> vkt::TexelRect
+{
+    uint32_t const x{std::min(rect.x, image.width)};
+    uint32_t const y{std::min(rect.y, image.height)};
+    return vkt::TexelRect{
+        .x = x,
+        .y = y,
+        .width = std::min(rect.width, image.width - x),
+        .height = std::min(rect.height, image.height - y),
+    };
+}
+
+// The values of the texels in one row of rect, which must be clipped.
+auto rowValues(
+    vkt::MutableImageRGBA16 const& image,
+    vkt::TexelRect const rect,
+    uint32_t const row
+) -> std::span<uint16_t>
+{
+    size_t const firstTexel{
+        static_cast<size_t>(row) * image.width + static_cast<size_t>(rect.x)
+    };
+    return image.texels.subspan(
+        firstTexel * CHANNELS, static_cast<size_t>(rect.width) * CHANNELS
+    );
+}
+
+template <size_t N>
+auto horner(float const t, std::array<float, N> const& coefficients) -> float
+{
+    float result{coefficients[N - 1]};
+    for (size_t index{N - 1}; index > 0; index--)
+    {
+        result = result * t + coefficients[index - 1];
+    }
+    return result;
+}
+
+// pow(linear, SRGB_EXPONENT) as exp2(SRGB_EXPONENT * log2(linear)), with the
+// same steps as the vector paths
+auto polynomialPow(float const linear) -> float
+{
+    auto const bits{std::bit_cast<uint32_t>(linear)};
+    auto const exponent{static_cast<float>(
+        static_cast<int32_t>(bits >> FLOAT_MANTISSA_BITS) - FLOAT_EXPONENT_BIAS
+    )};
+    float const mantissa{
+        std::bit_cast<float>((bits & FLOAT_MANTISSA_MASK) | FLOAT_ONE_BITS)
+    };
+    float const log2{exponent + horner(mantissa - 1.0F, LOG2_COEFFICIENTS)};
+
+    float const power{log2 * SRGB_EXPONENT};
+    float const whole{std::floor(power)};
+    auto const scale{std::bit_cast<float>(static_cast<uint32_t>(
+        (static_cast<int32_t>(whole) + FLOAT_EXPONENT_BIAS)
+        << FLOAT_MANTISSA_BITS
+    ))};
+    return horner(power - whole, EXP2_COEFFICIENTS) * scale;
+}
+
+auto encodeExact(uint16_t const value) -> uint16_t
+{
+    double const linear{static_cast<double>(value) / UNORM16_MAX};
+    double const nonlinear{
+        linear <= SRGB_CUTOFF
+            ? linear * SRGB_LINEAR_SLOPE
+            : std::pow(linear, 1.0 / 2.4) * SRGB_SCALE - SRGB_OFFSET
+    };
+    return toUnorm16(static_cast<float>(nonlinear));
+}
+
+auto encodePolynomial(uint16_t const value) -> uint16_t
+{
+    float const linear{static_cast<float>(value) / UNORM16_MAX};
+    float const nonlinear{
+        linear <= SRGB_CUTOFF
+            ? linear * SRGB_LINEAR_SLOPE
+            : polynomialPow(linear) * SRGB_SCALE - SRGB_OFFSET
+    };
+    return toUnorm16(nonlinear);
+}
+
+// 128KiB, which mostly stays in L2 while encoding
+auto encodeTable() -> std::array<uint16_t, UINT16_MAX + 1> const&
+{
+    static std::array<uint16_t, UINT16_MAX + 1> const TABLE{[]()
+    {
+        std::array<uint16_t, UINT16_MAX + 1> table{};
+        for (size_t value{0}; value < table.size(); value++)
+        {
+            table[value] = encodeExact(static_cast<uint16_t>(value));
+        }
+        return table;
+    }()};
+    return TABLE;
+}
+
+template <typename Encode>
+void encodeRowScalar(std::span<uint16_t> const values, Encode const& encode)
+{
+    for (size_t index{0}; index < values.size(); index++)
+    {
+        if (index % CHANNELS != ALPHA_CHANNEL)
+        {
+            values[index] = encode(values[index]);
+        }
+    }
+}
+
+void drawRowScalar(
+    std::span<uint16_t> const values,
+    uint32_t const firstX,
+    float const extentWidth,
+    uint16_t const v
+)
+{
+    for (size_t texel{0}; texel < values.size() / CHANNELS; texel++)
+    {
+        float const x{static_cast<float>(firstX + texel)};
+
+        std::span<uint16_t> const channels{
+            values.subspan(texel * CHANNELS, CHANNELS)
+        };
+        channels[0] = toUnorm16((x + 0.5F) / extentWidth);
+        channels[1] = v;
+        channels[2] = 0;
+        channels[3] = UINT16_MAX;
+    }
+}
+
+#if defined(VKT_KERNELS_X86)
+template <size_t N>
+VKT_TARGET_SSE4_1 auto
+hornerSSE4_1(__m128 const t, std::array<float, N> const& coefficients)
+    -> __m128
+{
+    __m128 result{_mm_set1_ps(coefficients[N - 1])};
+    for (size_t index{N - 1}; index > 0; index--)
+    {
+        result = _mm_add_ps(
+            _mm_mul_ps(result, t), _mm_set1_ps(coefficients[index - 1])
+        );
+    }
+    return result;
+}
+
+// Takes and returns values scaled to [0, 65535]
+VKT_TARGET_SSE4_1 auto encodeSSE4_1(__m128 const value) -> __m128
+{
+    __m128 const linear{_mm_mul_ps(value, _mm_set1_ps(1.0F / UNORM16_MAX))};
+
+    __m128i const bits{_mm_castps_si128(linear)};
+    __m128 const exponent{_mm_cvtepi32_ps(_mm_sub_epi32(
+        _mm_srli_epi32(bits, FLOAT_MANTISSA_BITS),
+        _mm_set1_epi32(FLOAT_EXPONENT_BIAS)
+    ))};
+    __m128 const mantissa{_mm_castsi128_ps(_mm_or_si128(
+        _mm_and_si128(bits, _mm_set1_epi32(FLOAT_MANTISSA_MASK)),
+        _mm_set1_epi32(FLOAT_ONE_BITS)
+    ))};
+    __m128 const log2{_mm_add_ps(
+        exponent,
+        hornerSSE4_1(_mm_sub_ps(mantissa, _mm_set1_ps(1.0F)), LOG2_COEFFICIENTS)
+    )};
+
+    __m128 const power{_mm_mul_ps(log2, _mm_set1_ps(SRGB_EXPONENT))};
+    __m128 const whole{_mm_floor_ps(power)};
+    __m128 const scale{_mm_castsi128_ps(_mm_slli_epi32(
+        _mm_add_epi32(
+            _mm_cvtps_epi32(whole), _mm_set1_epi32(FLOAT_EXPONENT_BIAS)
+        ),
+        FLOAT_MANTISSA_BITS
+    ))};
+    __m128 const pow{_mm_mul_ps(
+        hornerSSE4_1(_mm_sub_ps(power, whole), EXP2_COEFFICIENTS), scale
+    )};
+
+    __m128 const lower{_mm_mul_ps(linear, _mm_set1_ps(SRGB_LINEAR_SLOPE))};
+    __m128 const higher{_mm_sub_ps(
+        _mm_mul_ps(pow, _mm_set1_ps(SRGB_SCALE)), _mm_set1_ps(SRGB_OFFSET)
+    )};
+    __m128 const nonlinear{_mm_blendv_ps(
+        higher, lower, _mm_cmple_ps(linear, _mm_set1_ps(SRGB_CUTOFF))
+    )};
+
+    return _mm_mul_ps(
+        _mm_max_ps(nonlinear, _mm_setzero_ps()), _mm_set1_ps(UNORM16_MAX)
+    );
+}
+
+// Alpha is every fourth value, which is restored from the source
+int32_t constexpr ALPHA_BLEND_MASK{0b1000'1000};
+
+VKT_TARGET_SSE4_1 void encodeRowSSE4_1(std::span<uint16_t> const values)
+{
+    size_t constexpr STEP{8};
+    size_t const vectorEnd{values.size() / STEP * STEP};
+
+    for (size_t index{0}; index < vectorEnd; index += STEP)
+    {
+        auto* const pointer{reinterpret_cast<__m128i*>(values.data() + index)};
+        __m128i const texels{_mm_loadu_si128(pointer)};
+
+        __m128 const low{_mm_cvtepi32_ps(_mm_cvtepu16_epi32(texels))};
+        __m128 const high{
+            _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_srli_si128(texels, 8)))
+        };
+
+        // Converting rounds to nearest even, and packing saturates
+        __m128i const encoded{_mm_packus_epi32(
+            _mm_cvtps_epi32(encodeSSE4_1(low)),
+            _mm_cvtps_epi32(encodeSSE4_1(high))
+        )};
+        _mm_storeu_si128(
+            pointer, _mm_blend_epi16(encoded, texels, ALPHA_BLEND_MASK)
+        );
+    }
+
+    encodeRowScalar(values.subspan(vectorEnd), encodePolynomial);
+}
+
+template <size_t N>
+VKT_TARGET_AVX2 auto
+hornerAVX2(__m256 const t, std::array<float, N> const& coefficients) -> __m256
+{
+    __m256 result{_mm256_set1_ps(coefficients[N - 1])};
+    for (size_t index{N - 1}; index > 0; index--)
+    {
+        result = _mm256_fmadd_ps(
+            result, t, _mm256_set1_ps(coefficients[index - 1])
+        );
+    }
+    return result;
+}
+
+VKT_TARGET_AVX2 auto encodeAVX2(__m256 const value) -> __m256
+{
+    __m256 const linear{
+        _mm256_mul_ps(value, _mm256_set1_ps(1.0F / UNORM16_MAX))
+    };
+
+    __m256i const bits{_mm256_castps_si256(linear)};
+    __m256 const exponent{_mm256_cvtepi32_ps(_mm256_sub_epi32(
+        _mm256_srli_epi32(bits, FLOAT_MANTISSA_BITS),
+        _mm256_set1_epi32(FLOAT_EXPONENT_BIAS)
+    ))};
+    __m256 const mantissa{_mm256_castsi256_ps(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi32(FLOAT_MANTISSA_MASK)),
+        _mm256_set1_epi32(FLOAT_ONE_BITS)
+    ))};
+    __m256 const log2{_mm256_add_ps(
+        exponent,
+        hornerAVX2(
+            _mm256_sub_ps(mantissa, _mm256_set1_ps(1.0F)), LOG2_COEFFICIENTS
+        )
+    )};
+
+    __m256 const power{_mm256_mul_ps(log2, _mm256_set1_ps(SRGB_EXPONENT))};
+    __m256 const whole{_mm256_floor_ps(power)};
+    __m256 const scale{_mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_add_epi32(
+            _mm256_cvtps_epi32(whole), _mm256_set1_epi32(FLOAT_EXPONENT_BIAS)
+        ),
+        FLOAT_MANTISSA_BITS
+    ))};
+    __m256 const pow{_mm256_mul_ps(
+        hornerAVX2(_mm256_sub_ps(power, whole), EXP2_COEFFICIENTS), scale
+    )};
+
+    __m256 const lower{
+        _mm256_mul_ps(linear, _mm256_set1_ps(SRGB_LINEAR_SLOPE))
+    };
+    __m256 const higher{_mm256_fmsub_ps(
+        pow, _mm256_set1_ps(SRGB_SCALE), _mm256_set1_ps(SRGB_OFFSET)
+    )};
+    __m256 const nonlinear{_mm256_blendv_ps(
+        higher,
+        lower,
+        _mm256_cmp_ps(linear, _mm256_set1_ps(SRGB_CUTOFF), _CMP_LE_OQ)
+    )};
+
+    return _mm256_mul_ps(
+        _mm256_max_ps(nonlinear, _mm256_setzero_ps()),
+        _mm256_set1_ps(UNORM16_MAX)
+    );
+}
+
+VKT_TARGET_AVX2 void encodeRowAVX2(std::span<uint16_t> const values)
+{
+    size_t constexpr STEP{8};
+    size_t const vectorEnd{values.size() / STEP * STEP};
+
+    for (size_t index{0}; index < vectorEnd; index += STEP)
+    {
+        auto* const pointer{reinterpret_cast<__m128i*>(values.data() + index)};
+        __m128i const texels{_mm_loadu_si128(pointer)};
+
+        __m256i const encoded{_mm256_cvtps_epi32(
+            encodeAVX2(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(texels)))
+        )};
+        __m128i const packed{_mm_packus_epi32(
+            _mm256_castsi256_si128(encoded),
+            _mm256_extracti128_si256(encoded, 1)
+        )};
+        _mm_storeu_si128(
+            pointer, _mm_blend_epi16(packed, texels, ALPHA_BLEND_MASK)
+        );
+    }
+
+    encodeRowScalar(values.subspan(vectorEnd), encodePolynomial);
+}
+
+// AVX2 has no faster way to interleave the channels, so the test pattern only
+// has an SSE4.1 path.
+VKT_TARGET_SSE4_1 void drawRowSSE4_1(
+    std::span<uint16_t> const values,
+    uint32_t const firstX,
+    float const extentWidth,
+    uint16_t const v
+)
+{
+    size_t constexpr TEXELS_PER_STEP{4};
+    size_t const texelCount{values.size() / CHANNELS};
+    size_t const vectorEnd{texelCount / TEXELS_PER_STEP * TEXELS_PER_STEP};
+
+    __m128i const vLanes{_mm_set1_epi16(static_cast<int16_t>(v))};
+    // Blue of 0 and alpha of 1, as pairs of 16-bit values
+    __m128i const blueAlphaLanes{
+        _mm_set1_epi32(static_cast<int32_t>(0xFFFF'0000U))
+    };
+
+    for (size_t texel{0}; texel < vectorEnd; texel += TEXELS_PER_STEP)
+    {
+        __m128 const x{_mm_cvtepi32_ps(_mm_add_epi32(
+            _mm_set1_epi32(static_cast<int32_t>(firstX + texel)),
+            _mm_setr_epi32(0, 1, 2, 3)
+        ))};
+        __m128 const u{_mm_div_ps(
+            _mm_add_ps(x, _mm_set1_ps(0.5F)), _mm_set1_ps(extentWidth)
+        )};
+        __m128 const scaled{_mm_mul_ps(
+            _mm_min_ps(_mm_max_ps(u, _mm_setzero_ps()), _mm_set1_ps(1.0F)),
+            _mm_set1_ps(UNORM16_MAX)
+        )};
+
+        __m128i const uLanes{
+            _mm_packus_epi32(_mm_cvtps_epi32(scaled), _mm_setzero_si128())
+        };
+        __m128i const uvLanes{_mm_unpacklo_epi16(uLanes, vLanes)};
+
+        auto* const pointer{
+            reinterpret_cast<__m128i*>(values.data() + texel * CHANNELS)
+        };
+        _mm_storeu_si128(pointer, _mm_unpacklo_epi32(uvLanes, blueAlphaLanes));
+        _mm_storeu_si128(
+            pointer + 1, _mm_unpackhi_epi32(uvLanes, blueAlphaLanes)
+        );
+    }
+
+    drawRowScalar(
+        values.subspan(vectorEnd * CHANNELS),
+        firstX + static_cast<uint32_t>(vectorEnd),
+        extentWidth,
+        v
+    );
+}
+#elif defined(VKT_KERNELS_NEON)
+template <size_t N>
+auto hornerNEON(float32x4_t const t, std::array<float, N> const& coefficients)
+    -> float32x4_t
+{
+    float32x4_t result{vdupq_n_f32(coefficients[N - 1])};
+    for (size_t index{N - 1}; index > 0; index--)
+    {
+        result = vfmaq_f32(vdupq_n_f32(coefficients[index - 1]), result, t);
+    }
+    return result;
+}
+
+auto encodeNEON(float32x4_t const value) -> float32x4_t
+{
+    float32x4_t const linear{vmulq_n_f32(value, 1.0F / UNORM16_MAX)};
+
+    uint32x4_t const bits{vreinterpretq_u32_f32(linear)};
+    float32x4_t const exponent{vcvtq_f32_s32(vsubq_s32(
+        vreinterpretq_s32_u32(vshrq_n_u32(bits, FLOAT_MANTISSA_BITS)),
+        vdupq_n_s32(FLOAT_EXPONENT_BIAS)
+    ))};
+    float32x4_t const mantissa{vreinterpretq_f32_u32(vorrq_u32(
+        vandq_u32(bits, vdupq_n_u32(FLOAT_MANTISSA_MASK)),
+        vdupq_n_u32(FLOAT_ONE_BITS)
+    ))};
+    float32x4_t const log2{vaddq_f32(
+        exponent,
+        hornerNEON(vsubq_f32(mantissa, vdupq_n_f32(1.0F)), LOG2_COEFFICIENTS)
+    )};
+
+    float32x4_t const power{vmulq_n_f32(log2, SRGB_EXPONENT)};
+    float32x4_t const whole{vrndmq_f32(power)};
+    float32x4_t const scale{vreinterpretq_f32_s32(vshlq_n_s32(
+        vaddq_s32(vcvtq_s32_f32(whole), vdupq_n_s32(FLOAT_EXPONENT_BIAS)),
+        FLOAT_MANTISSA_BITS
+    ))};
+    float32x4_t const pow{vmulq_f32(
+        hornerNEON(vsubq_f32(power, whole), EXP2_COEFFICIENTS), scale
+    )};
+
+    float32x4_t const lower{vmulq_n_f32(linear, SRGB_LINEAR_SLOPE)};
+    float32x4_t const higher{
+        vfmaq_n_f32(vdupq_n_f32(-SRGB_OFFSET), pow, SRGB_SCALE)
+    };
+    float32x4_t const nonlinear{vbslq_f32(
+        vcleq_f32(linear, vdupq_n_f32(SRGB_CUTOFF)), lower, higher
+    )};
+
+    return vmulq_n_f32(vmaxq_f32(nonlinear, vdupq_n_f32(0.0F)), UNORM16_MAX);
+}
+
+void encodeRowNEON(std::span<uint16_t> const values)
+{
+    size_t constexpr STEP{8};
+    size_t const vectorEnd{values.size() / STEP * STEP};
+
+    // Alpha is every fourth value, which is restored from the source
+    uint16x8_t const alphaMask{vreinterpretq_u16_u64(
+        vdupq_n_u64(0xFFFF'0000'0000'0000ULL)
+    )};
+
+    for (size_t index{0}; index < vectorEnd; index += STEP)
+    {
+        uint16x8_t const texels{vld1q_u16(values.data() + index)};
+
+        float32x4_t const low{
+            encodeNEON(vcvtq_f32_u32(vmovl_u16(vget_low_u16(texels))))
+        };
+        float32x4_t const high{
+            encodeNEON(vcvtq_f32_u32(vmovl_u16(vget_high_u16(texels))))
+        };
+
+        // Converting rounds to nearest even, and narrowing saturates
+        uint16x8_t const encoded{vcombine_u16(
+            vqmovn_u32(vcvtnq_u32_f32(low)), vqmovn_u32(vcvtnq_u32_f32(high))
+        )};
+        vst1q_u16(
+            values.data() + index, vbslq_u16(alphaMask, texels, encoded)
+        );
+    }
+
+    encodeRowScalar(values.subspan(vectorEnd), encodePolynomial);
+}
+
+void drawRowNEON(
+    std::span<uint16_t> const values,
+    uint32_t const firstX,
+    float const extentWidth,
+    uint16_t const v
+)
+{
+    size_t constexpr TEXELS_PER_STEP{8};
+    size_t const texelCount{values.size() / CHANNELS};
+    size_t const vectorEnd{texelCount / TEXELS_PER_STEP * TEXELS_PER_STEP};
+
+    std::array<uint32_t, 4> constexpr LANE_OFFSETS{0, 1, 2, 3};
+    uint32x4_t const laneOffsets{vld1q_u32(LANE_OFFSETS.data())};
+
+    for (size_t texel{0}; texel < vectorEnd; texel += TEXELS_PER_STEP)
+    {
+        std::array<uint16x4_t, 2> halves{};
+        for (size_t half{0}; half < halves.size(); half++)
+        {
+            auto const halfX{static_cast<uint32_t>(firstX + texel + half * 4)};
+            float32x4_t const x{
+                vcvtq_f32_u32(vaddq_u32(vdupq_n_u32(halfX), laneOffsets))
+            };
+            float32x4_t const u{vdivq_f32(
+                vaddq_f32(x, vdupq_n_f32(0.5F)), vdupq_n_f32(extentWidth)
+            )};
+            float32x4_t const clamped{
+                vminq_f32(vmaxq_f32(u, vdupq_n_f32(0.0F)), vdupq_n_f32(1.0F))
+            };
+            halves[half] =
+                vqmovn_u32(vcvtnq_u32_f32(vmulq_n_f32(clamped, UNORM16_MAX)));
+        }
+
+        // Stores each lane of the four registers as one texel's channels
+        uint16x8x4_t const channels{{
+            vcombine_u16(halves[0], halves[1]),
+            vdupq_n_u16(v),
+            vdupq_n_u16(0),
+            vdupq_n_u16(UINT16_MAX),
+        }};
+        vst4q_u16(values.data() + texel * CHANNELS, channels);
+    }
+
+    drawRowScalar(
+        values.subspan(vectorEnd * CHANNELS),
+        firstX + static_cast<uint32_t>(vectorEnd),
+        extentWidth,
+        v
+    );
+}
+#endif
+
+auto resolveLevel(vkt::SIMDLevel const level) -> vkt::SIMDLevel
+{
+    return vkt::simdLevelSupported(level) ? level : vkt::detectedSIMDLevel();
+}
+} // namespace
+
+namespace vkt
+{
+auto srgbEncodingName(SRGBEncoding const encoding) -> char const*
+{
+    switch (encoding)
+    {
+    case SRGBEncoding::EXACT:
+        return "exact";
+    case SRGBEncoding::POLYNOMIAL:
+        return "polynomial";
+    case SRGBEncoding::LUT:
+        return "LUT";
+    }
+    return "unknown";
+}
+
+void drawTestPattern(
+    MutableImageRGBA16 const image, TexelRect const rect, SIMDLevel const level
+)
+{
+    // The pattern divides by the unclipped extent
+    auto const extentWidth{static_cast<float>(rect.width)};
+    auto const extentHeight{static_cast<float>(rect.height)};
+
+    TexelRect const clipped{clipRect(image, rect)};
+    SIMDLevel const resolved{resolveLevel(level)};
+
+    for (uint32_t row{clipped.y}; row < clipped.y + clipped.height; row++)
+    {
+        std::span<uint16_t> const values{rowValues(image, clipped, row)};
+        uint16_t const v{
+            toUnorm16((static_cast<float>(row) + 0.5F) / extentHeight)
+        };
+
+        switch (resolved)
+        {
+#if defined(VKT_KERNELS_X86)
+        case SIMDLevel::SSE4_1:
+        case SIMDLevel::AVX2:
+            drawRowSSE4_1(values, clipped.x, extentWidth, v);
+            break;
+#elif defined(VKT_KERNELS_NEON)
+        case SIMDLevel::NEON:
+            drawRowNEON(values, clipped.x, extentWidth, v);
+            break;
+#endif
+        default:
+            drawRowScalar(values, clipped.x, extentWidth, v);
+            break;
+        }
+    }
+}
+
+void encodeLinearToSRGB(
+    MutableImageRGBA16 const image,
+    TexelRect const rect,
+    SRGBEncoding const encoding,
+    SIMDLevel const level
+)
+{
+    TexelRect const clipped{clipRect(image, rect)};
+    SIMDLevel const resolved{resolveLevel(level)};
+
+    for (uint32_t row{clipped.y}; row < clipped.y + clipped.height; row++)
+    {
+        std::span<uint16_t> const values{rowValues(image, clipped, row)};
+
+        switch (encoding)
+        {
+        case SRGBEncoding::EXACT:
+            encodeRowScalar(values, encodeExact);
+            continue;
+        case SRGBEncoding::LUT:
+        {
+            // Table lookups do not vectorize, since gathers are no faster
+            std::array<uint16_t, UINT16_MAX + 1> const& table{encodeTable()};
+            encodeRowScalar(
+                values, [&table](uint16_t const value) { return table[value]; }
+            );
+            continue;
+        }
+        case SRGBEncoding::POLYNOMIAL:
+            break;
+        }
+
+        switch (resolved)
+        {
+#if defined(VKT_KERNELS_X86)
+        case SIMDLevel::SSE4_1:
+            encodeRowSSE4_1(values);
+            break;
+        case SIMDLevel::AVX2:
+            encodeRowAVX2(values);
+            break;
+#elif defined(VKT_KERNELS_NEON)
+        case SIMDLevel::NEON:
+            encodeRowNEON(values);
+            break;
+#endif
+        default:
+            encodeRowScalar(values, encodePolynomial);
+            break;
+        }
+    }
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "vulkan_template/core/CPUFeatures.hpp"
+#include "vulkan_template/core/Integer.hpp"
+#include <span>
+
+namespace vkt
+{
+// Texels of an RGBA image with 16 bits per channel that kernels write in place,
+// laid out like ImageRGBA16.
+struct MutableImageRGBA16
+{
+    uint32_t width{0};
+    uint32_t height{0};
+    std::span<uint16_t> texels{};
+};
+
+// Texels from (x, y) up to, but not including, (x + width, y + height).
+struct TexelRect
+{
+    uint32_t x{0};
+    uint32_t y{0};
+    uint32_t width{0};
+    uint32_t height{0};
+};
+
+enum class SRGBEncoding : uint8_t
+{
+    // Evaluates the transfer function with pow for every value
+    EXACT,
+    // Approximates pow with log2 and exp2 polynomials, within a 16-bit step
+    POLYNOMIAL,
+    // Looks every 16-bit value up in a table of exact results, built on first
+    // use, so it matches EXACT
+    LUT,
+};
+
+auto srgbEncodingName(SRGBEncoding encoding) -> char const*;
+
+// These match compute shaders so they can be used as a reference for their
+// output, or in place of them where there is no GPU. Texels outside of both the
+// rect and the image are left untouched. Values are rounded to nearest, as the
+// GPU does when storing to UNORM images.
+//
+// Kernels use the best SIMD level the CPU supports unless a lower one is
+// passed. Levels the CPU does not support fall back to the detected one.
+
+// Matches testpattern.comp, which writes (u, v, 0, 1) where uv is the texel's
+// center in the image divided by the rect's extent.
+void drawTestPattern(
+    MutableImageRGBA16 image,
+    TexelRect rect,
+    SIMDLevel level = detectedSIMDLevel()
+);
+
+// Matches oetf_srgb.comp, which converts color channels in place from linear to
+// sRGB encoding and leaves alpha as is. Only POLYNOMIAL is vectorized, so level
+// does not affect the other encodings.
+void encodeLinearToSRGB(
+    MutableImageRGBA16 image,
+    TexelRect rect,
+    SRGBEncoding encoding = SRGBEncoding::LUT,
+    SIMDLevel level = detectedSIMDLevel()
+);
+} // namespace vkt
\ No newline at end of file
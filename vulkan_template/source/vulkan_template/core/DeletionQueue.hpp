@@ -0,0 +1,46 @@
+#pragma once
+
+#include "vulkan_template/core/Log.hpp"
+#include <deque>
+#include <functional>
+
+namespace vkt
+{
+// Cleanup callbacks for a partially created object, run in the reverse order
+// they were pushed. Cleared once creation succeeds, so that only a failed
+// creation runs them.
+struct DeletionQueue
+{
+public:
+    void pushFunction(std::function<void()>&& function)
+    {
+        m_cleanupCallbacks.push_front(function);
+    }
+
+    void flush()
+    {
+        for (std::function<void()> const& function : m_cleanupCallbacks)
+        {
+            function();
+        }
+
+        m_cleanupCallbacks.clear();
+    }
+    void clear() { m_cleanupCallbacks.clear(); }
+
+    ~DeletionQueue() noexcept
+    {
+        if (!m_cleanupCallbacks.empty())
+        {
+            VKT_WARNING(
+                "Cleanup callbacks was flushed, potentially indicating "
+                "that dealing with a DeletionQueue instance was forgotten."
+            );
+            flush();
+        }
+    }
+
+private:
+    std::deque<std::function<void()>> m_cleanupCallbacks{};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "HeapAllocationCounter.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <cassert>
+
+#ifdef VKT_COUNT_HEAP_ALLOCATIONS
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace
+{
+// Constant-initialized, so it is safe to touch from the very first allocation
+// on a new thread.
+thread_local uint64_t threadAllocations{0};
+
+// Returns null on failure, leaving the throwing forms to throw.
+auto allocateCounted(size_t const size) noexcept -> void*
+{
+    threadAllocations += 1;
+    return std::malloc(std::max<size_t>(size, 1));
+}
+
+void freeCounted(void* const memory) noexcept { std::free(memory); }
+
+// Memory from this must be freed with freeAlignedCounted, since MSVC has no
+// aligned_alloc and its aligned allocations cannot be passed to free.
+auto allocateAlignedCounted(
+    size_t const size, std::align_val_t const alignment
+) noexcept -> void*
+{
+    threadAllocations += 1;
+
+    auto const alignmentBytes{static_cast<size_t>(alignment)};
+#ifdef _WIN32
+    return _aligned_malloc(std::max<size_t>(size, 1), alignmentBytes);
+#else
+    // aligned_alloc requires a size that is a multiple of the alignment
+    size_t const alignedSize{
+        (std::max<size_t>(size, 1) + alignmentBytes - 1) / alignmentBytes
+        * alignmentBytes
+    };
+    return std::aligned_alloc(alignmentBytes, alignedSize);
+#endif
+}
+
+void freeAlignedCounted(void* const memory) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+auto throwIfNull(void* const memory) -> void*
+{
+    if (memory == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    return memory;
+}
+} // namespace
+
+// Every replaceable form is replaced, since MSVC's standard library does not
+// forward the array, nothrow and sized forms to the basic ones.
+
+auto operator new(size_t const size) -> void*
+{
+    return throwIfNull(allocateCounted(size));
+}
+
+auto operator new[](size_t const size) -> void*
+{
+    return throwIfNull(allocateCounted(size));
+}
+
+auto operator new(size_t const size, std::nothrow_t const&) noexcept -> void*
+{
+    return allocateCounted(size);
+}
+
+auto operator new[](size_t const size, std::nothrow_t const&) noexcept
+    -> void*
+{
+    return allocateCounted(size);
+}
+
+auto operator new(size_t const size, std::align_val_t const alignment)
+    -> void*
+{
+    return throwIfNull(allocateAlignedCounted(size, alignment));
+}
+
+auto operator new[](size_t const size, std::align_val_t const alignment)
+    -> void*
+{
+    return throwIfNull(allocateAlignedCounted(size, alignment));
+}
+
+auto operator new(
+    size_t const size, std::align_val_t const alignment, std::nothrow_t const&
+) noexcept -> void*
+{
+    return allocateAlignedCounted(size, alignment);
+}
+
+auto operator new[](
+    size_t const size, std::align_val_t const alignment, std::nothrow_t const&
+) noexcept -> void*
+{
+    return allocateAlignedCounted(size, alignment);
+}
+
+void operator delete(void* const memory) noexcept { freeCounted(memory); }
+
+void operator delete[](void* const memory) noexcept { freeCounted(memory); }
+
+void operator delete(void* const memory, size_t) noexcept
+{
+    freeCounted(memory);
+}
+
+void operator delete[](void* const memory, size_t) noexcept
+{
+    freeCounted(memory);
+}
+
+void operator delete(void* const memory, std::nothrow_t const&) noexcept
+{
+    freeCounted(memory);
+}
+
+void operator delete[](void* const memory, std::nothrow_t const&) noexcept
+{
+    freeCounted(memory);
+}
+
+void operator delete(void* const memory, std::align_val_t) noexcept
+{
+    freeAlignedCounted(memory);
+}
+
+void operator delete[](void* const memory, std::align_val_t) noexcept
+{
+    freeAlignedCounted(memory);
+}
+
+void operator delete(void* const memory, size_t, std::align_val_t) noexcept
+{
+    freeAlignedCounted(memory);
+}
+
+void operator delete[](void* const memory, size_t, std::align_val_t) noexcept
+{
+    freeAlignedCounted(memory);
+}
+
+void operator delete(
+    void* const memory, std::align_val_t, std::nothrow_t const&
+) noexcept
+{
+    freeAlignedCounted(memory);
+}
+
+void operator delete[](
+    void* const memory, std::align_val_t, std::nothrow_t const&
+) noexcept
+{
+    freeAlignedCounted(memory);
+}
+#endif
+
+namespace vkt
+{
+auto threadHeapAllocations() -> uint64_t
+{
+#ifdef VKT_COUNT_HEAP_ALLOCATIONS
+    return threadAllocations;
+#else
+    return 0;
+#endif
+}
+
+HeapAllocationCheck::HeapAllocationCheck(char const* const label)
+    : m_label{label}
+    , m_allocationsAtStart{threadHeapAllocations()}
+{
+}
+
+HeapAllocationCheck::~HeapAllocationCheck()
+{
+    uint64_t const allocations{threadHeapAllocations() - m_allocationsAtStart};
+    if (allocations == 0)
+    {
+        return;
+    }
+
+    VKT_ERROR(
+        "{} made {} heap allocations, but should make none.",
+        m_label,
+        allocations
+    );
+    Logger::flush();
+    assert(allocations == 0);
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+
+namespace vkt
+{
+// Whether global operator new is replaced with one that counts allocations.
+// Enabled by building with VKT_COUNT_HEAP_ALLOCATIONS, which is meant for debug
+// builds since counting costs a thread-local increment per allocation.
+//
+// The replacement applies to the whole process, so anything that allocates
+// with operator new is counted, including Vulkan layers written in C++.
+auto constexpr heapAllocationsCounted() -> bool
+{
+#ifdef VKT_COUNT_HEAP_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Global heap allocations made so far by the calling thread, or 0 if they are
+// not counted.
+auto threadHeapAllocations() -> uint64_t;
+
+// Asserts that the calling thread makes no global heap allocations between
+// construction and destruction, such as in a loop that should only reuse
+// memory once it is warmed up. Does nothing if allocations are not counted.
+struct HeapAllocationCheck
+{
+public:
+    explicit HeapAllocationCheck(char const* label);
+    ~HeapAllocationCheck();
+
+    HeapAllocationCheck(HeapAllocationCheck const&) = delete;
+    auto operator=(HeapAllocationCheck const&) -> HeapAllocationCheck& = delete;
+    HeapAllocationCheck(HeapAllocationCheck&&) = delete;
+    auto operator=(HeapAllocationCheck&&) -> HeapAllocationCheck& = delete;
+
+private:
+    char const* m_label{""};
+    uint64_t m_allocationsAtStart{0};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "ImageCompare.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VKT_COMPARE_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VKT_COMPARE_NEON
+#endif
+
+namespace
+{
+// Compares values one at a time, for tails too short for a vector.
+void compareScalar(
+    std::span<uint16_t const> const actual,
+    std::span<uint16_t const> const reference,
+    uint16_t const tolerance,
+    vkt::ImageDifference& difference
+)
+{
+    for (size_t index{0}; index < actual.size(); index++)
+    {
+        auto const valueDifference{static_cast<uint16_t>(
+            actual[index] > reference[index] ? actual[index] - reference[index]
+                                             : reference[index] - actual[index]
+        )};
+
+        difference.maxDifference =
+            std::max(difference.maxDifference, valueDifference);
+        if (valueDifference > tolerance)
+        {
+            difference.exceedingCount += 1;
+        }
+    }
+}
+
+#if defined(VKT_COMPARE_SSE2)
+size_t constexpr LANES{8};
+
+// Returns how many values were compared.
+auto compareVector(
+    std::span<uint16_t const> const actual,
+    std::span<uint16_t const> const reference,
+    uint16_t const tolerance,
+    vkt::ImageDifference& difference
+) -> size_t
+{
+    __m128i const toleranceLanes{_mm_set1_epi16(static_cast<short>(tolerance))};
+    __m128i const zero{_mm_setzero_si128()};
+    __m128i maxLanes{zero};
+
+    size_t const vectorCount{actual.size() / LANES};
+    for (size_t vector{0}; vector < vectorCount; vector++)
+    {
+        __m128i const actualLanes{_mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(actual.data() + vector * LANES)
+        )};
+        __m128i const referenceLanes{_mm_loadu_si128(
+            reinterpret_cast<__m128i const*>(reference.data() + vector * LANES)
+        )};
+
+        // Saturating subtraction in both directions, where one side is zero,
+        // gives the absolute difference of unsigned values.
+        __m128i const differenceLanes{_mm_or_si128(
+            _mm_subs_epu16(actualLanes, referenceLanes),
+            _mm_subs_epu16(referenceLanes, actualLanes)
+        )};
+
+        // SSE2 has no unsigned 16-bit max, so max(a, b) is (a - b) + b with
+        // saturation.
+        maxLanes = _mm_add_epi16(
+            _mm_subs_epu16(differenceLanes, maxLanes), maxLanes
+        );
+
+        // Lanes within tolerance saturate to zero
+        __m128i const withinLanes{_mm_cmpeq_epi16(
+            _mm_subs_epu16(differenceLanes, toleranceLanes), zero
+        )};
+        auto const withinBytes{static_cast<uint32_t>(
+            std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(withinLanes)))
+        )};
+        difference.exceedingCount += LANES - withinBytes / 2;
+    }
+
+    std::array<uint16_t, LANES> maxValues{};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(maxValues.data()), maxLanes);
+    difference.maxDifference = std::max(
+        difference.maxDifference,
+        *std::max_element(maxValues.begin(), maxValues.end())
+    );
+
+    return vectorCount * LANES;
+}
+#elif defined(VKT_COMPARE_NEON)
+size_t constexpr LANES{8};
+
+auto compareVector(
+    std::span<uint16_t const> const actual,
+    std::span<uint16_t const> const reference,
+    uint16_t const tolerance,
+    vkt::ImageDifference& difference
+) -> size_t
+{
+    uint16x8_t const toleranceLanes{vdupq_n_u16(tolerance)};
+    uint16x8_t maxLanes{vdupq_n_u16(0)};
+
+    size_t const vectorCount{actual.size() / LANES};
+    for (size_t vector{0}; vector < vectorCount; vector++)
+    {
+        uint16x8_t const differenceLanes{vabdq_u16(
+            vld1q_u16(actual.data() + vector * LANES),
+            vld1q_u16(reference.data() + vector * LANES)
+        )};
+
+        maxLanes = vmaxq_u16(maxLanes, differenceLanes);
+
+        // Exceeding lanes are all ones, so shifting leaves one per lane
+        uint16x8_t const exceedingLanes{
+            vshrq_n_u16(vcgtq_u16(differenceLanes, toleranceLanes), 15)
+        };
+        difference.exceedingCount += vaddvq_u16(exceedingLanes);
+    }
+
+    difference.maxDifference =
+        std::max(difference.maxDifference, vmaxvq_u16(maxLanes));
+
+    return vectorCount * LANES;
+}
+#else
+auto compareVector(
+    std::span<uint16_t const>,
+    std::span<uint16_t const>,
+    uint16_t,
+    vkt::ImageDifference&
+) -> size_t
+{
+    return 0;
+}
+#endif
+} // namespace
+
+namespace vkt
+{
+auto compareImages(
+    std::span<uint16_t const> const actual,
+    std::span<uint16_t const> const reference,
+    uint16_t const tolerance
+) -> ImageDifference
+{
+    size_t const count{std::min(actual.size(), reference.size())};
+
+    ImageDifference difference{
+        .maxDifference = 0,
+        .exceedingCount = std::max(actual.size(), reference.size()) - count,
+    };
+    if (difference.exceedingCount > 0)
+    {
+        difference.maxDifference = UINT16_MAX;
+    }
+
+    size_t const compared{compareVector(
+        actual.first(count), reference.first(count), tolerance, difference
+    )};
+    compareScalar(
+        actual.subspan(compared, count - compared),
+        reference.subspan(compared, count - compared),
+        tolerance,
+        difference
+    );
+
+    return difference;
+}
+} // namespace vkt
\ No newline at end of file
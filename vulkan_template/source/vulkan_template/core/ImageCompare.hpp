@@ -0,0 +1,27 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <span>
+
+namespace vkt
+{
+struct ImageDifference
+{
+    // Largest absolute difference between any pair of channel values
+    uint16_t maxDifference{0};
+    // Channel values that differ by more than the tolerance
+    size_t exceedingCount{0};
+};
+
+// Compares two images channel by channel, such as 16-bit RGBA texels. Values
+// pass if they are within tolerance of the reference. Spans of different sizes
+// compare every value past the shorter one as exceeding.
+//
+// Uses SSE2 or NEON where available, so large images compare at close to
+// memory bandwidth.
+auto compareImages(
+    std::span<uint16_t const> actual,
+    std::span<uint16_t const> reference,
+    uint16_t tolerance
+) -> ImageDifference;
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,426 @@
+#include "ImageFile.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/core/MappedFile.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#include <stb/stb_image.h>
+
+namespace
+{
+using Bytes = std::vector<uint8_t>;
+
+void appendBigEndian32(Bytes& bytes, uint32_t const value)
+{
+    bytes.push_back(static_cast<uint8_t>(value >> 24U));
+    bytes.push_back(static_cast<uint8_t>(value >> 16U));
+    bytes.push_back(static_cast<uint8_t>(value >> 8U));
+    bytes.push_back(static_cast<uint8_t>(value));
+}
+
+template <typename T> void appendLittleEndian(Bytes& bytes, T const value)
+{
+    auto const bits{static_cast<uint64_t>(value)};
+    for (size_t byte{0}; byte < sizeof(T); byte++)
+    {
+        bytes.push_back(static_cast<uint8_t>(bits >> (byte * 8U)));
+    }
+}
+
+void appendString(Bytes& bytes, std::string_view const string)
+{
+    bytes.insert(bytes.end(), string.begin(), string.end());
+    bytes.push_back(0);
+}
+
+auto writeFile(std::filesystem::path const& path, Bytes const& bytes) -> bool
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    file.write(
+        reinterpret_cast<char const*>(bytes.data()),
+        static_cast<std::streamsize>(bytes.size())
+    );
+    if (!file.good())
+    {
+        VKT_ERROR("Failed to write image file '{}'.", path.string());
+        return false;
+    }
+    return true;
+}
+
+auto imageValid(vkt::ImageRGBA16 const& image) -> bool
+{
+    size_t const texelCount{
+        static_cast<size_t>(image.width) * static_cast<size_t>(image.height)
+    };
+    if (image.width == 0 || image.height == 0
+        || image.texels.size() != texelCount * 4)
+    {
+        VKT_ERROR(
+            "Image of {}x{} texels has {} channel values.",
+            image.width,
+            image.height,
+            image.texels.size()
+        );
+        return false;
+    }
+    return true;
+}
+
+auto crc32(std::span<uint8_t const> const bytes, uint32_t crc) -> uint32_t
+{
+    static std::array<uint32_t, 256> const TABLE{[]()
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t index{0}; index < table.size(); index++)
+        {
+            uint32_t value{index};
+            for (size_t bit{0}; bit < 8; bit++)
+            {
+                value = (value & 1U) != 0 ? 0xEDB88320U ^ (value >> 1U)
+                                          : value >> 1U;
+            }
+            table[index] = value;
+        }
+        return table;
+    }()};
+
+    crc = ~crc;
+    for (uint8_t const byte : bytes)
+    {
+        crc = TABLE[(crc ^ byte) & 0xFFU] ^ (crc >> 8U);
+    }
+    return ~crc;
+}
+
+// Chunk lengths and checksums wrap the chunk type and data
+void appendPNGChunk(
+    Bytes& png, std::string_view const type, std::span<uint8_t const> data
+)
+{
+    appendBigEndian32(png, static_cast<uint32_t>(data.size()));
+
+    size_t const typeOffset{png.size()};
+    png.insert(png.end(), type.begin(), type.end());
+    png.insert(png.end(), data.begin(), data.end());
+
+    appendBigEndian32(png, crc32(std::span{png}.subspan(typeOffset), 0));
+}
+
+// Wraps data in a zlib stream of stored, uncompressed deflate blocks
+auto zlibStored(std::span<uint8_t const> const data) -> Bytes
+{
+    size_t constexpr MAX_BLOCK_SIZE{65535};
+
+    Bytes stream{};
+    stream.reserve(data.size() + data.size() / MAX_BLOCK_SIZE * 5 + 16);
+
+    // Deflate with a 32KiB window, and no preset dictionary
+    stream.push_back(0x78);
+    stream.push_back(0x01);
+
+    size_t offset{0};
+    do
+    {
+        size_t const blockSize{std::min(MAX_BLOCK_SIZE, data.size() - offset)};
+        bool const finalBlock{offset + blockSize == data.size()};
+
+        stream.push_back(finalBlock ? 1 : 0);
+        appendLittleEndian(stream, static_cast<uint16_t>(blockSize));
+        appendLittleEndian(stream, static_cast<uint16_t>(~blockSize));
+
+        auto const blockBegin{data.begin() + static_cast<ptrdiff_t>(offset)};
+        stream.insert(
+            stream.end(),
+            blockBegin,
+            blockBegin + static_cast<ptrdiff_t>(blockSize)
+        );
+        offset += blockSize;
+    } while (offset < data.size());
+
+    uint32_t constexpr ADLER_MODULUS{65521};
+    uint32_t adlerLow{1};
+    uint32_t adlerHigh{0};
+    for (uint8_t const byte : data)
+    {
+        adlerLow = (adlerLow + byte) % ADLER_MODULUS;
+        adlerHigh = (adlerHigh + adlerLow) % ADLER_MODULUS;
+    }
+    appendBigEndian32(stream, (adlerHigh << 16U) | adlerLow);
+
+    return stream;
+}
+
+// Rounds to nearest even, see
+// https://gist.github.com/rygorous/2156668
+auto floatToHalf(float const value) -> uint16_t
+{
+    uint32_t constexpr SIGN_MASK{0x8000'0000U};
+    uint32_t constexpr FLOAT_INFINITY{255U << 23U};
+    uint32_t constexpr HALF_OVERFLOW{(127U + 16U) << 23U};
+    uint32_t constexpr HALF_NORMAL_MIN{113U << 23U};
+    uint32_t constexpr SUBNORMAL_MAGIC{
+        ((127U - 15U) + (23U - 10U) + 1U) << 23U
+    };
+
+    uint32_t bits{std::bit_cast<uint32_t>(value)};
+    uint32_t const sign{bits & SIGN_MASK};
+    bits ^= sign;
+
+    uint32_t half{0};
+    if (bits >= HALF_OVERFLOW)
+    {
+        // Infinity stays infinity, and NaN becomes a quiet NaN
+        half = bits > FLOAT_INFINITY ? 0x7E00U : 0x7C00U;
+    }
+    else if (bits < HALF_NORMAL_MIN)
+    {
+        // Adding the magic number lines the subnormal's mantissa up with the
+        // bottom of the float, and the addition rounds it.
+        float const aligned{
+            std::bit_cast<float>(bits) + std::bit_cast<float>(SUBNORMAL_MAGIC)
+        };
+        half = std::bit_cast<uint32_t>(aligned) - SUBNORMAL_MAGIC;
+    }
+    else
+    {
+        uint32_t const mantissaOdd{(bits >> 13U) & 1U};
+        bits += ((15U - 127U) << 23U) + 0xFFFU + mantissaOdd;
+        half = bits >> 13U;
+    }
+
+    return static_cast<uint16_t>(half | (sign >> 16U));
+}
+
+void appendEXRAttribute(
+    Bytes& exr,
+    std::string_view const name,
+    std::string_view const type,
+    Bytes const& value
+)
+{
+    appendString(exr, name);
+    appendString(exr, type);
+    appendLittleEndian(exr, static_cast<int32_t>(value.size()));
+    exr.insert(exr.end(), value.begin(), value.end());
+}
+} // namespace
+
+namespace vkt
+{
+auto writePNG(std::filesystem::path const& path, ImageRGBA16 const& image)
+    -> bool
+{
+    if (!imageValid(image))
+    {
+        return false;
+    }
+
+    Bytes header{};
+    appendBigEndian32(header, image.width);
+    appendBigEndian32(header, image.height);
+    uint8_t constexpr BIT_DEPTH{16};
+    uint8_t constexpr COLOR_TYPE_RGBA{6};
+    // Compression, filter, and interlace methods are all the defaults
+    header.insert(header.end(), {BIT_DEPTH, COLOR_TYPE_RGBA, 0, 0, 0});
+
+    // Each row starts with its filter type, and samples are big endian
+    size_t const rowValues{static_cast<size_t>(image.width) * 4};
+    Bytes scanlines{};
+    scanlines.reserve((1 + rowValues * 2) * image.height);
+    for (size_t row{0}; row < image.height; row++)
+    {
+        scanlines.push_back(0);
+        for (uint16_t const value :
+             image.texels.subspan(row * rowValues, rowValues))
+        {
+            scanlines.push_back(static_cast<uint8_t>(value >> 8U));
+            scanlines.push_back(static_cast<uint8_t>(value));
+        }
+    }
+
+    Bytes png{0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    appendPNGChunk(png, "IHDR", header);
+    appendPNGChunk(png, "IDAT", zlibStored(scanlines));
+    appendPNGChunk(png, "IEND", {});
+
+    return writeFile(path, png);
+}
+
+auto writeEXR(std::filesystem::path const& path, ImageRGBA16 const& image)
+    -> bool
+{
+    if (!imageValid(image))
+    {
+        return false;
+    }
+
+    Bytes exr{0x76, 0x2F, 0x31, 0x01};
+    // Version 2, as a single part image of scanlines
+    appendLittleEndian(exr, int32_t{2});
+
+    // Channels are stored in alphabetical order, each as half floats with no
+    // subsampling. Indices are into the RGBA texels.
+    std::array<std::pair<char const*, size_t>, 4> constexpr CHANNELS{
+        std::pair{"A", 3},
+        std::pair{"B", 2},
+        std::pair{"G", 1},
+        std::pair{"R", 0},
+    };
+    int32_t constexpr PIXEL_TYPE_HALF{1};
+
+    Bytes channels{};
+    for (auto const& [name, index] : CHANNELS)
+    {
+        appendString(channels, name);
+        appendLittleEndian(channels, PIXEL_TYPE_HALF);
+        // Perceptually linear flag, and three reserved bytes
+        appendLittleEndian(channels, uint32_t{0});
+        appendLittleEndian(channels, int32_t{1});
+        appendLittleEndian(channels, int32_t{1});
+    }
+    channels.push_back(0);
+    appendEXRAttribute(exr, "channels", "chlist", channels);
+
+    appendEXRAttribute(exr, "compression", "compression", Bytes{0});
+
+    auto const maxX{static_cast<int32_t>(image.width - 1)};
+    auto const maxY{static_cast<int32_t>(image.height - 1)};
+    Bytes window{};
+    for (int32_t const bound : {0, 0, maxX, maxY})
+    {
+        appendLittleEndian(window, bound);
+    }
+    appendEXRAttribute(exr, "dataWindow", "box2i", window);
+    appendEXRAttribute(exr, "displayWindow", "box2i", window);
+
+    // Increasing y, so rows are stored top to bottom
+    appendEXRAttribute(exr, "lineOrder", "lineOrder", Bytes{0});
+
+    Bytes one{};
+    appendLittleEndian(one, std::bit_cast<uint32_t>(1.0F));
+    appendEXRAttribute(exr, "pixelAspectRatio", "float", one);
+    appendEXRAttribute(exr, "screenWindowWidth", "float", one);
+    appendEXRAttribute(exr, "screenWindowCenter", "v2f", Bytes(8, 0));
+
+    exr.push_back(0);
+
+    // Without compression, each chunk is one row
+    size_t const rowValues{static_cast<size_t>(image.width) * 4};
+    size_t const rowDataSize{static_cast<size_t>(image.width) * 4 * 2};
+    size_t const chunkSize{4 + 4 + rowDataSize};
+
+    size_t const firstChunk{exr.size() + image.height * sizeof(uint64_t)};
+    for (size_t row{0}; row < image.height; row++)
+    {
+        appendLittleEndian(
+            exr, static_cast<uint64_t>(firstChunk + row * chunkSize)
+        );
+    }
+
+    exr.reserve(firstChunk + chunkSize * image.height);
+    for (size_t row{0}; row < image.height; row++)
+    {
+        std::span<uint16_t const> const texels{
+            image.texels.subspan(row * rowValues, rowValues)
+        };
+
+        appendLittleEndian(exr, static_cast<int32_t>(row));
+        appendLittleEndian(exr, static_cast<int32_t>(rowDataSize));
+        for (auto const& [name, index] : CHANNELS)
+        {
+            for (size_t texel{index}; texel < texels.size(); texel += 4)
+            {
+                float const normalized{
+                    static_cast<float>(texels[texel]) / 65535.0F
+                };
+                appendLittleEndian(exr, floatToHalf(normalized));
+            }
+        }
+    }
+
+    return writeFile(path, exr);
+}
+
+auto LoadedImageRGBA16::view() const -> ImageRGBA16
+{
+    return ImageRGBA16{.width = width, .height = height, .texels = texels};
+}
+
+auto readPNG(std::filesystem::path const& path)
+    -> std::optional<LoadedImageRGBA16>
+{
+    // Decoding from the mapping spares stb_image from buffering the file
+    std::optional<MappedFile> const file{MappedFile::open(path)};
+    if (!file.has_value())
+    {
+        VKT_ERROR("Failed to open PNG '{}'", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const fileBytes{file.value().bytes()};
+
+    int32_t width{0};
+    int32_t height{0};
+    int32_t fileChannels{0};
+    int32_t constexpr CHANNELS{4};
+
+    std::unique_ptr<stbi_us, decltype(&stbi_image_free)> const texels{
+        stbi_load_16_from_memory(
+            fileBytes.data(),
+            static_cast<int32_t>(fileBytes.size()),
+            &width,
+            &height,
+            &fileChannels,
+            CHANNELS
+        ),
+        &stbi_image_free
+    };
+    if (texels == nullptr)
+    {
+        VKT_ERROR(
+            "Failed to read PNG '{}': {}", path.string(), stbi_failure_reason()
+        );
+        return std::nullopt;
+    }
+
+    std::span<uint16_t const> const values{
+        texels.get(),
+        static_cast<size_t>(width) * static_cast<size_t>(height) * CHANNELS
+    };
+    return LoadedImageRGBA16{
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+        .texels = std::vector<uint16_t>(values.begin(), values.end()),
+    };
+}
+
+auto writeImageFile(
+    std::filesystem::path const& path, ImageRGBA16 const& image
+) -> bool
+{
+    std::string const extension{path.extension().string()};
+    if (extension == ".png")
+    {
+        return writePNG(path, image);
+    }
+    if (extension == ".exr")
+    {
+        return writeEXR(path, image);
+    }
+
+    VKT_ERROR(
+        "Unsupported image file extension '{}', expected .png or .exr.",
+        extension
+    );
+    return false;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkt
+{
+// Texels of an RGBA image with 16 bits per channel, in rows from top to bottom
+// with no padding between them. Values are normalized, so 65535 is 1.0.
+struct ImageRGBA16
+{
+    uint32_t width{0};
+    uint32_t height{0};
+    std::span<uint16_t const> texels{};
+};
+
+// Owns the texels of an image read from a file.
+struct LoadedImageRGBA16
+{
+    uint32_t width{0};
+    uint32_t height{0};
+    std::vector<uint16_t> texels{};
+
+    [[nodiscard]] auto view() const -> ImageRGBA16;
+};
+
+// Writes a 16-bit RGBA PNG. Values are written as they are, so they should
+// already be encoded, such as with the sRGB transfer function. Image data is
+// stored without compression, since encoding has to keep up with captures of
+// consecutive frames.
+auto writePNG(std::filesystem::path const&, ImageRGBA16 const&) -> bool;
+
+// Writes an uncompressed OpenEXR image with half float RGBA channels, holding
+// the normalized values. EXR readers expect linear values, so this suits
+// images that have not been encoded with a transfer function.
+auto writeEXR(std::filesystem::path const&, ImageRGBA16 const&) -> bool;
+
+// Reads a PNG of any bit depth and color type, converted to 16-bit RGBA.
+auto readPNG(std::filesystem::path const&) -> std::optional<LoadedImageRGBA16>;
+
+// Picks the format from the extension, which must be .png or .exr.
+auto writeImageFile(std::filesystem::path const&, ImageRGBA16 const&) -> bool;
+} // namespace vkt
\ No newline at end of file
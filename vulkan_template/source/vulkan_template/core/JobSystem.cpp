@@ -0,0 +1,444 @@
+#include "JobSystem.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+
+namespace
+{
+struct QueuedJob
+{
+    vkt::Job job{};
+    vkt::JobCounter* counter{nullptr};
+};
+
+// A ring buffer that doubles when full. Unlike std::deque, it never frees, so
+// a steady flow of jobs stops allocating once the ring has grown to fit.
+struct JobQueue
+{
+    std::mutex mutex{};
+
+    std::vector<QueuedJob> ring{};
+    size_t front{0};
+    size_t size{0};
+
+    void pushBack(QueuedJob&& job)
+    {
+        if (size == ring.size())
+        {
+            size_t constexpr MINIMUM_CAPACITY{64};
+
+            std::vector<QueuedJob> grown(
+                std::max(ring.size() * 2, MINIMUM_CAPACITY)
+            );
+            for (size_t index{0}; index < size; index++)
+            {
+                grown[index] = std::move(ring[(front + index) % ring.size()]);
+            }
+            ring = std::move(grown);
+            front = 0;
+        }
+
+        ring[(front + size) % ring.size()] = std::move(job);
+        size += 1;
+    }
+
+    auto popBack() -> QueuedJob
+    {
+        size -= 1;
+        return std::move(ring[(front + size) % ring.size()]);
+    }
+
+    auto popFront() -> QueuedJob
+    {
+        QueuedJob job{std::move(ring[front])};
+        front = (front + 1) % ring.size();
+        size -= 1;
+        return job;
+    }
+};
+
+// Null on threads that are not workers
+thread_local void const* workerScheduler{nullptr};
+thread_local size_t workerThreadIndex{0};
+} // namespace
+
+namespace vkt
+{
+JobCounter::~JobCounter()
+{
+    // Waits out a job that is finishing this counter on another thread
+    std::lock_guard const lock{m_continuationsMutex};
+}
+
+auto JobCounter::done() const -> bool { return m_pending.load() == 0; }
+
+struct JobSystem::Scheduler
+{
+    // Index 0 is shared by every thread that is not a worker
+    std::vector<std::unique_ptr<JobQueue>> queues{};
+    // Jobs in queues, so sleeping workers know when to wake
+    std::atomic<size_t> queuedJobs{0};
+
+    JobQueue mainThreadQueue{};
+    std::thread::id mainThread{};
+
+    std::mutex sleepMutex{};
+    std::condition_variable wakeWorkers{};
+    std::atomic<size_t> sleepingWorkers{0};
+    std::atomic<bool> stopping{false};
+
+    std::vector<std::thread> workers{};
+
+    [[nodiscard]] auto callerQueueIndex() const -> size_t;
+
+    void push(QueuedJob&& job);
+    auto pop(size_t queueIndex) -> std::optional<QueuedJob>;
+    void execute(QueuedJob& job);
+    void finish(JobCounter* counter);
+    void runWorker(size_t queueIndex);
+};
+
+auto JobSystem::Scheduler::callerQueueIndex() const -> size_t
+{
+    return workerScheduler == this ? workerThreadIndex : 0;
+}
+
+void JobSystem::Scheduler::push(QueuedJob&& job)
+{
+    JobQueue& queue{*queues[callerQueueIndex()]};
+    {
+        std::lock_guard const lock{queue.mutex};
+        queue.pushBack(std::move(job));
+    }
+    queuedJobs.fetch_add(1);
+
+    // Taking the lock orders this against a worker that checked for jobs but
+    // has not started waiting yet, which would miss the notification.
+    if (sleepingWorkers.load() > 0)
+    {
+        {
+            std::lock_guard const lock{sleepMutex};
+        }
+        wakeWorkers.notify_one();
+    }
+}
+
+auto JobSystem::Scheduler::pop(size_t const queueIndex)
+    -> std::optional<QueuedJob>
+{
+    {
+        JobQueue& ownQueue{*queues[queueIndex]};
+        std::lock_guard const lock{ownQueue.mutex};
+        if (ownQueue.size > 0)
+        {
+            QueuedJob job{ownQueue.popBack()};
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    // Start with the next queue over, so thieves spread out across victims
+    for (size_t offset{1}; offset < queues.size(); offset++)
+    {
+        JobQueue& victim{*queues[(queueIndex + offset) % queues.size()]};
+        std::lock_guard const lock{victim.mutex};
+        if (victim.size > 0)
+        {
+            QueuedJob job{victim.popFront()};
+            queuedJobs.fetch_sub(1);
+            return job;
+        }
+    }
+
+    return std::nullopt;
+}
+
+void JobSystem::Scheduler::execute(QueuedJob& job)
+{
+    job.job();
+    finish(job.counter);
+}
+
+void JobSystem::Scheduler::finish(JobCounter* const counter)
+{
+    if (counter == nullptr)
+    {
+        return;
+    }
+
+    // Counts above one can be decremented without the lock, since a waiter
+    // cannot observe them as done and destroy the counter.
+    uint32_t pending{counter->m_pending.load()};
+    while (pending > 1)
+    {
+        if (counter->m_pending.compare_exchange_weak(pending, pending - 1))
+        {
+            return;
+        }
+    }
+
+    std::vector<std::pair<Job, JobCounter*>> continuations{};
+    {
+        // The counter's destructor takes this lock, so the counter stays alive
+        // until the continuations are taken.
+        std::lock_guard const lock{counter->m_continuationsMutex};
+        if (counter->m_pending.fetch_sub(1) == 1)
+        {
+            continuations = std::exchange(counter->m_continuations, {});
+        }
+    }
+
+    // Their counters were incremented when they were submitted
+    for (auto& [job, continuationCounter] : continuations)
+    {
+        push(QueuedJob{.job = std::move(job), .counter = continuationCounter});
+    }
+}
+
+void JobSystem::Scheduler::runWorker(size_t const queueIndex)
+{
+    workerScheduler = this;
+    workerThreadIndex = queueIndex;
+
+    while (!stopping.load())
+    {
+        if (std::optional<QueuedJob> job{pop(queueIndex)}; job.has_value())
+        {
+            execute(job.value());
+            continue;
+        }
+
+        std::unique_lock lock{sleepMutex};
+        sleepingWorkers.fetch_add(1);
+        wakeWorkers.wait(
+            lock, [&]() { return stopping.load() || queuedJobs.load() > 0; }
+        );
+        sleepingWorkers.fetch_sub(1);
+    }
+}
+
+JobSystem::JobSystem(JobSystem&& other) noexcept { *this = std::move(other); }
+
+auto JobSystem::operator=(JobSystem&& other) noexcept -> JobSystem&
+{
+    destroy();
+
+    m_scheduler = std::move(other.m_scheduler);
+
+    return *this;
+}
+
+JobSystem::~JobSystem() { destroy(); }
+
+void JobSystem::destroy()
+{
+    if (m_scheduler == nullptr)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard const lock{m_scheduler->sleepMutex};
+        m_scheduler->stopping.store(true);
+    }
+    m_scheduler->wakeWorkers.notify_all();
+
+    for (std::thread& worker : m_scheduler->workers)
+    {
+        worker.join();
+    }
+
+    if (m_scheduler->queuedJobs.load() > 0)
+    {
+        VKT_WARNING(
+            "JobSystem destroyed with {} jobs that never ran.",
+            m_scheduler->queuedJobs.load()
+        );
+    }
+
+    m_scheduler.reset();
+}
+
+auto JobSystem::create(size_t const workerCount) -> std::optional<JobSystem>
+{
+    std::optional<JobSystem> result{std::in_place, JobSystem{}};
+    JobSystem& jobSystem{result.value()};
+
+    jobSystem.m_scheduler = std::make_unique<Scheduler>();
+    Scheduler& scheduler{*jobSystem.m_scheduler};
+
+    scheduler.mainThread = std::this_thread::get_id();
+
+    for (size_t index{0}; index < workerCount + 1; index++)
+    {
+        scheduler.queues.push_back(std::make_unique<JobQueue>());
+    }
+
+    // Queues must all exist before any worker starts stealing
+    for (size_t index{1}; index < workerCount + 1; index++)
+    {
+        scheduler.workers.emplace_back(
+            [&scheduler, index]() { scheduler.runWorker(index); }
+        );
+    }
+
+    return result;
+}
+
+auto JobSystem::defaultWorkerCount() -> size_t
+{
+    return std::max(std::thread::hardware_concurrency(), 2U) - 1;
+}
+
+auto JobSystem::workerCount() const -> size_t
+{
+    return m_scheduler->workers.size();
+}
+
+auto JobSystem::threadIndex() -> size_t { return workerThreadIndex; }
+
+void JobSystem::submit(Job job, JobCounter* const counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1);
+    }
+
+    m_scheduler->push(QueuedJob{.job = std::move(job), .counter = counter});
+}
+
+void JobSystem::submitAfter(
+    JobCounter& dependency, Job job, JobCounter* const counter
+)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1);
+    }
+
+    {
+        std::lock_guard const lock{dependency.m_continuationsMutex};
+
+        // Checked under the lock, so the job that finishes the dependency
+        // either sees this continuation or this sees it finished.
+        if (dependency.m_pending.load() > 0)
+        {
+            dependency.m_continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+
+    m_scheduler->push(QueuedJob{.job = std::move(job), .counter = counter});
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    Scheduler& scheduler{*m_scheduler};
+
+    bool const onMainThread{std::this_thread::get_id() == scheduler.mainThread
+    };
+    size_t const queueIndex{scheduler.callerQueueIndex()};
+
+    while (!counter.done())
+    {
+        // Main thread jobs may be what the counter waits on
+        if (onMainThread)
+        {
+            runMainThreadJobs();
+        }
+
+        if (std::optional<QueuedJob> job{scheduler.pop(queueIndex)};
+            job.has_value())
+        {
+            scheduler.execute(job.value());
+            continue;
+        }
+
+        // The remaining jobs are running on other threads
+        std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelForRanges(
+    size_t const count, size_t const grainSize, RangeFunction const function
+)
+{
+    size_t const grain{std::max<size_t>(grainSize, 1)};
+    size_t const rangeCount{(count + grain - 1) / grain};
+    if (rangeCount == 0)
+    {
+        return;
+    }
+
+    // Rather than a job per range, each job claims ranges from a shared cursor
+    // until none are left. Jobs then only capture the cursor, which fits in
+    // std::function without allocating, and uneven ranges balance out.
+    std::atomic<size_t> nextBegin{0};
+    auto const claimRanges{[&]()
+    {
+        for (size_t begin{nextBegin.fetch_add(grain)}; begin < count;
+             begin = nextBegin.fetch_add(grain))
+        {
+            function.invoke(
+                function.function, begin, std::min(begin + grain, count)
+            );
+        }
+    }};
+
+    JobCounter counter{};
+    size_t const helperCount{std::min(rangeCount, workerCount() + 1) - 1};
+    for (size_t helper{0}; helper < helperCount; helper++)
+    {
+        submit([&claimRanges]() { claimRanges(); }, &counter);
+    }
+
+    claimRanges();
+
+    wait(counter);
+}
+
+void JobSystem::submitMainThread(Job job, JobCounter* const counter)
+{
+    if (counter != nullptr)
+    {
+        counter->m_pending.fetch_add(1);
+    }
+
+    JobQueue& queue{m_scheduler->mainThreadQueue};
+    std::lock_guard const lock{queue.mutex};
+    queue.pushBack(QueuedJob{.job = std::move(job), .counter = counter});
+}
+
+void JobSystem::runMainThreadJobs()
+{
+    Scheduler& scheduler{*m_scheduler};
+
+    if (std::this_thread::get_id() != scheduler.mainThread)
+    {
+        VKT_ERROR("Main thread jobs must be run from the main thread.");
+        return;
+    }
+
+    JobQueue& queue{scheduler.mainThreadQueue};
+
+    // Jobs queued while these run wait for the next call
+    size_t queuedCount{0};
+    {
+        std::lock_guard const lock{queue.mutex};
+        queuedCount = queue.size;
+    }
+
+    for (size_t index{0}; index < queuedCount; index++)
+    {
+        QueuedJob job{};
+        {
+            std::lock_guard const lock{queue.mutex};
+            job = queue.popFront();
+        }
+        scheduler.execute(job);
+    }
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace vkt
+{
+using Job = std::function<void()>;
+
+// Counts outstanding jobs. Submitting a job with a counter increments it, and
+// the counter is decremented when the job finishes. Jobs submitted to wait on a
+// counter run once it reaches zero.
+//
+// Counters must outlive the jobs that reference them.
+struct JobCounter
+{
+public:
+    JobCounter() = default;
+
+    JobCounter(JobCounter const&) = delete;
+    auto operator=(JobCounter const&) -> JobCounter& = delete;
+    JobCounter(JobCounter&&) = delete;
+    auto operator=(JobCounter&&) -> JobCounter& = delete;
+
+    ~JobCounter();
+
+    [[nodiscard]] auto done() const -> bool;
+
+private:
+    friend struct JobSystem;
+
+    std::atomic<uint32_t> m_pending{0};
+
+    // Jobs waiting for the count to reach zero
+    std::mutex m_continuationsMutex{};
+    std::vector<std::pair<Job, JobCounter*>> m_continuations{};
+};
+
+// A work-stealing scheduler. Each worker thread owns a deque that it pushes
+// and pops at the back, so related jobs stay on warm caches, while idle workers
+// steal the oldest jobs from the front of other deques.
+//
+// Threads that wait on counters run queued jobs until the counter is done, so
+// jobs may freely submit and wait on other jobs without deadlocking.
+//
+// Work that must happen on the main thread, such as GLFW and ImGui calls, is
+// queued separately and only run when the main thread asks for it.
+struct JobSystem
+{
+public:
+    JobSystem(JobSystem const&) = delete;
+    auto operator=(JobSystem const&) -> JobSystem& = delete;
+
+    JobSystem(JobSystem&&) noexcept;
+    auto operator=(JobSystem&&) noexcept -> JobSystem&;
+    ~JobSystem();
+
+private:
+    JobSystem() = default;
+    void destroy();
+
+public:
+    // Spawns workerCount threads. The creating thread becomes the main thread,
+    // and also runs jobs while it waits. A workerCount of 0 runs every job on
+    // threads that wait.
+    static auto create(size_t workerCount) -> std::optional<JobSystem>;
+
+    // Worker count that leaves one hardware thread for the main thread.
+    static auto defaultWorkerCount() -> size_t;
+
+    [[nodiscard]] auto workerCount() const -> size_t;
+
+    // A dense index for the calling thread: 0 for any thread that is not a
+    // worker, such as the main thread, and 1 + the worker index for workers.
+    // Useful for per-thread resources such as command pools.
+    [[nodiscard]] static auto threadIndex() -> size_t;
+
+    void submit(Job job, JobCounter* counter = nullptr);
+
+    // Runs job once dependency reaches zero, or immediately if it already has.
+    void submitAfter(
+        JobCounter& dependency, Job job, JobCounter* counter = nullptr
+    );
+
+    // Runs queued jobs until counter reaches zero.
+    void wait(JobCounter& counter);
+
+    // Calls function(begin, end) on ranges of [0, count) no longer than
+    // grainSize, spread across workers, and returns once every range is done.
+    // Ranges run concurrently, so function is called through a const reference.
+    // It is never copied, so this does not allocate.
+    template <typename Function>
+    void parallelFor(size_t count, size_t grainSize, Function&& function)
+    {
+        using FunctionType = std::remove_reference_t<Function>;
+        parallelForRanges(
+            count,
+            grainSize,
+            RangeFunction{
+                .function = std::addressof(function),
+                .invoke =
+                    [](void const* const function,
+                       size_t const begin,
+                       size_t const end)
+            { (*static_cast<FunctionType const*>(function))(begin, end); },
+            }
+        );
+    }
+
+    // Queues job to run on the main thread, from any thread.
+    void submitMainThread(Job job, JobCounter* counter = nullptr);
+
+    // Runs every job queued for the main thread. Must be called from the main
+    // thread, such as once per frame.
+    void runMainThreadJobs();
+
+private:
+    struct RangeFunction
+    {
+        void const* function{nullptr};
+        void (*invoke)(void const* function, size_t begin, size_t end){nullptr};
+    };
+
+    void parallelForRanges(
+        size_t count, size_t grainSize, RangeFunction function
+    );
+
+    struct Scheduler;
+    std::unique_ptr<Scheduler> m_scheduler{};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "LinearArena.hpp"
+
+namespace vkt
+{
+LinearArena::LinearArena(size_t const blockSize)
+    : m_blockSize{std::max<size_t>(blockSize, 1)}
+{
+    allocateBlock(m_blockSize);
+}
+
+auto LinearArena::allocate(size_t const size, size_t const alignment) -> void*
+{
+    while (true)
+    {
+        if (m_currentBlock == m_blocks.size())
+        {
+            // Alignment padding can take up to alignment - 1 bytes
+            allocateBlock(size + alignment);
+        }
+
+        Block& block{m_blocks[m_currentBlock]};
+
+        auto const base{reinterpret_cast<uintptr_t>(block.memory.get())};
+        uintptr_t const address{base + m_offset};
+        uintptr_t const alignedAddress{
+            (address + alignment - 1) / alignment * alignment
+        };
+        size_t const alignedOffset{alignedAddress - base};
+
+        if (alignedOffset + size <= block.size)
+        {
+            m_bytesAllocated += alignedOffset + size - m_offset;
+            m_offset = alignedOffset + size;
+            return block.memory.get() + alignedOffset;
+        }
+
+        m_bytesAllocated += block.size - m_offset;
+        m_currentBlock += 1;
+        m_offset = 0;
+    }
+}
+
+void LinearArena::reset()
+{
+    if (m_blocks.size() > 1)
+    {
+        size_t const totalSize{capacity()};
+        m_blocks.clear();
+        allocateBlock(totalSize);
+    }
+
+    m_currentBlock = 0;
+    m_offset = 0;
+    m_bytesAllocated = 0;
+}
+
+auto LinearArena::bytesAllocated() const -> size_t { return m_bytesAllocated; }
+
+auto LinearArena::capacity() const -> size_t
+{
+    size_t capacity{0};
+    for (Block const& block : m_blocks)
+    {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void LinearArena::allocateBlock(size_t const minimumSize)
+{
+    size_t const size{std::max(minimumSize, m_blockSize)};
+    m_blocks.push_back(Block{
+        .memory = std::make_unique_for_overwrite<std::byte[]>(size),
+        .size = size,
+    });
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace vkt
+{
+// Hands out memory by bumping an offset through large blocks, and frees all of
+// it at once on reset. Meant for short-lived data that is rebuilt every cycle,
+// such as the arrays that Vulkan structs point to while a frame is recorded.
+//
+// Nothing is destructed on reset, so only trivially destructible types may be
+// placed in the arena.
+struct LinearArena
+{
+public:
+    static size_t constexpr DEFAULT_BLOCK_SIZE{64ULL * 1024ULL};
+
+    explicit LinearArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    // The memory stays valid until reset. When the current block is full, the
+    // next one is taken, and a new one is allocated from the heap if needed.
+    auto allocate(size_t size, size_t alignment) -> void*;
+
+    // Value-initialized elements.
+    template <typename T> auto allocateArray(size_t const count) -> std::span<T>
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+
+        if (count == 0)
+        {
+            return {};
+        }
+
+        auto* const data{static_cast<T*>(allocate(sizeof(T) * count, alignof(T))
+        )};
+        std::uninitialized_value_construct_n(data, count);
+
+        return {data, count};
+    }
+
+    template <typename T>
+    auto copy(std::span<T const> const source) -> std::span<T>
+    {
+        static_assert(std::is_trivially_destructible_v<T>);
+
+        if (source.empty())
+        {
+            return {};
+        }
+
+        auto* const data{
+            static_cast<T*>(allocate(source.size_bytes(), alignof(T)))
+        };
+        std::uninitialized_copy(source.begin(), source.end(), data);
+
+        return {data, source.size()};
+    }
+
+    // Frees everything allocated since the last reset. If that overflowed the
+    // first block, the blocks are merged into one that fits all of it, so that
+    // a steady workload stops touching the heap after its first cycle.
+    void reset();
+
+    // Bytes handed out since the last reset, including alignment padding.
+    [[nodiscard]] auto bytesAllocated() const -> size_t;
+    // Bytes that can be handed out before the heap is touched again.
+    [[nodiscard]] auto capacity() const -> size_t;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> memory{};
+        size_t size{0};
+    };
+
+    void allocateBlock(size_t minimumSize);
+
+    size_t m_blockSize{DEFAULT_BLOCK_SIZE};
+
+    std::vector<Block> m_blocks{};
+    size_t m_currentBlock{0};
+    // Into the current block
+    size_t m_offset{0};
+
+    // Including the unused tails of blocks that were skipped past
+    size_t m_bytesAllocated{0};
+};
+} // namespace vkt
\ No newline at end of file
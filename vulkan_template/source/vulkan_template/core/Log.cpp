@@ -1,11 +1,13 @@
 #include "Log.hpp"
 
+#include "vulkan_template/core/AsyncLogSink.hpp"
+#include <chrono>
 #include <spdlog/common.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/sinks/dup_filter_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/wincolor_sink.h>
 #include <spdlog/spdlog.h>
-#include <vector>
 
 namespace vkt
 {
@@ -13,25 +15,92 @@ std::shared_ptr<spdlog::logger> Logger::m_logger{};
 
 auto Logger::getLogger() -> spdlog::logger& { return *m_logger; }
 
-void Logger::initLogging()
+void Logger::initLogging(LogOptions const& options)
 {
+    // Dropped first, since setting the pattern would also apply to the sinks
+    // of registered loggers.
+    if (m_logger != nullptr)
+    {
+        m_logger->flush();
+        spdlog::drop(m_logger->name());
+    }
+
     spdlog::set_pattern("[%T] [%^%=7l%$] %v");
 
-    auto consoleSink{std::make_shared<spdlog::sinks::stdout_color_sink_st>()};
-    auto fileSink{std::make_shared<spdlog::sinks::basic_file_sink_st>(
-        "VulkanTemplate.log", true
-    )};
+    // Identical messages in a row, such as one logged every frame, are
+    // collapsed into a count of how many were skipped.
+    auto constexpr DUPLICATE_WINDOW{std::chrono::seconds{5}};
+    auto filterSink{
+        std::make_shared<spdlog::sinks::dup_filter_sink_mt>(DUPLICATE_WINDOW)
+    };
 
-    consoleSink->set_pattern("[%T] %^%=8l%$: %v");
-    fileSink->set_pattern("[%T] [%l] %v");
+    if (options.console)
+    {
+        auto consoleSink{
+            std::make_shared<spdlog::sinks::stdout_color_sink_mt>()
+        };
+        consoleSink->set_pattern("[%T] %^%=8l%$: %v");
+        filterSink->add_sink(consoleSink);
+    }
+    if (options.filePath != nullptr)
+    {
+        auto fileSink{std::make_shared<spdlog::sinks::basic_file_sink_mt>(
+            options.filePath, true
+        )};
+        fileSink->set_pattern("[%T] [%l] %v");
+        filterSink->add_sink(fileSink);
+    }
 
-    std::vector<spdlog::sink_ptr> sinks{consoleSink, fileSink};
-    m_logger = std::make_shared<spdlog::logger>(
-        "VULKAN_TEMPLATE", sinks.begin(), sinks.end()
-    );
+    spdlog::sink_ptr sink{filterSink};
+    if (options.mode == LogMode::ASYNCHRONOUS)
+    {
+        sink = std::make_shared<AsyncLogSink>(sink);
+    }
+
+    m_logger = std::make_shared<spdlog::logger>("VULKAN_TEMPLATE", sink);
 
     spdlog::register_logger(m_logger);
-    m_logger->set_level(spdlog::level::trace);
-    m_logger->flush_on(spdlog::level::trace);
+    // Levels below the compile time level never reach the logger
+    m_logger->set_level(
+        static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL)
+    );
+    if (options.mode == LogMode::SYNCHRONOUS)
+    {
+        m_logger->flush_on(spdlog::level::trace);
+    }
+    else
+    {
+        // The async sink flushes whenever its queue runs dry, and a flush here
+        // would block on the writer.
+        m_logger->flush_on(spdlog::level::off);
+    }
+}
+
+void Logger::flush()
+{
+    if (m_logger != nullptr)
+    {
+        m_logger->flush();
+    }
+}
+
+auto LogRateLimit::admit() -> std::optional<uint64_t>
+{
+    auto const sinceEpoch{std::chrono::steady_clock::now().time_since_epoch()};
+    int64_t const now{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count()
+    };
+
+    int64_t nextAdmit{m_nextAdmitNanoseconds.load()};
+    if (now < nextAdmit
+        || !m_nextAdmitNanoseconds.compare_exchange_strong(
+            nextAdmit, now + INTERVAL_NANOSECONDS
+        ))
+    {
+        m_suppressed.fetch_add(1);
+        return std::nullopt;
+    }
+
+    return m_suppressed.exchange(0);
 }
 } // namespace vkt
@@ -1,9 +1,14 @@
 #pragma once
 
+#include "vulkan_template/core/Integer.hpp"
+#include <atomic>
 #include <memory>
+#include <optional>
 
 // IWYU pragma: no_include <spdlog/common.h>
 
+// Messages below this level are compiled out of the VKT_* macros entirely,
+// arguments included. Override it with VKT_LOG_LEVEL in CMake.
 #ifndef SPDLOG_ACTIVE_LEVEL
 #ifdef VKT_DEBUG_BUILD
 #define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_DEBUG
@@ -17,15 +22,58 @@
 
 namespace vkt
 {
+enum class LogMode
+{
+    // Messages are written on a background thread, so logging costs little
+    // more than a copy. Messages are dropped rather than blocking if the
+    // writer falls behind.
+    ASYNCHRONOUS,
+    // Messages are written and flushed before the logging call returns, so
+    // nothing is lost if the process dies, but every call waits on the disk.
+    SYNCHRONOUS,
+};
+
+struct LogOptions
+{
+    LogMode mode{LogMode::ASYNCHRONOUS};
+    bool console{true};
+    // No file is written if null
+    char const* filePath{"VulkanTemplate.log"};
+};
+
 struct Logger
 {
 public:
     static auto getLogger() -> spdlog::logger&;
-    static void initLogging();
+
+    // May be called again to replace the logger, which first writes out
+    // everything the previous one had queued.
+    static void initLogging(LogOptions const& options = {});
+
+    // Blocks until every message logged so far is written, such as before
+    // asserting.
+    static void flush();
 
 private:
     static std::shared_ptr<spdlog::logger> m_logger;
 };
+
+// Admits one message per interval from a call site, and counts the rest, so
+// that per-frame failures do not flood the log. Used through the
+// VKT_*_RATE_LIMITED macros, which keep one of these per call site.
+struct LogRateLimit
+{
+public:
+    // The number of messages suppressed since the last admitted one, or empty
+    // if this message should be suppressed.
+    auto admit() -> std::optional<uint64_t>;
+
+private:
+    static int64_t constexpr INTERVAL_NANOSECONDS{1'000'000'000};
+
+    std::atomic<int64_t> m_nextAdmitNanoseconds{0};
+    std::atomic<uint64_t> m_suppressed{0};
+};
 } // namespace vkt
 
 #define VKT_TRACE(...)                                                         \
@@ -39,4 +87,43 @@ private:
 #define VKT_ERROR(...)                                                         \
     SPDLOG_LOGGER_ERROR(&vkt::Logger::getLogger(), __VA_ARGS__);
 #define VKT_CRITICAL(...)                                                      \
-    SPDLOG_LOGGER_CRITICAL(&vkt::Logger::getLogger(), __VA_ARGS__);
\ No newline at end of file
+    SPDLOG_LOGGER_CRITICAL(&vkt::Logger::getLogger(), __VA_ARGS__);
+
+#define VKT_LOG_RATE_LIMITED(log_macro, ...)                                   \
+    {                                                                          \
+        static vkt::LogRateLimit VKT_rateLimit{};                              \
+        if (std::optional<uint64_t> const VKT_suppressed{                      \
+                VKT_rateLimit.admit()                                          \
+            };                                                                 \
+            VKT_suppressed.has_value())                                        \
+        {                                                                      \
+            if (VKT_suppressed.value() > 0)                                    \
+            {                                                                  \
+                log_macro(                                                     \
+                    "Suppressed {} messages from {}:{} since it last logged.", \
+                    VKT_suppressed.value(),                                    \
+                    __FILE__,                                                  \
+                    __LINE__                                                   \
+                )                                                              \
+            }                                                                  \
+            log_macro(__VA_ARGS__)                                             \
+        }                                                                      \
+    }
+
+// For messages that may repeat every frame. Compiled out along with the level.
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define VKT_INFO_RATE_LIMITED(...) VKT_LOG_RATE_LIMITED(VKT_INFO, __VA_ARGS__)
+#else
+#define VKT_INFO_RATE_LIMITED(...) (void)0;
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define VKT_WARNING_RATE_LIMITED(...)                                          \
+    VKT_LOG_RATE_LIMITED(VKT_WARNING, __VA_ARGS__)
+#else
+#define VKT_WARNING_RATE_LIMITED(...) (void)0;
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define VKT_ERROR_RATE_LIMITED(...) VKT_LOG_RATE_LIMITED(VKT_ERROR, __VA_ARGS__)
+#else
+#define VKT_ERROR_RATE_LIMITED(...) (void)0;
+#endif
\ No newline at end of file
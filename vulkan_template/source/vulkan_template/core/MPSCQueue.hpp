@@ -0,0 +1,106 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace vkt
+{
+// A bounded queue between any number of producer threads and one consumer
+// thread. Neither side takes a lock: producers claim slots by advancing a
+// shared index, and each slot carries a sequence number that says whether it
+// holds a value yet, so the consumer never reads a slot still being written.
+//
+// Neither side blocks, so callers that need to sleep while the queue is empty
+// pair it with their own wait, such as on an atomic counter.
+template <typename T, size_t Capacity> struct MPSCQueue
+{
+    static_assert(Capacity > 0, "MPSCQueue needs room for at least one value");
+
+public:
+    MPSCQueue()
+    {
+        for (size_t index{0}; index < Capacity; index++)
+        {
+            m_slots[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread. Fails without moving from value if the queue is full.
+    auto tryPush(T& value) -> bool
+    {
+        size_t tail{m_tail.load(std::memory_order_relaxed)};
+        while (true)
+        {
+            Slot& slot{m_slots[tail % Capacity]};
+            size_t const sequence{slot.sequence.load(std::memory_order_acquire)
+            };
+
+            if (sequence == tail)
+            {
+                // The slot is free for this lap, so claim it
+                if (m_tail.compare_exchange_weak(
+                        tail, tail + 1, std::memory_order_relaxed
+                    ))
+                {
+                    slot.value = std::move(value);
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (sequence < tail)
+            {
+                // The consumer has not emptied the slot since the last lap
+                return false;
+            }
+            else
+            {
+                // Another producer claimed the slot first
+                tail = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only. Empty if the queue is empty, or if the oldest value is
+    // still being written.
+    auto tryPop() -> std::optional<T>
+    {
+        size_t const head{m_head.load(std::memory_order_relaxed)};
+        Slot& slot{m_slots[head % Capacity]};
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+        {
+            return std::nullopt;
+        }
+
+        std::optional<T> value{std::move(slot.value)};
+
+        // Frees the slot for producers on the next lap
+        slot.sequence.store(head + Capacity, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_relaxed);
+
+        return value;
+    }
+
+private:
+    // Keeps the indices off of each other's cache line, and off of the slots'.
+    static size_t constexpr CACHE_LINE_SIZE{64};
+
+    struct Slot
+    {
+        // Equals the index of the push that may write this slot next, and one
+        // past it once the value is written.
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    // Indices count up forever, and are wrapped into slots with a modulo.
+    // Written only by the consumer.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+    // Claimed by producers.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+
+    alignas(CACHE_LINE_SIZE) std::array<Slot, Capacity> m_slots{};
+};
+} // namespace vkt
\ No newline at end of file
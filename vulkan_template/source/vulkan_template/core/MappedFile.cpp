@@ -0,0 +1,237 @@
+#include "MappedFile.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <fstream>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+auto mapFile(std::filesystem::path const& path)
+    -> std::optional<std::pair<void const*, size_t>>
+{
+    HANDLE const file{CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    )};
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        VKT_ERROR("Unable to open file at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) == 0 || size.QuadPart <= 0)
+    {
+        VKT_ERROR("File is empty or unreadable at '{}'", path.string());
+        CloseHandle(file);
+        return std::nullopt;
+    }
+
+    HANDLE const mapping{
+        CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+    };
+    // The view keeps the file and mapping open until it is unmapped
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        VKT_ERROR("Unable to map file at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    void const* const data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    CloseHandle(mapping);
+    if (data == nullptr)
+    {
+        VKT_ERROR("Unable to map file at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    return std::pair{data, static_cast<size_t>(size.QuadPart)};
+}
+
+void unmapFile(void const* const data, size_t const /*size*/)
+{
+    UnmapViewOfFile(data);
+}
+#else
+auto mapFile(std::filesystem::path const& path)
+    -> std::optional<std::pair<void const*, size_t>>
+{
+    int const file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file < 0)
+    {
+        VKT_ERROR("Unable to open file at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        VKT_ERROR("File is empty or unreadable at '{}'", path.string());
+        close(file);
+        return std::nullopt;
+    }
+    auto const size{static_cast<size_t>(status.st_size)};
+
+    void* const data{mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0)};
+    // The mapping keeps its own reference to the file
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        VKT_ERROR("Unable to map file at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    return std::pair{static_cast<void const*>(data), size};
+}
+
+void unmapFile(void const* const data, size_t const size)
+{
+    munmap(const_cast<void*>(data), size);
+}
+#endif
+} // namespace
+
+namespace vkt
+{
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    destroy();
+
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+
+    return *this;
+}
+
+MappedFile::~MappedFile() { destroy(); }
+
+void MappedFile::destroy() noexcept
+{
+    if (m_data != nullptr)
+    {
+        unmapFile(m_data, m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+auto MappedFile::open(std::filesystem::path const& path)
+    -> std::optional<MappedFile>
+{
+    std::optional<std::pair<void const*, size_t>> const mapping{mapFile(path)};
+    if (!mapping.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::optional<MappedFile> result{std::in_place, MappedFile{}};
+    result.value().m_data = mapping.value().first;
+    result.value().m_size = mapping.value().second;
+
+    return result;
+}
+
+auto MappedFile::bytes() const -> std::span<uint8_t const>
+{
+    return {static_cast<uint8_t const*>(m_data), m_size};
+}
+
+auto FileBatch::read(std::span<std::filesystem::path const> const paths)
+    -> FileBatch
+{
+    size_t constexpr ALIGNMENT{sizeof(uint64_t)};
+
+    FileBatch batch{};
+    batch.m_entries.reserve(paths.size());
+
+    // Size everything up front so that the storage is allocated only once
+    size_t totalBytes{0};
+    for (std::filesystem::path const& path : paths)
+    {
+        std::error_code error{};
+        uintmax_t const size{std::filesystem::file_size(path, error)};
+        if (error)
+        {
+            VKT_ERROR(
+                "Unable to read size of file at '{}': {}",
+                path.string(),
+                error.message()
+            );
+            batch.m_entries.push_back(Entry{});
+            continue;
+        }
+
+        batch.m_entries.push_back(
+            Entry{.offset = totalBytes, .size = static_cast<size_t>(size)}
+        );
+        totalBytes += (static_cast<size_t>(size) + ALIGNMENT - 1)
+                    / ALIGNMENT * ALIGNMENT;
+    }
+
+    batch.m_storage.resize(totalBytes / ALIGNMENT);
+    auto* const storage{reinterpret_cast<char*>(batch.m_storage.data())};
+
+    for (size_t index{0}; index < paths.size(); index++)
+    {
+        Entry& entry{batch.m_entries[index]};
+        if (entry.size == 0)
+        {
+            continue;
+        }
+
+        std::ifstream file{paths[index], std::ios::binary};
+        file.read(
+            storage + entry.offset, static_cast<std::streamsize>(entry.size)
+        );
+        if (!file || static_cast<size_t>(file.gcount()) != entry.size)
+        {
+            // Such as when the file shrank after it was sized
+            VKT_ERROR("Unable to read file at '{}'", paths[index].string());
+            entry.size = 0;
+        }
+    }
+
+    return batch;
+}
+
+auto FileBatch::count() const -> size_t { return m_entries.size(); }
+
+auto FileBatch::bytes(size_t const index) const -> std::span<uint8_t const>
+{
+    if (index >= m_entries.size())
+    {
+        return {};
+    }
+
+    Entry const& entry{m_entries[index]};
+    auto const* const storage{
+        reinterpret_cast<uint8_t const*>(m_storage.data())
+    };
+    return {storage + entry.offset, entry.size};
+}
+} // namespace vkt
\ No newline at end of file
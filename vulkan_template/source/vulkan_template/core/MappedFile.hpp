@@ -0,0 +1,77 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkt
+{
+// A whole file mapped read-only into memory, so its bytes can be consumed
+// without first copying them into a heap allocation. Pages are read in by the
+// OS as they are touched, and come straight from its file cache when the file
+// was read recently.
+//
+// The mapping starts on a page boundary, so the bytes are aligned well enough
+// to read SPIR-V words or other structured data in place.
+struct MappedFile
+{
+public:
+    MappedFile(MappedFile const&) = delete;
+    auto operator=(MappedFile const&) -> MappedFile& = delete;
+
+    MappedFile(MappedFile&&) noexcept;
+    auto operator=(MappedFile&&) noexcept -> MappedFile&;
+
+    ~MappedFile();
+
+private:
+    MappedFile() = default;
+    void destroy() noexcept;
+
+public:
+    // Fails if the file cannot be opened or is empty, since an empty file
+    // cannot be mapped.
+    static auto open(std::filesystem::path const& path)
+        -> std::optional<MappedFile>;
+
+    // Valid until the file is destroyed. The file must not be truncated by
+    // another process while it is mapped.
+    [[nodiscard]] auto bytes() const -> std::span<uint8_t const>;
+
+private:
+    void const* m_data{nullptr};
+    size_t m_size{0};
+};
+
+// The contents of several small files read one after another into a single
+// allocation. For files of a few kilobytes, such as SPIR-V, setting up and
+// tearing down a mapping for each costs more than copying them, so batching
+// the reads replaces many mappings and allocations with one of each.
+struct FileBatch
+{
+public:
+    // Files that cannot be read are logged and get empty bytes, so that one
+    // missing file does not fail the rest of the batch.
+    static auto read(std::span<std::filesystem::path const> paths) -> FileBatch;
+
+    [[nodiscard]] auto count() const -> size_t;
+
+    // Bytes of the file at the same index as in the paths that were read.
+    // Each file starts on an 8 byte boundary. Valid until the batch is
+    // destroyed.
+    [[nodiscard]] auto bytes(size_t index) const -> std::span<uint8_t const>;
+
+private:
+    struct Entry
+    {
+        size_t offset{0};
+        size_t size{0};
+    };
+
+    std::vector<Entry> m_entries{};
+    // Elements are wider than bytes so that the storage is aligned for them.
+    std::vector<uint64_t> m_storage{};
+};
+} // namespace vkt
\ No newline at end of file
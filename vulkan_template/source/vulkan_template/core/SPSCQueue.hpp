@@ -0,0 +1,106 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include <array>
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace vkt
+{
+// A bounded queue between exactly one producer thread and one consumer thread.
+// Neither side takes a lock: each side only writes its own index and reads the
+// other's. Blocking calls sleep on the other side's index with atomic
+// wait/notify rather than spinning.
+template <typename T, size_t Capacity> struct SPSCQueue
+{
+    static_assert(Capacity > 0, "SPSCQueue needs room for at least one value");
+
+public:
+    // Producer only. Fails without moving from value if the queue is full.
+    auto tryPush(T& value) -> bool
+    {
+        size_t const tail{m_tail.load(std::memory_order_relaxed)};
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+        {
+            return false;
+        }
+
+        publish(tail, std::move(value));
+        return true;
+    }
+
+    // Producer only. Blocks while the queue is full.
+    void push(T&& value)
+    {
+        size_t const tail{m_tail.load(std::memory_order_relaxed)};
+
+        size_t head{m_head.load(std::memory_order_acquire)};
+        while (tail - head == Capacity)
+        {
+            m_head.wait(head, std::memory_order_acquire);
+            head = m_head.load(std::memory_order_acquire);
+        }
+
+        publish(tail, std::move(value));
+    }
+
+    // Consumer only. Empty if the queue is empty.
+    auto tryPop() -> std::optional<T>
+    {
+        size_t const head{m_head.load(std::memory_order_relaxed)};
+        if (m_tail.load(std::memory_order_acquire) == head)
+        {
+            return std::nullopt;
+        }
+
+        return consume(head);
+    }
+
+    // Consumer only. Blocks while the queue is empty.
+    auto pop() -> T
+    {
+        size_t const head{m_head.load(std::memory_order_relaxed)};
+
+        size_t tail{m_tail.load(std::memory_order_acquire)};
+        while (tail == head)
+        {
+            m_tail.wait(tail, std::memory_order_acquire);
+            tail = m_tail.load(std::memory_order_acquire);
+        }
+
+        return consume(head);
+    }
+
+private:
+    void publish(size_t const tail, T&& value)
+    {
+        m_slots[tail % Capacity] = std::move(value);
+
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_tail.notify_one();
+    }
+
+    auto consume(size_t const head) -> T
+    {
+        T value{std::move(m_slots[head % Capacity])};
+
+        m_head.store(head + 1, std::memory_order_release);
+        m_head.notify_one();
+
+        return value;
+    }
+
+    // Keeps each index on its own cache line, so the two threads do not
+    // invalidate each other's line on every operation.
+    static size_t constexpr CACHE_LINE_SIZE{64};
+
+    // Indices count up forever, and are wrapped into slots with a modulo.
+    // Written only by the consumer.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head{0};
+    // Written only by the producer.
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail{0};
+
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> m_slots{};
+};
+} // namespace vkt
\ No newline at end of file
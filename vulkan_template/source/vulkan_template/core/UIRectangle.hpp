@@ -38,6 +38,16 @@ struct UIRectangle
         };
     }
 
+    // The overlapping area, which has zero size if there is no overlap.
+    [[nodiscard]] auto intersect(UIRectangle const& other) const -> UIRectangle
+    {
+        UIRectangle const overlap{
+            .min{glm::max(min, other.min)},
+            .max{glm::min(max, other.max)},
+        };
+        return overlap.clampToMin();
+    }
+
     [[nodiscard]] auto shrink(glm::vec2 const margins) const -> UIRectangle
     {
         return UIRectangle{
@@ -0,0 +1,411 @@
+#include "BindlessHeap.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+auto bindingIndex(vkt::BindlessBinding const binding) -> size_t
+{
+    return static_cast<size_t>(binding);
+}
+
+auto bindingName(vkt::BindlessBinding const binding) -> char const*
+{
+    switch (binding)
+    {
+    case vkt::BindlessBinding::STORAGE_IMAGE:
+        return "storage image";
+    case vkt::BindlessBinding::SAMPLED_IMAGE:
+        return "sampled image";
+    case vkt::BindlessBinding::SAMPLER:
+        return "sampler";
+    }
+    return "unknown";
+}
+} // namespace
+
+namespace vkt
+{
+BindlessHeap::BindlessHeap(BindlessHeap&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto BindlessHeap::operator=(BindlessHeap&& other) noexcept -> BindlessHeap&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_pool = std::exchange(other.m_pool, VK_NULL_HANDLE);
+    m_setLayout = std::exchange(other.m_setLayout, VK_NULL_HANDLE);
+    m_pipelineLayout = std::exchange(other.m_pipelineLayout, VK_NULL_HANDLE);
+    m_set = std::exchange(other.m_set, VK_NULL_HANDLE);
+
+    m_slots = std::exchange(other.m_slots, {});
+
+    m_frame = std::exchange(other.m_frame, 0);
+    m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+
+    return *this;
+}
+
+BindlessHeap::~BindlessHeap() { destroy(); }
+
+void BindlessHeap::destroy() noexcept
+{
+    if (m_device != VK_NULL_HANDLE)
+    {
+        // The set is freed with the pool, and the layouts belong to the cache
+        vkDestroyDescriptorPool(m_device, m_pool, nullptr);
+    }
+
+    m_device = VK_NULL_HANDLE;
+    m_pool = VK_NULL_HANDLE;
+    m_setLayout = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_set = VK_NULL_HANDLE;
+    m_slots = {};
+}
+
+auto BindlessHeap::create(
+    VkDevice const device,
+    DescriptorLayoutCache& layoutCache,
+    Capacity const capacity,
+    uint32_t const framesInFlight
+) -> std::optional<BindlessHeap>
+{
+    std::optional<BindlessHeap> result{std::in_place, BindlessHeap{}};
+    BindlessHeap& heap{result.value()};
+    heap.m_device = device;
+    heap.m_framesInFlight = framesInFlight;
+
+    heap.m_slots[bindingIndex(BindlessBinding::STORAGE_IMAGE)].capacity =
+        capacity.storageImages;
+    heap.m_slots[bindingIndex(BindlessBinding::SAMPLED_IMAGE)].capacity =
+        capacity.sampledImages;
+    heap.m_slots[bindingIndex(BindlessBinding::SAMPLER)].capacity =
+        capacity.samplers;
+
+    // Slots are written while other slots are in use by pending command
+    // buffers, and most slots are empty at any given time.
+    VkDescriptorBindingFlags constexpr BINDING_FLAGS{
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+        | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+        | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+    };
+
+    DescriptorSetLayoutDescription description{
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+    };
+    for (BindlessBinding const binding :
+         {BindlessBinding::STORAGE_IMAGE,
+          BindlessBinding::SAMPLED_IMAGE,
+          BindlessBinding::SAMPLER})
+    {
+        description.bindings.push_back({
+            .binding = static_cast<uint32_t>(binding),
+            .type = heap.descriptorType(binding),
+            .count = heap.m_slots[bindingIndex(binding)].capacity,
+            .stageMask = VK_SHADER_STAGE_ALL,
+            .bindingFlags = BINDING_FLAGS,
+        });
+    }
+
+    if (std::optional<VkDescriptorSetLayout> const layoutResult{
+            layoutCache.getSetLayout(description)
+        };
+        layoutResult.has_value())
+    {
+        heap.m_setLayout = layoutResult.value();
+    }
+    else
+    {
+        VKT_ERROR("Failed to create bindless descriptor set layout.");
+        return std::nullopt;
+    }
+
+    VkPushConstantRange const pushConstantRange{heap.pushConstantRange()};
+    if (std::optional<VkPipelineLayout> const pipelineLayoutResult{
+            layoutCache.getPipelineLayout(
+                std::span{&heap.m_setLayout, 1},
+                std::span{&pushConstantRange, 1}
+            )
+        };
+        pipelineLayoutResult.has_value())
+    {
+        heap.m_pipelineLayout = pipelineLayoutResult.value();
+    }
+    else
+    {
+        VKT_ERROR("Failed to create bindless pipeline layout.");
+        return std::nullopt;
+    }
+
+    std::array<VkDescriptorPoolSize, 3> const poolSizes{
+        VkDescriptorPoolSize{
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = capacity.storageImages,
+        },
+        VkDescriptorPoolSize{
+            .type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+            .descriptorCount = capacity.sampledImages,
+        },
+        VkDescriptorPoolSize{
+            .type = VK_DESCRIPTOR_TYPE_SAMPLER,
+            .descriptorCount = capacity.samplers,
+        },
+    };
+
+    VkDescriptorPoolCreateInfo const poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data(),
+    };
+
+    VKT_TRY_VK(
+        vkCreateDescriptorPool(device, &poolInfo, nullptr, &heap.m_pool),
+        "Failed to create bindless descriptor pool.",
+        std::nullopt
+    );
+
+    VkDescriptorSetAllocateInfo const allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .descriptorPool = heap.m_pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &heap.m_setLayout,
+    };
+
+    VKT_TRY_VK(
+        vkAllocateDescriptorSets(device, &allocInfo, &heap.m_set),
+        "Failed to allocate bindless descriptor set.",
+        std::nullopt
+    );
+
+    return result;
+}
+
+auto BindlessHeap::registerStorageImage(
+    VkImageView const view, VkImageLayout const layout
+) -> std::optional<StorageImageHandle>
+{
+    std::optional<uint32_t> const slot{
+        acquireSlot(BindlessBinding::STORAGE_IMAGE)
+    };
+    if (!slot.has_value())
+    {
+        return std::nullopt;
+    }
+
+    writeImage(
+        BindlessBinding::STORAGE_IMAGE,
+        slot.value(),
+        VkDescriptorImageInfo{
+            .sampler = VK_NULL_HANDLE,
+            .imageView = view,
+            .imageLayout = layout,
+        }
+    );
+
+    return StorageImageHandle{slot.value()};
+}
+
+auto BindlessHeap::registerSampledImage(
+    VkImageView const view, VkImageLayout const layout
+) -> std::optional<SampledImageHandle>
+{
+    std::optional<uint32_t> const slot{
+        acquireSlot(BindlessBinding::SAMPLED_IMAGE)
+    };
+    if (!slot.has_value())
+    {
+        return std::nullopt;
+    }
+
+    writeImage(
+        BindlessBinding::SAMPLED_IMAGE,
+        slot.value(),
+        VkDescriptorImageInfo{
+            .sampler = VK_NULL_HANDLE,
+            .imageView = view,
+            .imageLayout = layout,
+        }
+    );
+
+    return SampledImageHandle{slot.value()};
+}
+
+auto BindlessHeap::registerSampler(VkSampler const sampler)
+    -> std::optional<SamplerHandle>
+{
+    std::optional<uint32_t> const slot{acquireSlot(BindlessBinding::SAMPLER)};
+    if (!slot.has_value())
+    {
+        return std::nullopt;
+    }
+
+    writeImage(
+        BindlessBinding::SAMPLER,
+        slot.value(),
+        VkDescriptorImageInfo{
+            .sampler = sampler,
+            .imageView = VK_NULL_HANDLE,
+            .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        }
+    );
+
+    return SamplerHandle{slot.value()};
+}
+
+void BindlessHeap::release(StorageImageHandle const handle)
+{
+    releaseSlot(BindlessBinding::STORAGE_IMAGE, handle.index);
+}
+
+void BindlessHeap::release(SampledImageHandle const handle)
+{
+    releaseSlot(BindlessBinding::SAMPLED_IMAGE, handle.index);
+}
+
+void BindlessHeap::release(SamplerHandle const handle)
+{
+    releaseSlot(BindlessBinding::SAMPLER, handle.index);
+}
+
+void BindlessHeap::advanceFrame()
+{
+    m_frame++;
+
+    for (Slots& slots : m_slots)
+    {
+        auto const retired{std::partition(
+            slots.pending.begin(),
+            slots.pending.end(),
+            [&](Slots::PendingRelease const& release)
+        { return release.releasedFrame + m_framesInFlight > m_frame; }
+        )};
+
+        for (auto it{retired}; it != slots.pending.end(); it++)
+        {
+            slots.free.push_back(it->index);
+        }
+        slots.pending.erase(retired, slots.pending.end());
+    }
+}
+
+void BindlessHeap::bind(
+    VkCommandBuffer const cmd, VkPipelineBindPoint const bindPoint
+) const
+{
+    vkCmdBindDescriptorSets(
+        cmd, bindPoint, m_pipelineLayout, 0, 1, &m_set, VKR_ARRAY_NONE
+    );
+}
+
+auto BindlessHeap::setLayout() const -> VkDescriptorSetLayout
+{
+    return m_setLayout;
+}
+
+auto BindlessHeap::pipelineLayout() const -> VkPipelineLayout
+{
+    return m_pipelineLayout;
+}
+
+auto BindlessHeap::pushConstantRange() const -> VkPushConstantRange
+{
+    return VkPushConstantRange{
+        .stageFlags = PUSH_CONSTANT_STAGES,
+        .offset = 0,
+        .size = PUSH_CONSTANT_SIZE,
+    };
+}
+
+auto BindlessHeap::descriptorType(BindlessBinding const binding) const
+    -> VkDescriptorType
+{
+    switch (binding)
+    {
+    case BindlessBinding::STORAGE_IMAGE:
+        return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    case BindlessBinding::SAMPLED_IMAGE:
+        return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    case BindlessBinding::SAMPLER:
+        return VK_DESCRIPTOR_TYPE_SAMPLER;
+    }
+    return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+}
+
+auto BindlessHeap::acquireSlot(BindlessBinding const binding)
+    -> std::optional<uint32_t>
+{
+    Slots& slots{m_slots[bindingIndex(binding)]};
+
+    if (!slots.free.empty())
+    {
+        uint32_t const index{slots.free.back()};
+        slots.free.pop_back();
+        return index;
+    }
+
+    if (slots.highWaterMark < slots.capacity)
+    {
+        return slots.highWaterMark++;
+    }
+
+    VKT_ERROR(
+        "Bindless heap is out of {} slots (capacity {}).",
+        bindingName(binding),
+        slots.capacity
+    );
+    return std::nullopt;
+}
+
+void BindlessHeap::releaseSlot(BindlessBinding const binding, uint32_t index)
+{
+    Slots& slots{m_slots[bindingIndex(binding)]};
+
+    if (index >= slots.highWaterMark)
+    {
+        VKT_WARNING(
+            "Released invalid bindless {} handle {}.",
+            bindingName(binding),
+            index
+        );
+        return;
+    }
+
+    slots.pending.push_back({.index = index, .releasedFrame = m_frame});
+}
+
+void BindlessHeap::writeImage(
+    BindlessBinding const binding,
+    uint32_t const index,
+    VkDescriptorImageInfo const& imageInfo
+)
+{
+    VkWriteDescriptorSet const write{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = nullptr,
+
+        .dstSet = m_set,
+        .dstBinding = static_cast<uint32_t>(binding),
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = descriptorType(binding),
+
+        .pImageInfo = &imageInfo,
+        .pBufferInfo = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+
+    vkUpdateDescriptorSets(m_device, 1, &write, VKR_ARRAY_NONE);
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <array>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace vkt
+{
+struct DescriptorLayoutCache;
+} // namespace vkt
+
+namespace vkt
+{
+enum class BindlessBinding : uint32_t
+{
+    STORAGE_IMAGE = 0,
+    SAMPLED_IMAGE = 1,
+    SAMPLER = 2,
+};
+
+// A stable index into one of the BindlessHeap's descriptor arrays. Shaders
+// receive these as plain uints through push constants.
+template <BindlessBinding Binding> struct BindlessHandle
+{
+    static uint32_t constexpr INVALID_INDEX{
+        std::numeric_limits<uint32_t>::max()
+    };
+
+    uint32_t index{INVALID_INDEX};
+
+    [[nodiscard]] auto valid() const -> bool { return index != INVALID_INDEX; }
+};
+
+using StorageImageHandle = BindlessHandle<BindlessBinding::STORAGE_IMAGE>;
+using SampledImageHandle = BindlessHandle<BindlessBinding::SAMPLED_IMAGE>;
+using SamplerHandle = BindlessHandle<BindlessBinding::SAMPLER>;
+
+// A single global descriptor set holding every image and sampler in use, so
+// that passes do not need their own pools or sets. Shaders declare:
+//
+// layout(set = 0, binding = 0) uniform image2D storageImages[];
+// layout(set = 0, binding = 1) uniform texture2D sampledImages[];
+// layout(set = 0, binding = 2) uniform sampler samplers[];
+//
+// and index them with handles passed in through push constants. The set is
+// bound once per command buffer, and every bindless shader shares one pipeline
+// layout so the binding stays valid across shader changes.
+struct BindlessHeap
+{
+public:
+    struct Capacity
+    {
+        uint32_t storageImages{1024U};
+        uint32_t sampledImages{1024U};
+        uint32_t samplers{64U};
+    };
+
+    // The minimum push constant size guaranteed by the spec, shared by all
+    // bindless shaders.
+    static uint32_t constexpr PUSH_CONSTANT_SIZE{128U};
+    static VkShaderStageFlags constexpr PUSH_CONSTANT_STAGES{
+        VK_SHADER_STAGE_ALL
+    };
+
+    BindlessHeap(BindlessHeap const&) = delete;
+    auto operator=(BindlessHeap const&) -> BindlessHeap& = delete;
+
+    BindlessHeap(BindlessHeap&&) noexcept;
+    auto operator=(BindlessHeap&&) noexcept -> BindlessHeap&;
+
+    ~BindlessHeap();
+
+private:
+    BindlessHeap() = default;
+    void destroy() noexcept;
+
+public:
+    // Released handles are recycled only after advanceFrame has been called
+    // framesInFlight times, so that in-flight frames never observe a slot
+    // being rewritten underneath them.
+    static auto create(
+        VkDevice,
+        DescriptorLayoutCache&,
+        Capacity capacity,
+        uint32_t framesInFlight
+    ) -> std::optional<BindlessHeap>;
+
+    auto registerStorageImage(VkImageView, VkImageLayout)
+        -> std::optional<StorageImageHandle>;
+    auto registerSampledImage(VkImageView, VkImageLayout)
+        -> std::optional<SampledImageHandle>;
+    auto registerSampler(VkSampler) -> std::optional<SamplerHandle>;
+
+    void release(StorageImageHandle);
+    void release(SampledImageHandle);
+    void release(SamplerHandle);
+
+    // Call once per frame, after waiting on that frame's fence.
+    void advanceFrame();
+
+    void bind(VkCommandBuffer, VkPipelineBindPoint) const;
+
+    // Owned by the DescriptorLayoutCache.
+    [[nodiscard]] auto setLayout() const -> VkDescriptorSetLayout;
+    // Owned by the DescriptorLayoutCache.
+    [[nodiscard]] auto pipelineLayout() const -> VkPipelineLayout;
+    [[nodiscard]] auto pushConstantRange() const -> VkPushConstantRange;
+
+    [[nodiscard]] auto descriptorType(BindlessBinding) const
+        -> VkDescriptorType;
+
+private:
+    struct Slots
+    {
+        uint32_t capacity{0};
+        // Slots below this have been handed out at least once.
+        uint32_t highWaterMark{0};
+        std::vector<uint32_t> free{};
+
+        struct PendingRelease
+        {
+            uint32_t index;
+            uint64_t releasedFrame;
+        };
+        std::vector<PendingRelease> pending{};
+    };
+
+    auto acquireSlot(BindlessBinding) -> std::optional<uint32_t>;
+    void releaseSlot(BindlessBinding, uint32_t index);
+    void writeImage(
+        BindlessBinding, uint32_t index, VkDescriptorImageInfo const&
+    );
+
+    VkDevice m_device{VK_NULL_HANDLE};
+    VkDescriptorPool m_pool{VK_NULL_HANDLE};
+    VkDescriptorSetLayout m_setLayout{VK_NULL_HANDLE};
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+    VkDescriptorSet m_set{VK_NULL_HANDLE};
+
+    std::array<Slots, 3> m_slots{};
+
+    uint64_t m_frame{0};
+    uint32_t m_framesInFlight{0};
+};
+} // namespace vkt
\ No newline at end of file
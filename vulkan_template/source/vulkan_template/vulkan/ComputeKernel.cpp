@@ -0,0 +1,233 @@
+#include "ComputeKernel.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace vkt
+{
+auto StorageImageBinding::descriptor() const -> PushDescriptorInfo
+{
+    return PushDescriptorInfo{
+        .image =
+            VkDescriptorImageInfo{
+                .sampler = VK_NULL_HANDLE,
+                .imageView = view,
+                .imageLayout = layout,
+            },
+    };
+}
+
+auto SampledImageBinding::descriptor() const -> PushDescriptorInfo
+{
+    return PushDescriptorInfo{
+        .image =
+            VkDescriptorImageInfo{
+                .sampler = sampler,
+                .imageView = view,
+                .imageLayout = layout,
+            },
+    };
+}
+
+auto StorageBufferBinding::descriptor() const -> PushDescriptorInfo
+{
+    return PushDescriptorInfo{
+        .buffer =
+            VkDescriptorBufferInfo{
+                .buffer = buffer,
+                .offset = offset,
+                .range = range,
+            },
+    };
+}
+
+namespace detail
+{
+auto pushConstantsMatch(
+    uint32_t const reflectedSize,
+    uint32_t const hostSize,
+    uint32_t const hostAlignment
+) -> bool
+{
+    uint32_t const alignment{std::max(hostAlignment, 1U)};
+    return (reflectedSize + alignment - 1) / alignment * alignment == hostSize;
+}
+
+auto checkComputeKernelInterface(
+    ShaderReflection const& reflection,
+    std::filesystem::path const& path,
+    VkSpecializationInfo const specializationInfo,
+    uint32_t const pushConstantSize,
+    uint32_t const pushConstantAlignment,
+    std::span<VkDescriptorType const> const bindingTypes
+) -> bool
+{
+    if (!pushConstantsMatch(
+            reflection.pushConstantSize(),
+            pushConstantSize,
+            pushConstantAlignment
+        ))
+    {
+        VKT_ERROR(
+            "Compute kernel at '{}' declares {} bytes of push constants, but "
+            "the host-side struct is {} bytes",
+            path.string(),
+            reflection.pushConstantSize(),
+            pushConstantSize
+        );
+        return false;
+    }
+
+    // Vulkan ignores map entries the SPIR-V does not declare, so a binary
+    // compiled from an older source would silently run with its defaults.
+    for (uint32_t index{0}; index < specializationInfo.mapEntryCount; index++)
+    {
+        uint32_t const constantId{
+            specializationInfo.pMapEntries[index].constantID
+        };
+        if (!reflection.declaresSpecializationConstant(constantId))
+        {
+            VKT_ERROR(
+                "Compute kernel at '{}' does not declare specialization "
+                "constant {}, so the SPIR-V may be stale. Rebuild the shaders "
+                "target.",
+                path.string(),
+                constantId
+            );
+            return false;
+        }
+    }
+
+    uint32_t constexpr PUSH_DESCRIPTOR_SET{1};
+
+    using Binding = DescriptorSetLayoutDescription::Binding;
+
+    std::span<Binding const> reflectedBindings{};
+    if (reflection.setLayouts.size() > PUSH_DESCRIPTOR_SET)
+    {
+        reflectedBindings = reflection.setLayouts[PUSH_DESCRIPTOR_SET].bindings;
+    }
+
+    if (reflectedBindings.size() != bindingTypes.size())
+    {
+        VKT_ERROR(
+            "Compute kernel at '{}' declares {} bindings in set {}, but the "
+            "host expects {}",
+            path.string(),
+            reflectedBindings.size(),
+            PUSH_DESCRIPTOR_SET,
+            bindingTypes.size()
+        );
+        return false;
+    }
+
+    for (size_t index{0}; index < bindingTypes.size(); index++)
+    {
+        auto const bindingIt{std::find_if(
+            reflectedBindings.begin(),
+            reflectedBindings.end(),
+            [&](Binding const& binding)
+        { return binding.binding == index; }
+        )};
+
+        if (bindingIt == reflectedBindings.end()
+            || bindingIt->type != bindingTypes[index] || bindingIt->count != 1)
+        {
+            VKT_ERROR(
+                "Compute kernel at '{}' does not declare binding {} of set {} "
+                "as a single {}",
+                path.string(),
+                index,
+                PUSH_DESCRIPTOR_SET,
+                string_VkDescriptorType(bindingTypes[index])
+            );
+            return false;
+        }
+    }
+
+    return true;
+}
+
+auto loadComputeKernel(
+    VkDevice const device,
+    BindlessHeap const& bindlessHeap,
+    DescriptorLayoutCache& layoutCache,
+    std::filesystem::path const& path,
+    VkSpecializationInfo const specializationInfo,
+    uint32_t const pushConstantSize,
+    uint32_t const pushConstantAlignment,
+    std::span<VkDescriptorType const> const bindingTypes
+) -> std::optional<LoadedComputeKernel>
+{
+    std::optional<ReflectedShaderObject> shaderResult{loadBindlessShaderObject(
+        device,
+        bindlessHeap,
+        layoutCache,
+        path,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        (VkFlags)0,
+        specializationInfo
+    )};
+    if (!shaderResult.has_value())
+    {
+        VKT_ERROR("Failed to load compute kernel at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    ReflectedShaderObject& shader{shaderResult.value()};
+
+    LoadedComputeKernel result{
+        .shader = shader.shaderObject,
+        .layout = shader.pipelineLayout,
+    };
+
+    // From here on the shader object must be destroyed on failure
+    auto const fail{[&]()
+    {
+        vkDestroyShaderEXT(device, result.shader, nullptr);
+        return std::nullopt;
+    }};
+
+    if (!checkComputeKernelInterface(
+            shader.reflection,
+            path,
+            specializationInfo,
+            pushConstantSize,
+            pushConstantAlignment,
+            bindingTypes
+        ))
+    {
+        return fail();
+    }
+
+    uint32_t constexpr PUSH_DESCRIPTOR_SET{1};
+
+    if (bindingTypes.empty())
+    {
+        return result;
+    }
+
+    result.descriptors = PushDescriptorTemplate::create(
+        device,
+        shader.reflection.setLayouts[PUSH_DESCRIPTOR_SET],
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        result.layout,
+        PUSH_DESCRIPTOR_SET
+    );
+    if (!result.descriptors.has_value())
+    {
+        VKT_ERROR(
+            "Failed to create push descriptor template for compute kernel at "
+            "'{}'",
+            path.string()
+        );
+        return fail();
+    }
+
+    return result;
+}
+} // namespace detail
+} // namespace vkt
\ No newline at end of file
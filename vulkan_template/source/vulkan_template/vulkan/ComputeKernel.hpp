@@ -0,0 +1,429 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
+#include "vulkan_template/vulkan/PushDescriptorTemplate.hpp"
+#include "vulkan_template/vulkan/Shader.hpp"
+#include "vulkan_template/vulkan/ShaderReflection.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include "vulkan_template/vulkan/WorkgroupAutotuner.hpp"
+#include <array>
+#include <concepts>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace vkt
+{
+struct DescriptorLayoutCache;
+} // namespace vkt
+
+namespace vkt
+{
+// A storage image in a kernel's push descriptor set.
+struct StorageImageBinding
+{
+    static VkDescriptorType constexpr TYPE{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE};
+
+    VkImageView view{VK_NULL_HANDLE};
+    VkImageLayout layout{VK_IMAGE_LAYOUT_GENERAL};
+
+    [[nodiscard]] auto descriptor() const -> PushDescriptorInfo;
+};
+
+// A combined image sampler in a kernel's push descriptor set.
+struct SampledImageBinding
+{
+    static VkDescriptorType constexpr TYPE{
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+    };
+
+    VkImageView view{VK_NULL_HANDLE};
+    VkSampler sampler{VK_NULL_HANDLE};
+    VkImageLayout layout{VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+    [[nodiscard]] auto descriptor() const -> PushDescriptorInfo;
+};
+
+// A storage buffer in a kernel's push descriptor set.
+struct StorageBufferBinding
+{
+    static VkDescriptorType constexpr TYPE{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER};
+
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkDeviceSize offset{0};
+    VkDeviceSize range{VK_WHOLE_SIZE};
+
+    [[nodiscard]] auto descriptor() const -> PushDescriptorInfo;
+};
+
+template <typename T>
+concept KernelBinding = requires(T const& binding) {
+    { T::TYPE } -> std::convertible_to<VkDescriptorType>;
+    { binding.descriptor() } -> std::same_as<PushDescriptorInfo>;
+};
+
+// Push constants are copied byte for byte into the bindless heap's shared
+// range. An empty struct means the kernel has no push constants.
+template <typename T>
+concept KernelPushConstants =
+    std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>;
+
+struct NoPushConstants
+{
+};
+
+namespace detail
+{
+struct LoadedComputeKernel
+{
+    VkShaderEXT shader{VK_NULL_HANDLE};
+    // Owned by the DescriptorLayoutCache
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    // Empty when the kernel has no push descriptor bindings
+    std::optional<PushDescriptorTemplate> descriptors{};
+};
+
+// Whether a push constant block whose members end at reflectedSize bytes is
+// laid out like a host-side struct of hostSize bytes. The struct may have tail
+// padding up to its alignment that the block does not.
+auto pushConstantsMatch(
+    uint32_t reflectedSize, uint32_t hostSize, uint32_t hostAlignment
+) -> bool;
+
+// Checks a compute shader's reflected interface against the host-side types:
+// the push constant block must match the host-side struct of pushConstantSize
+// bytes, set 1 must hold one descriptor of each of bindingTypes at bindings 0,
+// 1, 2..., and every constant in specializationInfo must be declared.
+auto checkComputeKernelInterface(
+    ShaderReflection const&,
+    std::filesystem::path const& path,
+    VkSpecializationInfo specializationInfo,
+    uint32_t pushConstantSize,
+    uint32_t pushConstantAlignment,
+    std::span<VkDescriptorType const> bindingTypes
+) -> bool;
+
+// Loads a bindless compute shader and checks its interface as above.
+auto loadComputeKernel(
+    VkDevice,
+    BindlessHeap const&,
+    DescriptorLayoutCache&,
+    std::filesystem::path const& path,
+    VkSpecializationInfo specializationInfo,
+    uint32_t pushConstantSize,
+    uint32_t pushConstantAlignment,
+    std::span<VkDescriptorType const> bindingTypes
+) -> std::optional<LoadedComputeKernel>;
+} // namespace detail
+
+// A compute shader object whose push constants and push descriptor bindings
+// are fixed by its template arguments. The interface is checked against the
+// device's guaranteed limits at compile time and against the SPIR-V at load
+// time, so a mismatched shader fails to load instead of reading garbage.
+//
+// Bindings are pushed to set 1 in order, so the Nth binding type is binding N
+// in the shader. Recording a dispatch binds the shader, pushes descriptors and
+// constants from the stack, and dispatches, without allocating. The bindless
+// heap must already be bound to the compute bind point.
+template <KernelPushConstants PushConstants, KernelBinding... Bindings>
+struct ComputeKernel
+{
+public:
+    static uint32_t constexpr PUSH_CONSTANT_SIZE{
+        std::is_empty_v<PushConstants>
+            ? 0U
+            : static_cast<uint32_t>(sizeof(PushConstants))
+    };
+    static uint32_t constexpr PUSH_CONSTANT_ALIGNMENT{
+        static_cast<uint32_t>(alignof(PushConstants))
+    };
+
+    // BindlessHeap::PUSH_CONSTANT_SIZE is the spec's minimum for
+    // maxPushConstantsSize, so this holds on every device.
+    static_assert(
+        PUSH_CONSTANT_SIZE <= BindlessHeap::PUSH_CONSTANT_SIZE,
+        "Push constants exceed the bindless heap's shared range."
+    );
+    static_assert(
+        PUSH_CONSTANT_SIZE % 4 == 0,
+        "Push constant size must be a multiple of 4 bytes."
+    );
+    static_assert(
+        std::is_empty_v<PushConstants> || alignof(PushConstants) % 4 == 0,
+        "Push constants must be made of 4-byte aligned members."
+    );
+
+    // The shader and workgroup size to dispatch with. Autotuning records
+    // candidates other than the kernel's current one.
+    struct Variant
+    {
+        VkShaderEXT shader{VK_NULL_HANDLE};
+        WorkgroupSize workgroupSize{};
+    };
+
+    // Records one run of a representative workload with the given variant.
+    using Workload = std::function<void(VkCommandBuffer, Variant)>;
+
+    ComputeKernel(ComputeKernel const&) = delete;
+    auto operator=(ComputeKernel const&) -> ComputeKernel& = delete;
+
+    ComputeKernel(ComputeKernel&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+    auto operator=(ComputeKernel&& other) noexcept -> ComputeKernel&
+    {
+        destroy();
+
+        m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+        m_path = std::exchange(other.m_path, {});
+        m_constants = std::exchange(other.m_constants, {});
+        m_shader = std::exchange(other.m_shader, VK_NULL_HANDLE);
+        m_workgroupSize = std::exchange(other.m_workgroupSize, {});
+        m_layout = std::exchange(other.m_layout, VK_NULL_HANDLE);
+        m_descriptors = std::exchange(other.m_descriptors, std::nullopt);
+
+        return *this;
+    }
+
+    ~ComputeKernel() { destroy(); }
+
+private:
+    ComputeKernel() = default;
+    void destroy() noexcept
+    {
+        if (m_device != VK_NULL_HANDLE)
+        {
+            vkDestroyShaderEXT(m_device, m_shader, nullptr);
+        }
+
+        m_device = VK_NULL_HANDLE;
+        m_path.clear();
+        m_constants.clear();
+        m_shader = VK_NULL_HANDLE;
+        m_workgroupSize = {};
+        m_layout = VK_NULL_HANDLE;
+        m_descriptors.reset();
+    }
+
+public:
+    // Constants specialize the shader from ID 2 onward, after the workgroup
+    // size, and are kept when autotuning recreates the shader.
+    static auto create(
+        VkDevice const device,
+        BindlessHeap const& bindlessHeap,
+        DescriptorLayoutCache& layoutCache,
+        std::filesystem::path const& path,
+        WorkgroupSize const workgroupSize = {},
+        std::span<uint32_t const> const constants = {}
+    ) -> std::optional<ComputeKernel>
+    {
+        ComputeSpecialization const specialization{
+            computeSpecialization(workgroupSize, constants)
+        };
+        std::optional<detail::LoadedComputeKernel> loadResult{
+            detail::loadComputeKernel(
+                device,
+                bindlessHeap,
+                layoutCache,
+                path,
+                specialization.info(),
+                PUSH_CONSTANT_SIZE,
+                PUSH_CONSTANT_ALIGNMENT,
+                BINDING_TYPES
+            )
+        };
+        if (!loadResult.has_value())
+        {
+            return std::nullopt;
+        }
+
+        std::optional<ComputeKernel> result{std::in_place, ComputeKernel{}};
+        ComputeKernel& kernel{result.value()};
+
+        kernel.m_device = device;
+        kernel.m_path = path;
+        kernel.m_constants.assign(constants.begin(), constants.end());
+        kernel.m_shader = loadResult.value().shader;
+        kernel.m_workgroupSize = workgroupSize;
+        kernel.m_layout = loadResult.value().layout;
+        kernel.m_descriptors = std::move(loadResult.value().descriptors);
+
+        return result;
+    }
+
+    // Checks the SPIR-V at path against the template arguments without a
+    // device, so that a stale or mismatched shader is caught before anything
+    // runs on a GPU. Constants are the same as create() would be passed.
+    static auto checkInterface(
+        std::filesystem::path const& path,
+        std::span<uint32_t const> const constants = {}
+    ) -> bool
+    {
+        std::optional<ShaderReflection> const reflection{
+            reflectShaderFile(path)
+        };
+        if (!reflection.has_value())
+        {
+            return false;
+        }
+
+        ComputeSpecialization const specialization{
+            computeSpecialization(WorkgroupSize{}, constants)
+        };
+        return detail::checkComputeKernelInterface(
+            reflection.value(),
+            path,
+            specialization.info(),
+            PUSH_CONSTANT_SIZE,
+            PUSH_CONSTANT_ALIGNMENT,
+            BINDING_TYPES
+        );
+    }
+
+    [[nodiscard]] auto variant() const -> Variant
+    {
+        return Variant{
+            .shader = m_shader,
+            .workgroupSize = m_workgroupSize,
+        };
+    }
+
+    // Picks the fastest workgroup size for this device by timing workload with
+    // each candidate, and reloads the shader with it. On failure the current
+    // shader is kept.
+    void autotune(
+        WorkgroupAutotuner& autotuner,
+        std::string const& key,
+        BindlessHeap const& bindlessHeap,
+        DescriptorLayoutCache& layoutCache,
+        Workload const& workload
+    )
+    {
+        WorkgroupSize const tuned{autotuner.tune(
+            key,
+            WorkgroupAutotuner::defaultCandidates(),
+            [&](WorkgroupSize const candidate) -> std::optional<VkShaderEXT>
+        {
+            ComputeSpecialization const specialization{
+                computeSpecialization(candidate, m_constants)
+            };
+            std::optional<detail::LoadedComputeKernel> const loadResult{
+                detail::loadComputeKernel(
+                    m_device,
+                    bindlessHeap,
+                    layoutCache,
+                    m_path,
+                    specialization.info(),
+                    PUSH_CONSTANT_SIZE,
+                    PUSH_CONSTANT_ALIGNMENT,
+                    BINDING_TYPES
+                )
+            };
+            if (!loadResult.has_value())
+            {
+                return std::nullopt;
+            }
+            return loadResult.value().shader;
+        },
+            [&](VkCommandBuffer const cmd,
+                VkShaderEXT const shader,
+                WorkgroupSize const workgroupSize)
+        {
+            workload(
+                cmd,
+                Variant{
+                    .shader = shader,
+                    .workgroupSize = workgroupSize,
+                }
+            );
+        }
+        )};
+
+        if (tuned == m_workgroupSize)
+        {
+            return;
+        }
+
+        std::optional<ComputeKernel> tunedKernel{create(
+            m_device, bindlessHeap, layoutCache, m_path, tuned, m_constants
+        )};
+        if (!tunedKernel.has_value())
+        {
+            VKT_WARNING(
+                "Failed to recreate '{}' with autotuned workgroup size.",
+                m_path.string()
+            );
+            return;
+        }
+
+        *this = std::move(tunedKernel).value();
+    }
+
+    // Dispatches enough workgroups to cover invocations.
+    void record(
+        VkCommandBuffer const cmd,
+        PushConstants const& pushConstants,
+        VkExtent3D const invocations,
+        Bindings const&... bindings
+    ) const
+    {
+        record(cmd, variant(), pushConstants, invocations, bindings...);
+    }
+
+    void record(
+        VkCommandBuffer const cmd,
+        Variant const kernelVariant,
+        PushConstants const& pushConstants,
+        VkExtent3D const invocations,
+        Bindings const&... bindings
+    ) const
+    {
+        VkShaderStageFlagBits const stage{VK_SHADER_STAGE_COMPUTE_BIT};
+        vkCmdBindShadersEXT(cmd, 1, &stage, &kernelVariant.shader);
+
+        if constexpr (sizeof...(Bindings) > 0)
+        {
+            std::array<PushDescriptorInfo, sizeof...(Bindings)> const
+                descriptors{bindings.descriptor()...};
+            m_descriptors.value().push(cmd, descriptors);
+        }
+
+        if constexpr (PUSH_CONSTANT_SIZE > 0)
+        {
+            vkCmdPushConstants(
+                cmd,
+                m_layout,
+                BindlessHeap::PUSH_CONSTANT_STAGES,
+                0,
+                PUSH_CONSTANT_SIZE,
+                &pushConstants
+            );
+        }
+
+        computeDispatch(cmd, invocations, kernelVariant.workgroupSize);
+    }
+
+private:
+    static std::array<VkDescriptorType, sizeof...(Bindings)> constexpr
+        BINDING_TYPES{Bindings::TYPE...};
+
+    VkDevice m_device{VK_NULL_HANDLE};
+    std::filesystem::path m_path{};
+    std::vector<uint32_t> m_constants{};
+
+    VkShaderEXT m_shader{VK_NULL_HANDLE};
+    WorkgroupSize m_workgroupSize{};
+
+    // Owned by the DescriptorLayoutCache
+    VkPipelineLayout m_layout{VK_NULL_HANDLE};
+    std::optional<PushDescriptorTemplate> m_descriptors{};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "DescriptorLayoutCache.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <functional>
+#include <utility>
+
+namespace
+{
+template <typename T> void hashCombine(size_t& seed, T const& value)
+{
+    // Same mixing constant as boost::hash_combine
+    size_t constexpr GOLDEN_RATIO{0x9e3779b9};
+    seed ^= std::hash<T>{}(value) + GOLDEN_RATIO + (seed << 6U) + (seed >> 2U);
+}
+} // namespace
+
+namespace vkt
+{
+auto DescriptorLayoutCache::SetLayoutHash::operator()(
+    DescriptorSetLayoutDescription const& description
+) const -> size_t
+{
+    size_t seed{0};
+    hashCombine(seed, description.flags);
+    for (DescriptorSetLayoutDescription::Binding const& binding :
+         description.bindings)
+    {
+        hashCombine(seed, binding.binding);
+        hashCombine(seed, binding.type);
+        hashCombine(seed, binding.count);
+        hashCombine(seed, binding.stageMask);
+        hashCombine(seed, binding.bindingFlags);
+        for (VkSampler const sampler : binding.immutableSamplers)
+        {
+            hashCombine(seed, sampler);
+        }
+    }
+    return seed;
+}
+
+auto DescriptorLayoutCache::PipelineLayoutHash::operator()(
+    PipelineLayoutDescription const& description
+) const -> size_t
+{
+    size_t seed{0};
+    for (VkDescriptorSetLayout const layout : description.setLayouts)
+    {
+        hashCombine(seed, layout);
+    }
+    for (PipelineLayoutDescription::PushConstantRange const& range :
+         description.pushConstantRanges)
+    {
+        hashCombine(seed, range.stageMask);
+        hashCombine(seed, range.offset);
+        hashCombine(seed, range.size);
+    }
+    return seed;
+}
+
+DescriptorLayoutCache::DescriptorLayoutCache(DescriptorLayoutCache&& other
+) noexcept
+{
+    *this = std::move(other);
+}
+
+auto DescriptorLayoutCache::operator=(DescriptorLayoutCache&& other) noexcept
+    -> DescriptorLayoutCache&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_setLayouts = std::move(other.m_setLayouts);
+    m_pipelineLayouts = std::move(other.m_pipelineLayouts);
+
+    other.m_setLayouts.clear();
+    other.m_pipelineLayouts.clear();
+
+    return *this;
+}
+
+DescriptorLayoutCache::~DescriptorLayoutCache() { destroy(); }
+
+void DescriptorLayoutCache::destroy() noexcept
+{
+    if (m_device == VK_NULL_HANDLE)
+    {
+        if (!m_setLayouts.empty() || !m_pipelineLayouts.empty())
+        {
+            VKT_WARNING("DescriptorLayoutCache destroyed with no device, but "
+                        "cached layouts. Memory was maybe leaked.");
+        }
+        return;
+    }
+
+    // Pipeline layouts reference set layouts, so destroy them first
+    for (auto const& [description, layout] : m_pipelineLayouts)
+    {
+        vkDestroyPipelineLayout(m_device, layout, nullptr);
+    }
+    for (auto const& [description, layout] : m_setLayouts)
+    {
+        vkDestroyDescriptorSetLayout(m_device, layout, nullptr);
+    }
+
+    m_pipelineLayouts.clear();
+    m_setLayouts.clear();
+    m_device = VK_NULL_HANDLE;
+}
+
+auto DescriptorLayoutCache::create(VkDevice const device)
+    -> std::optional<DescriptorLayoutCache>
+{
+    if (device == VK_NULL_HANDLE)
+    {
+        VKT_ERROR("Device is null.");
+        return std::nullopt;
+    }
+
+    std::optional<DescriptorLayoutCache> result{
+        std::in_place, DescriptorLayoutCache{}
+    };
+    result.value().m_device = device;
+
+    return result;
+}
+
+auto DescriptorLayoutCache::getSetLayout(
+    DescriptorSetLayoutDescription const& description
+) -> std::optional<VkDescriptorSetLayout>
+{
+    if (auto const cached{m_setLayouts.find(description)};
+        cached != m_setLayouts.end())
+    {
+        return cached->second;
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> bindings{};
+    std::vector<VkDescriptorBindingFlags> bindingFlags{};
+    bindings.reserve(description.bindings.size());
+    bindingFlags.reserve(description.bindings.size());
+
+    for (DescriptorSetLayoutDescription::Binding const& binding :
+         description.bindings)
+    {
+        bool const immutable{!binding.immutableSamplers.empty()};
+
+        bindings.push_back(VkDescriptorSetLayoutBinding{
+            .binding = binding.binding,
+            .descriptorType = binding.type,
+            .descriptorCount =
+                immutable
+                    ? static_cast<uint32_t>(binding.immutableSamplers.size())
+                    : binding.count,
+            .stageFlags = binding.stageMask,
+            .pImmutableSamplers =
+                immutable ? binding.immutableSamplers.data() : nullptr,
+        });
+        bindingFlags.push_back(binding.bindingFlags);
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo const flagsInfo{
+        .sType =
+            VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .pNext = nullptr,
+
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data(),
+    };
+
+    VkDescriptorSetLayoutCreateInfo const info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &flagsInfo,
+        .flags = description.flags,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data(),
+    };
+
+    VkDescriptorSetLayout layout{VK_NULL_HANDLE};
+    VKT_TRY_VK(
+        vkCreateDescriptorSetLayout(m_device, &info, nullptr, &layout),
+        "Failed to create cached descriptor set layout.",
+        std::nullopt
+    );
+
+    m_setLayouts.emplace(description, layout);
+
+    return layout;
+}
+
+auto DescriptorLayoutCache::getPipelineLayout(
+    std::span<VkDescriptorSetLayout const> const setLayouts,
+    std::span<VkPushConstantRange const> const pushConstantRanges
+) -> std::optional<VkPipelineLayout>
+{
+    PipelineLayoutDescription description{
+        .setLayouts = std::vector<VkDescriptorSetLayout>(
+            setLayouts.begin(), setLayouts.end()
+        ),
+    };
+    for (VkPushConstantRange const& range : pushConstantRanges)
+    {
+        description.pushConstantRanges.push_back({
+            .stageMask = range.stageFlags,
+            .offset = range.offset,
+            .size = range.size,
+        });
+    }
+
+    if (auto const cached{m_pipelineLayouts.find(description)};
+        cached != m_pipelineLayouts.end())
+    {
+        return cached->second;
+    }
+
+    VkPipelineLayoutCreateInfo const layoutCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext = nullptr,
+
+        .flags = 0,
+
+        .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+        .pSetLayouts = setLayouts.data(),
+
+        .pushConstantRangeCount =
+            static_cast<uint32_t>(pushConstantRanges.size()),
+        .pPushConstantRanges = pushConstantRanges.data(),
+    };
+
+    VkPipelineLayout layout{VK_NULL_HANDLE};
+    VKT_TRY_VK(
+        vkCreatePipelineLayout(m_device, &layoutCreateInfo, nullptr, &layout),
+        "Failed to create cached pipeline layout.",
+        std::nullopt
+    );
+
+    m_pipelineLayouts.emplace(std::move(description), layout);
+
+    return layout;
+}
+
+auto DescriptorLayoutCache::setLayoutCount() const -> size_t
+{
+    return m_setLayouts.size();
+}
+
+auto DescriptorLayoutCache::pipelineLayoutCount() const -> size_t
+{
+    return m_pipelineLayouts.size();
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace vkt
+{
+// Describes the contents of a VkDescriptorSetLayout. Two equal descriptions
+// produce interchangeable layouts, which is what the cache keys on.
+struct DescriptorSetLayoutDescription
+{
+    struct Binding
+    {
+        uint32_t binding{0};
+        VkDescriptorType type{VK_DESCRIPTOR_TYPE_SAMPLER};
+        uint32_t count{1};
+        VkShaderStageFlags stageMask{0};
+        VkDescriptorBindingFlags bindingFlags{0};
+        std::vector<VkSampler> immutableSamplers{};
+
+        auto operator==(Binding const&) const -> bool = default;
+    };
+
+    VkDescriptorSetLayoutCreateFlags flags{0};
+    std::vector<Binding> bindings{};
+
+    auto operator==(DescriptorSetLayoutDescription const&) const
+        -> bool = default;
+};
+
+// Deduplicates descriptor set layouts and pipeline layouts by their contents.
+// The cache owns every layout it hands out, and they live until the cache is
+// destroyed. This lets subsystems share handles without tracking ownership.
+struct DescriptorLayoutCache
+{
+public:
+    DescriptorLayoutCache(DescriptorLayoutCache const&) = delete;
+    auto operator=(DescriptorLayoutCache const&)
+        -> DescriptorLayoutCache& = delete;
+
+    DescriptorLayoutCache(DescriptorLayoutCache&&) noexcept;
+    auto operator=(DescriptorLayoutCache&&) noexcept -> DescriptorLayoutCache&;
+
+    ~DescriptorLayoutCache();
+
+private:
+    DescriptorLayoutCache() = default;
+    void destroy() noexcept;
+
+public:
+    static auto create(VkDevice) -> std::optional<DescriptorLayoutCache>;
+
+    auto getSetLayout(DescriptorSetLayoutDescription const&)
+        -> std::optional<VkDescriptorSetLayout>;
+
+    auto getPipelineLayout(
+        std::span<VkDescriptorSetLayout const> setLayouts,
+        std::span<VkPushConstantRange const> pushConstantRanges
+    ) -> std::optional<VkPipelineLayout>;
+
+    [[nodiscard]] auto setLayoutCount() const -> size_t;
+    [[nodiscard]] auto pipelineLayoutCount() const -> size_t;
+
+private:
+    struct PipelineLayoutDescription
+    {
+        struct PushConstantRange
+        {
+            VkShaderStageFlags stageMask{0};
+            uint32_t offset{0};
+            uint32_t size{0};
+
+            auto operator==(PushConstantRange const&) const -> bool = default;
+        };
+
+        std::vector<VkDescriptorSetLayout> setLayouts{};
+        std::vector<PushConstantRange> pushConstantRanges{};
+
+        auto operator==(PipelineLayoutDescription const&) const
+            -> bool = default;
+    };
+
+    struct SetLayoutHash
+    {
+        auto operator()(DescriptorSetLayoutDescription const&) const -> size_t;
+    };
+    struct PipelineLayoutHash
+    {
+        auto operator()(PipelineLayoutDescription const&) const -> size_t;
+    };
+
+    VkDevice m_device{VK_NULL_HANDLE};
+
+    std::unordered_map<
+        DescriptorSetLayoutDescription,
+        VkDescriptorSetLayout,
+        SetLayoutHash>
+        m_setLayouts{};
+    std::unordered_map<
+        PipelineLayoutDescription,
+        VkPipelineLayout,
+        PipelineLayoutHash>
+        m_pipelineLayouts{};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "GPURingBuffer.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <utility>
+
+namespace
+{
+auto alignUp(VkDeviceSize const offset, VkDeviceSize const alignment)
+    -> VkDeviceSize
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+namespace vkt
+{
+GPURingBuffer::GPURingBuffer(GPURingBuffer&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto GPURingBuffer::operator=(GPURingBuffer&& other) noexcept -> GPURingBuffer&
+{
+    destroy();
+
+    m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+    m_allocation = std::exchange(other.m_allocation, VK_NULL_HANDLE);
+    m_buffer = std::exchange(other.m_buffer, VK_NULL_HANDLE);
+
+    m_mapped = std::exchange(other.m_mapped, nullptr);
+    m_address = std::exchange(other.m_address, 0);
+    m_capacity = std::exchange(other.m_capacity, 0);
+    m_deviceLocal = std::exchange(other.m_deviceLocal, false);
+
+    m_head.store(other.m_head.exchange(0));
+    m_tail = std::exchange(other.m_tail, 0);
+
+    m_frameEnds = std::exchange(other.m_frameEnds, {});
+    m_frame = std::exchange(other.m_frame, 0);
+
+    return *this;
+}
+
+GPURingBuffer::~GPURingBuffer() { destroy(); }
+
+void GPURingBuffer::destroy() noexcept
+{
+    if (m_allocator != VK_NULL_HANDLE)
+    {
+        // Mapped memory is unmapped along with the allocation
+        vmaDestroyBuffer(m_allocator, m_buffer, m_allocation);
+    }
+
+    m_allocator = VK_NULL_HANDLE;
+    m_allocation = VK_NULL_HANDLE;
+    m_buffer = VK_NULL_HANDLE;
+    m_mapped = nullptr;
+    m_address = 0;
+    m_capacity = 0;
+    m_head.store(0);
+    m_tail = 0;
+    m_frameEnds = {};
+}
+
+auto GPURingBuffer::create(
+    VkDevice const device,
+    VmaAllocator const allocator,
+    VkDeviceSize const capacity,
+    uint32_t const framesInFlight
+) -> std::optional<GPURingBuffer>
+{
+    if (capacity == 0 || framesInFlight == 0)
+    {
+        VKT_ERROR(
+            "GPU ring buffer needs a capacity and at least one frame in flight."
+        );
+        return std::nullopt;
+    }
+
+    std::optional<GPURingBuffer> result{std::in_place, GPURingBuffer{}};
+    GPURingBuffer& ring{result.value()};
+
+    ring.m_capacity = alignUp(capacity, MAX_ALIGNMENT);
+    ring.m_frameEnds.resize(framesInFlight, 0);
+
+    VkBufferCreateInfo const bufferInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+
+        .flags = 0,
+
+        .size = ring.m_capacity,
+        .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT
+               | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+               | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
+    };
+
+    // Preferring device local memory while requiring host visibility picks
+    // the resizable BAR heap when there is one, and system memory otherwise.
+    // Coherence is required so that writes never need flushing.
+    VmaAllocationCreateInfo const allocationInfo{
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+               | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT
+                       | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+    };
+
+    VmaAllocationInfo mappedInfo{};
+    VKT_TRY_VK(
+        vmaCreateBuffer(
+            allocator,
+            &bufferInfo,
+            &allocationInfo,
+            &ring.m_buffer,
+            &ring.m_allocation,
+            &mappedInfo
+        ),
+        "Failed to allocate GPU ring buffer.",
+        std::nullopt
+    );
+    ring.m_allocator = allocator;
+    ring.m_mapped = static_cast<std::byte*>(mappedInfo.pMappedData);
+
+    VkMemoryPropertyFlags memoryFlags{0};
+    vmaGetAllocationMemoryProperties(
+        allocator, ring.m_allocation, &memoryFlags
+    );
+    ring.m_deviceLocal =
+        (memoryFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+    if (!ring.m_deviceLocal)
+    {
+        VKT_INFO(
+            "No resizable BAR memory available, so the GPU ring buffer lives "
+            "in host memory."
+        );
+    }
+
+    VkBufferDeviceAddressInfo const addressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .pNext = nullptr,
+        .buffer = ring.m_buffer,
+    };
+    ring.m_address = vkGetBufferDeviceAddress(device, &addressInfo);
+
+    return result;
+}
+
+void GPURingBuffer::advanceFrame()
+{
+    VkDeviceSize const head{m_head.load()};
+
+    // The finished frame's allocations end where the next frame's begin
+    m_frameEnds[m_frame % m_frameEnds.size()] = head;
+    m_frame += 1;
+
+    // This frame reuses the slot of the frame that retired with the fence the
+    // caller waited on, so everything that frame allocated can be overwritten.
+    m_tail = m_frameEnds[m_frame % m_frameEnds.size()];
+}
+
+auto GPURingBuffer::allocate(
+    VkDeviceSize const size, VkDeviceSize const alignment
+) -> std::optional<GPUAllocation>
+{
+    if (alignment == 0 || alignment > MAX_ALIGNMENT
+        || (alignment & (alignment - 1)) != 0)
+    {
+        VKT_ERROR("GPU ring buffer alignment {} is not supported.", alignment);
+        return std::nullopt;
+    }
+    if (size > m_capacity)
+    {
+        VKT_ERROR(
+            "GPU ring buffer allocation of {} bytes is larger than the ring's "
+            "{} bytes.",
+            size,
+            m_capacity
+        );
+        return std::nullopt;
+    }
+
+    VkDeviceSize head{m_head.load()};
+    VkDeviceSize begin{0};
+    do
+    {
+        begin = alignUp(head, alignment);
+
+        // Allocations are contiguous, so one that would straddle the end of
+        // the ring starts over at the beginning instead.
+        if (begin % m_capacity + size > m_capacity)
+        {
+            begin = alignUp(begin, m_capacity);
+        }
+
+        if (begin + size - m_tail > m_capacity)
+        {
+            VKT_WARNING_RATE_LIMITED(
+                "GPU ring buffer is full, failed to allocate {} bytes.", size
+            );
+            return std::nullopt;
+        }
+    } while (!m_head.compare_exchange_weak(head, begin + size));
+
+    VkDeviceSize const offset{begin % m_capacity};
+    return GPUAllocation{
+        .hostMemory = std::span{m_mapped + offset, static_cast<size_t>(size)},
+        .address = m_address + offset,
+        .buffer = m_buffer,
+        .offset = offset,
+    };
+}
+
+auto GPURingBuffer::capacity() const -> VkDeviceSize { return m_capacity; }
+
+auto GPURingBuffer::deviceLocal() const -> bool { return m_deviceLocal; }
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace vkt
+{
+// Memory written by the host this frame and read by the device through
+// hostMemory's device address.
+struct GPUAllocation
+{
+    std::span<std::byte> hostMemory{};
+    VkDeviceAddress address{0};
+
+    // For APIs that want a buffer and offset rather than an address, such as
+    // uniform buffer descriptors.
+    VkBuffer buffer{VK_NULL_HANDLE};
+    VkDeviceSize offset{0};
+};
+
+// A persistently mapped buffer that per-pass and per-draw data is suballocated
+// from linearly, so parameter blocks larger than push constants can be passed
+// to shaders by device address without creating buffers or descriptors.
+//
+// The memory is host visible, and device local when the device exposes
+// resizable BAR, so shaders read it at full speed. Otherwise it falls back to
+// host memory that shaders read over the bus.
+//
+// Allocations wrap around the ring, and live until advanceFrame has been
+// called framesInFlight times. Allocating more than the ring holds across the
+// frames in flight fails rather than overwriting data in use.
+struct GPURingBuffer
+{
+public:
+    // Covers every alignment Vulkan requires of uniform, storage, and device
+    // address data.
+    static VkDeviceSize constexpr MAX_ALIGNMENT{256};
+
+    GPURingBuffer(GPURingBuffer const&) = delete;
+    auto operator=(GPURingBuffer const&) -> GPURingBuffer& = delete;
+
+    GPURingBuffer(GPURingBuffer&&) noexcept;
+    auto operator=(GPURingBuffer&&) noexcept -> GPURingBuffer&;
+
+    ~GPURingBuffer();
+
+private:
+    GPURingBuffer() = default;
+    void destroy() noexcept;
+
+public:
+    // Capacity is rounded up to MAX_ALIGNMENT.
+    static auto create(
+        VkDevice,
+        VmaAllocator,
+        VkDeviceSize capacity,
+        uint32_t framesInFlight
+    ) -> std::optional<GPURingBuffer>;
+
+    // Call once per frame, after waiting on that frame's fence, and before
+    // allocating for the frame.
+    void advanceFrame();
+
+    // Safe to call from several threads at once, such as from passes recorded
+    // in parallel, but not concurrently with advanceFrame. Alignment must be a
+    // power of two no greater than MAX_ALIGNMENT.
+    auto allocate(VkDeviceSize size, VkDeviceSize alignment)
+        -> std::optional<GPUAllocation>;
+
+    // Copies value into the ring, for shaders to read through the address.
+    template <typename T>
+    auto push(T const& value) -> std::optional<VkDeviceAddress>
+    {
+        static_assert(
+            std::is_trivially_copyable_v<T>,
+            "Values are copied bytewise into GPU memory."
+        );
+
+        std::optional<GPUAllocation> const allocation{
+            allocate(sizeof(T), alignof(T))
+        };
+        if (!allocation.has_value())
+        {
+            return std::nullopt;
+        }
+
+        std::memcpy(allocation.value().hostMemory.data(), &value, sizeof(T));
+        return allocation.value().address;
+    }
+
+    [[nodiscard]] auto capacity() const -> VkDeviceSize;
+    // True if shaders read the ring from device local memory.
+    [[nodiscard]] auto deviceLocal() const -> bool;
+
+private:
+    VmaAllocator m_allocator{VK_NULL_HANDLE};
+    VmaAllocation m_allocation{VK_NULL_HANDLE};
+    VkBuffer m_buffer{VK_NULL_HANDLE};
+
+    std::byte* m_mapped{nullptr};
+    VkDeviceAddress m_address{0};
+    VkDeviceSize m_capacity{0};
+    bool m_deviceLocal{false};
+
+    // Offsets count up forever, and are wrapped into the ring with a modulo.
+    // Allocations at or past m_tail may be overwritten, since every frame that
+    // used them has retired.
+    std::atomic<VkDeviceSize> m_head{0};
+    VkDeviceSize m_tail{0};
+
+    // Where each frame in flight's allocations end, indexed by frame modulo
+    // the frame count.
+    std::vector<VkDeviceSize> m_frameEnds{};
+    uint64_t m_frame{0};
+};
+} // namespace vkt
\ No newline at end of file
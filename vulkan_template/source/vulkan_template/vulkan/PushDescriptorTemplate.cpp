@@ -0,0 +1,142 @@
+#include "PushDescriptorTemplate.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include <utility>
+#include <vector>
+
+namespace vkt
+{
+PushDescriptorTemplate::PushDescriptorTemplate(PushDescriptorTemplate&& other
+) noexcept
+{
+    *this = std::move(other);
+}
+
+auto PushDescriptorTemplate::operator=(PushDescriptorTemplate&& other
+) noexcept -> PushDescriptorTemplate&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_template = std::exchange(other.m_template, VK_NULL_HANDLE);
+    m_pipelineLayout = std::exchange(other.m_pipelineLayout, VK_NULL_HANDLE);
+    m_set = std::exchange(other.m_set, 0);
+    m_descriptorCount = std::exchange(other.m_descriptorCount, 0);
+
+    return *this;
+}
+
+PushDescriptorTemplate::~PushDescriptorTemplate() { destroy(); }
+
+void PushDescriptorTemplate::destroy() noexcept
+{
+    if (m_device != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorUpdateTemplate(m_device, m_template, nullptr);
+    }
+
+    m_device = VK_NULL_HANDLE;
+    m_template = VK_NULL_HANDLE;
+    m_pipelineLayout = VK_NULL_HANDLE;
+    m_set = 0;
+    m_descriptorCount = 0;
+}
+
+auto PushDescriptorTemplate::create(
+    VkDevice const device,
+    DescriptorSetLayoutDescription const& description,
+    VkPipelineBindPoint const bindPoint,
+    VkPipelineLayout const pipelineLayout,
+    uint32_t const set
+) -> std::optional<PushDescriptorTemplate>
+{
+    if ((description.flags
+         & VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR)
+        == 0)
+    {
+        VKT_ERROR("Push descriptor template requires a push descriptor layout."
+        );
+        return std::nullopt;
+    }
+
+    std::optional<PushDescriptorTemplate> result{
+        std::in_place, PushDescriptorTemplate{}
+    };
+    PushDescriptorTemplate& pushTemplate{result.value()};
+    pushTemplate.m_device = device;
+    pushTemplate.m_pipelineLayout = pipelineLayout;
+    pushTemplate.m_set = set;
+
+    std::vector<VkDescriptorUpdateTemplateEntry> entries{};
+    for (DescriptorSetLayoutDescription::Binding const& binding :
+         description.bindings)
+    {
+        entries.push_back(VkDescriptorUpdateTemplateEntry{
+            .dstBinding = binding.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = binding.count,
+            .descriptorType = binding.type,
+            .offset =
+                pushTemplate.m_descriptorCount * sizeof(PushDescriptorInfo),
+            .stride = sizeof(PushDescriptorInfo),
+        });
+
+        pushTemplate.m_descriptorCount += binding.count;
+    }
+
+    VkDescriptorUpdateTemplateCreateInfo const createInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR,
+
+        // Only read for descriptor set templates
+        .descriptorSetLayout = VK_NULL_HANDLE,
+
+        .pipelineBindPoint = bindPoint,
+        .pipelineLayout = pipelineLayout,
+        .set = set,
+    };
+
+    VKT_TRY_VK(
+        vkCreateDescriptorUpdateTemplate(
+            device, &createInfo, nullptr, &pushTemplate.m_template
+        ),
+        "Failed to create push descriptor update template.",
+        std::nullopt
+    );
+
+    return result;
+}
+
+auto PushDescriptorTemplate::descriptorCount() const -> uint32_t
+{
+    return m_descriptorCount;
+}
+
+void PushDescriptorTemplate::push(
+    VkCommandBuffer const cmd,
+    std::span<PushDescriptorInfo const> const descriptors
+) const
+{
+    if (descriptors.size() != m_descriptorCount)
+    {
+        VKT_ERROR(
+            "Push descriptor template expected {} descriptors, got {}.",
+            m_descriptorCount,
+            descriptors.size()
+        );
+        return;
+    }
+
+    vkCmdPushDescriptorSetWithTemplateKHR(
+        cmd, m_template, m_pipelineLayout, m_set, descriptors.data()
+    );
+}
+} // namespace vkt
\ No newline at end of file
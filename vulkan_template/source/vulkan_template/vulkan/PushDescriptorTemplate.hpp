@@ -0,0 +1,71 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <optional>
+#include <span>
+
+namespace vkt
+{
+struct DescriptorSetLayoutDescription;
+} // namespace vkt
+
+namespace vkt
+{
+// One descriptor's worth of data for a push descriptor template. Which member
+// is read depends on the descriptor type of the binding it lands in.
+union PushDescriptorInfo
+{
+    VkDescriptorImageInfo image;
+    VkDescriptorBufferInfo buffer;
+    VkBufferView texelBuffer;
+};
+
+// Writes a descriptor set straight into a command buffer with
+// VK_KHR_push_descriptor, so passes whose inputs change every frame need no
+// descriptor set allocation or vkUpdateDescriptorSets call.
+//
+// The update template reads one PushDescriptorInfo per descriptor, ordered by
+// binding and then by array element, so callers only fill a flat array.
+struct PushDescriptorTemplate
+{
+public:
+    PushDescriptorTemplate(PushDescriptorTemplate const&) = delete;
+    auto operator=(PushDescriptorTemplate const&)
+        -> PushDescriptorTemplate& = delete;
+
+    PushDescriptorTemplate(PushDescriptorTemplate&&) noexcept;
+    auto operator=(PushDescriptorTemplate&&) noexcept
+        -> PushDescriptorTemplate&;
+
+    ~PushDescriptorTemplate();
+
+private:
+    PushDescriptorTemplate() = default;
+    void destroy() noexcept;
+
+public:
+    // The description must have been created with
+    // VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR, and describe the
+    // layout at index set of pipelineLayout.
+    static auto create(
+        VkDevice,
+        DescriptorSetLayoutDescription const&,
+        VkPipelineBindPoint,
+        VkPipelineLayout,
+        uint32_t set
+    ) -> std::optional<PushDescriptorTemplate>;
+
+    // The number of PushDescriptorInfo that push expects.
+    [[nodiscard]] auto descriptorCount() const -> uint32_t;
+
+    void push(VkCommandBuffer, std::span<PushDescriptorInfo const>) const;
+
+private:
+    VkDevice m_device{VK_NULL_HANDLE};
+    VkDescriptorUpdateTemplate m_template{VK_NULL_HANDLE};
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+    uint32_t m_set{0};
+    uint32_t m_descriptorCount{0};
+};
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "ReadbackService.hpp"
+
+#include "vulkan_template/core/JobSystem.hpp"
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/Image.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace
+{
+// Only color formats that render targets use are supported
+auto bytesPerTexel(VkFormat const format) -> std::optional<VkDeviceSize>
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+    case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+        return 4;
+    case VK_FORMAT_R16G16B16A16_UNORM:
+    case VK_FORMAT_R16G16B16A16_SFLOAT:
+        return 8;
+    case VK_FORMAT_R32G32B32A32_SFLOAT:
+        return 16;
+    default:
+        return std::nullopt;
+    }
+}
+} // namespace
+
+namespace vkt
+{
+ReadbackService::ReadbackService(ReadbackService&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto ReadbackService::operator=(ReadbackService&& other) noexcept
+    -> ReadbackService&
+{
+    destroy();
+
+    m_allocator = std::exchange(other.m_allocator, VK_NULL_HANDLE);
+
+    m_stagingBuffers = std::move(other.m_stagingBuffers);
+    m_pendingCallbacks = std::move(other.m_pendingCallbacks);
+
+    m_frame = std::exchange(other.m_frame, 0);
+    m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+
+    return *this;
+}
+
+ReadbackService::~ReadbackService() { destroy(); }
+
+void ReadbackService::destroy() noexcept
+{
+    if (m_pendingCallbacks != nullptr)
+    {
+        // The callbacks read from the staging buffers, and run on workers
+        // without any waiting needed from this thread.
+        while (!m_pendingCallbacks->done())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    for (std::unique_ptr<StagingBuffer> const& staging : m_stagingBuffers)
+    {
+        if (staging->state.load() == StagingState::RECORDED)
+        {
+            VKT_WARNING("Readback destroyed with copies that never retired.");
+        }
+        if (staging->allocation != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(m_allocator, staging->buffer, staging->allocation);
+        }
+    }
+
+    m_allocator = VK_NULL_HANDLE;
+    m_stagingBuffers.clear();
+    m_pendingCallbacks.reset();
+    m_frame = 0;
+    m_framesInFlight = 0;
+}
+
+auto ReadbackService::create(
+    VmaAllocator const allocator,
+    uint32_t const stagingBufferCount,
+    uint32_t const framesInFlight
+) -> std::optional<ReadbackService>
+{
+    if (stagingBufferCount == 0)
+    {
+        VKT_ERROR("Readback needs at least one staging buffer.");
+        return std::nullopt;
+    }
+
+    std::optional<ReadbackService> result{std::in_place, ReadbackService{}};
+    ReadbackService& readback{result.value()};
+
+    readback.m_allocator = allocator;
+    readback.m_framesInFlight = framesInFlight;
+    readback.m_pendingCallbacks = std::make_unique<JobCounter>();
+
+    for (uint32_t index{0}; index < stagingBufferCount; index++)
+    {
+        readback.m_stagingBuffers.push_back(std::make_unique<StagingBuffer>());
+    }
+
+    return result;
+}
+
+auto ReadbackService::recordCopy(
+    VkCommandBuffer const cmd,
+    Image& image,
+    VkRect2D const region,
+    ReadbackCallback callback
+) -> bool
+{
+    std::optional<VkDeviceSize> const texelSize{bytesPerTexel(image.format())};
+    if (!texelSize.has_value())
+    {
+        VKT_ERROR_RATE_LIMITED(
+            "Readback does not support image format {}.",
+            string_VkFormat(image.format())
+        );
+        return false;
+    }
+
+    VkExtent2D const imageExtent{image.extent2D()};
+    if (region.offset.x < 0 || region.offset.y < 0
+        || region.extent.width == 0 || region.extent.height == 0
+        || static_cast<uint32_t>(region.offset.x) + region.extent.width
+               > imageExtent.width
+        || static_cast<uint32_t>(region.offset.y) + region.extent.height
+               > imageExtent.height)
+    {
+        VKT_ERROR_RATE_LIMITED("Readback region is outside of the image.");
+        return false;
+    }
+
+    auto const staging{std::find_if(
+        m_stagingBuffers.begin(),
+        m_stagingBuffers.end(),
+        [](std::unique_ptr<StagingBuffer> const& staging)
+    { return staging->state.load() == StagingState::FREE; }
+    )};
+    if (staging == m_stagingBuffers.end())
+    {
+        VKT_WARNING_RATE_LIMITED(
+            "All {} readback staging buffers are in use, dropping copy.",
+            m_stagingBuffers.size()
+        );
+        return false;
+    }
+    StagingBuffer& buffer{**staging};
+
+    VkDeviceSize const size{
+        static_cast<VkDeviceSize>(region.extent.width) * region.extent.height
+        * texelSize.value()
+    };
+    if (!reserve(buffer, size))
+    {
+        return false;
+    }
+
+    image.recordTransitionBarriered(
+        cmd, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_ASPECT_COLOR_BIT
+    );
+
+    // Zero row length and height mean the rows are tightly packed
+    VkBufferImageCopy2 const copyRegion{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
+        .pNext = nullptr,
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = imageSubresourceLayers(VK_IMAGE_ASPECT_COLOR_BIT),
+        .imageOffset = VkOffset3D{region.offset.x, region.offset.y, 0},
+        .imageExtent =
+            VkExtent3D{region.extent.width, region.extent.height, 1},
+    };
+    VkCopyImageToBufferInfo2 const copyInfo{
+        .sType = VK_STRUCTURE_TYPE_COPY_IMAGE_TO_BUFFER_INFO_2,
+        .pNext = nullptr,
+        .srcImage = image.image(),
+        .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .dstBuffer = buffer.buffer,
+        .regionCount = 1,
+        .pRegions = &copyRegion,
+    };
+    vkCmdCopyImageToBuffer2(cmd, &copyInfo);
+
+    // Makes the copy visible to the host once the frame's fence signals
+    VkBufferMemoryBarrier2 const hostBarrier{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+        .pNext = nullptr,
+        .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+        .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+        .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer.buffer,
+        .offset = 0,
+        .size = size,
+    };
+    VkDependencyInfo const dependency{
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .pNext = nullptr,
+        .bufferMemoryBarrierCount = 1,
+        .pBufferMemoryBarriers = &hostBarrier,
+    };
+    vkCmdPipelineBarrier2(cmd, &dependency);
+
+    buffer.recordedFrame = m_frame;
+    buffer.result = ReadbackResult{
+        .extent = region.extent,
+        .format = image.format(),
+        .texels = std::span<std::byte const>{
+            buffer.mapped, static_cast<size_t>(size)
+        },
+    };
+    buffer.callback = std::move(callback);
+    buffer.state.store(StagingState::RECORDED);
+
+    return true;
+}
+
+void ReadbackService::advanceFrame(JobSystem& jobSystem)
+{
+    m_frame += 1;
+
+    for (std::unique_ptr<StagingBuffer> const& staging : m_stagingBuffers)
+    {
+        // Frames are waited on in order, so the fence waited on before this
+        // call covers every frame at least framesInFlight frames old.
+        if (staging->state.load() == StagingState::RECORDED
+            && staging->recordedFrame + m_framesInFlight <= m_frame)
+        {
+            consume(jobSystem, *staging);
+        }
+    }
+}
+
+void ReadbackService::flush(JobSystem& jobSystem)
+{
+    for (std::unique_ptr<StagingBuffer> const& staging : m_stagingBuffers)
+    {
+        if (staging->state.load() == StagingState::RECORDED)
+        {
+            consume(jobSystem, *staging);
+        }
+    }
+
+    jobSystem.wait(*m_pendingCallbacks);
+}
+
+auto ReadbackService::reserve(StagingBuffer& staging, VkDeviceSize const size)
+    -> bool
+{
+    if (staging.capacity >= size)
+    {
+        return true;
+    }
+
+    if (staging.allocation != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(m_allocator, staging.buffer, staging.allocation);
+        staging.buffer = VK_NULL_HANDLE;
+        staging.allocation = VK_NULL_HANDLE;
+        staging.capacity = 0;
+        staging.mapped = nullptr;
+    }
+
+    VkBufferCreateInfo const bufferInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+
+        .flags = 0,
+
+        .size = size,
+        .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
+    };
+
+    // Random host access picks cached memory, which the host reads quickly
+    VmaAllocationCreateInfo const allocationInfo{
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT
+               | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+    };
+
+    VmaAllocationInfo mappedInfo{};
+    VKT_TRY_VK(
+        vmaCreateBuffer(
+            m_allocator,
+            &bufferInfo,
+            &allocationInfo,
+            &staging.buffer,
+            &staging.allocation,
+            &mappedInfo
+        ),
+        "Failed to allocate readback staging buffer.",
+        false
+    );
+    staging.capacity = size;
+    staging.mapped = static_cast<std::byte*>(mappedInfo.pMappedData);
+
+    return true;
+}
+
+void ReadbackService::consume(JobSystem& jobSystem, StagingBuffer& staging)
+{
+    // Does nothing for coherent memory
+    VKT_CHECK_VK(vmaInvalidateAllocation(
+        m_allocator, staging.allocation, 0, VK_WHOLE_SIZE
+    ));
+
+    staging.state.store(StagingState::CONSUMING);
+    jobSystem.submit(
+        [&staging]()
+    {
+        staging.callback(staging.result);
+        staging.callback = nullptr;
+        staging.state.store(StagingState::FREE);
+    },
+        m_pendingCallbacks.get()
+    );
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkt
+{
+struct Image;
+struct JobCounter;
+struct JobSystem;
+} // namespace vkt
+
+namespace vkt
+{
+// Texels copied off of the device, valid only for the duration of the callback
+// they are passed to.
+struct ReadbackResult
+{
+    VkExtent2D extent{};
+    VkFormat format{VK_FORMAT_UNDEFINED};
+    // Rows from top to bottom, with no padding between them
+    std::span<std::byte const> texels{};
+};
+
+// Runs on a worker thread once the copy has finished on the device.
+using ReadbackCallback = std::function<void(ReadbackResult const&)>;
+
+// Copies image regions into host memory without stalling the frame. Copies are
+// recorded into the frame's command buffer, and retire with the frame's fence
+// like other per-frame resources, after which their callbacks run on workers.
+// Slow consumers, such as encoders writing files, then never block recording.
+//
+// Each copy in flight or being consumed holds one staging buffer. If none are
+// free, copies are refused rather than waiting for one.
+struct ReadbackService
+{
+public:
+    ReadbackService(ReadbackService const&) = delete;
+    auto operator=(ReadbackService const&) -> ReadbackService& = delete;
+
+    ReadbackService(ReadbackService&&) noexcept;
+    auto operator=(ReadbackService&&) noexcept -> ReadbackService&;
+
+    // Waits for callbacks that are still running.
+    ~ReadbackService();
+
+private:
+    ReadbackService() = default;
+    void destroy() noexcept;
+
+public:
+    // Staging buffers are allocated on first use, and grow to fit larger
+    // copies.
+    static auto create(
+        VmaAllocator, uint32_t stagingBufferCount, uint32_t framesInFlight
+    ) -> std::optional<ReadbackService>;
+
+    // Records a copy of region of image's color, which is transitioned to
+    // TRANSFER_SRC_OPTIMAL. Fails without recording anything if every staging
+    // buffer is in use or the format is not supported.
+    auto recordCopy(
+        VkCommandBuffer, Image&, VkRect2D region, ReadbackCallback callback
+    ) -> bool;
+
+    // Call once per frame, after waiting on that frame's fence. Hands copies
+    // from frames that have retired to the job system.
+    void advanceFrame(JobSystem&);
+
+    // Call once the device is idle. Hands every recorded copy to the job
+    // system and blocks until every callback has run.
+    void flush(JobSystem&);
+
+private:
+    enum class StagingState : uint8_t
+    {
+        FREE,
+        // Recorded into a frame that has not retired yet
+        RECORDED,
+        // Handed to a worker, which frees it once the callback returns
+        CONSUMING,
+    };
+
+    struct StagingBuffer
+    {
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VmaAllocation allocation{VK_NULL_HANDLE};
+        VkDeviceSize capacity{0};
+        std::byte* mapped{nullptr};
+
+        std::atomic<StagingState> state{StagingState::FREE};
+        uint64_t recordedFrame{0};
+        ReadbackResult result{};
+        ReadbackCallback callback{};
+    };
+
+    auto reserve(StagingBuffer&, VkDeviceSize size) -> bool;
+    void consume(JobSystem&, StagingBuffer&);
+
+    VmaAllocator m_allocator{VK_NULL_HANDLE};
+
+    // Held by pointer so workers can reference them while this moves
+    std::vector<std::unique_ptr<StagingBuffer>> m_stagingBuffers{};
+    std::unique_ptr<JobCounter> m_pendingCallbacks{};
+
+    uint64_t m_frame{0};
+    uint32_t m_framesInFlight{0};
+};
+} // namespace vkt
\ No newline at end of file
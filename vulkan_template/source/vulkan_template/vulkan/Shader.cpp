@@ -1,55 +1,61 @@
 #include "Shader.hpp"
 
+#include "vulkan_template/core/AssetArchive.hpp"
 #include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/core/MappedFile.hpp"
+#include "vulkan_template/vulkan/BindlessHeap.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
 #include "vulkan_template/vulkan/VulkanMacros.hpp"
-#include <fstream>
+#include <array>
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace detail
 {
-auto ensureAbsolutePath(
-    std::filesystem::path const& path,
-    std::filesystem::path const& root = std::filesystem::current_path()
-) -> std::filesystem::path
+// SPIR-V from the mounted archive when it has the shader, and otherwise mapped
+// from the file system. Bytes point into whichever of the two holds them.
+struct ShaderFile
 {
-    if (path.is_absolute())
-    {
-        return path;
-    }
-
-    return root / path;
-}
+    std::optional<vkt::MappedFile> mapped{};
+    std::vector<uint8_t> unpacked{};
+    std::span<uint8_t const> bytes{};
+};
 
-auto loadFileBytes(std::filesystem::path const& path) -> std::vector<uint8_t>
+auto loadShaderFile(std::filesystem::path const& path)
+    -> std::optional<ShaderFile>
 {
-    std::filesystem::path const assetPath{ensureAbsolutePath(path)};
-    std::ifstream file(path, std::ios::ate | std::ios::binary);
+    std::optional<ShaderFile> result{std::in_place};
+    ShaderFile& file{result.value()};
 
-    if (!file.is_open())
+    std::string const name{path.generic_string()};
+    vkt::AssetArchive const* const archive{vkt::mountedAssetArchive()};
+    if (archive != nullptr && archive->contains(name))
     {
-        VKT_ERROR("Unable to open file at {}", path.string());
-        return {};
+        file.bytes = archive->view(name);
+        if (!file.bytes.empty())
+        {
+            return result;
+        }
+
+        std::optional<std::vector<uint8_t>> unpacked{archive->read(name)};
+        if (!unpacked.has_value())
+        {
+            return std::nullopt;
+        }
+        file.unpacked = std::move(unpacked).value();
+        file.bytes = file.unpacked;
+        return result;
     }
 
-    size_t const fileSizeBytes = static_cast<size_t>(file.tellg());
-    if (fileSizeBytes == 0)
+    file.mapped = vkt::MappedFile::open(path);
+    if (!file.mapped.has_value())
     {
-        VKT_ERROR("File at empty at {}", path.string());
-        return {};
+        return std::nullopt;
     }
-
-    std::vector<uint8_t> buffer(fileSizeBytes);
-
-    file.seekg(0, std::ios::beg);
-    file.read(
-        reinterpret_cast<char*>(buffer.data()),
-        static_cast<std::streamsize>(fileSizeBytes)
-    );
-
-    file.close();
-
-    return buffer;
+    file.bytes = file.mapped.value().bytes();
+    return result;
 }
 
 auto computeDispatchCount(uint32_t invocations, uint32_t workgroupSize)
@@ -69,27 +75,16 @@ auto computeDispatchCount(uint32_t invocations, uint32_t workgroupSize)
     return count + 1;
 }
 
-} // namespace detail
-
-namespace vkt
-{
-auto loadShaderObject(
+auto createShaderObject(
     VkDevice const device,
-    std::filesystem::path const& path,
+    std::span<uint8_t const> const spirv,
     VkShaderStageFlagBits const stage,
     VkShaderStageFlags const nextStage,
     std::span<VkDescriptorSetLayout const> const layouts,
     std::span<VkPushConstantRange const> const pushConstantRanges,
-    VkSpecializationInfo const specializationInfo
+    VkSpecializationInfo const& specializationInfo
 ) -> std::optional<VkShaderEXT>
 {
-    std::vector<uint8_t> const fileBytes{detail::loadFileBytes(path)};
-    if (fileBytes.empty())
-    {
-        VKT_ERROR("Failed to load file for texture at '{}'", path.string());
-        return std::nullopt;
-    }
-
     VkShaderCreateInfoEXT const createInfo{
         .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
         .pNext = nullptr,
@@ -100,8 +95,8 @@ auto loadShaderObject(
         .nextStage = nextStage,
 
         .codeType = VkShaderCodeTypeEXT::VK_SHADER_CODE_TYPE_SPIRV_EXT,
-        .codeSize = fileBytes.size(),
-        .pCode = fileBytes.data(),
+        .codeSize = spirv.size_bytes(),
+        .pCode = spirv.data(),
 
         .pName = "main",
 
@@ -127,21 +122,383 @@ auto loadShaderObject(
 
     return shaderObject;
 }
+} // namespace detail
+
+namespace vkt
+{
+auto loadShaderObject(
+    VkDevice const device,
+    std::filesystem::path const& path,
+    VkShaderStageFlagBits const stage,
+    VkShaderStageFlags const nextStage,
+    std::span<VkDescriptorSetLayout const> const layouts,
+    std::span<VkPushConstantRange const> const pushConstantRanges,
+    VkSpecializationInfo const specializationInfo
+) -> std::optional<VkShaderEXT>
+{
+    std::optional<detail::ShaderFile> const file{detail::loadShaderFile(path)};
+    if (!file.has_value())
+    {
+        VKT_ERROR("Failed to load file for shader at '{}'", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const fileBytes{file.value().bytes};
+
+    return detail::createShaderObject(
+        device,
+        fileBytes,
+        stage,
+        nextStage,
+        layouts,
+        pushConstantRanges,
+        specializationInfo
+    );
+}
+
+auto reflectShaderFile(std::filesystem::path const& path)
+    -> std::optional<ShaderReflection>
+{
+    std::optional<detail::ShaderFile> const file{detail::loadShaderFile(path)};
+    if (!file.has_value())
+    {
+        VKT_ERROR("Failed to load file for shader at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    std::optional<ShaderReflection> reflectionResult{
+        ShaderReflection::reflect(file.value().bytes)
+    };
+    if (!reflectionResult.has_value())
+    {
+        VKT_ERROR("Failed to reflect shader at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    return reflectionResult;
+}
+
+auto loadReflectedShaderObject(
+    VkDevice const device,
+    DescriptorLayoutCache& layoutCache,
+    std::filesystem::path const& path,
+    VkShaderStageFlagBits const stage,
+    VkShaderStageFlags const nextStage,
+    VkSpecializationInfo const specializationInfo
+) -> std::optional<ReflectedShaderObject>
+{
+    std::optional<detail::ShaderFile> const file{detail::loadShaderFile(path)};
+    if (!file.has_value())
+    {
+        VKT_ERROR("Failed to load file for shader at '{}'", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const fileBytes{file.value().bytes};
+
+    std::optional<ShaderReflection> reflectionResult{
+        ShaderReflection::reflect(fileBytes)
+    };
+    if (!reflectionResult.has_value())
+    {
+        VKT_ERROR("Failed to reflect shader at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    ReflectedShaderObject result{
+        .reflection = std::move(reflectionResult).value(),
+    };
+
+    if (result.reflection.stage != stage)
+    {
+        VKT_ERROR(
+            "Shader at '{}' was reflected as stage {}, but was loaded as {}",
+            path.string(),
+            string_VkShaderStageFlagBits(result.reflection.stage),
+            string_VkShaderStageFlagBits(stage)
+        );
+        return std::nullopt;
+    }
+
+    for (DescriptorSetLayoutDescription const& description :
+         result.reflection.setLayouts)
+    {
+        std::optional<VkDescriptorSetLayout> const setLayoutResult{
+            layoutCache.getSetLayout(description)
+        };
+        if (!setLayoutResult.has_value())
+        {
+            VKT_ERROR(
+                "Failed to get reflected descriptor set layout for shader at "
+                "'{}'",
+                path.string()
+            );
+            return std::nullopt;
+        }
+        result.setLayouts.push_back(setLayoutResult.value());
+    }
+
+    if (std::optional<VkPipelineLayout> const pipelineLayoutResult{
+            layoutCache.getPipelineLayout(
+                result.setLayouts, result.reflection.pushConstantRanges
+            )
+        };
+        pipelineLayoutResult.has_value())
+    {
+        result.pipelineLayout = pipelineLayoutResult.value();
+    }
+    else
+    {
+        VKT_ERROR(
+            "Failed to get reflected pipeline layout for shader at '{}'",
+            path.string()
+        );
+        return std::nullopt;
+    }
+
+    if (std::optional<VkShaderEXT> const shaderResult{
+            detail::createShaderObject(
+                device,
+                fileBytes,
+                stage,
+                nextStage,
+                result.setLayouts,
+                result.reflection.pushConstantRanges,
+                specializationInfo
+            )
+        };
+        shaderResult.has_value())
+    {
+        result.shaderObject = shaderResult.value();
+    }
+    else
+    {
+        VKT_ERROR("Failed to create shader object at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+auto loadBindlessShaderObject(
+    VkDevice const device,
+    BindlessHeap const& heap,
+    DescriptorLayoutCache& layoutCache,
+    std::filesystem::path const& path,
+    VkShaderStageFlagBits const stage,
+    VkShaderStageFlags const nextStage,
+    VkSpecializationInfo const specializationInfo
+) -> std::optional<ReflectedShaderObject>
+{
+    std::optional<detail::ShaderFile> const file{detail::loadShaderFile(path)};
+    if (!file.has_value())
+    {
+        VKT_ERROR("Failed to load file for shader at '{}'", path.string());
+        return std::nullopt;
+    }
+    std::span<uint8_t const> const fileBytes{file.value().bytes};
+
+    std::optional<ShaderReflection> reflectionResult{
+        ShaderReflection::reflect(fileBytes)
+    };
+    if (!reflectionResult.has_value())
+    {
+        VKT_ERROR("Failed to reflect shader at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    ReflectedShaderObject result{
+        .reflection = std::move(reflectionResult).value(),
+    };
+
+    if (result.reflection.stage != stage)
+    {
+        VKT_ERROR(
+            "Shader at '{}' was reflected as stage {}, but was loaded as {}",
+            path.string(),
+            string_VkShaderStageFlagBits(result.reflection.stage),
+            string_VkShaderStageFlagBits(stage)
+        );
+        return std::nullopt;
+    }
+
+    uint32_t constexpr HEAP_SET{0};
+    uint32_t constexpr PUSH_DESCRIPTOR_SET{1};
+
+    if (result.reflection.setLayouts.size() > PUSH_DESCRIPTOR_SET + 1)
+    {
+        VKT_ERROR(
+            "Bindless shader at '{}' uses descriptor sets other than 0 and 1",
+            path.string()
+        );
+        return std::nullopt;
+    }
+
+    if (!result.reflection.setLayouts.empty())
+    {
+        for (auto const& binding :
+             result.reflection.setLayouts[HEAP_SET].bindings)
+        {
+            uint32_t constexpr MAX_BINDING{
+                static_cast<uint32_t>(BindlessBinding::SAMPLER)
+            };
+            if (binding.binding > MAX_BINDING
+                || binding.type
+                       != heap.descriptorType(
+                           static_cast<BindlessBinding>(binding.binding)
+                       ))
+            {
+                VKT_ERROR(
+                    "Bindless shader at '{}' declares binding {} as {}, which "
+                    "does not match the bindless heap",
+                    path.string(),
+                    binding.binding,
+                    string_VkDescriptorType(binding.type)
+                );
+                return std::nullopt;
+            }
+        }
+    }
+
+    if (result.reflection.pushConstantSize() > BindlessHeap::PUSH_CONSTANT_SIZE)
+    {
+        VKT_ERROR(
+            "Bindless shader at '{}' has {} bytes of push constants, which "
+            "exceeds the shared range of {} bytes",
+            path.string(),
+            result.reflection.pushConstantSize(),
+            BindlessHeap::PUSH_CONSTANT_SIZE
+        );
+        return std::nullopt;
+    }
+
+    result.pipelineLayout = heap.pipelineLayout();
+    result.setLayouts = {heap.setLayout()};
+
+    VkPushConstantRange const pushConstantRange{heap.pushConstantRange()};
+
+    if (result.reflection.setLayouts.size() > PUSH_DESCRIPTOR_SET)
+    {
+        DescriptorSetLayoutDescription& pushDescription{
+            result.reflection.setLayouts[PUSH_DESCRIPTOR_SET]
+        };
+        pushDescription.flags |=
+            VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+
+        std::optional<VkDescriptorSetLayout> const pushLayoutResult{
+            layoutCache.getSetLayout(pushDescription)
+        };
+        if (!pushLayoutResult.has_value())
+        {
+            VKT_ERROR(
+                "Failed to get push descriptor set layout for shader at '{}'",
+                path.string()
+            );
+            return std::nullopt;
+        }
+        result.setLayouts.push_back(pushLayoutResult.value());
+
+        if (std::optional<VkPipelineLayout> const pipelineLayoutResult{
+                layoutCache.getPipelineLayout(
+                    result.setLayouts, std::span{&pushConstantRange, 1}
+                )
+            };
+            pipelineLayoutResult.has_value())
+        {
+            result.pipelineLayout = pipelineLayoutResult.value();
+        }
+        else
+        {
+            VKT_ERROR(
+                "Failed to get pipeline layout for shader at '{}'",
+                path.string()
+            );
+            return std::nullopt;
+        }
+    }
+    if (std::optional<VkShaderEXT> const shaderResult{
+            detail::createShaderObject(
+                device,
+                fileBytes,
+                stage,
+                nextStage,
+                result.setLayouts,
+                std::span{&pushConstantRange, 1},
+                specializationInfo
+            )
+        };
+        shaderResult.has_value())
+    {
+        result.shaderObject = shaderResult.value();
+    }
+    else
+    {
+        VKT_ERROR("Failed to create shader object at '{}'", path.string());
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+auto ComputeSpecialization::info() const -> VkSpecializationInfo
+{
+    return VkSpecializationInfo{
+        .mapEntryCount = count,
+        .pMapEntries = entries.data(),
+        .dataSize = count * sizeof(uint32_t),
+        .pData = values.data(),
+    };
+}
+
+auto computeSpecialization(
+    WorkgroupSize const size, std::span<uint32_t const> const constants
+) -> ComputeSpecialization
+{
+    ComputeSpecialization specialization{};
+
+    auto const add{[&](uint32_t const value)
+    {
+        if (specialization.count == ComputeSpecialization::MAX_CONSTANTS)
+        {
+            VKT_ERROR(
+                "More than {} specialization constants, dropping {}.",
+                ComputeSpecialization::MAX_CONSTANTS,
+                value
+            );
+            return;
+        }
+
+        uint32_t const index{specialization.count};
+        specialization.values[index] = value;
+        specialization.entries[index] = VkSpecializationMapEntry{
+            .constantID = index,
+            .offset = static_cast<uint32_t>(index * sizeof(uint32_t)),
+            .size = sizeof(uint32_t),
+        };
+        specialization.count += 1;
+    }};
+
+    add(size.x);
+    add(size.y);
+    for (uint32_t const constant : constants)
+    {
+        add(constant);
+    }
+
+    return specialization;
+}
+
 void computeDispatch(
     VkCommandBuffer const cmd,
     VkExtent3D const invocations,
-    uint32_t const workgroupSize
+    WorkgroupSize const workgroupSize
 )
 {
     uint32_t const X{
-        detail::computeDispatchCount(invocations.width, workgroupSize)
+        detail::computeDispatchCount(invocations.width, workgroupSize.x)
     };
     uint32_t const Y{
-        detail::computeDispatchCount(invocations.height, workgroupSize)
-    };
-    uint32_t const Z{
-        detail::computeDispatchCount(invocations.depth, workgroupSize)
+        detail::computeDispatchCount(invocations.height, workgroupSize.y)
     };
+    uint32_t const Z{invocations.depth};
 
     vkCmdDispatch(cmd, X, Y, Z);
 }
@@ -1,13 +1,59 @@
 #pragma once
 
 #include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/ShaderReflection.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <array>
 #include <filesystem>
 #include <optional>
 #include <span>
+#include <vector>
 
 namespace vkt
 {
+struct BindlessHeap;
+struct DescriptorLayoutCache;
+} // namespace vkt
+
+namespace vkt
+{
+// Compute workgroup dimensions. Shaders receive these through specialization
+// constants 0 and 1, by declaring:
+//
+// layout(local_size_x_id = 0, local_size_y_id = 1) in;
+struct WorkgroupSize
+{
+    uint32_t x{16};
+    uint32_t y{16};
+
+    auto operator==(WorkgroupSize const&) const -> bool = default;
+};
+
+// Specialization data for a compute shader: the workgroup size as constants 0
+// and 1, followed by the shader's own constants as 2, 3, and so on. Every
+// constant is 32 bits, which covers bool, int, uint, and float constants.
+struct ComputeSpecialization
+{
+    static size_t constexpr MAX_CONSTANTS{8};
+
+    std::array<uint32_t, MAX_CONSTANTS> values{};
+    std::array<VkSpecializationMapEntry, MAX_CONSTANTS> entries{};
+    uint32_t count{0};
+
+    // The returned info points into this object, so it must outlive its use.
+    [[nodiscard]] auto info() const -> VkSpecializationInfo;
+};
+
+// Constants past MAX_CONSTANTS in total are dropped with an error.
+auto computeSpecialization(
+    WorkgroupSize size, std::span<uint32_t const> constants = {}
+) -> ComputeSpecialization;
+
+// Reads and reflects the SPIR-V at path, from the mounted archive or the file
+// system as loading does, without needing a device.
+auto reflectShaderFile(std::filesystem::path const& path)
+    -> std::optional<ShaderReflection>;
+
 auto loadShaderObject(
     VkDevice,
     std::filesystem::path const& path,
@@ -18,7 +64,64 @@ auto loadShaderObject(
     VkSpecializationInfo specializationInfo
 ) -> std::optional<VkShaderEXT>;
 
+// A shader object along with the layouts derived from its SPIR-V. The layouts
+// are owned by the DescriptorLayoutCache, so only the shader object needs to be
+// destroyed by the caller.
+struct ReflectedShaderObject
+{
+    VkShaderEXT shaderObject{VK_NULL_HANDLE};
+    VkPipelineLayout pipelineLayout{VK_NULL_HANDLE};
+
+    // Indexed by set number, matching the pipeline layout.
+    std::vector<VkDescriptorSetLayout> setLayouts{};
+
+    ShaderReflection reflection{};
+};
+
+// Loads a shader object whose descriptor set layouts, push constant ranges,
+// and pipeline layout are reflected from the SPIR-V instead of specified by
+// hand. Layouts are shared through the cache with any other shader or system
+// that uses an identical layout.
+auto loadReflectedShaderObject(
+    VkDevice,
+    DescriptorLayoutCache&,
+    std::filesystem::path const& path,
+    VkShaderStageFlagBits stage,
+    VkShaderStageFlags nextStage,
+    VkSpecializationInfo specializationInfo
+) -> std::optional<ReflectedShaderObject>;
+
+// Loads a shader object that reads its resources from the BindlessHeap. The
+// reflected interface is validated against the heap: set 0 bindings must match
+// the heap's descriptor types, and the push constant block must fit within the
+// heap's shared range.
+//
+// The shader may also declare set 1, which becomes a push descriptor set for
+// per-pass inputs (see PushDescriptorTemplate). Its reflected description is
+// left in reflection.setLayouts[1] with the push descriptor flag set. Without
+// set 1, the returned pipeline layout is the heap's. Either way, set 0 stays
+// compatible so the bound heap is not disturbed.
+auto loadBindlessShaderObject(
+    VkDevice,
+    BindlessHeap const&,
+    DescriptorLayoutCache&,
+    std::filesystem::path const& path,
+    VkShaderStageFlagBits stage,
+    VkShaderStageFlags nextStage,
+    VkSpecializationInfo specializationInfo
+) -> std::optional<ReflectedShaderObject>;
+
+// Dispatches enough workgroups to cover invocations. Extra invocations past the
+// edges must be discarded by the shader.
 void computeDispatch(
-    VkCommandBuffer, VkExtent3D invocations, uint32_t workgroupSize
+    VkCommandBuffer, VkExtent3D invocations, WorkgroupSize workgroupSize
 );
-} // namespace vkt
\ No newline at end of file
+} // namespace vkt
+
+// Internals of shader loading, declared so benchmarks can reach them.
+namespace detail
+{
+// Workgroups needed along one axis to cover invocations.
+auto computeDispatchCount(uint32_t invocations, uint32_t workgroupSize)
+    -> uint32_t;
+} // namespace detail
\ No newline at end of file
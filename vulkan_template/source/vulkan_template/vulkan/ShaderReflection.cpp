@@ -0,0 +1,181 @@
+#include "ShaderReflection.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include <algorithm>
+#include <spirv_reflect.h>
+
+namespace
+{
+auto reflectModule(SpvReflectShaderModule const& module)
+    -> std::optional<vkt::ShaderReflection>
+{
+    vkt::ShaderReflection reflection{
+        .stage = static_cast<VkShaderStageFlagBits>(module.shader_stage),
+    };
+
+    uint32_t setCount{0};
+    if (spvReflectEnumerateDescriptorSets(&module, &setCount, nullptr)
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected descriptor sets.");
+        return std::nullopt;
+    }
+    std::vector<SpvReflectDescriptorSet*> sets(setCount);
+    if (spvReflectEnumerateDescriptorSets(&module, &setCount, sets.data())
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected descriptor sets.");
+        return std::nullopt;
+    }
+
+    for (SpvReflectDescriptorSet const* const set : sets)
+    {
+        if (set->set >= reflection.setLayouts.size())
+        {
+            reflection.setLayouts.resize(set->set + 1);
+        }
+
+        vkt::DescriptorSetLayoutDescription& layout{
+            reflection.setLayouts[set->set]
+        };
+
+        for (uint32_t index{0}; index < set->binding_count; index++)
+        {
+            SpvReflectDescriptorBinding const& binding{*set->bindings[index]};
+
+            layout.bindings.push_back({
+                .binding = binding.binding,
+                // SpvReflectDescriptorType mirrors VkDescriptorType's values
+                .type = static_cast<VkDescriptorType>(binding.descriptor_type),
+                .count = binding.count,
+                .stageMask = static_cast<VkShaderStageFlags>(reflection.stage),
+                .bindingFlags = 0,
+            });
+        }
+
+        // Sort so that descriptions compare equal regardless of the order
+        // bindings appear in the SPIR-V.
+        std::sort(
+            layout.bindings.begin(),
+            layout.bindings.end(),
+            [](auto const& lhs, auto const& rhs)
+        { return lhs.binding < rhs.binding; }
+        );
+    }
+
+    uint32_t blockCount{0};
+    if (spvReflectEnumeratePushConstantBlocks(&module, &blockCount, nullptr)
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected push constant blocks.");
+        return std::nullopt;
+    }
+    std::vector<SpvReflectBlockVariable*> blocks(blockCount);
+    if (spvReflectEnumeratePushConstantBlocks(
+            &module, &blockCount, blocks.data()
+        )
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected push constant blocks.");
+        return std::nullopt;
+    }
+
+    for (SpvReflectBlockVariable const* const block : blocks)
+    {
+        // spirv-reflect pads block->size out to a multiple of 16 bytes, as if
+        // the block were a std140 array element. The range only needs to
+        // reach the end of the last member, which is also the size of the
+        // matching host-side struct.
+        uint32_t end{block->offset};
+        for (uint32_t index{0}; index < block->member_count; index++)
+        {
+            SpvReflectBlockVariable const& member{block->members[index]};
+            end = std::max(end, member.offset + member.size);
+        }
+
+        // Range sizes must be a multiple of 4
+        uint32_t constexpr RANGE_ALIGNMENT{4};
+        end = (end + RANGE_ALIGNMENT - 1) / RANGE_ALIGNMENT * RANGE_ALIGNMENT;
+
+        reflection.pushConstantRanges.push_back(VkPushConstantRange{
+            .stageFlags = static_cast<VkShaderStageFlags>(reflection.stage),
+            .offset = block->offset,
+            .size = end - block->offset,
+        });
+    }
+
+    uint32_t constantCount{0};
+    if (spvReflectEnumerateSpecializationConstants(
+            &module, &constantCount, nullptr
+        )
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected specialization constants.");
+        return std::nullopt;
+    }
+    std::vector<SpvReflectSpecializationConstant*> constants(constantCount);
+    if (spvReflectEnumerateSpecializationConstants(
+            &module, &constantCount, constants.data()
+        )
+        != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR("Failed to enumerate reflected specialization constants.");
+        return std::nullopt;
+    }
+
+    for (SpvReflectSpecializationConstant const* const constant : constants)
+    {
+        reflection.specializationConstantIds.push_back(constant->constant_id);
+    }
+
+    return reflection;
+}
+} // namespace
+
+namespace vkt
+{
+auto ShaderReflection::reflect(std::span<uint8_t const> const spirv)
+    -> std::optional<ShaderReflection>
+{
+    SpvReflectShaderModule module{};
+    if (SpvReflectResult const createResult{spvReflectCreateShaderModule(
+            spirv.size_bytes(), spirv.data(), &module
+        )};
+        createResult != SPV_REFLECT_RESULT_SUCCESS)
+    {
+        VKT_ERROR(
+            "Failed to reflect SPIR-V, spirv-reflect error code {}.",
+            static_cast<int32_t>(createResult)
+        );
+        return std::nullopt;
+    }
+
+    std::optional<ShaderReflection> result{reflectModule(module)};
+
+    spvReflectDestroyShaderModule(&module);
+
+    return result;
+}
+
+auto ShaderReflection::pushConstantSize() const -> uint32_t
+{
+    uint32_t size{0};
+    for (VkPushConstantRange const& range : pushConstantRanges)
+    {
+        size = std::max(size, range.offset + range.size);
+    }
+    return size;
+}
+
+auto ShaderReflection::declaresSpecializationConstant(
+    uint32_t const constantId
+) const -> bool
+{
+    return std::find(
+               specializationConstantIds.begin(),
+               specializationConstantIds.end(),
+               constantId
+           )
+        != specializationConstantIds.end();
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/DescriptorLayoutCache.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace vkt
+{
+// The resource interface of a single SPIR-V entry point, as read back by
+// spirv-reflect.
+struct ShaderReflection
+{
+    VkShaderStageFlagBits stage{VK_SHADER_STAGE_COMPUTE_BIT};
+
+    // Indexed by set number. Set numbers that the shader skips are left as
+    // empty descriptions, so this can be turned directly into a pipeline
+    // layout.
+    std::vector<DescriptorSetLayoutDescription> setLayouts{};
+
+    // Each range ends at the last byte of the block's last member, rounded up
+    // to 4 bytes. This is unlike spirv-reflect's block size, which includes
+    // std140-style padding out to 16 bytes.
+    std::vector<VkPushConstantRange> pushConstantRanges{};
+
+    // The SpecId of every specialization constant, including those that
+    // LocalSizeId uses for the workgroup size.
+    std::vector<uint32_t> specializationConstantIds{};
+
+    static auto reflect(std::span<uint8_t const> spirv)
+        -> std::optional<ShaderReflection>;
+
+    // Total size of the push constant block, or 0 if there is none.
+    [[nodiscard]] auto pushConstantSize() const -> uint32_t;
+
+    [[nodiscard]] auto declaresSpecializationConstant(uint32_t constantId) const
+        -> bool;
+};
+} // namespace vkt
\ No newline at end of file
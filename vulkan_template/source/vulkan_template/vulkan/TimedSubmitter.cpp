@@ -0,0 +1,283 @@
+#include "TimedSubmitter.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <utility>
+#include <vector>
+
+namespace vkt
+{
+TimedSubmitter::TimedSubmitter(TimedSubmitter&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto TimedSubmitter::operator=(TimedSubmitter&& other) noexcept
+    -> TimedSubmitter&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_queue = std::exchange(other.m_queue, VK_NULL_HANDLE);
+
+    m_commandPool = std::exchange(other.m_commandPool, VK_NULL_HANDLE);
+    m_commandBuffer = std::exchange(other.m_commandBuffer, VK_NULL_HANDLE);
+    m_fence = std::exchange(other.m_fence, VK_NULL_HANDLE);
+
+    m_timestampPool = std::exchange(other.m_timestampPool, VK_NULL_HANDLE);
+    m_timestampCount = std::exchange(other.m_timestampCount, 0);
+    m_timestampPeriod = std::exchange(other.m_timestampPeriod, 1.0);
+
+    return *this;
+}
+
+TimedSubmitter::~TimedSubmitter() { destroy(); }
+
+void TimedSubmitter::destroy() noexcept
+{
+    if (m_device != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(m_device, m_timestampPool, nullptr);
+        vkDestroyFence(m_device, m_fence, nullptr);
+        // Frees the command buffer along with the pool
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    }
+
+    m_device = VK_NULL_HANDLE;
+    m_queue = VK_NULL_HANDLE;
+    m_commandPool = VK_NULL_HANDLE;
+    m_commandBuffer = VK_NULL_HANDLE;
+    m_fence = VK_NULL_HANDLE;
+    m_timestampPool = VK_NULL_HANDLE;
+    m_timestampCount = 0;
+    m_timestampPeriod = 1.0;
+}
+
+auto TimedSubmitter::create(
+    VkPhysicalDevice const physicalDevice,
+    VkDevice const device,
+    VkQueue const queue,
+    uint32_t const queueFamilyIndex,
+    uint32_t const timestampCount
+) -> std::optional<TimedSubmitter>
+{
+    std::optional<TimedSubmitter> result{std::in_place, TimedSubmitter{}};
+    TimedSubmitter& submitter{result.value()};
+
+    submitter.m_device = device;
+    submitter.m_queue = queue;
+
+    VkCommandPoolCreateInfo const commandPoolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queueFamilyIndex,
+    };
+    VKT_TRY_VK(
+        vkCreateCommandPool(
+            device, &commandPoolInfo, nullptr, &submitter.m_commandPool
+        ),
+        "Failed to create timed submitter command pool.",
+        std::nullopt
+    );
+
+    VkCommandBufferAllocateInfo const cmdAllocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = submitter.m_commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    VKT_TRY_VK(
+        vkAllocateCommandBuffers(
+            device, &cmdAllocInfo, &submitter.m_commandBuffer
+        ),
+        "Failed to allocate timed submitter command buffer.",
+        std::nullopt
+    );
+
+    VkFenceCreateInfo const fenceInfo{fenceCreateInfo()};
+    VKT_TRY_VK(
+        vkCreateFence(device, &fenceInfo, nullptr, &submitter.m_fence),
+        "Failed to create timed submitter fence.",
+        std::nullopt
+    );
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    submitter.m_timestampPeriod =
+        static_cast<double>(properties.limits.timestampPeriod);
+
+    uint32_t queueFamilyCount{0};
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice, &queueFamilyCount, nullptr
+    );
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice, &queueFamilyCount, queueFamilies.data()
+    );
+
+    bool const timestampsSupported{
+        queueFamilyIndex < queueFamilies.size()
+        && queueFamilies[queueFamilyIndex].timestampValidBits > 0
+        && properties.limits.timestampPeriod > 0.0F
+    };
+    if (!timestampsSupported || timestampCount == 0)
+    {
+        return result;
+    }
+
+    VkQueryPoolCreateInfo const queryPoolInfo{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = timestampCount,
+        .pipelineStatistics = 0,
+    };
+    VKT_TRY_VK(
+        vkCreateQueryPool(
+            device, &queryPoolInfo, nullptr, &submitter.m_timestampPool
+        ),
+        "Failed to create timed submitter timestamp query pool.",
+        std::nullopt
+    );
+    submitter.m_timestampCount = timestampCount;
+
+    return result;
+}
+
+auto TimedSubmitter::begin() -> std::optional<VkCommandBuffer>
+{
+    VKT_TRY_VK(
+        vkResetCommandBuffer(m_commandBuffer, 0),
+        "Failed to reset timed submitter commands.",
+        std::nullopt
+    );
+
+    VkCommandBufferBeginInfo const beginInfo{
+        commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+    };
+    VKT_TRY_VK(
+        vkBeginCommandBuffer(m_commandBuffer, &beginInfo),
+        "Failed to begin timed submitter commands.",
+        std::nullopt
+    );
+
+    if (m_timestampPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(
+            m_commandBuffer, m_timestampPool, 0, m_timestampCount
+        );
+    }
+
+    return m_commandBuffer;
+}
+
+void TimedSubmitter::writeTimestamp(uint32_t const index)
+{
+    if (m_timestampPool == VK_NULL_HANDLE)
+    {
+        return;
+    }
+    if (index >= m_timestampCount)
+    {
+        VKT_ERROR(
+            "Timestamp {} is out of range of the {} timestamps.",
+            index,
+            m_timestampCount
+        );
+        return;
+    }
+
+    vkCmdWriteTimestamp2(
+        m_commandBuffer,
+        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        m_timestampPool,
+        index
+    );
+}
+
+auto TimedSubmitter::submitAndWait() -> VkResult
+{
+    VKT_PROPAGATE_VK(
+        vkEndCommandBuffer(m_commandBuffer),
+        "Failed to end timed submitter commands."
+    );
+
+    std::vector<VkCommandBufferSubmitInfo> const cmdSubmitInfos{
+        commandBufferSubmitInfo(m_commandBuffer)
+    };
+    std::vector<VkSemaphoreSubmitInfo> const waitInfos{};
+    std::vector<VkSemaphoreSubmitInfo> const signalInfos{};
+    VkSubmitInfo2 const submission{
+        submitInfo(cmdSubmitInfos, waitInfos, signalInfos)
+    };
+
+    VKT_PROPAGATE_VK(
+        vkQueueSubmit2(m_queue, 1, &submission, m_fence),
+        "Failed to submit timed submitter commands."
+    );
+
+    // Software drivers run slowly, so this is generous
+    uint64_t constexpr TIMEOUT_NANOSECONDS{60'000'000'000};
+    VKT_PROPAGATE_VK(
+        vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, TIMEOUT_NANOSECONDS),
+        "Failed to wait on timed submitter fence."
+    );
+
+    VKT_PROPAGATE_VK(
+        vkResetFences(m_device, 1, &m_fence),
+        "Failed to reset timed submitter fence."
+    );
+
+    return VK_SUCCESS;
+}
+
+auto TimedSubmitter::millisecondsBetween(
+    uint32_t const first, uint32_t const second
+) const -> std::optional<double>
+{
+    if (m_timestampPool == VK_NULL_HANDLE || first >= m_timestampCount
+        || second >= m_timestampCount)
+    {
+        return std::nullopt;
+    }
+
+    auto const readTicks{[&](uint32_t const index) -> std::optional<uint64_t>
+    {
+        uint64_t ticks{0};
+        VKT_TRY_VK(
+            vkGetQueryPoolResults(
+                m_device,
+                m_timestampPool,
+                index,
+                1,
+                sizeof(ticks),
+                &ticks,
+                sizeof(ticks),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT
+            ),
+            "Failed to read timed submitter timestamps.",
+            std::nullopt
+        );
+        return ticks;
+    }};
+
+    std::optional<uint64_t> const firstTicks{readTicks(first)};
+    std::optional<uint64_t> const secondTicks{readTicks(second)};
+    if (!firstTicks.has_value() || !secondTicks.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<double>(secondTicks.value() - firstTicks.value())
+         * m_timestampPeriod / 1'000'000.0;
+}
+
+auto TimedSubmitter::timestampsSupported() const -> bool
+{
+    return m_timestampPool != VK_NULL_HANDLE;
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <optional>
+
+namespace vkt
+{
+// Records into one command buffer and waits on each submission, with
+// timestamps between recorded commands when the queue supports them. Meant for
+// tools and tests that measure GPU work, rather than for frames.
+struct TimedSubmitter
+{
+public:
+    TimedSubmitter(TimedSubmitter const&) = delete;
+    auto operator=(TimedSubmitter const&) -> TimedSubmitter& = delete;
+
+    TimedSubmitter(TimedSubmitter&&) noexcept;
+    auto operator=(TimedSubmitter&&) noexcept -> TimedSubmitter&;
+
+    ~TimedSubmitter();
+
+private:
+    TimedSubmitter() = default;
+    void destroy() noexcept;
+
+public:
+    // QueueFamilyIndex must be the family of queue. Fails only on Vulkan
+    // errors, so a queue without timestamps still gets a submitter.
+    static auto create(
+        VkPhysicalDevice,
+        VkDevice,
+        VkQueue,
+        uint32_t queueFamilyIndex,
+        uint32_t timestampCount
+    ) -> std::optional<TimedSubmitter>;
+
+    // Resets and begins the command buffer for a one time submission, and
+    // resets every timestamp.
+    auto begin() -> std::optional<VkCommandBuffer>;
+
+    // Writes a timestamp once all previous commands have completed. Does
+    // nothing if the queue does not support timestamps.
+    void writeTimestamp(uint32_t index);
+
+    // Ends the command buffer, submits it, and waits until it completes.
+    auto submitAndWait() -> VkResult;
+
+    // Milliseconds between two timestamps written in the last submission.
+    [[nodiscard]] auto millisecondsBetween(uint32_t first, uint32_t second)
+        const -> std::optional<double>;
+
+    [[nodiscard]] auto timestampsSupported() const -> bool;
+
+private:
+    VkDevice m_device{VK_NULL_HANDLE};
+    VkQueue m_queue{VK_NULL_HANDLE};
+
+    VkCommandPool m_commandPool{VK_NULL_HANDLE};
+    VkCommandBuffer m_commandBuffer{VK_NULL_HANDLE};
+    VkFence m_fence{VK_NULL_HANDLE};
+
+    // Null when the queue does not support timestamps
+    VkQueryPool m_timestampPool{VK_NULL_HANDLE};
+    uint32_t m_timestampCount{0};
+    // Nanoseconds per timestamp tick.
+    double m_timestampPeriod{1.0};
+};
+} // namespace vkt
\ No newline at end of file
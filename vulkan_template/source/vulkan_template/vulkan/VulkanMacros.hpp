@@ -39,6 +39,7 @@
             VKT_ERROR(                                                         \
                 "VkError {} detected.", string_VkResult(VKT_CHECK_result)      \
             )                                                                  \
+            vkt::Logger::flush();                                              \
             assert(VKT_CHECK_result == VK_SUCCESS);                            \
         }                                                                      \
     }
@@ -1,5 +1,7 @@
 #include "VulkanStructs.hpp"
 
+#include "vulkan_template/core/LinearArena.hpp"
+
 namespace vkt
 {
 auto fenceCreateInfo(VkFenceCreateFlags const flags) -> VkFenceCreateInfo
@@ -85,9 +87,9 @@ auto commandBufferSubmitInfo(VkCommandBuffer const cmd)
 }
 
 auto submitInfo(
-    std::vector<VkCommandBufferSubmitInfo> const& cmdInfo,
-    std::vector<VkSemaphoreSubmitInfo> const& waitSemaphoreInfo,
-    std::vector<VkSemaphoreSubmitInfo> const& signalSemaphoreInfo
+    std::span<VkCommandBufferSubmitInfo const> const cmdInfo,
+    std::span<VkSemaphoreSubmitInfo const> const waitSemaphoreInfo,
+    std::span<VkSemaphoreSubmitInfo const> const signalSemaphoreInfo
 ) -> VkSubmitInfo2
 {
     return {
@@ -109,6 +111,20 @@ auto submitInfo(
     };
 }
 
+auto submitInfo(
+    LinearArena& arena,
+    std::initializer_list<VkCommandBufferSubmitInfo> const cmdInfo,
+    std::initializer_list<VkSemaphoreSubmitInfo> const waitSemaphoreInfo,
+    std::initializer_list<VkSemaphoreSubmitInfo> const signalSemaphoreInfo
+) -> VkSubmitInfo2
+{
+    return submitInfo(
+        arena.copy(std::span{cmdInfo}),
+        arena.copy(std::span{waitSemaphoreInfo}),
+        arena.copy(std::span{signalSemaphoreInfo})
+    );
+}
+
 auto imageCreateInfo(
     VkFormat const format,
     VkImageLayout const initialLayout,
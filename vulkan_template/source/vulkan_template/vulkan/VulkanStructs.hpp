@@ -2,10 +2,15 @@
 
 #include "vulkan_template/core/Integer.hpp"
 #include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <initializer_list>
 #include <optional>
 #include <span>
 #include <string>
-#include <vector>
+
+namespace vkt
+{
+struct LinearArena;
+} // namespace vkt
 
 // Shorthand factory methods for data-holding Vulkan structs, with reasonable
 // defaults.
@@ -31,9 +36,17 @@ auto semaphoreSubmitInfo(VkPipelineStageFlags2 stageMask, VkSemaphore semaphore)
     -> VkSemaphoreSubmitInfo;
 auto commandBufferSubmitInfo(VkCommandBuffer cmd) -> VkCommandBufferSubmitInfo;
 auto submitInfo(
-    std::vector<VkCommandBufferSubmitInfo> const& cmdInfo,
-    std::vector<VkSemaphoreSubmitInfo> const& waitSemaphoreInfo,
-    std::vector<VkSemaphoreSubmitInfo> const& signalSemaphoreInfo
+    std::span<VkCommandBufferSubmitInfo const> cmdInfo,
+    std::span<VkSemaphoreSubmitInfo const> waitSemaphoreInfo,
+    std::span<VkSemaphoreSubmitInfo const> signalSemaphoreInfo
+) -> VkSubmitInfo2;
+// Copies the infos into arena, so they may be temporaries. The result points
+// into arena, and is valid until it is reset.
+auto submitInfo(
+    LinearArena& arena,
+    std::initializer_list<VkCommandBufferSubmitInfo> cmdInfo,
+    std::initializer_list<VkSemaphoreSubmitInfo> waitSemaphoreInfo,
+    std::initializer_list<VkSemaphoreSubmitInfo> signalSemaphoreInfo
 ) -> VkSubmitInfo2;
 
 auto imageCreateInfo(
@@ -0,0 +1,505 @@
+#include "WorkgroupAutotuner.hpp"
+
+#include "vulkan_template/core/Log.hpp"
+#include "vulkan_template/vulkan/VulkanMacros.hpp"
+#include "vulkan_template/vulkan/VulkanStructs.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// Each sample records the workload this many times, to amortize submission
+// overhead and timer granularity.
+uint32_t constexpr RUNS_PER_SAMPLE{4};
+uint32_t constexpr SAMPLES{5};
+
+std::array<vkt::WorkgroupSize, 8> constexpr DEFAULT_CANDIDATES{
+    vkt::WorkgroupSize{.x = 16, .y = 16},
+    vkt::WorkgroupSize{.x = 8, .y = 8},
+    vkt::WorkgroupSize{.x = 32, .y = 8},
+    vkt::WorkgroupSize{.x = 8, .y = 32},
+    vkt::WorkgroupSize{.x = 32, .y = 32},
+    vkt::WorkgroupSize{.x = 64, .y = 4},
+    vkt::WorkgroupSize{.x = 16, .y = 8},
+    vkt::WorkgroupSize{.x = 64, .y = 1},
+};
+
+auto createDeviceKey(VkPhysicalDeviceProperties const& properties)
+    -> std::string
+{
+    std::string uuid{};
+    for (uint8_t const byte : properties.pipelineCacheUUID)
+    {
+        uuid += fmt::format("{:02x}", byte);
+    }
+
+    return fmt::format(
+        "{:04x}-{:04x}-{:08x}-{}",
+        properties.vendorID,
+        properties.deviceID,
+        properties.driverVersion,
+        uuid
+    );
+}
+
+auto cacheKey(std::string const& deviceKey, std::string const& key)
+    -> std::string
+{
+    return deviceKey + " " + key;
+}
+} // namespace
+
+namespace vkt
+{
+WorkgroupAutotuner::WorkgroupAutotuner(WorkgroupAutotuner&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+auto WorkgroupAutotuner::operator=(WorkgroupAutotuner&& other) noexcept
+    -> WorkgroupAutotuner&
+{
+    destroy();
+
+    m_device = std::exchange(other.m_device, VK_NULL_HANDLE);
+    m_queue = std::exchange(other.m_queue, VK_NULL_HANDLE);
+
+    m_commandPool = std::exchange(other.m_commandPool, VK_NULL_HANDLE);
+    m_commandBuffer = std::exchange(other.m_commandBuffer, VK_NULL_HANDLE);
+    m_fence = std::exchange(other.m_fence, VK_NULL_HANDLE);
+
+    m_timestampPool = std::exchange(other.m_timestampPool, VK_NULL_HANDLE);
+    m_timestampPeriod = std::exchange(other.m_timestampPeriod, 1.0);
+
+    m_maxInvocations = std::exchange(other.m_maxInvocations, 0);
+    m_maxSizeX = std::exchange(other.m_maxSizeX, 0);
+    m_maxSizeY = std::exchange(other.m_maxSizeY, 0);
+
+    m_deviceKey = std::move(other.m_deviceKey);
+    m_cachePath = std::move(other.m_cachePath);
+    m_cache = std::move(other.m_cache);
+
+    return *this;
+}
+
+WorkgroupAutotuner::~WorkgroupAutotuner() { destroy(); }
+
+void WorkgroupAutotuner::destroy() noexcept
+{
+    if (m_device != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(m_device, m_timestampPool, nullptr);
+        vkDestroyFence(m_device, m_fence, nullptr);
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    }
+
+    m_device = VK_NULL_HANDLE;
+    m_queue = VK_NULL_HANDLE;
+    m_commandPool = VK_NULL_HANDLE;
+    m_commandBuffer = VK_NULL_HANDLE;
+    m_fence = VK_NULL_HANDLE;
+    m_timestampPool = VK_NULL_HANDLE;
+}
+
+auto WorkgroupAutotuner::create(
+    VkPhysicalDevice const physicalDevice,
+    VkDevice const device,
+    VkQueue const queue,
+    uint32_t const queueFamilyIndex,
+    std::filesystem::path const& cachePath
+) -> std::optional<WorkgroupAutotuner>
+{
+    std::optional<WorkgroupAutotuner> result{
+        std::in_place, WorkgroupAutotuner{}
+    };
+    WorkgroupAutotuner& autotuner{result.value()};
+    autotuner.m_device = device;
+    autotuner.m_queue = queue;
+    autotuner.m_cachePath = cachePath;
+
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    autotuner.m_deviceKey = createDeviceKey(properties);
+    autotuner.m_maxInvocations =
+        properties.limits.maxComputeWorkGroupInvocations;
+    autotuner.m_maxSizeX = properties.limits.maxComputeWorkGroupSize[0];
+    autotuner.m_maxSizeY = properties.limits.maxComputeWorkGroupSize[1];
+    autotuner.m_timestampPeriod =
+        static_cast<double>(properties.limits.timestampPeriod);
+
+    VkCommandPoolCreateInfo const commandPoolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queueFamilyIndex,
+    };
+    VKT_TRY_VK(
+        vkCreateCommandPool(
+            device, &commandPoolInfo, nullptr, &autotuner.m_commandPool
+        ),
+        "Failed to create autotuner command pool.",
+        std::nullopt
+    );
+
+    VkCommandBufferAllocateInfo const cmdAllocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = autotuner.m_commandPool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1,
+    };
+    VKT_TRY_VK(
+        vkAllocateCommandBuffers(
+            device, &cmdAllocInfo, &autotuner.m_commandBuffer
+        ),
+        "Failed to allocate autotuner command buffer.",
+        std::nullopt
+    );
+
+    VkFenceCreateInfo const fenceInfo{fenceCreateInfo()};
+    VKT_TRY_VK(
+        vkCreateFence(device, &fenceInfo, nullptr, &autotuner.m_fence),
+        "Failed to create autotuner fence.",
+        std::nullopt
+    );
+
+    uint32_t queueFamilyCount{0};
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice, &queueFamilyCount, nullptr
+    );
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(
+        physicalDevice, &queueFamilyCount, queueFamilies.data()
+    );
+
+    bool const timestampsSupported{
+        queueFamilyIndex < queueFamilies.size()
+        && queueFamilies[queueFamilyIndex].timestampValidBits > 0
+        && properties.limits.timestampPeriod > 0.0F
+    };
+    if (timestampsSupported)
+    {
+        VkQueryPoolCreateInfo const queryPoolInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = 2,
+            .pipelineStatistics = 0,
+        };
+        VKT_TRY_VK(
+            vkCreateQueryPool(
+                device, &queryPoolInfo, nullptr, &autotuner.m_timestampPool
+            ),
+            "Failed to create autotuner timestamp query pool.",
+            std::nullopt
+        );
+    }
+    else
+    {
+        VKT_WARNING("Queue does not support timestamps, autotuning will time "
+                    "submissions on the CPU.");
+    }
+
+    autotuner.loadCache();
+
+    return result;
+}
+
+auto WorkgroupAutotuner::tune(
+    std::string const& key,
+    std::span<WorkgroupSize const> const candidates,
+    CreateCandidate const& createCandidate,
+    RecordCandidate const& recordCandidate
+) -> WorkgroupSize
+{
+    WorkgroupSize const fallback{
+        candidates.empty() ? WorkgroupSize{} : candidates.front()
+    };
+
+    std::string const fullKey{cacheKey(m_deviceKey, key)};
+    if (auto const cached{m_cache.find(fullKey)}; cached != m_cache.end())
+    {
+        if (fitsLimits(cached->second))
+        {
+            return cached->second;
+        }
+
+        VKT_WARNING(
+            "Cached workgroup size for '{}' exceeds device limits, retuning.",
+            key
+        );
+    }
+
+    std::optional<WorkgroupSize> best{};
+    double bestNanoseconds{0.0};
+
+    for (WorkgroupSize const candidate : candidates)
+    {
+        if (!fitsLimits(candidate))
+        {
+            continue;
+        }
+
+        std::optional<VkShaderEXT> const shaderResult{
+            createCandidate(candidate)
+        };
+        if (!shaderResult.has_value())
+        {
+            VKT_WARNING(
+                "Failed to create '{}' with workgroup size {}x{}.",
+                key,
+                candidate.x,
+                candidate.y
+            );
+            continue;
+        }
+
+        std::optional<double> const nanoseconds{
+            measure(shaderResult.value(), candidate, recordCandidate)
+        };
+
+        vkDestroyShaderEXT(m_device, shaderResult.value(), nullptr);
+
+        if (!nanoseconds.has_value())
+        {
+            continue;
+        }
+
+        VKT_DEBUG(
+            "'{}' with workgroup size {}x{}: {:.3f} ms",
+            key,
+            candidate.x,
+            candidate.y,
+            nanoseconds.value() / 1'000'000.0
+        );
+
+        if (!best.has_value() || nanoseconds.value() < bestNanoseconds)
+        {
+            best = candidate;
+            bestNanoseconds = nanoseconds.value();
+        }
+    }
+
+    if (!best.has_value())
+    {
+        VKT_WARNING(
+            "Failed to measure any workgroup size for '{}', using {}x{}.",
+            key,
+            fallback.x,
+            fallback.y
+        );
+        return fallback;
+    }
+
+    VKT_INFO(
+        "Autotuned '{}' to workgroup size {}x{}.", key, best->x, best->y
+    );
+
+    m_cache[fullKey] = best.value();
+    saveCache();
+
+    return best.value();
+}
+
+auto WorkgroupAutotuner::defaultCandidates() -> std::span<WorkgroupSize const>
+{
+    return DEFAULT_CANDIDATES;
+}
+
+auto WorkgroupAutotuner::fitsLimits(WorkgroupSize const size) const -> bool
+{
+    return size.x > 0 && size.y > 0 && size.x <= m_maxSizeX
+        && size.y <= m_maxSizeY && size.x * size.y <= m_maxInvocations;
+}
+
+auto WorkgroupAutotuner::measure(
+    VkShaderEXT const shader,
+    WorkgroupSize const size,
+    RecordCandidate const& recordCandidate
+) -> std::optional<double>
+{
+    VkCommandBuffer const cmd{m_commandBuffer};
+    VkCommandBufferBeginInfo const beginInfo{
+        commandBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT)
+    };
+
+    std::vector<double> samples{};
+
+    // The first pass is a warm-up, so that first-use costs such as shader
+    // upload and layout transitions are not measured.
+    for (uint32_t sample{0}; sample < SAMPLES + 1; sample++)
+    {
+        if (VkResult const resetResult{vkResetCommandBuffer(cmd, 0)};
+            resetResult != VK_SUCCESS)
+        {
+            VKT_LOG_VK(resetResult, "Failed to reset autotuner commands.");
+            return std::nullopt;
+        }
+        if (VkResult const beginResult{vkBeginCommandBuffer(cmd, &beginInfo)};
+            beginResult != VK_SUCCESS)
+        {
+            VKT_LOG_VK(beginResult, "Failed to begin autotuner commands.");
+            return std::nullopt;
+        }
+
+        if (m_timestampPool != VK_NULL_HANDLE)
+        {
+            vkCmdResetQueryPool(cmd, m_timestampPool, 0, 2);
+            vkCmdWriteTimestamp2(
+                cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_timestampPool, 0
+            );
+        }
+
+        for (uint32_t run{0}; run < RUNS_PER_SAMPLE; run++)
+        {
+            recordCandidate(cmd, shader, size);
+        }
+
+        if (m_timestampPool != VK_NULL_HANDLE)
+        {
+            vkCmdWriteTimestamp2(
+                cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, m_timestampPool, 1
+            );
+        }
+
+        if (VkResult const endResult{vkEndCommandBuffer(cmd)};
+            endResult != VK_SUCCESS)
+        {
+            VKT_LOG_VK(endResult, "Failed to end autotuner commands.");
+            return std::nullopt;
+        }
+
+        auto const cpuStart{std::chrono::steady_clock::now()};
+        if (submitAndWait() != VK_SUCCESS)
+        {
+            return std::nullopt;
+        }
+        auto const cpuEnd{std::chrono::steady_clock::now()};
+
+        if (sample == 0)
+        {
+            continue;
+        }
+
+        if (m_timestampPool == VK_NULL_HANDLE)
+        {
+            samples.push_back(
+                std::chrono::duration<double, std::nano>(cpuEnd - cpuStart)
+                    .count()
+            );
+            continue;
+        }
+
+        std::array<uint64_t, 2> timestamps{};
+        if (VkResult const queryResult{vkGetQueryPoolResults(
+                m_device,
+                m_timestampPool,
+                0,
+                2,
+                sizeof(timestamps),
+                timestamps.data(),
+                sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT
+            )};
+            queryResult != VK_SUCCESS)
+        {
+            VKT_LOG_VK(queryResult, "Failed to read autotuner timestamps.");
+            return std::nullopt;
+        }
+
+        samples.push_back(
+            static_cast<double>(timestamps[1] - timestamps[0])
+            * m_timestampPeriod
+        );
+    }
+
+    auto const median{samples.begin() + samples.size() / 2};
+    std::nth_element(samples.begin(), median, samples.end());
+
+    return *median;
+}
+
+auto WorkgroupAutotuner::submitAndWait() -> VkResult
+{
+    std::vector<VkCommandBufferSubmitInfo> const cmdSubmitInfos{
+        commandBufferSubmitInfo(m_commandBuffer)
+    };
+    std::vector<VkSemaphoreSubmitInfo> const waitInfos{};
+    std::vector<VkSemaphoreSubmitInfo> const signalInfos{};
+    VkSubmitInfo2 const submission{
+        submitInfo(cmdSubmitInfos, waitInfos, signalInfos)
+    };
+
+    VKT_PROPAGATE_VK(
+        vkQueueSubmit2(m_queue, 1, &submission, m_fence),
+        "Failed to submit autotuner commands."
+    );
+
+    uint64_t constexpr TIMEOUT_NANOSECONDS{10'000'000'000};
+    VKT_PROPAGATE_VK(
+        vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, TIMEOUT_NANOSECONDS),
+        "Failed to wait on autotuner fence."
+    );
+
+    VKT_PROPAGATE_VK(
+        vkResetFences(m_device, 1, &m_fence),
+        "Failed to reset autotuner fence."
+    );
+
+    return VK_SUCCESS;
+}
+
+void WorkgroupAutotuner::loadCache()
+{
+    std::ifstream file{m_cachePath};
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    // One entry per line: <device key> <shader key> <x> <y>
+    std::string line{};
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream{line};
+
+        std::string deviceKey{};
+        std::string key{};
+        WorkgroupSize size{};
+        if (!(lineStream >> deviceKey >> key >> size.x >> size.y))
+        {
+            VKT_WARNING(
+                "Skipping malformed line in workgroup cache '{}'.",
+                m_cachePath.string()
+            );
+            continue;
+        }
+
+        m_cache[cacheKey(deviceKey, key)] = size;
+    }
+}
+
+void WorkgroupAutotuner::saveCache() const
+{
+    std::ofstream file{m_cachePath, std::ios::trunc};
+    if (!file.is_open())
+    {
+        VKT_WARNING(
+            "Unable to write workgroup cache to '{}'.", m_cachePath.string()
+        );
+        return;
+    }
+
+    for (auto const& [key, size] : m_cache)
+    {
+        file << key << " " << size.x << " " << size.y << "\n";
+    }
+}
+} // namespace vkt
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "vulkan_template/core/Integer.hpp"
+#include "vulkan_template/vulkan/Shader.hpp"
+#include "vulkan_template/vulkan/VulkanUsage.hpp"
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace vkt
+{
+// Picks compute workgroup dimensions per device by timing each candidate on
+// the GPU. Winners are written to a cache file keyed by device and driver, so
+// the benchmark only runs the first time a shader is seen on a given device.
+//
+// Tuning submits and waits on the queue, so it is meant to run during
+// initialization, before frames are in flight.
+struct WorkgroupAutotuner
+{
+public:
+    WorkgroupAutotuner(WorkgroupAutotuner const&) = delete;
+    auto operator=(WorkgroupAutotuner const&) -> WorkgroupAutotuner& = delete;
+
+    WorkgroupAutotuner(WorkgroupAutotuner&&) noexcept;
+    auto operator=(WorkgroupAutotuner&&) noexcept -> WorkgroupAutotuner&;
+
+    ~WorkgroupAutotuner();
+
+private:
+    WorkgroupAutotuner() = default;
+    void destroy() noexcept;
+
+public:
+    // QueueFamilyIndex should be capable of compute.
+    static auto create(
+        VkPhysicalDevice,
+        VkDevice,
+        VkQueue,
+        uint32_t queueFamilyIndex,
+        std::filesystem::path const& cachePath
+    ) -> std::optional<WorkgroupAutotuner>;
+
+    // Creates the shader specialized with the given workgroup size, see
+    // computeSpecialization. The autotuner destroys the shader once it has
+    // been measured.
+    using CreateCandidate =
+        std::function<std::optional<VkShaderEXT>(WorkgroupSize)>;
+    // Records one run of the benchmark workload with the given shader.
+    using RecordCandidate =
+        std::function<void(VkCommandBuffer, VkShaderEXT, WorkgroupSize)>;
+
+    // Returns the cached winner for key on this device if there is one.
+    // Otherwise times each candidate that fits the device's limits, caches the
+    // fastest, and returns it. Falls back to the first candidate if none could
+    // be measured.
+    auto tune(
+        std::string const& key,
+        std::span<WorkgroupSize const> candidates,
+        CreateCandidate const&,
+        RecordCandidate const&
+    ) -> WorkgroupSize;
+
+    // A spread of square and wide shapes for 2D image work.
+    static auto defaultCandidates() -> std::span<WorkgroupSize const>;
+
+private:
+    [[nodiscard]] auto fitsLimits(WorkgroupSize) const -> bool;
+
+    // Returns the median GPU time of the workload in nanoseconds.
+    auto measure(VkShaderEXT, WorkgroupSize, RecordCandidate const&)
+        -> std::optional<double>;
+
+    auto submitAndWait() -> VkResult;
+
+    void loadCache();
+    void saveCache() const;
+
+    VkDevice m_device{VK_NULL_HANDLE};
+    VkQueue m_queue{VK_NULL_HANDLE};
+
+    VkCommandPool m_commandPool{VK_NULL_HANDLE};
+    VkCommandBuffer m_commandBuffer{VK_NULL_HANDLE};
+    VkFence m_fence{VK_NULL_HANDLE};
+
+    // Null when the queue does not support timestamps, in which case the
+    // autotuner falls back to timing submissions on the CPU.
+    VkQueryPool m_timestampPool{VK_NULL_HANDLE};
+    // Nanoseconds per timestamp tick.
+    double m_timestampPeriod{1.0};
+
+    uint32_t m_maxInvocations{0};
+    uint32_t m_maxSizeX{0};
+    uint32_t m_maxSizeY{0};
+
+    // Identifies the device and driver, since a driver update can change
+    // which shape wins.
+    std::string m_deviceKey{};
+
+    std::filesystem::path m_cachePath{};
+    // Keyed by device key and shader key, including other devices' entries so
+    // they survive rewriting the file.
+    std::map<std::string, WorkgroupSize> m_cache{};
+};
+} // namespace vkt
\ No newline at end of file